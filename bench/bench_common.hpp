@@ -0,0 +1,80 @@
+/// @file bench_common.hpp
+/// @brief Общие средства микробенчмарков
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace Bench {
+
+/// @brief Результат замера
+struct Measurement {
+  double seconds = 0;  ///< Лучшее время прохода
+  size_t items = 0;    ///< Элементов за проход
+};
+
+/// @brief Замеряет функцию, выполняющую один проход
+/// @details Первый проход прогревочный, результатом считается лучший из
+/// последующих, чтобы отсечь влияние других процессов
+/// @param repeats Количество замеряемых проходов
+/// @param items Элементов за проход
+/// @param pass Функция прохода
+template <typename Pass>
+Measurement measure(size_t repeats, size_t items, Pass&& pass) {
+  using Clock = std::chrono::steady_clock;
+  pass();
+
+  double best = 0;
+  for (size_t i = 0; i < std::max<size_t>(repeats, 1); ++i) {
+    const auto start = Clock::now();
+    pass();
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+    if (i == 0 || elapsed.count() < best) best = elapsed.count();
+  }
+  return {best, items};
+}
+
+/// @brief Не дает компилятору удалить вычисление результата
+template <typename T>
+void keep(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/// @brief Читает положительное число из аргумента командной строки
+/// @param argc Количество аргументов
+/// @param argv Аргументы
+/// @param index Номер аргумента
+/// @param fallback Значение, если аргумент не задан
+/// @return Значение аргумента
+inline size_t argument(int argc, char* argv[], int index, size_t fallback) {
+  if (index >= argc) return fallback;
+  const unsigned long long value = std::strtoull(argv[index], nullptr, 10);
+  return value > 0 ? static_cast<size_t>(value) : fallback;
+}
+
+/// @brief Печатает строку результата: время прохода, скорость и ускорение
+/// @param name Название варианта
+/// @param result Замер варианта
+/// @param baseline Замер базового варианта
+inline void report(std::string_view name, const Measurement& result,
+                   const Measurement& baseline) {
+  const double per_second = static_cast<double>(result.items) / result.seconds;
+  const double per_item =
+      result.seconds * 1e9 /
+      static_cast<double>(std::max<size_t>(result.items, 1));
+  std::cout << std::left << std::setw(28) << name << std::right << std::fixed
+            << std::setprecision(3) << std::setw(10) << result.seconds
+            << " с  " << std::setprecision(0) << std::setw(12) << per_second
+            << " эл/с  " << std::setprecision(1) << std::setw(9) << per_item
+            << " нс/эл  x" << std::setprecision(1)
+            << baseline.seconds / result.seconds << "\n";
+}
+
+}
@@ -0,0 +1,187 @@
+/// @file evtx_decode_bench.cpp
+/// @brief Декодирование записей EVTX: планы шаблонов против полного обхода
+/// @details Блоки файла декодируются в одном потоке теми же декодером и
+/// сборщиком записей, что и в EvtxNativeParser, с кешем планов шаблонов и
+/// без него (полный обход тела шаблона для каждой записи). Перед замером
+/// проверяется, что оба варианта дают одинаковые события. Отдельно
+/// замеряется EvtxNativeParser::forEachRecord с одним потоком разбора.
+/// Каждый вариант сворачивает поля всех записей, поэтому время включает
+/// обращение к ним.
+///
+/// Запуск: bench_evtx_decode <файл.evtx> [проходов]
+
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../parsers/event_log/formats/common/mapped_file.hpp"
+#include "../parsers/event_log/formats/evtx/binxml.hpp"
+#include "../parsers/event_log/formats/evtx/chunk.hpp"
+#include "../parsers/event_log/formats/evtx/native_parser.hpp"
+#include "../parsers/event_log/formats/evtx/record_assembler.hpp"
+#include "../parsers/event_log/formats/evtx/template_plan.hpp"
+#include "bench_common.hpp"
+
+namespace {
+
+using namespace EventLogAnalysis;
+
+constexpr uint64_t kDigestSeed = 0xcbf29ce484222325ULL;  ///< Начало FNV-1a
+
+/// @brief Итог прохода: число записей и свертка их содержимого
+struct DecodeResult {
+  size_t records = 0;                   ///< Разобранных записей
+  size_t damaged = 0;                   ///< Неразобранных записей
+  uint64_t digest = 0;                  ///< Свертка записей (FNV-1a)
+  TemplateCache::Statistics templates;  ///< Счетчики кеша планов
+};
+
+/// @brief Дописывает байты в свертку FNV-1a
+void mix(uint64_t& digest, std::string_view bytes) noexcept {
+  for (const char ch : bytes) {
+    digest ^= static_cast<uint8_t>(ch);
+    digest *= 0x100000001b3ULL;
+  }
+  digest ^= 0xff;
+  digest *= 0x100000001b3ULL;
+}
+
+/// @brief Дописывает число в свертку
+void mix(uint64_t& digest, uint64_t value) noexcept {
+  mix(digest, std::string_view(reinterpret_cast<const char*>(&value),
+                               sizeof(value)));
+}
+
+/// @brief Дописывает содержимое события в свертку
+void mix(uint64_t& digest, const EventData& event) {
+  mix(digest, event.getRecordId());
+  mix(digest, event.getTimestamp());
+  mix(digest, event.getEventId());
+  mix(digest, static_cast<uint64_t>(event.getLevel()));
+  mix(digest, event.getProvider());
+  mix(digest, event.getComputer());
+  mix(digest, event.getChannel());
+  mix(digest, event.getUserSid());
+  for (const EventField& field : event.getData()) {
+    mix(digest, field.name.view());
+    mix(digest, field.value());
+  }
+}
+
+/// @brief Находит блоки файла по порядку их расположения
+std::vector<EvtxChunk> chunksOf(std::span<const uint8_t> file) {
+  std::vector<EvtxChunk> chunks;
+  for (size_t offset = EvtxFileHeader::kSize;
+       offset + EvtxChunk::kSize <= file.size(); offset += EvtxChunk::kSize) {
+    const auto chunk =
+        EvtxChunk::parse(file.subspan(offset, EvtxChunk::kSize), offset);
+    if (chunk && !chunk->empty()) {
+      chunks.push_back(*chunk);
+    }
+  }
+  return chunks;
+}
+
+/// @brief Декодирует все записи блоков
+/// @param chunks Блоки файла
+/// @param use_plans Использовать кеш планов шаблонов
+DecodeResult decodeAll(const std::vector<EvtxChunk>& chunks, bool use_plans) {
+  DecodeResult result;
+  result.digest = kDigestSeed;
+  TemplateCache templates;
+
+  for (const EvtxChunk& chunk : chunks) {
+    BinXmlDecoder decoder(chunk.bytes(), use_plans ? &templates : nullptr);
+    auto arena = std::make_shared<EventArena>(true);
+    EvtxRecordAssembler assembler(arena);
+
+    chunk.forEachRecord([&](const EvtxRecordLocation& location) {
+      const auto header = static_cast<uint32_t>(EvtxChunk::kRecordHeaderSize);
+      try {
+        assembler.reset(location, nullptr, false);
+        decoder.decode(location.offset + header,
+                       location.size - header - 4, assembler);
+      } catch (const std::exception&) {
+        result.damaged++;
+        return true;
+      }
+      mix(result.digest, assembler.build());
+      result.records++;
+      return true;
+    });
+  }
+  result.templates = templates.statistics();
+  return result;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cerr << "Использование: " << argv[0]
+              << " <файл.evtx> [проходов]\n";
+    return 1;
+  }
+
+  const std::string file_path(argv[1]);
+  const size_t repeats = Bench::argument(argc, argv, 2, 3);
+
+  try {
+    const MappedFile file(file_path);
+    const std::vector<EvtxChunk> chunks = chunksOf(file.bytes());
+
+    const DecodeResult walked = decodeAll(chunks, false);
+    const DecodeResult planned = decodeAll(chunks, true);
+    if (walked.records != planned.records ||
+        walked.digest != planned.digest) {
+      std::cerr << "События по планам шаблонов не совпадают с полным "
+                   "обходом\n";
+      return 1;
+    }
+
+    std::cout << file_path << ": " << chunks.size() << " блоков, "
+              << walked.records << " записей, поврежденных "
+              << walked.damaged << "\n"
+              << "Планы: по плану " << planned.templates.plan_hits
+              << ", скомпилировано " << planned.templates.compiled
+              << ", из других блоков " << planned.templates.shared
+              << ", полным обходом " << planned.templates.fallbacks << "\n";
+
+    const auto baseline = Bench::measure(repeats, walked.records, [&] {
+      Bench::keep(decodeAll(chunks, false).digest);
+    });
+    const auto plans = Bench::measure(repeats, planned.records, [&] {
+      Bench::keep(decodeAll(chunks, true).digest);
+    });
+
+    EvtxNativeParserOptions options;
+    options.worker_threads = 1;
+    EvtxNativeParser parser(options);
+    DecodeResult parsed;
+    const auto native = Bench::measure(repeats, walked.records, [&] {
+      parsed = {};
+      parsed.digest = kDigestSeed;
+      parser.forEachRecord(file_path, [&parsed](EventData&& event) {
+        mix(parsed.digest, event);
+        parsed.records++;
+        return true;
+      });
+    });
+    if (parsed.records != walked.records || parsed.digest != walked.digest) {
+      std::cerr << "События EvtxNativeParser не совпадают с полным обходом\n";
+      return 1;
+    }
+
+    Bench::report("full template walk", baseline, baseline);
+    Bench::report("template plans", plans, baseline);
+    Bench::report("EvtxNativeParser, 1 thread", native, baseline);
+  } catch (const std::exception& e) {
+    std::cerr << "Ошибка: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
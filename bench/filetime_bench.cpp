@@ -0,0 +1,121 @@
+/// @file filetime_bench.cpp
+/// @brief Форматирование FILETIME: gmtime и ostringstream против
+/// FiletimeFormatter
+/// @details Метки идут почти подряд, как в журналах событий: шаг от 0 до 3
+/// секунд. Базовый вариант воспроизводит прежний filetimeToString через
+/// gmtime и ostringstream. Перед замером проверяется, что все варианты
+/// дают одинаковые строки.
+///
+/// Запуск: bench_filetime [меток] [проходов]
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../utils/time/filetime_formatter.hpp"
+#include "bench_common.hpp"
+
+namespace {
+
+constexpr uint64_t kEpochDifference = 116444736000000000ULL;  ///< 1601-1970
+constexpr uint64_t kTicksPerSecond = 10000000ULL;  ///< Интервалов в секунде
+constexpr size_t kBatchSize = 4096;  ///< Меток в пакете formatBatch
+
+/// @brief Прежнее форматирование через gmtime и ostringstream
+std::string gmtimeToString(uint64_t filetime) {
+  if (filetime == 0) return "N/A";
+
+  const auto seconds =
+      static_cast<time_t>((filetime - kEpochDifference) / kTicksPerSecond);
+  const tm* time = gmtime(&seconds);
+  if (!time) return "";
+
+  std::ostringstream oss;
+  oss << std::setfill('0') << std::setw(4) << (time->tm_year + 1900) << "-"
+      << std::setw(2) << (time->tm_mon + 1) << "-" << std::setw(2)
+      << time->tm_mday << " " << std::setw(2) << time->tm_hour << ":"
+      << std::setw(2) << time->tm_min << ":" << std::setw(2) << time->tm_sec;
+  return oss.str();
+}
+
+/// @brief Создает почти последовательные метки начиная с 2024-03-01
+std::vector<uint64_t> makeTimestamps(size_t count) {
+  std::mt19937_64 random(4688);
+  std::uniform_int_distribution<uint64_t> step(0, 3 * kTicksPerSecond);
+  std::vector<uint64_t> timestamps(count);
+  uint64_t filetime = kEpochDifference + 1709251200ULL * kTicksPerSecond;
+  for (uint64_t& timestamp : timestamps) {
+    filetime += step(random);
+    timestamp = filetime;
+  }
+  return timestamps;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+  const size_t count = Bench::argument(argc, argv, 1, 10000000);
+  const size_t repeats = Bench::argument(argc, argv, 2, 1);
+  const std::vector<uint64_t> timestamps = makeTimestamps(count);
+
+  FiletimeFormatter formatter;
+  std::array<char, kBatchSize * FiletimeFormatter::kLength> batch{};
+  const size_t checked = std::min<size_t>(count, 100000);
+  for (size_t i = 0; i < checked; i += kBatchSize) {
+    const auto part = std::span(timestamps).subspan(
+        i, std::min(kBatchSize, checked - i));
+    formatter.formatBatch(part, batch);
+    for (size_t j = 0; j < part.size(); ++j) {
+      const std::string expected = gmtimeToString(part[j]);
+      const std::string_view batched(batch.data() + j * expected.size(),
+                                     expected.size());
+      if (formatter.toString(part[j]) != expected || batched != expected) {
+        std::cerr << "Результат не совпадает с gmtime: " << expected << "\n";
+        return 1;
+      }
+    }
+  }
+
+  std::cout << count << " меток, шаг 0-3 с\n";
+
+  const auto baseline = Bench::measure(repeats, count, [&] {
+    for (const uint64_t timestamp : timestamps) {
+      Bench::keep(gmtimeToString(timestamp).size());
+    }
+  });
+  const auto strings = Bench::measure(repeats, count, [&] {
+    for (const uint64_t timestamp : timestamps) {
+      Bench::keep(formatter.toString(timestamp).size());
+    }
+  });
+  const auto buffer = Bench::measure(repeats, count, [&] {
+    char out[FiletimeFormatter::kLength];
+    for (const uint64_t timestamp : timestamps) {
+      formatter.format(timestamp, out);
+      Bench::keep(out);
+    }
+  });
+  const auto batched = Bench::measure(repeats, count, [&] {
+    for (size_t i = 0; i < count; i += kBatchSize) {
+      formatter.formatBatch(
+          std::span(timestamps).subspan(i, std::min(kBatchSize, count - i)),
+          batch);
+      Bench::keep(batch);
+    }
+  });
+
+  Bench::report("gmtime + ostringstream", baseline, baseline);
+  Bench::report("toString", strings, baseline);
+  Bench::report("format", buffer, baseline);
+  Bench::report("formatBatch", batched, baseline);
+  return 0;
+}
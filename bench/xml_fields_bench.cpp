@@ -0,0 +1,144 @@
+/// @file xml_fields_bench.cpp
+/// @brief Извлечение полей Data из XML события: std::regex против сканера
+/// @details Запись - синтетическое событие 4688 журнала Security. Базовый
+/// вариант воспроизводит прежний разбор XmlEventParser на std::regex с
+/// заменой сущностей по одной. Перед замером проверяется, что все варианты
+/// дают одинаковые поля.
+///
+/// Запуск: bench_xml_fields [записей за проход] [проходов]
+
+#include <iostream>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include "../parsers/event_log/formats/common/xml_parser.hpp"
+#include "bench_common.hpp"
+
+namespace {
+
+using Fields = std::unordered_map<std::string, std::string>;
+
+/// @brief Синтетическое событие создания процесса (4688)
+constexpr std::string_view kRecord =
+    R"(<Event xmlns="http://schemas.microsoft.com/win/2004/08/events/event">)"
+    R"(<System><Provider Name="Microsoft-Windows-Security-Auditing" )"
+    R"(Guid="{54849625-5478-4994-A5BA-3E3B0328C30D}"/><EventID>4688</EventID>)"
+    R"(<Version>2</Version><Level>0</Level><Task>13312</Task>)"
+    R"(<Opcode>0</Opcode><Keywords>0x8020000000000000</Keywords>)"
+    R"(<TimeCreated SystemTime="2024-03-18T09:41:27.5512683Z"/>)"
+    R"(<EventRecordID>1048576</EventRecordID><Correlation/>)"
+    R"(<Execution ProcessID="4" ThreadID="7240"/><Channel>Security</Channel>)"
+    R"(<Computer>WS-0421.corp.example.com</Computer><Security/></System>)"
+    R"(<EventData>)"
+    R"(<Data Name="SubjectUserSid">)"
+    R"(S-1-5-21-3623811015-3361044348-30300820-1013</Data>)"
+    R"(<Data Name="SubjectUserName">j.smith</Data>)"
+    R"(<Data Name="SubjectDomainName">CORP</Data>)"
+    R"(<Data Name="SubjectLogonId">0x3e7a21</Data>)"
+    R"(<Data Name="NewProcessId">0x1f34</Data>)"
+    R"(<Data Name="NewProcessName">)"
+    R"(C:\Windows\System32\WindowsPowerShell\v1.0\powershell.exe</Data>)"
+    R"(<Data Name="TokenElevationType">%%1938</Data>)"
+    R"(<Data Name="ProcessId">0x1a2c</Data>)"
+    R"(<Data Name="CommandLine">powershell.exe -NoProfile -Command )"
+    R"(&quot;Get-ChildItem C:\Users | Where-Object { $_.Length -gt 0 } )"
+    R"(&gt; C:\Temp\out.txt&quot;</Data>)"
+    R"(<Data Name="TargetUserSid">S-1-0-0</Data>)"
+    R"(<Data Name="TargetUserName">-</Data>)"
+    R"(<Data Name="TargetDomainName">-</Data>)"
+    R"(<Data Name="TargetLogonId">0x0</Data>)"
+    R"(<Data Name="ParentProcessName">C:\Windows\explorer.exe</Data>)"
+    R"(<Data Name="MandatoryLabel">S-1-16-8192</Data>)"
+    R"(</EventData></Event>)";
+
+/// @brief Прежний разбор полей на std::regex
+class RegexFieldParser {
+ public:
+  Fields parseEventData(const std::string& xml) const {
+    Fields result;
+    auto it = std::sregex_iterator(xml.begin(), xml.end(), data_regex_);
+    for (auto end = std::sregex_iterator(); it != end; ++it) {
+      if (const std::smatch& match = *it; match.size() == 3) {
+        result.emplace(match[1].str(), decodeXmlEntities(match[2].str()));
+      }
+    }
+    return result;
+  }
+
+ private:
+  std::string decodeXmlEntities(std::string text) const {
+    for (const auto& [entity, replacement] : entities_) {
+      size_t pos = 0;
+      while ((pos = text.find(entity, pos)) != std::string::npos) {
+        text.replace(pos, entity.length(), replacement);
+        pos += replacement.length();
+      }
+    }
+    return text;
+  }
+
+  std::regex data_regex_{R"xml(<Data\s+Name="([^"]+)">([^<]*)</Data>)xml"};
+  std::unordered_map<std::string, std::string> entities_{{"&amp;", "&"},
+                                                         {"&lt;", "<"},
+                                                         {"&gt;", ">"},
+                                                         {"&quot;", "\""},
+                                                         {"&apos;", "'"}};
+};
+
+}
+
+int main(int argc, char* argv[]) {
+  using EventLogAnalysis::XmlEventParser;
+
+  const size_t records = Bench::argument(argc, argv, 1, 20000);
+  const size_t repeats = Bench::argument(argc, argv, 2, 3);
+  const std::string record(kRecord);
+  const RegexFieldParser regex_parser;
+
+  const Fields expected = regex_parser.parseEventData(record);
+  Fields visited;
+  XmlEventParser::forEachDataField(
+      record, [&visited](std::string_view name, std::string_view raw_value) {
+        std::string value;
+        XmlEventParser::appendDecoded(value, raw_value);
+        visited.emplace(name, std::move(value));
+      });
+  if (expected.size() != 15 ||
+      XmlEventParser::parseEventData(record) != expected ||
+      visited != expected) {
+    std::cerr << "Результаты разбора не совпадают с std::regex\n";
+    return 1;
+  }
+
+  std::cout << "Событие 4688, " << record.size() << " байт, " << records
+            << " записей за проход\n";
+
+  const auto baseline = Bench::measure(repeats, records, [&] {
+    for (size_t i = 0; i < records; ++i) {
+      Bench::keep(regex_parser.parseEventData(record).size());
+    }
+  });
+  const auto parsed = Bench::measure(repeats, records, [&] {
+    for (size_t i = 0; i < records; ++i) {
+      Bench::keep(XmlEventParser::parseEventData(record).size());
+    }
+  });
+  const auto views = Bench::measure(repeats, records, [&] {
+    for (size_t i = 0; i < records; ++i) {
+      size_t bytes = 0;
+      XmlEventParser::forEachDataField(
+          record, [&bytes](std::string_view name, std::string_view value) {
+            bytes += name.size() + value.size();
+          });
+      Bench::keep(bytes);
+    }
+  });
+
+  Bench::report("std::regex", baseline, baseline);
+  Bench::report("parseEventData", parsed, baseline);
+  Bench::report("forEachDataField", views, baseline);
+  return 0;
+}
@@ -43,6 +43,21 @@ struct AutorunEntry {
   std::string location;  ///< Место расположения в реестре или файловой системе
 };
 
+/// @brief Активность процесса по событиям Sysmon
+struct SysmonActivity {
+  uint64_t event_count = 0;                 ///< Количество событий
+  uint64_t image_loads = 0;                 ///< Загрузки модулей (ID 7)
+  uint64_t file_creates = 0;                ///< Созданные файлы (ID 11)
+  uint64_t registry_sets = 0;               ///< Изменения реестра (ID 13)
+  uint64_t dns_queries = 0;                 ///< DNS-запросы (ID 22)
+  std::string first_seen;                   ///< Время первого события
+  std::string last_seen;                    ///< Время последнего события
+  std::vector<std::string> hashes;          ///< Хэши образа (ID 1)
+  std::vector<std::string> loaded_modules;  ///< Загруженные модули (ID 7)
+  std::vector<std::string> dns_names;       ///< Запрошенные имена (ID 22)
+  std::vector<std::string> events;          ///< Сохраненные события
+};
+
 /// @brief Информация о процессе
 struct ProcessInfo {
   std::string filename;                ///< Имя файла
@@ -51,6 +66,8 @@ struct ProcessInfo {
   std::string command;                 ///< Командная строка запуска
   std::vector<PrefetchAnalysis::VolumeInfo> volumes;
   std::vector<PrefetchAnalysis::FileMetric> metrics;
+  std::vector<std::string> logon_sessions;  ///< Сеансы входа запусков
+  SysmonActivity sysmon;                    ///< Активность по Sysmon
 };
 
 /// @brief Информация о сетевом подключении
@@ -60,6 +77,9 @@ struct NetworkConnection {
   std::string remote_address;  ///< Удалённый IP-адрес
   uint16_t port = 0;           ///< Номер порта
   std::string protocol;        ///< Протокол соединения (TCP/UDP)
+  uint64_t event_count = 0;    ///< Количество событий о соединении
+  std::string first_seen;      ///< Время первого события
+  std::string last_seen;       ///< Время последнего события
 };
 
 /// @brief Агрегированные результаты анализа
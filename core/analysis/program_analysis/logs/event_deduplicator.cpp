@@ -0,0 +1,144 @@
+#include "event_deduplicator.hpp"
+
+#include <functional>
+#include <string_view>
+#include <utility>
+
+namespace {
+
+/// @brief Начальное число ячеек сегмента
+constexpr size_t kInitialSlots = 256;
+
+/// @brief Перемешивание 64-битного значения (splitmix64)
+constexpr uint64_t mix(uint64_t value) noexcept {
+  value ^= value >> 30;
+  value *= 0xBF58476D1CE4E5B9ULL;
+  value ^= value >> 27;
+  value *= 0x94D049BB133111EBULL;
+  return value ^ (value >> 31);
+}
+
+/// @brief Добавляет строку к свертке источника
+uint64_t combine(uint64_t seed, std::string_view text) noexcept {
+  return mix(seed ^ std::hash<std::string_view>{}(text));
+}
+
+}
+
+namespace WindowsDiskAnalysis {
+
+EventDeduplicator::EventDeduplicator(size_t log_count)
+    : shards_(std::make_unique<Shard[]>(size_t{1} << kShardBits)),
+      stale_(std::make_unique<std::atomic<bool>[]>(log_count)) {}
+
+std::optional<EventDeduplicator::Key> EventDeduplicator::keyOf(
+    const EventLogAnalysis::EventData& event) {
+  Key key;
+  key.record_id = event.getRecordId();
+  if (key.record_id == 0) {
+    return std::nullopt;
+  }
+  key.timestamp = event.getTimestamp();
+  key.source = mix(event.getEventId());
+  key.source = combine(key.source, event.getComputer());
+  key.source = combine(key.source, event.getChannel());
+  key.source = combine(key.source, event.getProvider());
+  return key;
+}
+
+bool EventDeduplicator::claim(const Key& key, uint32_t rank) {
+  const uint64_t hash = hashOf(key);
+  Shard& shard = shardOf(hash);
+  std::lock_guard lock(shard.mutex);
+
+  // Заполнение не выше 3/4: линейное пробирование остается коротким
+  if ((shard.size + 1) * 4 > shard.slots.size() * 3) {
+    grow(shard);
+  }
+  Slot& slot = find(shard, key, hash);
+  if (slot.key.record_id == 0) {
+    slot.key = key;
+    slot.rank = rank;
+    shard.size++;
+    return true;
+  }
+
+  duplicates_.fetch_add(1, std::memory_order_relaxed);
+  if (slot.rank <= rank) {
+    return false;
+  }
+  stale_[slot.rank].store(true, std::memory_order_relaxed);
+  slot.rank = rank;
+  return true;
+}
+
+void EventDeduplicator::restore(std::span<const Key> owned,
+                                std::span<const Key> skipped, uint32_t rank) {
+  bool changed = false;
+  for (const Key& key : owned) changed |= !claim(key, rank);
+  for (const Key& key : skipped) changed |= claim(key, rank);
+  if (changed) {
+    stale_[rank].store(true, std::memory_order_relaxed);
+  }
+}
+
+bool EventDeduplicator::take(const Key& key, uint32_t rank) {
+  const uint64_t hash = hashOf(key);
+  Shard& shard = shardOf(hash);
+  std::lock_guard lock(shard.mutex);
+
+  // Запись, не заявленная при первом разборе (журнал дописан между
+  // разборами), закрепляется за журналом
+  if ((shard.size + 1) * 4 > shard.slots.size() * 3) {
+    grow(shard);
+  }
+  Slot& slot = find(shard, key, hash);
+  if (slot.key.record_id == 0) {
+    slot.key = key;
+    slot.rank = rank;
+    shard.size++;
+  } else if (slot.rank != rank || slot.taken) {
+    return false;
+  }
+  slot.taken = true;
+  return true;
+}
+
+uint64_t EventDeduplicator::hashOf(const Key& key) noexcept {
+  return mix(key.record_id ^ mix(key.timestamp ^ mix(key.source)));
+}
+
+EventDeduplicator::Shard& EventDeduplicator::shardOf(uint64_t hash) noexcept {
+  // Старшие биты выбирают сегмент, младшие - ячейку в нем
+  return shards_[hash >> (64 - kShardBits)];
+}
+
+EventDeduplicator::Slot& EventDeduplicator::find(Shard& shard, const Key& key,
+                                                 uint64_t hash) noexcept {
+  const size_t mask = shard.slots.size() - 1;
+  for (size_t i = hash & mask;; i = (i + 1) & mask) {
+    Slot& slot = shard.slots[i];
+    if (slot.key.record_id == 0 || slot.key == key) {
+      return slot;
+    }
+  }
+}
+
+void EventDeduplicator::grow(Shard& shard) {
+  std::vector<Slot> slots(
+      shard.slots.empty() ? kInitialSlots : shard.slots.size() * 2);
+  const size_t mask = slots.size() - 1;
+  for (const Slot& slot : shard.slots) {
+    if (slot.key.record_id == 0) {
+      continue;
+    }
+    size_t i = hashOf(slot.key) & mask;
+    while (slots[i].key.record_id != 0) {
+      i = (i + 1) & mask;
+    }
+    slots[i] = slot;
+  }
+  shard.slots = std::move(slots);
+}
+
+}
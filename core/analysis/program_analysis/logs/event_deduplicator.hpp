@@ -0,0 +1,143 @@
+/// @file event_deduplicator.hpp
+/// @brief Отбрасывание повторов записей из пересекающихся журналов
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "../../../../parsers/event_log/model/event_data.hpp"
+
+namespace WindowsDiskAnalysis {
+
+/// @class EventDeduplicator
+/// @brief Потокобезопасное закрепление записей журналов за одной из копий
+/// @details Образы содержат архивы "Archive-Security-*.evtx", экспортированные
+/// и резервные копии, записи которых пересекаются с рабочим журналом.
+/// Запись определяется номером, временем и источником (компьютер, канал,
+/// провайдер, ID события); источник хранится 64-битной сверткой строк, так
+/// как различных источников в образе единицы. Каждый журнал имеет
+/// постоянный приоритет (ранг), и запись закрепляется за журналом с
+/// наименьшим рангом среди содержащих ее, независимо от порядка завершения
+/// задач. Журнал, учтивший запись до того, как ее заявил журнал с меньшим
+/// рангом, помечается устаревшим и после заявок всех журналов разбирается
+/// повторно с проверкой закрепления (take). Ключи лежат в открытой
+/// адресации без узлов, разбитой на сегменты со своими блокировками,
+/// поэтому память пропорциональна числу различных записей, а задачи разных
+/// журналов редко ждут друг друга. Записи без номера (некоторые
+/// восстановленные) не отбрасываются.
+class EventDeduplicator {
+ public:
+  /// @brief Ключ записи (номер 0 - пустая ячейка)
+  struct Key {
+    uint64_t record_id = 0;  ///< Номер записи
+    uint64_t timestamp = 0;  ///< Время записи (FILETIME)
+    uint64_t source = 0;     ///< Свертка источника и ID события
+
+    bool operator==(const Key&) const = default;
+  };
+
+  /// @brief Конструктор
+  /// @param log_count Количество журналов (ранги 0..log_count-1)
+  explicit EventDeduplicator(size_t log_count);
+
+  /// @brief Возвращает ключ записи
+  /// @param event Событие
+  /// @return Ключ или std::nullopt для записи без номера
+  [[nodiscard]] static std::optional<Key> keyOf(
+      const EventLogAnalysis::EventData& event);
+
+  /// @brief Заявляет запись журнала
+  /// @details Если запись была закреплена за журналом с большим рангом, она
+  /// переходит к заявителю, а прежний журнал помечается устаревшим
+  /// @param key Ключ записи
+  /// @param rank Ранг журнала
+  /// @return true, если запись заявлена впервые или перешла к журналу;
+  /// false для повтора, в том числе внутри того же журнала
+  [[nodiscard]] bool claim(const Key& key, uint32_t rank);
+
+  /// @brief Заявляет записи журнала, результаты которого взяты из
+  /// контрольной точки
+  /// @details Журнал помечается устаревшим, если закрепление его записей
+  /// расходится с сохраненным в точке
+  /// @param owned Записи, учтенные журналом
+  /// @param skipped Записи, пропущенные как закрепленные за другими
+  /// @param rank Ранг журнала
+  void restore(std::span<const Key> owned, std::span<const Key> skipped,
+               uint32_t rank);
+
+  /// @brief Учитывает запись при повторном разборе журнала
+  /// @details Вызывается после завершения заявок всех журналов. Повтор
+  /// записи внутри журнала, как и при заявке, не учитывается
+  /// @param key Ключ записи
+  /// @param rank Ранг журнала
+  /// @return true, если запись закреплена за журналом и встретилась впервые
+  [[nodiscard]] bool take(const Key& key, uint32_t rank);
+
+  /// @brief Проверяет, что результаты журнала нужно получить повторно
+  /// @param rank Ранг журнала
+  [[nodiscard]] bool stale(uint32_t rank) const noexcept {
+    return stale_[rank].load(std::memory_order_relaxed);
+  }
+
+  /// @brief Возвращает количество повторных копий записей
+  [[nodiscard]] uint64_t duplicates() const noexcept {
+    return duplicates_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  /// @brief Ячейка множества
+  struct Slot {
+    Key key;             ///< Ключ записи
+    uint32_t rank = 0;   ///< Ранг журнала, за которым закреплена запись
+    bool taken = false;  ///< Запись учтена при повторном разборе
+  };
+
+  /// @brief Сегмент множества
+  struct Shard {
+    std::mutex mutex;         ///< Защита ячеек
+    std::vector<Slot> slots;  ///< Ячейки (размер - степень двойки)
+    size_t size = 0;          ///< Количество занятых ячеек
+  };
+
+  /// @brief Возвращает хэш ключа
+  [[nodiscard]] static uint64_t hashOf(const Key& key) noexcept;
+
+  /// @brief Возвращает сегмент ключа
+  [[nodiscard]] Shard& shardOf(uint64_t hash) noexcept;
+
+  /// @brief Находит ячейку ключа или пустую ячейку для него
+  [[nodiscard]] static Slot& find(Shard& shard, const Key& key,
+                                  uint64_t hash) noexcept;
+
+  /// @brief Удваивает число ячеек сегмента
+  static void grow(Shard& shard);
+
+  static constexpr size_t kShardBits = 6;  ///< 64 сегмента
+
+  std::unique_ptr<Shard[]> shards_;             ///< Сегменты множества
+  std::unique_ptr<std::atomic<bool>[]> stale_;  ///< Устаревшие журналы
+  std::atomic<uint64_t> duplicates_{0};         ///< Повторные копии
+};
+
+/// @brief Ключи записей журнала, сохраняемые в контрольной точке
+/// @details Позволяют восстановить заявки журнала, результаты которого
+/// взяты из точки без разбора
+struct EventLogRecordKeys {
+  std::vector<EventDeduplicator::Key> owned;    ///< Учтенные записи
+  std::vector<EventDeduplicator::Key> skipped;  ///< Пропущенные повторы
+};
+
+/// @brief Участие журнала в отбрасывании повторов
+struct EventLogDedup {
+  EventDeduplicator* seen = nullptr;  ///< Записи журналов (nullptr - нет)
+  uint32_t rank = 0;                  ///< Ранг журнала
+  bool settled = false;  ///< Заявки завершены, записи учитываются через take
+};
+
+}
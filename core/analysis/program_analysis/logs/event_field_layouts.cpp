@@ -0,0 +1,61 @@
+#include "event_field_layouts.hpp"
+
+#include <algorithm>
+
+using EventLogAnalysis::EventField;
+using EventLogAnalysis::Symbol;
+
+namespace WindowsDiskAnalysis {
+
+EventFieldLayouts::EventFieldLayouts(
+    std::initializer_list<std::initializer_list<std::string_view>> roles) {
+  candidates_.reserve(roles.size());
+  for (const auto& names : roles) {
+    auto& symbols = candidates_.emplace_back();
+    for (const auto name : names) symbols.push_back(Symbol::intern(name));
+  }
+}
+
+std::span<const int32_t> EventFieldLayouts::slotsOf(
+    uint32_t event_id, std::span<const EventField> fields) {
+  for (const auto& layout : layouts_) {
+    if (layout.event_id == event_id && fits(layout, fields)) {
+      return layout.slots;
+    }
+  }
+  layouts_.push_back(resolve(event_id, fields));
+  return layouts_.back().slots;
+}
+
+std::string_view EventFieldLayouts::valueAt(std::span<const EventField> fields,
+                                            int32_t slot) noexcept {
+  return slot == kMissing ? std::string_view{}
+                          : fields[static_cast<size_t>(slot)].value();
+}
+
+bool EventFieldLayouts::fits(const Layout& layout,
+                             std::span<const EventField> fields) noexcept {
+  return std::ranges::equal(layout.fields, fields, {}, {}, &EventField::name);
+}
+
+EventFieldLayouts::Layout EventFieldLayouts::resolve(
+    uint32_t event_id, std::span<const EventField> fields) const {
+  Layout layout;
+  layout.event_id = event_id;
+  layout.fields.reserve(fields.size());
+  for (const auto& field : fields) layout.fields.push_back(field.name);
+  layout.slots.assign(candidates_.size(), kMissing);
+
+  for (size_t role = 0; role < candidates_.size(); ++role) {
+    for (const Symbol name : candidates_[role]) {
+      const auto found = std::ranges::find(fields, name, &EventField::name);
+      if (found != fields.end()) {
+        layout.slots[role] = static_cast<int32_t>(found - fields.begin());
+        break;
+      }
+    }
+  }
+  return layout;
+}
+
+}
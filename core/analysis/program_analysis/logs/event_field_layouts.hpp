@@ -0,0 +1,71 @@
+/// @file event_field_layouts.hpp
+/// @brief Кэш позиций полей событий по раскладкам
+
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "../../../../parsers/event_log/model/event_data.hpp"
+
+namespace WindowsDiskAnalysis {
+
+/// @class EventFieldLayouts
+/// @brief Позиции извлекаемых полей для каждой встреченной раскладки
+/// @details Извлекаемое поле (роль) задается списком имен-кандидатов в
+/// порядке приоритета. Позиции ролей ищутся по именам один раз для каждой
+/// раскладки события - сочетания ID и последовательности имен полей.
+/// Раскладка узнается сравнением номеров интернированных имен (Symbol), а
+/// не строк, поэтому отсутствующее в ней поле (kMissing) не может появиться
+/// у события с той же раскладкой: другая версия шаблона провайдера дает
+/// новую раскладку.
+/// Экземпляр не потокобезопасен: каждая задача разбора создает свой.
+class EventFieldLayouts {
+ public:
+  static constexpr int32_t kMissing = -1;  ///< Поле отсутствует в раскладке
+
+  /// @brief Конструктор
+  /// @param roles Имена-кандидаты для каждой роли
+  EventFieldLayouts(
+      std::initializer_list<std::initializer_list<std::string_view>> roles);
+
+  /// @brief Возвращает позиции ролей для события
+  /// @param event_id ID события
+  /// @param fields Поля события
+  /// @return Позиции по порядку ролей (kMissing - поля нет)
+  [[nodiscard]] std::span<const int32_t> slotsOf(
+      uint32_t event_id, std::span<const EventLogAnalysis::EventField> fields);
+
+  /// @brief Возвращает значение поля по позиции
+  /// @return Значение или пустая строка для kMissing
+  [[nodiscard]] static std::string_view valueAt(
+      std::span<const EventLogAnalysis::EventField> fields,
+      int32_t slot) noexcept;
+
+ private:
+  /// @brief Позиции ролей для одной раскладки
+  struct Layout {
+    uint32_t event_id = 0;                         ///< ID события
+    std::vector<EventLogAnalysis::Symbol> fields;  ///< Имена полей по порядку
+    std::vector<int32_t> slots;                    ///< Позиции ролей
+  };
+
+  /// @brief Проверяет, что имена полей события совпадают с раскладкой
+  [[nodiscard]] static bool fits(
+      const Layout& layout,
+      std::span<const EventLogAnalysis::EventField> fields) noexcept;
+
+  /// @brief Определяет позиции ролей по именам
+  [[nodiscard]] Layout resolve(
+      uint32_t event_id,
+      std::span<const EventLogAnalysis::EventField> fields) const;
+
+  std::vector<std::vector<EventLogAnalysis::Symbol>>
+      candidates_;               ///< Имена-кандидаты по ролям
+  std::vector<Layout> layouts_;  ///< Встреченные раскладки
+};
+
+}
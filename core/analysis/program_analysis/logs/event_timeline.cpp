@@ -0,0 +1,445 @@
+#include "event_timeline.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <system_error>
+#include <tuple>
+
+#include "../../../../parsers/event_log/model/event_data_builder.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+/// @brief Размер буфера чтения файлового прогона при слиянии
+constexpr size_t kReadBufferSize = 64 * 1024;
+
+/// @brief Заголовок записи файлового прогона
+struct RecordHeader {
+  uint64_t timestamp = 0;  ///< Время события (FILETIME)
+  uint32_t source = 0;     ///< Номер журнала
+  uint32_t size = 0;       ///< Размер сериализованного события
+};
+
+/// @brief Дописывает значение в буфер записи
+template <typename T>
+void put(std::string& out, T value) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/// @brief Дописывает строку с длиной в буфер записи
+void putString(std::string& out, std::string_view text) {
+  put(out, static_cast<uint32_t>(text.size()));
+  out += text;
+}
+
+/// @brief Сериализует событие (без времени, оно хранится в заголовке)
+/// @details Непустое description заменяет описание события
+void encodeEvent(const EventLogAnalysis::EventData& event,
+                 std::string_view description, std::string& out) {
+  out.clear();
+  put(out, event.getEventId());
+  put(out, event.getRecordId());
+  put(out, static_cast<int32_t>(event.getLevel()));
+  putString(out, event.getProvider());
+  putString(out, event.getComputer());
+  putString(out, event.getChannel());
+  putString(out, event.getUserSid());
+  const auto fields = event.getData();
+  put(out, static_cast<uint32_t>(fields.size()));
+  for (const auto& field : fields) {
+    putString(out, field.name.view());
+    putString(out, field.value());
+  }
+  putString(out,
+            description.empty() ? event.getDescription() : description);
+  putString(out, event.getXml());
+  const auto binary = event.getBinaryData();
+  putString(out, std::string_view(reinterpret_cast<const char*>(binary.data()),
+                                  binary.size()));
+}
+
+/// @brief Последовательное чтение сериализованного события
+class RecordReader {
+ public:
+  explicit RecordReader(std::string_view bytes) : bytes_(bytes) {}
+
+  template <typename T>
+  T value() {
+    T result;
+    std::memcpy(&result, take(sizeof(T)), sizeof(T));
+    return result;
+  }
+
+  std::string_view string() {
+    const auto size = value<uint32_t>();
+    return {take(size), size};
+  }
+
+ private:
+  const char* take(size_t size) {
+    if (bytes_.size() - pos_ < size) {
+      throw std::runtime_error("Запись прогона хронологии обрезана");
+    }
+    const char* data = bytes_.data() + pos_;
+    pos_ += size;
+    return data;
+  }
+
+  std::string_view bytes_;
+  size_t pos_ = 0;
+};
+
+/// @brief Восстанавливает событие из записи прогона
+EventLogAnalysis::EventData decodeEvent(uint64_t timestamp,
+                                        std::string_view bytes) {
+  RecordReader reader(bytes);
+  EventLogAnalysis::EventDataBuilder builder;
+  builder.setTimestamp(timestamp);
+  builder.setEventId(reader.value<uint32_t>());
+  builder.setRecordId(reader.value<uint64_t>());
+  builder.setLevel(
+      static_cast<EventLogAnalysis::EventLevel>(reader.value<int32_t>()));
+  builder.setProvider(reader.string());
+  builder.setComputer(reader.string());
+  builder.setChannel(reader.string());
+  builder.setUserSid(reader.string());
+  const auto field_count = reader.value<uint32_t>();
+  for (uint32_t i = 0; i < field_count; ++i) {
+    const auto name = reader.string();
+    builder.addData(name, reader.string());
+  }
+  if (const auto description = reader.string(); !description.empty()) {
+    builder.setDescription(description);
+  }
+  if (const auto xml = reader.string(); !xml.empty()) {
+    builder.setXml(xml);
+  }
+  if (const auto binary = reader.string(); !binary.empty()) {
+    builder.setBinaryData(std::span(
+        reinterpret_cast<const uint8_t*>(binary.data()), binary.size()));
+  }
+  return std::move(builder).build();
+}
+
+/// @brief Курсор прогона при слиянии
+class RunCursor {
+ public:
+  /// @param run Прогон
+  /// @param buffer Буфер чтения файла (не используется для прогона в памяти)
+  RunCursor(const WindowsDiskAnalysis::EventRun& run, std::vector<char>& buffer)
+      : run_(run) {
+    if (!run_.path.empty()) {
+      file_.rdbuf()->pubsetbuf(buffer.data(),
+                               static_cast<std::streamsize>(buffer.size()));
+      file_.open(run_.path, std::ios::binary);
+      if (!file_) {
+        throw std::runtime_error("Не удалось открыть прогон хронологии: " +
+                                 run_.path.string());
+      }
+    }
+  }
+
+  /// @brief Переходит к следующей записи
+  /// @return false, если записи закончились
+  bool next() {
+    if (position_ == run_.count) {
+      return false;
+    }
+    if (run_.path.empty()) {
+      const auto& entry = run_.entries[position_];
+      header_ = {entry.timestamp, run_.source, entry.size};
+      record_ = std::string_view(run_.bytes).substr(entry.offset, entry.size);
+    } else {
+      file_.read(reinterpret_cast<char*>(&header_), sizeof(header_));
+      buffer_.resize(header_.size);
+      file_.read(buffer_.data(), header_.size);
+      if (!file_) {
+        throw std::runtime_error("Прогон хронологии обрезан: " +
+                                 run_.path.string());
+      }
+      record_ = buffer_;
+    }
+    ++position_;
+    return true;
+  }
+
+  /// @brief Ключ порядка: время, журнал, номер прогона
+  [[nodiscard]] auto key() const noexcept {
+    return std::tuple(header_.timestamp, header_.source, run_.ordinal);
+  }
+
+  [[nodiscard]] const RecordHeader& header() const noexcept { return header_; }
+  [[nodiscard]] std::string_view record() const noexcept { return record_; }
+
+ private:
+  const WindowsDiskAnalysis::EventRun& run_;
+  std::ifstream file_;
+  uint64_t position_ = 0;
+  RecordHeader header_;
+  std::string buffer_;
+  std::string_view record_;
+};
+
+/// @brief Сливает прогоны через кучу, передавая записи обработчику
+/// @return false, если обработчик прекратил слияние
+template <typename Sink>
+bool mergeRuns(const std::vector<WindowsDiskAnalysis::EventRun>& runs,
+               Sink&& sink) {
+  std::vector<std::vector<char>> buffers;
+  std::vector<std::unique_ptr<RunCursor>> cursors;
+  cursors.reserve(runs.size());
+  for (const auto& run : runs) {
+    auto& buffer = buffers.emplace_back(run.path.empty() ? 0 : kReadBufferSize);
+    cursors.push_back(std::make_unique<RunCursor>(run, buffer));
+  }
+
+  const auto later = [](const RunCursor* a, const RunCursor* b) {
+    return a->key() > b->key();
+  };
+  std::priority_queue<RunCursor*, std::vector<RunCursor*>, decltype(later)>
+      heap(later);
+  for (const auto& cursor : cursors) {
+    if (cursor->next()) heap.push(cursor.get());
+  }
+
+  while (!heap.empty()) {
+    RunCursor* cursor = heap.top();
+    heap.pop();
+    if (!sink(cursor->header(), cursor->record())) {
+      return false;
+    }
+    if (cursor->next()) heap.push(cursor);
+  }
+  return true;
+}
+
+}
+
+namespace WindowsDiskAnalysis {
+
+size_t EventRun::memoryUsage() const noexcept {
+  return bytes.capacity() + entries.capacity() * sizeof(Entry);
+}
+
+EventRunBuilder::EventRunBuilder(EventTimeline& timeline, uint32_t source,
+                                 size_t budget)
+    : timeline_(timeline), budget_(budget) {
+  current_.source = source;
+}
+
+void EventRunBuilder::add(const EventLogAnalysis::EventData& event,
+                          std::string_view description) {
+  encodeEvent(event, description, record_);
+  if (current_.count > 0 &&
+      current_.bytes.size() + record_.size() +
+              (current_.entries.size() + 1) * sizeof(EventRun::Entry) >
+          budget_) {
+    EventRun run = takeRun();
+    timeline_.spill(run);
+    runs_.push_back(std::move(run));
+  }
+
+  current_.entries.push_back({event.getTimestamp(), current_.bytes.size(),
+                              static_cast<uint32_t>(record_.size())});
+  current_.bytes += record_;
+  current_.count++;
+}
+
+void EventRunBuilder::finish() {
+  if (current_.count > 0) {
+    EventRun run = takeRun();
+    run.bytes.shrink_to_fit();
+    run.entries.shrink_to_fit();
+    if (!timeline_.reserve(run.memoryUsage())) {
+      timeline_.spill(run);
+    }
+    runs_.push_back(std::move(run));
+  }
+  timeline_.accept(std::move(runs_));
+  runs_.clear();
+}
+
+EventRun EventRunBuilder::takeRun() {
+  EventRun run;
+  run.source = current_.source;
+  run.ordinal = runs_.size();
+  run.count = current_.count;
+  run.bytes.swap(current_.bytes);
+  run.entries.swap(current_.entries);
+  current_.count = 0;
+
+  const auto by_time = [](const EventRun::Entry& a, const EventRun::Entry& b) {
+    return a.timestamp < b.timestamp;
+  };
+  if (!std::ranges::is_sorted(run.entries, by_time)) {
+    std::ranges::stable_sort(run.entries, by_time);
+  }
+  return run;
+}
+
+EventTimeline::EventTimeline(size_t memory_budget, fs::path temp_dir,
+                             size_t parallel_sources)
+    : memory_budget_(memory_budget),
+      retained_budget_(memory_budget / 2),
+      source_budget_(memory_budget / 2 / std::max<size_t>(parallel_sources, 1)),
+      temp_dir_(std::move(temp_dir)) {
+  if (temp_dir_.empty()) {
+    temp_dir_ = fs::temp_directory_path();
+  }
+}
+
+EventTimeline::~EventTimeline() {
+  if (!spill_dir_.empty()) {
+    std::error_code error;
+    fs::remove_all(spill_dir_, error);
+  }
+}
+
+EventRunBuilder EventTimeline::openSource(uint32_t source) {
+  return EventRunBuilder(*this, source, source_budget_);
+}
+
+fs::path EventTimeline::nextSpillPath() {
+  std::lock_guard lock(mutex_);
+  if (spill_dir_.empty()) {
+    // Собственный каталог со случайным именем: несколько запусков могут
+    // использовать один каталог временных файлов
+    std::random_device random;
+    for (int attempt = 0; attempt < 16 && spill_dir_.empty(); ++attempt) {
+      fs::path candidate =
+          temp_dir_ / ("evtimeline-" + std::to_string(random()));
+      std::error_code error;
+      if (fs::create_directories(candidate, error)) {
+        spill_dir_ = std::move(candidate);
+      }
+    }
+    if (spill_dir_.empty()) {
+      throw std::runtime_error(
+          "Не удалось создать каталог прогонов хронологии в " +
+          temp_dir_.string());
+    }
+  }
+  return spill_dir_ / (std::to_string(next_file_++) + ".run");
+}
+
+void EventTimeline::spill(EventRun& run) {
+  run.path = nextSpillPath();
+  {
+    std::ofstream out(run.path, std::ios::binary | std::ios::trunc);
+    for (const auto& entry : run.entries) {
+      const RecordHeader header{entry.timestamp, run.source, entry.size};
+      out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      out.write(run.bytes.data() + entry.offset, entry.size);
+    }
+    if (!out) {
+      throw std::runtime_error("Не удалось записать прогон хронологии: " +
+                               run.path.string());
+    }
+  }
+  std::string().swap(run.bytes);
+  std::vector<EventRun::Entry>().swap(run.entries);
+}
+
+void EventTimeline::accept(std::vector<EventRun>&& runs) {
+  std::lock_guard lock(mutex_);
+  runs_.insert(runs_.end(), std::make_move_iterator(runs.begin()),
+               std::make_move_iterator(runs.end()));
+}
+
+bool EventTimeline::reserve(size_t size) noexcept {
+  size_t retained = retained_.load();
+  do {
+    if (retained + size > retained_budget_) {
+      return false;
+    }
+  } while (!retained_.compare_exchange_weak(retained, retained + size));
+  return true;
+}
+
+EventRun EventTimeline::mergeGroup(std::vector<EventRun>&& group) {
+  EventRun merged;
+  merged.source = group.front().source;
+  merged.ordinal = group.front().ordinal;
+  merged.path = nextSpillPath();
+
+  std::ofstream out(merged.path, std::ios::binary | std::ios::trunc);
+  mergeRuns(group, [&out, &merged](const RecordHeader& header,
+                                   std::string_view record) {
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(record.data(), static_cast<std::streamsize>(record.size()));
+    merged.count++;
+    return true;
+  });
+  if (!out) {
+    throw std::runtime_error("Не удалось записать прогон хронологии: " +
+                             merged.path.string());
+  }
+
+  for (const auto& run : group) {
+    std::error_code error;
+    fs::remove(run.path, error);
+  }
+  return merged;
+}
+
+bool EventTimeline::merge(
+    const EventLogAnalysis::EventRecordVisitor& consumer) {
+  std::vector<EventRun> runs = std::move(runs_);
+  runs_.clear();
+
+  // Номер прогона становится сквозным рангом, чтобы порядок событий с
+  // равным временем не зависел от группировки при предварительном слиянии
+  std::ranges::sort(runs, [](const EventRun& a, const EventRun& b) {
+    return std::tie(a.source, a.ordinal) < std::tie(b.source, b.ordinal);
+  });
+  for (size_t i = 0; i < runs.size(); ++i) runs[i].ordinal = i;
+
+  // Буферы разбора журналов уже освобождены, поэтому буферы чтения файлов
+  // занимают бюджет за вычетом прогонов в памяти; лишние файлы сливаются
+  // группами соседних рангов
+  const size_t available = memory_budget_ - std::min(retained_.load(),
+                                                     memory_budget_);
+  const size_t fan_in = std::max<size_t>(available / kReadBufferSize, 2);
+  while (std::ranges::count_if(runs, [](const EventRun& run) {
+           return !run.path.empty();
+         }) > static_cast<std::ptrdiff_t>(fan_in)) {
+    std::vector<EventRun> next;
+    std::vector<EventRun> group;
+    for (auto& run : runs) {
+      if (run.path.empty()) {
+        next.push_back(std::move(run));
+        continue;
+      }
+      group.push_back(std::move(run));
+      if (group.size() == fan_in) {
+        next.push_back(mergeGroup(std::move(group)));
+        group.clear();
+      }
+    }
+    for (auto& run : group) next.push_back(std::move(run));
+    runs = std::move(next);
+    std::ranges::sort(runs, {}, &EventRun::ordinal);
+  }
+
+  const bool completed = mergeRuns(
+      runs, [&consumer](const RecordHeader& header, std::string_view record) {
+        return consumer(decodeEvent(header.timestamp, record));
+      });
+
+  for (const auto& run : runs) {
+    if (!run.path.empty()) {
+      std::error_code error;
+      fs::remove(run.path, error);
+    }
+  }
+  retained_ = 0;
+  return completed;
+}
+
+}
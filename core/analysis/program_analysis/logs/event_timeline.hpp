@@ -0,0 +1,153 @@
+/// @file event_timeline.hpp
+/// @brief Хронология событий нескольких журналов с ограничением памяти
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../../../../parsers/event_log/interfaces/irecord_reader.hpp"
+#include "../../../../parsers/event_log/model/event_data.hpp"
+
+namespace WindowsDiskAnalysis {
+
+/// @brief Упорядоченный по времени прогон событий одного журнала
+/// @details Записи прогона хранятся сериализованными: в памяти (последний
+/// прогон журнала, если хватило бюджета) или во временном файле
+struct EventRun {
+  /// @brief Положение записи в памяти прогона
+  struct Entry {
+    uint64_t timestamp = 0;  ///< Время события (FILETIME)
+    size_t offset = 0;       ///< Смещение записи
+    uint32_t size = 0;       ///< Размер записи
+  };
+
+  uint32_t source = 0;         ///< Номер журнала (порядок при равном времени)
+  size_t ordinal = 0;          ///< Номер прогона в журнале
+  std::string bytes;           ///< Записи в памяти
+  std::vector<Entry> entries;  ///< Записи в порядке времени
+  std::filesystem::path path;  ///< Файл прогона (пусто - прогон в памяти)
+  uint64_t count = 0;          ///< Количество записей
+
+  /// @brief Возвращает объем памяти, занятый прогоном
+  [[nodiscard]] size_t memoryUsage() const noexcept;
+};
+
+class EventTimeline;
+
+/// @class EventRunBuilder
+/// @brief Собирает события одного журнала в упорядоченные прогоны
+/// @details События сериализуются в буфер; при превышении бюджета буфер
+/// сортируется по времени и выгружается во временный файл. Журналы обычно
+/// уже почти упорядочены, поэтому сортировка устойчива и пропускается для
+/// упорядоченного буфера. Экземпляр не потокобезопасен: каждая задача
+/// разбора создает свой.
+class EventRunBuilder {
+ public:
+  /// @brief Добавляет событие
+  /// @param event Событие
+  /// @param description Описание, заменяющее описание события (пусто -
+  /// описание события)
+  /// @throws std::runtime_error Если прогон не удалось выгрузить
+  void add(const EventLogAnalysis::EventData& event,
+           std::string_view description = {});
+
+  /// @brief Завершает журнал и передает прогоны хронологии
+  /// @details Последний прогон остается в памяти, если он укладывается в
+  /// общий бюджет удерживаемых прогонов, иначе выгружается
+  void finish();
+
+ private:
+  friend class EventTimeline;
+
+  /// @brief Конструктор (см. EventTimeline::openSource)
+  EventRunBuilder(EventTimeline& timeline, uint32_t source, size_t budget);
+
+  /// @brief Сортирует буфер и забирает его как прогон
+  [[nodiscard]] EventRun takeRun();
+
+  EventTimeline& timeline_;     ///< Хронология-владелец прогонов
+  size_t budget_;               ///< Бюджет буфера в байтах
+  EventRun current_;            ///< Заполняемый прогон
+  std::vector<EventRun> runs_;  ///< Выгруженные прогоны журнала
+  std::string record_;          ///< Буфер сериализации события
+};
+
+/// @class EventTimeline
+/// @brief Хронология событий журналов с k-путевым слиянием
+/// @details Журналы разбираются независимо в упорядоченные по времени
+/// прогоны (EventRunBuilder), после чего прогоны сливаются через кучу и
+/// события передаются обработчику в порядке времени. Половина бюджета
+/// делится между буферами одновременно разбираемых журналов, вторая
+/// половина отводится на удерживаемые в памяти прогоны и на буферы чтения
+/// файлов при слиянии. Если файловых прогонов больше, чем помещается
+/// буферов, они предварительно сливаются группами. Поэтому пиковое
+/// потребление памяти задается бюджетом и не зависит от объема журналов.
+/// Временные файлы удаляются деструктором.
+class EventTimeline {
+ public:
+  /// @brief Конструктор
+  /// @param memory_budget Бюджет памяти в байтах
+  /// @param temp_dir Каталог временных файлов прогонов
+  /// @param parallel_sources Количество одновременно разбираемых журналов
+  EventTimeline(size_t memory_budget, std::filesystem::path temp_dir,
+                size_t parallel_sources);
+
+  /// @brief Деструктор, удаляющий временные файлы
+  ~EventTimeline();
+
+  /// @brief Запрет копирования
+  EventTimeline(const EventTimeline&) = delete;
+
+  /// @brief Запрет присваивания копированием
+  EventTimeline& operator=(const EventTimeline&) = delete;
+
+  /// @brief Создает сборщик прогонов для журнала (потокобезопасно)
+  /// @param source Номер журнала; при равном времени события журнала с
+  /// меньшим номером идут первыми
+  [[nodiscard]] EventRunBuilder openSource(uint32_t source);
+
+  /// @brief Передает события всех журналов обработчику в порядке времени
+  /// @details Вызывается после завершения всех сборщиков; прогоны
+  /// расходуются слиянием
+  /// @param consumer Обработчик событий (false прекращает слияние)
+  /// @return true если переданы все события
+  /// @throws std::runtime_error Если файл прогона не удалось прочитать
+  bool merge(const EventLogAnalysis::EventRecordVisitor& consumer);
+
+ private:
+  friend class EventRunBuilder;
+
+  /// @brief Записывает прогон во временный файл и освобождает его память
+  /// @throws std::runtime_error Если файл не удалось записать
+  void spill(EventRun& run);
+
+  /// @brief Возвращает путь к новому временному файлу (потокобезопасно)
+  [[nodiscard]] std::filesystem::path nextSpillPath();
+
+  /// @brief Принимает прогоны завершенного журнала (потокобезопасно)
+  void accept(std::vector<EventRun>&& runs);
+
+  /// @brief Пытается зарезервировать память под удерживаемый прогон
+  [[nodiscard]] bool reserve(size_t size) noexcept;
+
+  /// @brief Сливает группу прогонов в один файловый прогон
+  [[nodiscard]] EventRun mergeGroup(std::vector<EventRun>&& group);
+
+  size_t memory_budget_;              ///< Общий бюджет памяти
+  size_t retained_budget_;            ///< Бюджет прогонов в памяти
+  size_t source_budget_;              ///< Бюджет буфера одного журнала
+  std::filesystem::path temp_dir_;    ///< Каталог временных файлов
+  std::atomic<size_t> retained_{0};   ///< Память удерживаемых прогонов
+  std::filesystem::path spill_dir_;   ///< Собственный каталог файлов
+  uint64_t next_file_ = 0;            ///< Счетчик имен временных файлов
+  std::mutex mutex_;                  ///< Защита прогонов и каталога
+  std::vector<EventRun> runs_;        ///< Прогоны всех журналов
+};
+
+}
@@ -2,22 +2,71 @@
 
 #include <algorithm>
 #include <filesystem>
+#include <fstream>
+#include <future>
+#include <optional>
+#include <span>
+#include <system_error>
 #include <utility>
 
+#include "../../../../parsers/event_log/formats/common/crc32.hpp"
+#include "../../../../utils/concurrency/thread_pool.hpp"
 #include "../../../../utils/config/config.hpp"
 #include "../../../../utils/logging/logger.hpp"
+#include "../../../../utils/time/filetime_formatter.hpp"
 #include "../../../../utils/utils.hpp"
 
 namespace fs = std::filesystem;
 
+namespace {
+
+/// @brief Читает список ID событий из раздела конфигурации
+/// @param config Конфигурация
+/// @param section Раздел
+/// @param key Ключ со списком ID через запятую
+/// @param ids Список ID (пополняется)
+void loadEventIds(const Config& config, const std::string& section,
+                  const std::string& key, std::vector<uint32_t>& ids) {
+  for (auto& id_str : split(config.getString(section, key, ""), ',')) {
+    trim(id_str);
+    if (!id_str.empty()) {
+      try {
+        ids.push_back(static_cast<uint32_t>(std::stoul(id_str)));
+      } catch (...) {
+        GlobalLogger::get()->debug("Некорректный ID события в {}: \"{}\"",
+                                   key, id_str);
+      }
+    }
+  }
+}
+
+/// @brief Размер блока записи хронологии в файл
+constexpr size_t kTimelineBlockSize = 1 << 20;
+
+/// @brief Дописывает поле CSV, заключая его в кавычки при необходимости
+void appendCsvField(std::string& out, std::string_view text) {
+  if (text.find_first_of(",\"\r\n") == std::string_view::npos) {
+    out += text;
+    return;
+  }
+  out += '"';
+  for (const char c : text) {
+    if (c == '"') out += '"';
+    out += c;
+  }
+  out += '"';
+}
+
+}
+
 namespace WindowsDiskAnalysis {
 
-EventLogAnalyzer::EventLogAnalyzer(
-    std::unique_ptr<EventLogAnalysis::IEventLogParser> evt_parser,
-    std::unique_ptr<EventLogAnalysis::IEventLogParser> evtx_parser,
-    std::string os_version, const std::string& ini_path)
-    : evt_parser_(std::move(evt_parser)),
-      evtx_parser_(std::move(evtx_parser)),
+EventLogAnalyzer::EventLogAnalyzer(EventLogParserFactory evt_factory,
+                                   EventLogParserFactory evtx_factory,
+                                   std::string os_version,
+                                   const std::string& ini_path)
+    : evt_factory_(std::move(evt_factory)),
+      evtx_factory_(std::move(evtx_factory)),
       os_version_(std::move(os_version)) {
   trim(os_version_);
   loadConfigurations(ini_path);
@@ -37,61 +86,104 @@ void EventLogAnalyzer::loadConfigurations(const std::string& ini_path) {
     }
   }
 
-  // Загрузка ID событий о процессах
-  std::string process_ids = config.getString(os_version_, "ProcessEventIDs", "");
-  auto process_id_list = split(process_ids, ',');
-  for (auto& id_str : process_id_list) {
-    trim(id_str);
-    if (!id_str.empty()) {
-      try {
-        config_.process_event_ids.push_back(static_cast<uint32_t>(std::stoul(id_str)));
-      } catch (...) {
-        logger->debug("Некорректный ID процесса: \"{}\"", id_str);
-      }
-    }
-  }
+  // Загрузка ID событий: процессы, сеть, входы и выходы (сеансы запуска
+  // процессов), события Sysmon и сохраняемые целиком события Sysmon
+  loadEventIds(config, os_version_, "ProcessEventIDs",
+               config_.process_event_ids);
+  loadEventIds(config, os_version_, "NetworkEventIDs",
+               config_.network_event_ids);
+  loadEventIds(config, os_version_, "LogonEventIDs", config_.logon_event_ids);
+  loadEventIds(config, os_version_, "SysmonEventIDs",
+               config_.sysmon_event_ids);
+  loadEventIds(config, os_version_, "SysmonRetainIDs",
+               config_.sysmon_retain_ids);
 
-  // Загрузка ID событий о сети
-  std::string network_ids = config.getString(os_version_, "NetworkEventIDs", "");
-  auto network_id_list = split(network_ids, ',');
-  for (auto& id_str : network_id_list) {
-    trim(id_str);
-    if (!id_str.empty()) {
-      try {
-        config_.network_event_ids.push_back(static_cast<uint32_t>(std::stoul(id_str)));
-      } catch (...) {
-        logger->debug("Некорректный ID сети: \"{}\"", id_str);
-      }
-    }
-  }
+  // Количество рабочих потоков для разбора журналов
+  const int threads = config.getInt("General", "EventLogThreads", 0);
+  config_.worker_threads = threads > 0 ? static_cast<size_t>(threads) : 0;
 
-  logger->debug("Загружена конфигурация журналов для \"{}\"", os_version_);
-}
+  process_ids_ = EventLogAnalysis::EventIdFilter(config_.process_event_ids);
+  network_ids_ = EventLogAnalysis::EventIdFilter(config_.network_event_ids);
+  logon_ids_ = EventLogAnalysis::EventIdFilter(config_.logon_event_ids);
+  sysmon_ids_ = EventLogAnalysis::EventIdFilter(config_.sysmon_event_ids);
+  sysmon_retain_ids_ =
+      EventLogAnalysis::EventIdFilter(config_.sysmon_retain_ids);
+  sysmon_ids_.merge(sysmon_retain_ids_);
+  event_ids_ = process_ids_;
+  event_ids_.merge(network_ids_);
+  event_ids_.merge(logon_ids_);
+  event_ids_.merge(sysmon_ids_);
 
-EventLogAnalysis::IEventLogParser* EventLogAnalyzer::getParserForFile(
-    const std::string& file_path) const {
-  const fs::path path = file_path;
-  std::string ext = path.extension().string();
+  // Обработчики без настроенных ID не учитываются при отборе журналов
+  const std::pair<const EventLogAnalysis::EventIdFilter*, EventLogRoute>
+      route_ids[] = {{&process_ids_, kRouteProcess},
+                     {&network_ids_, kRouteNetwork},
+                     {&logon_ids_, kRouteLogon},
+                     {&sysmon_ids_, kRouteSysmon}};
+  for (const auto& [ids, route] : route_ids) {
+    if (!ids->empty()) configured_routes_ |= route;
+  }
+  routing_ = EventLogRouting::load(config, "EventLogChannels");
+  config_.recover = config.getBool("General", "EventLogRecovery", false);
+  config_.deduplicate =
+      config.getBool("General", "EventLogDeduplication", true);
 
-  // Преобразование расширения к нижнему регистру
-  std::transform(ext.begin(), ext.end(), ext.begin(),
-                 [](unsigned char c) { return std::tolower(c); });
+  // Выражение фильтра компилируется один раз и передается парсерам
+  config_.filter = config.getString(os_version_, "EventLogFilter", "");
+  trim(config_.filter);
+  if (!config_.filter.empty()) {
+    try {
+      filter_ = std::make_shared<const EventLogAnalysis::EventFilter>(
+          EventLogAnalysis::EventFilter::compile(config_.filter));
+    } catch (const std::exception& e) {
+      logger->warn("Фильтр событий для \"{}\" не применен: \"{}\"",
+                   os_version_, e.what());
+    }
+  }
 
-  if (ext == ".evt") {
-    return evt_parser_.get();
+  // Каталог контрольных точек; точки, сохраненные при других ID событий
+  // или другом фильтре, не используются
+  config_.checkpoint_dir =
+      config.getString("General", "EventLogCheckpointDir", "");
+  trim(config_.checkpoint_dir);
+  for (const auto* filter : {&process_ids_, &network_ids_, &logon_ids_,
+                             &sysmon_ids_, &sysmon_retain_ids_}) {
+    const auto ids = filter->values();
+    settings_hash_ = EventLogAnalysis::Crc32::compute(
+        std::span(reinterpret_cast<const uint8_t*>(ids.data()),
+                  ids.size() * sizeof(uint32_t)),
+        settings_hash_);
+    const uint8_t separator = 0;
+    settings_hash_ = EventLogAnalysis::Crc32::compute(std::span(&separator, 1),
+                                                      settings_hash_);
   }
-  if (ext == ".evtx") {
-    return evtx_parser_.get();
+  if (filter_) {
+    settings_hash_ = EventLogAnalysis::Crc32::compute(
+        std::span(reinterpret_cast<const uint8_t*>(config_.filter.data()),
+                  config_.filter.size()),
+        settings_hash_);
   }
 
-  return nullptr;
+  // Бюджет памяти и каталог прогонов хронологии
+  const int timeline_mb =
+      config.getInt("General", "EventLogTimelineMemoryMb", 256);
+  config_.timeline_memory =
+      static_cast<size_t>(std::max(timeline_mb, 16)) * 1024 * 1024;
+  config_.timeline_dir =
+      config.getString("General", "EventLogTimelineTempDir", "");
+  trim(config_.timeline_dir);
+
+  config_.summary_top = static_cast<size_t>(
+      std::max(config.getInt("General", "EventLogSummaryTopN", 20), 1));
+
+  logger->debug("Загружена конфигурация журналов для \"{}\"", os_version_);
 }
 
-void EventLogAnalyzer::collect(
-    const std::string& disk_root,
-    std::map<std::string, ProcessInfo>& /*process_data*/,
-    std::vector<NetworkConnection>& /*network_connections*/) {
+
+std::vector<std::string> EventLogAnalyzer::collectLogFiles(
+    const std::string& disk_root) const {
   const auto logger = GlobalLogger::get();
+  std::vector<std::pair<uintmax_t, std::string>> files;
 
   for (const auto& log_path : config_.log_paths) {
     std::string full_path = disk_root + log_path;
@@ -102,40 +194,610 @@ void EventLogAnalyzer::collect(
       continue;
     }
 
-    std::vector<std::string> files_to_parse;
-
     // Собираем файлы для обработки
     if (fs::is_directory(full_path)) {
       for (const auto& entry : fs::directory_iterator(full_path)) {
         if (entry.is_regular_file()) {
-          files_to_parse.push_back(entry.path().string());
+          std::error_code ec;
+          const uintmax_t size = entry.file_size(ec);
+          files.emplace_back(ec ? 0 : size, entry.path().string());
         }
       }
     } else if (fs::is_regular_file(full_path)) {
-      files_to_parse.push_back(full_path);
+      std::error_code ec;
+      const uintmax_t size = fs::file_size(full_path, ec);
+      files.emplace_back(ec ? 0 : size, full_path);
     } else {
       logger->debug("Путь не является ни файлом, ни директорией: \"{}\"",
                     full_path);
+    }
+  }
+
+  // Крупные журналы ставятся в очередь первыми, чтобы время этапа
+  // определялось самым большим файлом, а не хвостом очереди. Журналы
+  // одного размера упорядочены по пути: порядок задает ранги журналов при
+  // отбрасывании повторов и не зависит от порядка обхода каталога
+  std::ranges::sort(files, [](const auto& a, const auto& b) {
+    return a.first != b.first ? a.first > b.first : a.second < b.second;
+  });
+
+  std::vector<std::string> result;
+  result.reserve(files.size());
+  for (auto& [size, path] : files) {
+    result.push_back(std::move(path));
+  }
+  return result;
+}
+
+std::unique_ptr<EventLogAnalysis::IEventLogParser>
+EventLogAnalyzer::createParserForFile(const std::string& file_path) const {
+  const fs::path path = file_path;
+  const std::string ext = to_lower(path.extension().string());
+
+  if (ext == ".evt" && evt_factory_) {
+    return evt_factory_();
+  }
+  if (ext == ".evtx" && evtx_factory_) {
+    return evtx_factory_();
+  }
+
+  return nullptr;
+}
+
+bool EventLogAnalyzer::isEmptyLog(EventLogAnalysis::IEventLogParser& parser,
+                                  const std::string& file_path) const {
+  if (config_.recover) {
+    return false;
+  }
+  const auto summary = parser.readSummary(file_path);
+  return summary && summary->empty();
+}
+
+EventLogAnalysis::EventIdFilter EventLogAnalyzer::eventIdsFor(
+    uint8_t routes) const {
+  if ((routes & kRouteAll) == kRouteAll) {
+    return event_ids_;
+  }
+  EventLogAnalysis::EventIdFilter ids;
+  if (routes & kRouteProcess) ids.merge(process_ids_);
+  if (routes & kRouteNetwork) ids.merge(network_ids_);
+  if (routes & kRouteLogon) ids.merge(logon_ids_);
+  if (routes & kRouteSysmon) ids.merge(sysmon_ids_);
+  return ids;
+}
+
+EventLogBuffer EventLogAnalyzer::processLogFile(
+    const std::string& disk_root, const std::string& file_path, uint8_t routes,
+    const EventLogDedup& dedup) const {
+  const auto logger = GlobalLogger::get();
+
+  auto parser = createParserForFile(file_path);
+  if (!parser) {
+    logger->debug("Неизвестный формат журнала: \"{}\"", file_path);
+    return {};
+  }
+
+  logger->debug("Разбор журнала событий: \"{}\"", file_path);
+
+  if (!config_.checkpoint_dir.empty()) {
+    const std::string log_key = file_path.starts_with(disk_root)
+                                    ? file_path.substr(disk_root.size())
+                                    : file_path;
+    const fs::path checkpoint_path = EventLogCheckpoint::pathFor(
+        config_.checkpoint_dir, host_.empty() ? disk_root : host_, log_key);
+    return processWithCheckpoint(*parser, checkpoint_path, file_path, routes,
+                                 dedup);
+  }
+
+  EventLogBuffer buffer;
+  extractRecords(*parser, file_path, {}, routes, dedup, buffer);
+  return buffer;
+}
+
+EventLogBuffer EventLogAnalyzer::processWithCheckpoint(
+    EventLogAnalysis::IEventLogParser& parser,
+    const fs::path& checkpoint_path, const std::string& file_path,
+    uint8_t routes, const EventLogDedup& dedup) const {
+  const auto logger = GlobalLogger::get();
+  const auto identity = EventLogFileIdentity::of(file_path);
+
+  // Набор ID журнала зависит от его обработчиков; ключи записей хранятся
+  // только в точках с отбрасыванием повторов
+  const uint8_t settings[] = {routes, dedup.seen ? uint8_t{1} : uint8_t{0}};
+  const uint32_t settings_hash =
+      EventLogAnalysis::Crc32::compute(settings, settings_hash_);
+  auto stored = EventLogCheckpoint::load(checkpoint_path);
+  if (stored && stored->settings_hash != settings_hash) {
+    stored.reset();
+  }
+
+  // При повторном разборе закрепление записей окончательно: сохраненные
+  // результаты расходятся с ним, поэтому журнал разбирается полностью
+  if (dedup.settled) {
+    stored.reset();
+  }
+  const auto restore = [&dedup](const EventLogBuffer& buffer) {
+    if (dedup.seen) {
+      dedup.seen->restore(buffer.records.owned, buffer.records.skipped,
+                          dedup.rank);
+    }
+  };
+
+  // Последняя запись определяется до разбора: точка сохраняется только для
+  // записей, вошедших в выборку
+  const auto last = parser.locateRecord(
+      file_path, EventLogAnalysis::EventLogTail::kLastRecord);
+
+  // Размер и время изменения сохраняются при копировании журнала другого
+  // снимка, поэтому неизменность подтверждается и последней записью
+  if (stored && stored->identity == identity && last &&
+      *last == stored->tail) {
+    logger->debug("Журнал не изменился с прошлого запуска: \"{}\"",
+                  file_path);
+    restore(stored->buffer);
+    return std::move(stored->buffer);
+  }
+
+  EventLogCheckpoint checkpoint;
+  EventLogAnalysis::EventLogQuery query;
+  if (last) {
+    query.record_to = last->record_id;
+  }
+  if (stored && last) {
+    // Журнал продолжен, только если запись точки лежит по прежнему смещению
+    // с прежним содержимым. Вытесненная из кольца запись не отличается от
+    // журнала другого узла или перезаписанного журнала, поэтому такой
+    // журнал разбирается полностью
+    const auto current = parser.locateRecord(file_path, stored->tail.record_id);
+    if (current && *current == stored->tail) {
+      logger->debug("Разбор журнала \"{}\" продолжен с записи {}", file_path,
+                    stored->tail.record_id + 1);
+      query.record_from = stored->tail.record_id + 1;
+      restore(stored->buffer);
+      checkpoint = std::move(*stored);
+    } else {
+      logger->info("Последняя обработанная запись журнала \"{}\" не найдена, "
+                   "выполняется полный разбор",
+                   file_path);
+    }
+  }
+
+  extractRecords(parser, file_path, query, routes, dedup, checkpoint.buffer);
+  if (!last) {
+    // Пустой журнал или парсер без доступа к записям: точка не сохраняется
+    return std::move(checkpoint.buffer);
+  }
+
+  checkpoint.identity = identity;
+  checkpoint.settings_hash = settings_hash;
+  checkpoint.tail = *last;
+  try {
+    checkpoint.save(checkpoint_path);
+  } catch (const std::exception& e) {
+    logger->warn("Контрольная точка журнала \"{}\" не сохранена: \"{}\"",
+                 file_path, e.what());
+  }
+  return std::move(checkpoint.buffer);
+}
+
+void EventLogAnalyzer::extractRecords(
+    EventLogAnalysis::IEventLogParser& parser, const std::string& file_path,
+    EventLogAnalysis::EventLogQuery query, uint8_t routes,
+    const EventLogDedup& dedup, EventLogBuffer& buffer) const {
+  query.event_ids = eventIdsFor(routes);
+  query.setFilter(filter_);
+
+  // Один проход по файлу для всех настроенных ID; записи обрабатываются по
+  // одной и не накапливаются в памяти
+  ProcessEventExtractor processes;
+  NetworkEventDecoder connections;
+  LogonEventExtractor logons;
+  SysmonEventExtractor sysmon;
+  const bool keep_keys = dedup.seen && !config_.checkpoint_dir.empty();
+  parser.queryRecords(
+      file_path, query,
+      [this, routes, &dedup, keep_keys, &buffer, &processes, &connections,
+       &logons, &sysmon](EventLogAnalysis::EventData&& event) {
+        // Запись, закрепленная за другой копией журнала, пропускается
+        if (dedup.seen) {
+          if (const auto key = EventDeduplicator::keyOf(event)) {
+            const bool owned = dedup.settled
+                                   ? dedup.seen->take(*key, dedup.rank)
+                                   : dedup.seen->claim(*key, dedup.rank);
+            if (keep_keys) {
+              (owned ? buffer.records.owned : buffer.records.skipped)
+                  .push_back(*key);
+            }
+            if (!owned) {
+              return true;
+            }
+          }
+        }
+        const uint32_t event_id = event.getEventId();
+
+        // События Sysmon агрегируются и не сопоставляются со списками ID
+        // других провайдеров; создание процесса и подключение разбираются
+        // также общими извлекателями
+        if ((routes & kRouteSysmon) && sysmon_ids_.contains(event_id) &&
+            SysmonEventExtractor::matches(event)) {
+          if (event_id == 1) {
+            processes.extract(event, buffer);
+          } else if (event_id == 3) {
+            connections.decode(event, buffer.connections);
+          }
+          sysmon.extract(event, buffer.sysmon,
+                         sysmon_retain_ids_.contains(event_id));
+          buffer.matched_events++;
+          return true;
+        }
+
+        if ((routes & kRouteProcess) && process_ids_.contains(event_id)) {
+          processes.extract(event, buffer);
+          buffer.matched_events++;
+        }
+        if ((routes & kRouteNetwork) && network_ids_.contains(event_id)) {
+          connections.decode(event, buffer.connections);
+          buffer.matched_events++;
+        }
+        if ((routes & kRouteLogon) && logon_ids_.contains(event_id)) {
+          logons.extract(event, buffer.logons);
+          buffer.matched_events++;
+        }
+        return true;
+      });
+}
+
+void EventLogAnalyzer::mergeBuffer(EventLogBuffer& buffer,
+                                   NetworkFlowTable& flows,
+                                   std::vector<LogonEvent>& logons,
+                                   SysmonActivityTable& sysmon) {
+  flows.merge(buffer.connections);
+  buffer.connections = {};
+  logons.insert(logons.end(), std::make_move_iterator(buffer.logons.begin()),
+                std::make_move_iterator(buffer.logons.end()));
+  buffer.logons = {};
+  sysmon.merge(buffer.sysmon);
+  buffer.sysmon = {};
+}
+
+void EventLogAnalyzer::collect(
+    const std::string& disk_root,
+    std::map<std::string, ProcessInfo>& process_data,
+    std::vector<NetworkConnection>& network_connections) {
+  const auto logger = GlobalLogger::get();
+
+  if (event_ids_.empty()) {
+    logger->warn("Анализ журналов событий пропущен: не настроены ID событий");
+    return;
+  }
+
+  const auto candidates = collectLogFiles(disk_root);
+  if (candidates.empty()) {
+    logger->warn("Журналы событий не найдены");
+    return;
+  }
+
+  // Журналы отбираются до постановки в очередь: сначала по имени канала
+  // без открытия файла, затем по заголовку файла
+  std::vector<std::string> files;
+  std::vector<uint8_t> file_routes;
+  size_t unrouted = 0;
+  size_t empty = 0;
+  for (const auto& file_path : candidates) {
+    const uint8_t routes = routing_.routesOf(file_path) & configured_routes_;
+    if (routes == kRouteNone) {
+      unrouted++;
+      continue;
+    }
+    if (const auto parser = createParserForFile(file_path);
+        parser && isEmptyLog(*parser, file_path)) {
+      empty++;
       continue;
     }
+    files.push_back(file_path);
+    file_routes.push_back(routes);
+  }
+  logger->debug("Найдено {} журналов событий: {} без обработчиков, {} "
+                "пустых",
+                candidates.size(), unrouted, empty);
+  if (files.empty()) {
+    logger->info("Журналы событий с подходящими каналами не найдены");
+    return;
+  }
+
+  // Ранг журнала - его место в очереди: крупные журналы заявляют записи
+  // первыми, поэтому записи архивов и копий, как правило, уже закреплены за
+  // рабочим журналом, и повторный разбор требуется редко
+  std::unique_ptr<EventDeduplicator> seen;
+  if (config_.deduplicate) {
+    seen = std::make_unique<EventDeduplicator>(files.size());
+  }
+
+  ThreadPool pool(
+      ThreadPool::resolveThreadCount(config_.worker_threads, files.size()));
+  logger->debug("Разбор {} журналов событий в {} потоках", files.size(),
+                pool.size());
+
+  const auto submit = [&](size_t i, bool settled) {
+    const EventLogDedup dedup{seen.get(), static_cast<uint32_t>(i), settled};
+    return pool.submit([this, &disk_root, &file_path = files[i],
+                        routes = file_routes[i], dedup]() {
+      return processLogFile(disk_root, file_path, routes, dedup);
+    });
+  };
+  std::vector<std::future<EventLogBuffer>> tasks;
+  tasks.reserve(files.size());
+  for (size_t i = 0; i < files.size(); ++i) {
+    tasks.push_back(submit(i, false));
+  }
+
+  // Ключи записей нужны только для сохранения контрольной точки в задаче
+  std::vector<EventLogBuffer> buffers(files.size());
+  const auto receive = [&](size_t i) {
+    try {
+      buffers[i] = tasks[i].get();
+      buffers[i].records = {};
+    } catch (const std::exception& e) {
+      buffers[i] = {};
+      logger->warn("Ошибка анализа журнала \"{}\": \"{}\"", files[i],
+                   e.what());
+    }
+  };
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    receive(i);
+  }
 
-    // Обрабатываем собранные файлы
-    for (const auto& file_path : files_to_parse) {
-      auto* parser = getParserForFile(file_path);
-      if (!parser) {
-        logger->debug("Неизвестный формат журнала: \"{}\"", file_path);
-        continue;
+  // Журналы, у которых запись перешла к журналу с меньшим рангом, учли ее
+  // напрасно: после заявок всех журналов они разбираются повторно. Буферы
+  // хранят агрегаты (потоки, счетчики Sysmon), из которых отдельную запись
+  // не вычесть, поэтому в худшем случае повторно разбираются все журналы,
+  // кроме первого, и время разбора удваивается
+  if (seen) {
+    std::vector<size_t> stale;
+    for (size_t i = 0; i < files.size(); ++i) {
+      if (seen->stale(static_cast<uint32_t>(i))) {
+        logger->debug("Журнал \"{}\" разбирается повторно: его записи "
+                      "закреплены за журналом с меньшим рангом",
+                      files[i]);
+        stale.push_back(i);
+        tasks[i] = submit(i, true);
       }
+    }
+    for (const size_t i : stale) {
+      receive(i);
+    }
+    logger->debug("Пропущено {} повторных записей архивов и копий журналов",
+                  seen->duplicates());
+    if (!stale.empty()) {
+      logger->info("Повторно разобрано {} из {} журналов событий из-за "
+                   "повторов записей в архивах и копиях",
+                   stale.size(), files.size());
+    }
+  }
+
+  // Буферы объединяются в порядке рангов, что делает результат
+  // независимым от порядка завершения потоков. Сеанс запуска процесса
+  // может быть описан в другом журнале (Security и его архивы), поэтому
+  // события о процессах соединяются после сбора входов из всех журналов
+  NetworkFlowTable flows;
+  std::vector<LogonEvent> logons;
+  SysmonActivityTable sysmon;
+  size_t matched_events = 0;
+  for (auto& buffer : buffers) {
+    matched_events += buffer.matched_events;
+    mergeBuffer(buffer, flows, logons, sysmon);
+  }
+
+  const LogonSessionIndex sessions(std::move(logons));
+  logger->debug("Восстановлено {} сеансов входа", sessions.size());
+  ProcessDataIndex process_index(process_data);
+  for (auto& buffer : buffers) {
+    process_index.join(std::move(buffer.processes), sessions);
+  }
+  process_index.join(sysmon);
 
-      // TODO: Implement event parsing logic using the parser interface
-      // Currently the parser interface methods used in the original code (getEventsByType)
-      // might not be available or might have different signatures.
-      // Assuming we need to iterate over events and filter by ID.
+  // Потоки одного процесса и адресов из разных журналов объединяются
+  auto connections = flows.connections();
+  network_connections.insert(network_connections.end(),
+                             std::make_move_iterator(connections.begin()),
+                             std::make_move_iterator(connections.end()));
 
-      // Placeholder for actual parsing logic
-      logger->debug("Parsing event log: {}", file_path);
+  logger->info("Проанализировано \"{}\" журналов событий, найдено \"{}\" "
+               "подходящих событий",
+               files.size(), matched_events);
+}
+
+void EventLogAnalyzer::setHostIdentity(std::string host) {
+  host_ = std::move(host);
+}
+
+void EventLogAnalyzer::setMessageResolver(
+    std::shared_ptr<ProviderMessageResolver> messages) {
+  messages_ = std::move(messages);
+}
+
+bool EventLogAnalyzer::buildTimeline(
+    const std::string& disk_root,
+    const EventLogAnalysis::EventRecordVisitor& consumer) const {
+  const auto logger = GlobalLogger::get();
+
+  const auto files = collectLogFiles(disk_root);
+  if (files.empty()) {
+    logger->warn("Журналы событий не найдены");
+    return true;
+  }
+
+  ThreadPool pool(
+      ThreadPool::resolveThreadCount(config_.worker_threads, files.size()));
+  EventTimeline timeline(config_.timeline_memory, config_.timeline_dir,
+                         pool.size());
+  logger->debug("Построение хронологии {} журналов в {} потоках, бюджет {} "
+                "МБ",
+                files.size(), pool.size(),
+                config_.timeline_memory / (1024 * 1024));
+
+  std::vector<std::future<void>> tasks;
+  tasks.reserve(files.size());
+  for (size_t i = 0; i < files.size(); ++i) {
+    tasks.push_back(pool.submit([this, &timeline, &file_path = files[i], i]() {
+      auto parser = createParserForFile(file_path);
+      if (!parser || isEmptyLog(*parser, file_path)) {
+        return;
+      }
+      EventLogAnalysis::EventLogQuery query;
+      query.setFilter(filter_);
+      auto runs = timeline.openSource(static_cast<uint32_t>(i));
+      std::string description;
+      parser->queryRecords(
+          file_path, query,
+          [this, &runs, &description](EventLogAnalysis::EventData&& event) {
+            if (messages_ && messages_->describe(event, description)) {
+              runs.add(event, description);
+            } else {
+              runs.add(event);
+            }
+            return true;
+          });
+      runs.finish();
+    }));
+  }
+
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    try {
+      tasks[i].get();
+    } catch (const std::exception& e) {
+      logger->warn("Ошибка разбора журнала \"{}\" для хронологии: \"{}\"",
+                   files[i], e.what());
+    }
+  }
+
+  if (messages_) {
+    try {
+      messages_->save();
+    } catch (const std::exception& e) {
+      logger->warn("Кэш сообщений провайдеров не сохранен: \"{}\"", e.what());
+    }
+  }
+
+  return timeline.merge(consumer);
+}
+
+void EventLogAnalyzer::summarize(const std::string& disk_root,
+                                 const std::string& report_path) const {
+  const auto logger = GlobalLogger::get();
+
+  const auto files = collectLogFiles(disk_root);
+  if (files.empty()) {
+    logger->warn("Журналы событий не найдены");
+    return;
+  }
+
+  // Набор кандидатов больше выводимого списка: ключи у его нижней границы
+  // вытесняют друг друга, а оценки верхней части списка устойчивы
+  const size_t top_capacity = config_.summary_top * 4;
+  ThreadPool pool(
+      ThreadPool::resolveThreadCount(config_.worker_threads, files.size()));
+  logger->debug("Сводка {} журналов событий в {} потоках", files.size(),
+                pool.size());
+
+  std::vector<std::future<EventLogStatistics>> tasks;
+  tasks.reserve(files.size());
+  for (const auto& file_path : files) {
+    tasks.push_back(pool.submit([this, &file_path, top_capacity]() {
+      EventLogStatistics statistics(top_capacity);
+      auto parser = createParserForFile(file_path);
+      if (!parser || isEmptyLog(*parser, file_path)) {
+        return statistics;
+      }
+      // Записи EVT не содержат канала: он определяется по имени файла
+      const std::string fallback_channel =
+          fs::path(file_path).stem().string();
+      EventLogAnalysis::EventLogQuery query;
+      query.setFilter(filter_);
+      parser->queryRecords(
+          file_path, query,
+          [&statistics, &fallback_channel](
+              EventLogAnalysis::EventData&& event) {
+            statistics.add(event, fallback_channel);
+            return true;
+          });
+      return statistics;
+    }));
+  }
+
+  EventLogStatistics summary(top_capacity);
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    try {
+      summary.merge(tasks[i].get());
+    } catch (const std::exception& e) {
+      logger->warn("Ошибка разбора журнала \"{}\" для сводки: \"{}\"",
+                   files[i], e.what());
     }
   }
+
+  summary.writeReport(report_path, config_.summary_top);
+  logger->info("Сводка {} журналов событий ({} каналов) записана в \"{}\"",
+               files.size(), summary.channels().size(), report_path);
+}
+
+void EventLogAnalyzer::exportTimeline(const std::string& disk_root,
+                                      const std::string& report_path) const {
+  const auto logger = GlobalLogger::get();
+
+  std::ofstream out(report_path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    throw std::runtime_error("Не удалось открыть файл хронологии: " +
+                             report_path);
+  }
+
+  // Строки собираются в блок и записываются в файл крупными порциями
+  std::string block = "Время,Канал,Провайдер,ID,Уровень,Компьютер,Номер,"
+                      "Описание\n";
+  block.reserve(kTimelineBlockSize * 2);
+  FiletimeFormatter formatter;
+  char time[FiletimeFormatter::kLength];
+  uint64_t events = 0;
+  const bool complete = buildTimeline(
+      disk_root, [&](EventLogAnalysis::EventData&& event) {
+        if (event.getTimestamp() != 0) {
+          formatter.format(event.getTimestamp(), time);
+          block.append(time, FiletimeFormatter::kLength);
+        }
+        block += ',';
+        appendCsvField(block, event.getChannel());
+        block += ',';
+        appendCsvField(block, event.getProvider());
+        block += ',';
+        block += std::to_string(event.getEventId());
+        block += ',';
+        block += EventLogAnalysis::to_string(event.getLevel());
+        block += ',';
+        appendCsvField(block, event.getComputer());
+        block += ',';
+        block += std::to_string(event.getRecordId());
+        block += ',';
+        appendCsvField(block, event.getDescription());
+        block += '\n';
+        events++;
+
+        if (block.size() >= kTimelineBlockSize) {
+          out.write(block.data(), static_cast<std::streamsize>(block.size()));
+          block.clear();
+        }
+        return static_cast<bool>(out);
+      });
+  out.write(block.data(), static_cast<std::streamsize>(block.size()));
+
+  if (!out) {
+    throw std::runtime_error("Ошибка записи файла хронологии: " +
+                             report_path);
+  }
+  if (!complete) {
+    logger->warn("Хронология событий записана не полностью: \"{}\"",
+                 report_path);
+  }
+  logger->info("Хронология {} событий записана в \"{}\"", events,
+               report_path);
 }
 
 }
@@ -3,39 +3,75 @@
 
 #pragma once
 
+#include <filesystem>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
-#include "../../../../parsers/event_log/formats/evtx/parser.hpp"
+#include "../../../../parsers/event_log/interfaces/iparser.hpp"
 #include "../../os_detection/os_detection.hpp"
 #include "../data/analysis_data.hpp"
+#include "event_deduplicator.hpp"
+#include "event_timeline.hpp"
+#include "eventlog_checkpoint.hpp"
+#include "eventlog_routing.hpp"
+#include "eventlog_statistics.hpp"
+#include "logon_session_index.hpp"
+#include "network_event_decoder.hpp"
+#include "process_event_extractor.hpp"
+#include "provider_message_resolver.hpp"
+#include "sysmon_event_extractor.hpp"
 
 namespace WindowsDiskAnalysis {
 
+/// @brief Фабрика парсеров журналов событий
+/// @details Каждая задача пула получает собственный экземпляр парсера, так как
+/// парсеры хранят состояние открытого файла и не являются потокобезопасными
+using EventLogParserFactory =
+    std::function<std::unique_ptr<EventLogAnalysis::IEventLogParser>()>;
+
 /// @brief Конфигурация параметров для анализа журналов событий
 struct EventLogConfig {
   std::vector<std::string> log_paths;       ///< Пути к файлам журналов событий
   std::vector<uint32_t> process_event_ids;  ///< ID событий о процессах
   std::vector<uint32_t>
       network_event_ids;  ///< ID событий о сетевых подключениях
+  std::vector<uint32_t> logon_event_ids;   ///< ID событий входа и выхода
+  std::vector<uint32_t> sysmon_event_ids;   ///< ID агрегируемых событий Sysmon
+  std::vector<uint32_t> sysmon_retain_ids;  ///< ID сохраняемых событий Sysmon
+  size_t worker_threads = 0;  ///< Количество рабочих потоков (0 - по числу ядер)
+  std::string checkpoint_dir;  ///< Каталог контрольных точек (пусто - нет)
+  bool recover = false;  ///< Восстановление записей (пустые не отбрасываются)
+  bool deduplicate = true;  ///< Учет повторов копий журналов один раз
+  std::string filter;  ///< Выражение фильтра событий (пусто - нет)
+  size_t timeline_memory = 0;  ///< Бюджет памяти хронологии в байтах
+  std::string timeline_dir;    ///< Каталог прогонов хронологии (пусто - TMP)
+  size_t summary_top = 20;    ///< Процессов и пользователей в сводке канала
 };
 
 /// @brief Анализатор журналов событий Windows
 class EventLogAnalyzer {
  public:
   /// @brief Конструктор анализатора
-  /// @param evt_parser Парсер для формата EVT
-  /// @param evtx_parser Парсер для формата EVTX
+  /// @param evt_factory Фабрика парсеров формата EVT
+  /// @param evtx_factory Фабрика парсеров формата EVTX
   /// @param os_version Версия целевой ОС
   /// @param ini_path Путь к конфигурационному файлу
-  EventLogAnalyzer(
-      std::unique_ptr<EventLogAnalysis::IEventLogParser> evt_parser,
-      std::unique_ptr<EventLogAnalysis::IEventLogParser> evtx_parser,
-      std::string os_version, const std::string& ini_path);
+  EventLogAnalyzer(EventLogParserFactory evt_factory,
+                   EventLogParserFactory evtx_factory, std::string os_version,
+                   const std::string& ini_path);
 
   /// @brief Сбор данных из журналов событий
+  /// @details Журналы отбираются по таблице каналов (см. EventLogRouting) и
+  /// заголовку файла: каналы без обработчиков и пустые журналы не
+  /// открываются. Каждый отобранный файл обрабатывается отдельной задачей
+  /// пула потоков; результаты задач объединяются после завершения всех
+  /// задач. Записи, повторяющиеся в архивах и копиях журналов, учитываются
+  /// один раз (см. EventDeduplicator).
+  /// При заданном каталоге контрольных точек неизмененные журналы не
+  /// разбираются, а дописанные разбираются с первой новой записи
   /// @param disk_root Корневой путь анализируемого диска
   /// @param process_data Карта данных о процессах (заполняется)
   /// @param network_connections Вектор сетевых подключений (заполняется)
@@ -43,23 +79,158 @@ class EventLogAnalyzer {
                std::map<std::string, ProcessInfo>& process_data,
                std::vector<NetworkConnection>& network_connections);
 
+  /// @brief Задает идентичность узла образа для контрольных точек
+  /// @details Точки журналов разных узлов в общем каталоге не смешиваются.
+  /// Без идентичности узлом считается корневой путь диска
+  /// @param host Имя компьютера образа (пусто - путь к образу)
+  void setHostIdentity(std::string host);
+
+  /// @brief Задает источник описаний событий по сообщениям провайдеров
+  /// @param messages Источник описаний (nullptr - описания из журналов)
+  void setMessageResolver(std::shared_ptr<ProviderMessageResolver> messages);
+
+  /// @brief Передает события всех журналов обработчику в порядке времени
+  /// @details Журналы разбираются пулом потоков в упорядоченные по времени
+  /// прогоны, которые затем сливаются (см. EventTimeline). Применяется
+  /// выражение фильтра; ID событий не ограничиваются настройками процессов
+  /// и сети. Пиковое потребление памяти задается EventLogTimelineMemoryMb.
+  /// При заданном источнике описаний (см. setMessageResolver) описание
+  /// события формируется по шаблону сообщения провайдера
+  /// @param disk_root Корневой путь анализируемого диска
+  /// @param consumer Обработчик событий (false прекращает обход)
+  /// @return true если переданы все события
+  bool buildTimeline(
+      const std::string& disk_root,
+      const EventLogAnalysis::EventRecordVisitor& consumer) const;
+
+  /// @brief Записывает сводку всех журналов по каналам
+  /// @details Обзор перед подробным анализом: количество событий по ID,
+  /// провайдерам и часам, первое и последнее событие, наиболее частые
+  /// процессы и пользователи (см. EventLogStatistics). Журналы разбираются
+  /// пулом потоков за один проход, события не сохраняются; каждая задача
+  /// ведет свою сводку, сводки объединяются по завершении. ID событий не
+  /// ограничиваются, применяется выражение фильтра; пустые журналы
+  /// пропускаются
+  /// @param disk_root Корневой путь анализируемого диска
+  /// @param report_path Путь к файлу отчета
+  /// @throws std::runtime_error Если отчет не удалось записать
+  void summarize(const std::string& disk_root,
+                 const std::string& report_path) const;
+
+  /// @brief Записывает хронологию событий всех журналов в CSV
+  /// @details События поступают из buildTimeline в порядке времени и
+  /// записываются по мере слияния прогонов, не накапливаясь в памяти
+  /// @param disk_root Корневой путь анализируемого диска
+  /// @param report_path Путь к файлу хронологии
+  /// @throws std::runtime_error Если файл не удалось записать
+  void exportTimeline(const std::string& disk_root,
+                      const std::string& report_path) const;
+
  private:
   /// @brief Загружает конфигурацию из INI-файла
   /// @param ini_path Путь к конфигурационному файлу
   void loadConfigurations(const std::string& ini_path);
 
-  /// @brief Определяет парсер по расширению файла журнала
+  /// @brief Собирает файлы журналов по настроенным путям
+  /// @param disk_root Корневой путь анализируемого диска
+  /// @return Пути к файлам, упорядоченные по убыванию размера
+  [[nodiscard]] std::vector<std::string> collectLogFiles(
+      const std::string& disk_root) const;
+
+  /// @brief Проверяет по заголовку файла, что журнал не содержит записей
+  /// @details При восстановлении записей журнал пустым не считается:
+  /// удаленные записи могут остаться в файле очищенного журнала
+  /// @param parser Парсер журнала
   /// @param file_path Путь к файлу журнала
-  /// @return Указатель на соответствующий парсер
-  [[nodiscard]] EventLogAnalysis::IEventLogParser* getParserForFile(
-      const std::string& file_path) const;
-
-  std::unique_ptr<EventLogAnalysis::IEventLogParser>
-      evt_parser_;  ///< Парсер для EVT
-  std::unique_ptr<EventLogAnalysis::IEventLogParser>
-      evtx_parser_;  ///< Парсер для EVTX
+  [[nodiscard]] bool isEmptyLog(EventLogAnalysis::IEventLogParser& parser,
+                                const std::string& file_path) const;
+
+  /// @brief Возвращает ID событий, запрашиваемые для обработчиков журнала
+  /// @param routes Маска EventLogRoute
+  [[nodiscard]] EventLogAnalysis::EventIdFilter eventIdsFor(
+      uint8_t routes) const;
+
+  /// @brief Создает парсер по расширению файла журнала
+  /// @param file_path Путь к файлу журнала
+  /// @return Новый экземпляр парсера или nullptr для неизвестного формата
+  [[nodiscard]] std::unique_ptr<EventLogAnalysis::IEventLogParser>
+  createParserForFile(const std::string& file_path) const;
+
+  /// @brief Обрабатывает один файл журнала
+  /// @param disk_root Корневой путь анализируемого диска
+  /// @param file_path Путь к файлу журнала
+  /// @param routes Обработчики журнала (маска EventLogRoute)
+  /// @param dedup Отбрасывание повторов записей журнала
+  /// @return Локальный буфер извлеченных записей
+  [[nodiscard]] EventLogBuffer processLogFile(const std::string& disk_root,
+                                              const std::string& file_path,
+                                              uint8_t routes,
+                                              const EventLogDedup& dedup) const;
+
+  /// @brief Обрабатывает журнал с учетом контрольной точки
+  /// @details Журнал с неизменной идентичностью не разбирается. Дописанный
+  /// журнал, в котором последняя обработанная запись найдена по прежнему
+  /// смещению с прежней контрольной суммой блока, разбирается со следующей
+  /// записи, и новые результаты добавляются к накопленным. Иначе (журнал
+  /// очищен, перезаписан, запись вытеснена из кольца или точка относится к
+  /// журналу другого узла) журнал разбирается полностью. Записи журнала из
+  /// точки заявляются повторно по сохраненным ключам
+  /// @param parser Парсер журнала
+  /// @param checkpoint_path Путь к контрольной точке журнала
+  /// @param file_path Путь к файлу журнала
+  /// @param routes Обработчики журнала (маска EventLogRoute)
+  /// @param dedup Отбрасывание повторов записей журнала
+  /// @return Накопленные результаты журнала
+  [[nodiscard]] EventLogBuffer processWithCheckpoint(
+      EventLogAnalysis::IEventLogParser& parser,
+      const std::filesystem::path& checkpoint_path,
+      const std::string& file_path, uint8_t routes,
+      const EventLogDedup& dedup) const;
+
+  /// @brief Извлекает записи выборки в буфер
+  /// @param parser Парсер журнала
+  /// @param file_path Путь к файлу журнала
+  /// @param query Выборка (ID событий подставляются из настроек)
+  /// @param routes Обработчики журнала (маска EventLogRoute)
+  /// @param dedup Отбрасывание повторов записей журнала
+  /// @param buffer Буфер для сохранения записей
+  void extractRecords(EventLogAnalysis::IEventLogParser& parser,
+                      const std::string& file_path,
+                      EventLogAnalysis::EventLogQuery query, uint8_t routes,
+                      const EventLogDedup& dedup,
+                      EventLogBuffer& buffer) const;
+
+  /// @brief Объединяет локальный буфер задачи с общим результатом
+  /// @details Группы событий о процессах соединяются с данными о процессах
+  /// после построения индекса сеансов входа по всем журналам
+  /// @param buffer Буфер задачи
+  /// @param flows Общая таблица сетевых потоков
+  /// @param logons События входа всех журналов
+  /// @param sysmon Общая активность образов по Sysmon
+  static void mergeBuffer(EventLogBuffer& buffer, NetworkFlowTable& flows,
+                          std::vector<LogonEvent>& logons,
+                          SysmonActivityTable& sysmon);
+
+  EventLogParserFactory evt_factory_;   ///< Фабрика парсеров EVT
+  EventLogParserFactory evtx_factory_;  ///< Фабрика парсеров EVTX
   EventLogConfig config_; ///< Конфигурация для текущей версии ОС
+  EventLogAnalysis::EventIdFilter process_ids_;  ///< ID событий о процессах
+  EventLogAnalysis::EventIdFilter network_ids_;  ///< ID событий о сети
+  EventLogAnalysis::EventIdFilter logon_ids_;    ///< ID событий входа
+  EventLogAnalysis::EventIdFilter sysmon_ids_;   ///< ID событий Sysmon
+  EventLogAnalysis::EventIdFilter
+      sysmon_retain_ids_;  ///< ID событий Sysmon, сохраняемых целиком
+  EventLogAnalysis::EventIdFilter
+      event_ids_;  ///< Объединение ID, запрашиваемых у парсера
+  std::shared_ptr<const EventLogAnalysis::EventFilter>
+      filter_;  ///< Скомпилированное выражение фильтра
+  EventLogRouting routing_;  ///< Обработчики журналов по каналам
+  std::shared_ptr<ProviderMessageResolver>
+      messages_;  ///< Описания событий по сообщениям провайдеров
+  uint8_t configured_routes_ = kRouteNone;  ///< Обработчики с заданными ID
+  uint32_t settings_hash_ = 0;  ///< Сумма настроек отбора для контрольных точек
   std::string os_version_;  ///< Целевая версия ОС
+  std::string host_;        ///< Идентичность узла образа (пусто - путь)
 };
 
-}
\ No newline at end of file
+}
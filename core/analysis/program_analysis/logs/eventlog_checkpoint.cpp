@@ -0,0 +1,385 @@
+#include "eventlog_checkpoint.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+#include "../../../../parsers/event_log/formats/common/crc32.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char kMagic[8] = {'E', 'v', 'l', 'C', 'h', 'k', 'p', '8'};
+
+/// @brief Последовательная запись полей точки
+class CheckpointWriter {
+ public:
+  template <typename T>
+  void value(T value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    out_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  void string(const std::string& text) {
+    value(static_cast<uint32_t>(text.size()));
+    out_ += text;
+  }
+
+  template <typename T>
+  void values(const std::vector<T>& items) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    value(static_cast<uint64_t>(items.size()));
+    out_.append(reinterpret_cast<const char*>(items.data()),
+                items.size() * sizeof(T));
+  }
+
+  [[nodiscard]] const std::string& bytes() const noexcept { return out_; }
+
+ private:
+  std::string out_;
+};
+
+/// @brief Последовательное чтение полей точки
+/// @details Выход за конец данных означает поврежденный файл
+class CheckpointReader {
+ public:
+  explicit CheckpointReader(const std::string& bytes) : bytes_(bytes) {}
+
+  template <typename T>
+  T value() {
+    static_assert(std::is_trivially_copyable_v<T>);
+    T result;
+    std::memcpy(&result, take(sizeof(T)), sizeof(T));
+    return result;
+  }
+
+  std::string string() {
+    const auto size = value<uint32_t>();
+    return std::string(take(size), size);
+  }
+
+  template <typename T>
+  std::vector<T> values() {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const auto count = value<uint64_t>();
+    if (count > (bytes_.size() - pos_) / sizeof(T)) {
+      throw std::runtime_error("Контрольная точка обрезана");
+    }
+    std::vector<T> result(static_cast<size_t>(count));
+    if (!result.empty()) {
+      std::memcpy(result.data(), take(result.size() * sizeof(T)),
+                  result.size() * sizeof(T));
+    }
+    return result;
+  }
+
+  [[nodiscard]] bool atEnd() const noexcept { return pos_ == bytes_.size(); }
+
+ private:
+  const char* take(size_t size) {
+    if (bytes_.size() - pos_ < size) {
+      throw std::runtime_error("Контрольная точка обрезана");
+    }
+    const char* data = bytes_.data() + pos_;
+    pos_ += size;
+    return data;
+  }
+
+  const std::string& bytes_;
+  size_t pos_ = 0;
+};
+
+}
+
+namespace WindowsDiskAnalysis {
+
+EventLogFileIdentity EventLogFileIdentity::of(const std::string& file_path) {
+  EventLogFileIdentity identity;
+  std::error_code error;
+  const auto size = fs::file_size(file_path, error);
+  if (!error) {
+    identity.file_size = size;
+  }
+  const auto modified = fs::last_write_time(file_path, error);
+  if (!error) {
+    identity.modified_time = modified.time_since_epoch().count();
+  }
+  return identity;
+}
+
+std::optional<EventLogCheckpoint> EventLogCheckpoint::load(
+    const fs::path& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return std::nullopt;
+  }
+  const std::string bytes((std::istreambuf_iterator<char>(in)),
+                          std::istreambuf_iterator<char>());
+
+  try {
+    CheckpointReader reader(bytes);
+    char magic[sizeof(kMagic)];
+    for (char& c : magic) c = reader.value<char>();
+    if (!std::equal(std::begin(magic), std::end(magic), kMagic)) {
+      return std::nullopt;
+    }
+
+    EventLogCheckpoint checkpoint;
+    checkpoint.identity.file_size = reader.value<uint64_t>();
+    checkpoint.identity.modified_time = reader.value<int64_t>();
+    checkpoint.settings_hash = reader.value<uint32_t>();
+    checkpoint.tail.record_id = reader.value<uint64_t>();
+    checkpoint.tail.offset = reader.value<uint64_t>();
+    checkpoint.tail.checksum = reader.value<uint32_t>();
+    checkpoint.buffer.matched_events = reader.value<uint64_t>();
+
+    const auto process_count = reader.value<uint32_t>();
+    for (uint32_t i = 0; i < process_count; ++i) {
+      std::string key = reader.string();
+      ProcessEventGroup group;
+      group.image = reader.string();
+      group.command = reader.string();
+      const auto time_count = reader.value<uint32_t>();
+      for (uint32_t j = 0; j < time_count; ++j) {
+        group.creation_times.push_back(reader.value<uint64_t>());
+      }
+      for (uint32_t j = 0; j < time_count; ++j) {
+        group.logon_ids.push_back(reader.value<uint64_t>());
+      }
+      checkpoint.buffer.processes.emplace(std::move(key), std::move(group));
+    }
+
+    NetworkFlowTable& flows = checkpoint.buffer.connections;
+    const auto string_count = reader.value<uint32_t>();
+    for (uint32_t i = 0; i < string_count; ++i) {
+      if (flows.intern(reader.string()) != i) {
+        return std::nullopt;
+      }
+    }
+    const auto flow_count = reader.value<uint32_t>();
+    for (uint32_t i = 0; i < flow_count; ++i) {
+      NetworkFlowKey key;
+      key.process = reader.value<uint32_t>();
+      key.port = reader.value<uint16_t>();
+      key.protocol = reader.value<uint8_t>();
+      key.local = reader.value<IpAddress>();
+      key.remote = reader.value<IpAddress>();
+      NetworkFlowStats stats;
+      stats.count = reader.value<uint64_t>();
+      stats.first_seen = reader.value<uint64_t>();
+      stats.last_seen = reader.value<uint64_t>();
+
+      // Ссылки на таблицу строк проверяются: иначе поврежденная точка
+      // привела бы к выходу за ее границы при выводе
+      const auto valid = [string_count](const IpAddress& address) {
+        return address.family <= IpAddress::Family::Text &&
+               (address.family != IpAddress::Family::Text ||
+                address.textIndex() < string_count);
+      };
+      if (key.process >= string_count || !valid(key.local) ||
+          !valid(key.remote)) {
+        return std::nullopt;
+      }
+      flows.add(key, stats);
+    }
+
+    const auto logon_count = reader.value<uint32_t>();
+    for (uint32_t i = 0; i < logon_count; ++i) {
+      LogonEvent& logon = checkpoint.buffer.logons.emplace_back();
+      logon.logon_id = reader.value<uint64_t>();
+      logon.time = reader.value<uint64_t>();
+      logon.logon_type = reader.value<uint32_t>();
+      logon.logoff = reader.value<uint8_t>() != 0;
+      logon.user = reader.string();
+    }
+
+    SysmonActivityTable& sysmon = checkpoint.buffer.sysmon;
+    const auto sysmon_string_count = reader.value<uint32_t>();
+    for (uint32_t i = 0; i < sysmon_string_count; ++i) {
+      if (sysmon.intern(reader.string()) != i) {
+        return std::nullopt;
+      }
+    }
+    const auto read_set = [&reader, sysmon_string_count](
+                              std::unordered_set<uint32_t>& indices) {
+      const auto count = reader.value<uint32_t>();
+      for (uint32_t i = 0; i < count; ++i) {
+        const auto index = reader.value<uint32_t>();
+        if (index >= sysmon_string_count) return false;
+        indices.insert(index);
+      }
+      return true;
+    };
+    const auto image_count = reader.value<uint32_t>();
+    for (uint32_t i = 0; i < image_count; ++i) {
+      const auto key = reader.value<uint32_t>();
+      SysmonImageStats stats;
+      stats.image = reader.value<uint32_t>();
+      stats.first_seen = reader.value<uint64_t>();
+      stats.last_seen = reader.value<uint64_t>();
+      stats.events = reader.value<uint64_t>();
+      stats.image_loads = reader.value<uint64_t>();
+      stats.file_creates = reader.value<uint64_t>();
+      stats.registry_sets = reader.value<uint64_t>();
+      stats.dns_queries = reader.value<uint64_t>();
+      if (key >= sysmon_string_count || stats.image >= sysmon_string_count ||
+          !read_set(stats.hashes) || !read_set(stats.modules) ||
+          !read_set(stats.domains)) {
+        return std::nullopt;
+      }
+      const auto record_count = reader.value<uint32_t>();
+      for (uint32_t j = 0; j < record_count; ++j) {
+        SysmonRecord& record = stats.records.emplace_back();
+        record.event_id = reader.value<uint32_t>();
+        record.time = reader.value<uint64_t>();
+        record.details = reader.string();
+      }
+      sysmon.add(key, std::move(stats));
+    }
+
+    using Key = EventDeduplicator::Key;
+    checkpoint.buffer.records.owned = reader.values<Key>();
+    checkpoint.buffer.records.skipped = reader.values<Key>();
+
+    if (!reader.atEnd()) {
+      return std::nullopt;
+    }
+    return checkpoint;
+  } catch (const std::exception&) {
+    return std::nullopt;
+  }
+}
+
+void EventLogCheckpoint::save(const fs::path& path) const {
+  CheckpointWriter writer;
+  for (const char c : kMagic) writer.value(c);
+  writer.value(identity.file_size);
+  writer.value(identity.modified_time);
+  writer.value(settings_hash);
+  writer.value(tail.record_id);
+  writer.value(tail.offset);
+  writer.value(tail.checksum);
+  writer.value(static_cast<uint64_t>(buffer.matched_events));
+
+  writer.value(static_cast<uint32_t>(buffer.processes.size()));
+  for (const auto& [key, group] : buffer.processes) {
+    writer.string(key);
+    writer.string(group.image);
+    writer.string(group.command);
+    writer.value(static_cast<uint32_t>(group.creation_times.size()));
+    for (const uint64_t time : group.creation_times) writer.value(time);
+    for (const uint64_t logon_id : group.logon_ids) writer.value(logon_id);
+  }
+
+  const NetworkFlowTable& flows = buffer.connections;
+  writer.value(static_cast<uint32_t>(flows.strings().size()));
+  for (const auto& text : flows.strings()) writer.string(text);
+  writer.value(static_cast<uint32_t>(flows.flows().size()));
+  for (const auto& [key, stats] : flows.flows()) {
+    writer.value(key.process);
+    writer.value(key.port);
+    writer.value(key.protocol);
+    writer.value(key.local);
+    writer.value(key.remote);
+    writer.value(stats.count);
+    writer.value(stats.first_seen);
+    writer.value(stats.last_seen);
+  }
+
+  writer.value(static_cast<uint32_t>(buffer.logons.size()));
+  for (const auto& logon : buffer.logons) {
+    writer.value(logon.logon_id);
+    writer.value(logon.time);
+    writer.value(logon.logon_type);
+    writer.value(static_cast<uint8_t>(logon.logoff ? 1 : 0));
+    writer.string(logon.user);
+  }
+
+  const SysmonActivityTable& sysmon = buffer.sysmon;
+  writer.value(static_cast<uint32_t>(sysmon.strings().size()));
+  for (const auto& text : sysmon.strings()) writer.string(text);
+  const auto write_set = [&writer](const std::unordered_set<uint32_t>& set) {
+    writer.value(static_cast<uint32_t>(set.size()));
+    for (const uint32_t index : set) writer.value(index);
+  };
+  writer.value(static_cast<uint32_t>(sysmon.images().size()));
+  for (const auto& [key, stats] : sysmon.images()) {
+    writer.value(key);
+    writer.value(stats.image);
+    writer.value(stats.first_seen);
+    writer.value(stats.last_seen);
+    writer.value(stats.events);
+    writer.value(stats.image_loads);
+    writer.value(stats.file_creates);
+    writer.value(stats.registry_sets);
+    writer.value(stats.dns_queries);
+    write_set(stats.hashes);
+    write_set(stats.modules);
+    write_set(stats.domains);
+    writer.value(static_cast<uint32_t>(stats.records.size()));
+    for (const auto& record : stats.records) {
+      writer.value(record.event_id);
+      writer.value(record.time);
+      writer.string(record.details);
+    }
+  }
+
+  writer.values(buffer.records.owned);
+  writer.values(buffer.records.skipped);
+
+  std::error_code error;
+  fs::create_directories(path.parent_path(), error);
+
+  // Запись через временный файл: прерванный запуск не оставит
+  // недописанную точку
+  fs::path temp_path = path;
+  temp_path += ".tmp";
+  {
+    std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+    out.write(writer.bytes().data(),
+              static_cast<std::streamsize>(writer.bytes().size()));
+    if (!out) {
+      throw std::runtime_error("Не удалось записать контрольную точку: " +
+                               temp_path.string());
+    }
+  }
+
+  fs::rename(temp_path, path, error);
+  if (error) {
+    fs::remove(temp_path, error);
+    throw std::runtime_error("Не удалось сохранить контрольную точку: " +
+                             path.string());
+  }
+}
+
+fs::path EventLogCheckpoint::pathFor(const fs::path& checkpoint_dir,
+                                     std::string_view host,
+                                     const std::string& log_key) {
+  // Относительный путь журнала становится именем файла, узел - суффиксом
+  // из суммы его идентичности без учета регистра
+  std::string name = log_key;
+  std::ranges::replace_if(
+      name, [](char c) { return c == '/' || c == '\\' || c == ':'; }, '_');
+  while (!name.empty() && name.front() == '_') name.erase(name.begin());
+
+  std::string host_key(host);
+  std::ranges::transform(host_key, host_key.begin(), [](unsigned char c) {
+    return static_cast<char>(std::tolower(c));
+  });
+  char suffix[10];
+  std::snprintf(suffix, sizeof(suffix), ".%08x",
+                EventLogAnalysis::Crc32::compute(std::span(
+                    reinterpret_cast<const uint8_t*>(host_key.data()),
+                    host_key.size())));
+  return checkpoint_dir / (name + suffix + ".evlchk");
+}
+
+}
@@ -0,0 +1,96 @@
+/// @file eventlog_checkpoint.hpp
+/// @brief Контрольные точки инкрементального разбора журналов событий
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../../../../parsers/event_log/model/event_log_tail.hpp"
+#include "../data/analysis_data.hpp"
+#include "event_deduplicator.hpp"
+#include "logon_session_index.hpp"
+#include "network_flow.hpp"
+#include "string_key_hash.hpp"
+#include "sysmon_activity.hpp"
+
+namespace WindowsDiskAnalysis {
+
+/// @brief События о процессах одного образа, накопленные при разборе
+struct ProcessEventGroup {
+  std::string image;                     ///< Путь к образу из первого события
+  std::string command;                   ///< Первая непустая командная строка
+  std::vector<uint64_t> creation_times;  ///< Время создания (FILETIME)
+  std::vector<uint64_t> logon_ids;       ///< LogonId сеанса каждого создания
+};
+
+/// @brief Группы событий о процессах по нормализованному пути образа
+using ProcessEventGroups =
+    std::unordered_map<std::string, ProcessEventGroup, StringKeyHash,
+                       std::equal_to<>>;
+
+/// @brief Результаты разбора одного журнала
+struct EventLogBuffer {
+  ProcessEventGroups processes;    ///< События о процессах
+  NetworkFlowTable connections;    ///< Сетевые потоки
+  std::vector<LogonEvent> logons;  ///< События входа и выхода
+  SysmonActivityTable sysmon;      ///< Активность образов по Sysmon
+  EventLogRecordKeys records;      ///< Ключи записей (для точек с повторами)
+  size_t matched_events = 0;       ///< Количество подходящих событий
+};
+
+/// @brief Идентичность файла журнала
+struct EventLogFileIdentity {
+  uint64_t file_size = 0;     ///< Размер файла
+  int64_t modified_time = 0;  ///< Время изменения файла
+
+  /// @brief Определяет идентичность файла
+  /// @param file_path Путь к файлу
+  [[nodiscard]] static EventLogFileIdentity of(const std::string& file_path);
+
+  /// @brief Сравнивает идентичности
+  bool operator==(const EventLogFileIdentity&) const = default;
+};
+
+/// @brief Контрольная точка разбора журнала
+/// @details Хранит идентичность файла, последнюю обработанную запись с
+/// контрольной суммой ее блока и накопленные результаты разбора журнала, а
+/// при отбрасывании повторов - ключи учтенных и пропущенных записей.
+/// Точки привязаны к узлу образа и пути журнала относительно корня диска,
+/// поэтому повторные снимки одного узла, смонтированные в разные каталоги,
+/// используют общие точки, а одноименные журналы разных узлов - нет.
+/// Формат использует порядок байтов машины и предназначен для локального
+/// кэша.
+struct EventLogCheckpoint {
+  EventLogFileIdentity identity;        ///< Файл при сохранении точки
+  uint32_t settings_hash = 0;           ///< Сумма настроек отбора событий
+  EventLogAnalysis::EventLogTail tail;  ///< Последняя обработанная запись
+  EventLogBuffer buffer;                ///< Накопленные результаты
+
+  /// @brief Загружает контрольную точку
+  /// @param path Путь к файлу точки
+  /// @return Точка или std::nullopt, если файла нет или он поврежден
+  [[nodiscard]] static std::optional<EventLogCheckpoint> load(
+      const std::filesystem::path& path);
+
+  /// @brief Сохраняет контрольную точку (через временный файл)
+  /// @param path Путь к файлу точки
+  /// @throws std::runtime_error Если файл не удалось записать
+  void save(const std::filesystem::path& path) const;
+
+  /// @brief Возвращает путь к точке журнала в каталоге точек
+  /// @param checkpoint_dir Каталог контрольных точек
+  /// @param host Идентичность узла образа (имя компьютера или путь к образу)
+  /// @param log_key Путь журнала относительно корня диска
+  [[nodiscard]] static std::filesystem::path pathFor(
+      const std::filesystem::path& checkpoint_dir, std::string_view host,
+      const std::string& log_key);
+};
+
+}
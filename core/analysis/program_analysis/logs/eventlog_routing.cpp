@@ -0,0 +1,94 @@
+#include "eventlog_routing.hpp"
+
+#include <filesystem>
+#include <utility>
+
+#include "../../../../utils/logging/logger.hpp"
+#include "../../../../utils/utils.hpp"
+
+namespace {
+
+/// @brief Префикс имени архивной копии журнала
+constexpr std::string_view kArchivePrefix = "archive-";
+
+}
+
+namespace WindowsDiskAnalysis {
+
+EventLogRouting EventLogRouting::load(const Config& config,
+                                      const std::string& section) {
+  EventLogRouting routing;
+  if (!config.hasSection(section)) {
+    return routing;
+  }
+
+  // Раздел задан: неперечисленные каналы не разбираются, если нет "*"
+  routing.default_routes_ = kRouteNone;
+  for (auto [channel, names] : config.getAllValues(section)) {
+    trim(channel);
+    const uint8_t routes = parseRoutes(channel, names);
+    if (channel == "*") {
+      routing.default_routes_ = routes;
+    } else {
+      routing.channels_[to_lower(channel)] = routes;
+    }
+  }
+  return routing;
+}
+
+uint8_t EventLogRouting::parseRoutes(const std::string& channel,
+                                     const std::string& names) {
+  uint8_t routes = kRouteNone;
+  for (auto& name : split(names, ',')) {
+    trim(name);
+    name = to_lower(name);
+    if (name.empty()) {
+      continue;
+    }
+    if (name == "process") {
+      routes |= kRouteProcess;
+    } else if (name == "network") {
+      routes |= kRouteNetwork;
+    } else if (name == "logon") {
+      routes |= kRouteLogon;
+    } else if (name == "sysmon") {
+      routes |= kRouteSysmon;
+    } else if (name == "all") {
+      routes |= kRouteAll;
+    } else {
+      GlobalLogger::get()->warn(
+          "Неизвестный обработчик \"{}\" для канала \"{}\"", name, channel);
+    }
+  }
+  return routes;
+}
+
+uint8_t EventLogRouting::routesOf(const std::string& file_path) const {
+  if (channels_.empty()) {
+    return default_routes_;
+  }
+
+  const std::string name =
+      to_lower(std::filesystem::path(file_path).stem().string());
+  if (const auto found = channels_.find(name); found != channels_.end()) {
+    return found->second;
+  }
+
+  // "Archive-<канал>-ГГГГ-ММ-ДД-чч-мм-сс-ммм": имя канала само содержит
+  // дефисы, поэтому проверяются все префиксы, начиная с самого длинного
+  if (name.starts_with(kArchivePrefix)) {
+    std::string_view channel = std::string_view(name).substr(
+        kArchivePrefix.size());
+    for (size_t dash = channel.rfind('-'); dash != std::string_view::npos;
+         dash = channel.rfind('-')) {
+      channel = channel.substr(0, dash);
+      if (const auto found = channels_.find(channel);
+          found != channels_.end()) {
+        return found->second;
+      }
+    }
+  }
+  return default_routes_;
+}
+
+}
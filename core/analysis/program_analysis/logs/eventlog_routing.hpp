@@ -0,0 +1,60 @@
+/// @file eventlog_routing.hpp
+/// @brief Маршрутизация журналов событий по обработчикам
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "../../../../utils/config/config.hpp"
+#include "string_key_hash.hpp"
+
+namespace WindowsDiskAnalysis {
+
+/// @brief Обработчики, которые может питать журнал (битовая маска)
+enum EventLogRoute : uint8_t {
+  kRouteNone = 0,
+  kRouteProcess = 1 << 0,  ///< События о процессах
+  kRouteNetwork = 1 << 1,  ///< События о сетевых подключениях
+  kRouteLogon = 1 << 2,    ///< События входа и выхода
+  kRouteSysmon = 1 << 3,   ///< События Sysmon
+  kRouteAll = kRouteProcess | kRouteNetwork | kRouteLogon | kRouteSysmon,
+};
+
+/// @class EventLogRouting
+/// @brief Таблица каналов журналов и обработчиков, которые они питают
+/// @details На Windows 10 каталог winevt/Logs содержит 300-400 файлов, и
+/// лишь несколько каналов могут содержать настроенные события. Файл
+/// журнала сопоставляется с каналом по имени ("Security.evtx",
+/// "Microsoft-Windows-Sysmon%4Operational.evtx", архивы
+/// "Archive-Security-...") без открытия файла; журналы без обработчиков
+/// не разбираются. Таблица задается разделом [EventLogChannels]; ключ "*"
+/// задает обработчики неперечисленных каналов. Без раздела все журналы
+/// питают все обработчики.
+class EventLogRouting {
+ public:
+  /// @brief Загружает таблицу из конфигурации
+  /// @param config Конфигурация
+  /// @param section Раздел с таблицей каналов
+  /// @return Таблица (без раздела - все журналы питают все обработчики)
+  [[nodiscard]] static EventLogRouting load(const Config& config,
+                                            const std::string& section);
+
+  /// @brief Возвращает обработчики журнала по имени файла
+  /// @param file_path Путь к файлу журнала
+  /// @return Маска EventLogRoute (kRouteNone - журнал не нужен)
+  [[nodiscard]] uint8_t routesOf(const std::string& file_path) const;
+
+ private:
+  /// @brief Разбирает список обработчиков "process, network, ..."
+  [[nodiscard]] static uint8_t parseRoutes(const std::string& channel,
+                                           const std::string& names);
+
+  std::unordered_map<std::string, uint8_t, StringKeyHash, std::equal_to<>>
+      channels_;                        ///< Обработчики по имени канала
+  uint8_t default_routes_ = kRouteAll;  ///< Обработчики прочих каналов
+};
+
+}
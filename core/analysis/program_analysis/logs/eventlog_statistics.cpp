@@ -0,0 +1,204 @@
+#include "eventlog_statistics.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "../../../../utils/time/filetime_formatter.hpp"
+#include "process_event_extractor.hpp"
+
+namespace {
+
+/// @brief Интервалов FILETIME (100 нс) в часе
+constexpr uint64_t kFiletimeHour = 36'000'000'000ULL;
+
+/// @brief Возвращает пары словаря по убыванию счетчика
+template <typename Map>
+auto byCount(const Map& counts) {
+  std::vector<std::pair<typename Map::key_type, uint64_t>> result(
+      counts.begin(), counts.end());
+  std::ranges::sort(result, [](const auto& a, const auto& b) {
+    return a.second != b.second ? a.second > b.second : a.first < b.first;
+  });
+  return result;
+}
+
+/// @brief Прибавляет счетчики одного словаря к другому
+template <typename Map>
+void addCounts(Map& target, const Map& source) {
+  for (const auto& [key, count] : source) {
+    target[key] += count;
+  }
+}
+
+}
+
+namespace WindowsDiskAnalysis {
+
+ChannelStatistics::ChannelStatistics(size_t top_capacity)
+    : processes(top_capacity), users(top_capacity) {}
+
+void ChannelStatistics::merge(const ChannelStatistics& other) {
+  if (other.events == 0) {
+    return;
+  }
+  if (other.first_seen != 0 &&
+      (first_seen == 0 || other.first_seen < first_seen)) {
+    first_seen = other.first_seen;
+  }
+  last_seen = std::max(last_seen, other.last_seen);
+  events += other.events;
+  addCounts(event_ids, other.event_ids);
+  addCounts(hours, other.hours);
+  for (const auto& [provider, count] : other.providers) {
+    if (const auto found = providers.find(provider);
+        found != providers.end()) {
+      found->second += count;
+    } else {
+      providers.emplace(provider, count);
+    }
+  }
+  processes.merge(other.processes);
+  users.merge(other.users);
+}
+
+// Поле процесса: 4688 (NewProcessName), Sysmon (Image), 4624/4648
+// (ProcessName), 5156 (Application). Поле пользователя: цель входа или
+// субъект действия
+EventLogStatistics::EventLogStatistics(size_t top_capacity)
+    : top_capacity_(top_capacity),
+      layouts_({{"NewProcessName", "Image", "ProcessName", "Application"},
+                {"TargetUserName", "SubjectUserName", "User"}}) {}
+
+ChannelStatistics& EventLogStatistics::channel(std::string_view name) {
+  if (const auto found = channels_.find(name); found != channels_.end()) {
+    return found->second;
+  }
+  return channels_.emplace(std::string(name), top_capacity_).first->second;
+}
+
+void EventLogStatistics::add(const EventLogAnalysis::EventData& event,
+                             std::string_view fallback_channel) {
+  // Строки интернированы: совпадение адреса означает совпадение строки
+  std::string_view channel_name = event.getChannel();
+  if (channel_name.empty()) channel_name = fallback_channel;
+  if (!current_ || channel_name.data() != channel_key_.data() ||
+      channel_name.size() != channel_key_.size()) {
+    current_ = &channel(channel_name);
+    channel_key_ = channel_name;
+    provider_count_ = nullptr;
+  }
+  ChannelStatistics& stats = *current_;
+
+  const std::string_view provider = event.getProvider();
+  if (!provider_count_ || provider.data() != provider_key_.data() ||
+      provider.size() != provider_key_.size()) {
+    auto found = stats.providers.find(provider);
+    if (found == stats.providers.end()) {
+      found = stats.providers.emplace(std::string(provider), 0).first;
+    }
+    provider_count_ = &found->second;
+    provider_key_ = provider;
+  }
+  ++*provider_count_;
+
+  const uint64_t timestamp = event.getTimestamp();
+  stats.events++;
+  stats.event_ids[event.getEventId()]++;
+  if (timestamp != 0) {
+    if (stats.first_seen == 0 || timestamp < stats.first_seen) {
+      stats.first_seen = timestamp;
+    }
+    stats.last_seen = std::max(stats.last_seen, timestamp);
+    stats.hours[timestamp / kFiletimeHour]++;
+  }
+
+  const auto fields = event.getData();
+  if (fields.empty()) {
+    if (const auto sid = event.getUserSid(); !sid.empty()) {
+      stats.users.add(sid);
+    }
+    return;
+  }
+  const auto slots = layouts_.slotsOf(event.getEventId(), fields);
+  if (const auto image = EventFieldLayouts::valueAt(fields, slots[kProcess]);
+      !image.empty() && image != "-") {
+    normalizeImagePath(image, process_);
+    stats.processes.add(process_);
+  }
+  std::string_view user = EventFieldLayouts::valueAt(fields, slots[kUser]);
+  if (user.empty() || user == "-") user = event.getUserSid();
+  if (!user.empty()) {
+    stats.users.add(user);
+  }
+}
+
+void EventLogStatistics::merge(const EventLogStatistics& other) {
+  for (const auto& [name, stats] : other.channels_) {
+    channel(name).merge(stats);
+  }
+  current_ = nullptr;
+  provider_count_ = nullptr;
+}
+
+void EventLogStatistics::writeReport(const std::string& report_path,
+                                     size_t top_count) const {
+  std::ofstream out(report_path, std::ios::trunc);
+  if (!out) {
+    throw std::runtime_error("Не удалось открыть файл сводки: " +
+                             report_path);
+  }
+
+  uint64_t total = 0;
+  for (const auto& [name, stats] : channels_) total += stats.events;
+  out << "Сводка журналов событий\n"
+      << "Каналов: " << channels_.size() << ", событий: " << total << "\n";
+
+  FiletimeFormatter formatter;
+  for (const auto& [name, stats] : channels_) {
+    out << "\n[" << name << "]\n"
+        << "Событий: " << stats.events << "\n";
+    if (stats.first_seen != 0) {
+      out << "Первое событие: " << formatter.toString(stats.first_seen)
+          << "\n"
+          << "Последнее событие: " << formatter.toString(stats.last_seen)
+          << "\n";
+    }
+
+    out << "ID событий:\n";
+    for (const auto& [event_id, count] : byCount(stats.event_ids)) {
+      out << "  " << event_id << "\t" << count << "\n";
+    }
+    out << "Провайдеры:\n";
+    for (const auto& [provider, count] : byCount(stats.providers)) {
+      out << "  " << provider << "\t" << count << "\n";
+    }
+
+    std::vector<std::pair<uint64_t, uint64_t>> hours(stats.hours.begin(),
+                                                     stats.hours.end());
+    std::ranges::sort(hours);
+    out << "По часам (UTC):\n";
+    for (const auto& [hour, count] : hours) {
+      // "ГГГГ-ММ-ДД чч" из "ГГГГ-ММ-ДД чч:мм:сс"
+      out << "  " << formatter.toString(hour * kFiletimeHour).substr(0, 13)
+          << ":00\t" << count << "\n";
+    }
+
+    out << "Процессы (оценка):\n";
+    for (const auto& [process, count] : stats.processes.top(top_count)) {
+      out << "  " << process << "\t" << count << "\n";
+    }
+    out << "Пользователи (оценка):\n";
+    for (const auto& [user, count] : stats.users.top(top_count)) {
+      out << "  " << user << "\t" << count << "\n";
+    }
+  }
+
+  if (!out) {
+    throw std::runtime_error("Ошибка записи файла сводки: " + report_path);
+  }
+}
+
+}
@@ -0,0 +1,94 @@
+/// @file eventlog_statistics.hpp
+/// @brief Потоковая сводка журналов событий по каналам
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "../../../../parsers/event_log/model/event_data.hpp"
+#include "event_field_layouts.hpp"
+#include "frequency_sketch.hpp"
+#include "string_key_hash.hpp"
+
+namespace WindowsDiskAnalysis {
+
+/// @brief Сводка одного канала журнала
+/// @details Счетчики по ID событий, провайдерам и часам точные: их
+/// множества ограничены. Процессы и пользователи оцениваются эскизами
+/// (см. HeavyHitters), так как их число в журнале не ограничено.
+struct ChannelStatistics {
+  uint64_t events = 0;      ///< Количество событий
+  uint64_t first_seen = 0;  ///< Время первого события (FILETIME)
+  uint64_t last_seen = 0;   ///< Время последнего события (FILETIME)
+  std::unordered_map<uint32_t, uint64_t> event_ids;  ///< События по ID
+  std::unordered_map<uint64_t, uint64_t> hours;      ///< События по часам
+  std::unordered_map<std::string, uint64_t, StringKeyHash, std::equal_to<>>
+      providers;           ///< События по провайдерам
+  HeavyHitters processes;  ///< Наиболее частые процессы
+  HeavyHitters users;      ///< Наиболее частые пользователи
+
+  /// @brief Конструктор
+  /// @param top_capacity Размер наборов наиболее частых ключей
+  explicit ChannelStatistics(size_t top_capacity);
+
+  /// @brief Объединяет со сводкой того же канала другой задачи
+  void merge(const ChannelStatistics& other);
+};
+
+/// @class EventLogStatistics
+/// @brief Сводка журналов по каналам за один проход
+/// @details События учитываются сразу после декодирования и не
+/// сохраняются. Повторные канал и провайдер распознаются по адресу строки
+/// интернирования (равные строки имеют один адрес), поэтому поиск по
+/// словарю выполняется только при их смене. Экземпляр не потокобезопасен:
+/// каждая задача разбора ведет свою сводку, сводки объединяются в конце.
+class EventLogStatistics {
+ public:
+  /// @brief Конструктор
+  /// @param top_capacity Размер наборов наиболее частых ключей
+  explicit EventLogStatistics(size_t top_capacity);
+
+  /// @brief Учитывает событие
+  /// @param event Событие
+  /// @param fallback_channel Канал событий без канала (журналы EVT)
+  void add(const EventLogAnalysis::EventData& event,
+           std::string_view fallback_channel);
+
+  /// @brief Объединяет со сводкой другой задачи
+  void merge(const EventLogStatistics& other);
+
+  /// @brief Записывает сводку в текстовый отчет
+  /// @param report_path Путь к файлу отчета
+  /// @param top_count Количество наиболее частых процессов и пользователей
+  /// @throws std::runtime_error Если файл не удалось записать
+  void writeReport(const std::string& report_path, size_t top_count) const;
+
+  /// @brief Возвращает сводки по каналам
+  [[nodiscard]] const std::map<std::string, ChannelStatistics, std::less<>>&
+  channels() const noexcept {
+    return channels_;
+  }
+
+ private:
+  /// @brief Извлекаемое поле события
+  enum Role : size_t { kProcess, kUser };
+
+  /// @brief Возвращает сводку канала, создавая ее при отсутствии
+  ChannelStatistics& channel(std::string_view name);
+
+  size_t top_capacity_;  ///< Размер наборов наиболее частых ключей
+  std::map<std::string, ChannelStatistics, std::less<>>
+      channels_;                          ///< Сводки по каналам
+  EventFieldLayouts layouts_;             ///< Позиции полей по раскладкам
+  std::string process_;                   ///< Буфер пути процесса
+  std::string_view channel_key_;          ///< Канал прошлого события
+  ChannelStatistics* current_ = nullptr;  ///< Сводка прошлого канала
+  std::string_view provider_key_;         ///< Провайдер прошлого события
+  uint64_t* provider_count_ = nullptr;    ///< Счетчик прошлого провайдера
+};
+
+}
@@ -0,0 +1,153 @@
+#include "frequency_sketch.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+/// @brief Перемешивание 64-битного значения (splitmix64)
+constexpr uint64_t mix(uint64_t value) noexcept {
+  value ^= value >> 30;
+  value *= 0xBF58476D1CE4E5B9ULL;
+  value ^= value >> 27;
+  value *= 0x94D049BB133111EBULL;
+  return value ^ (value >> 31);
+}
+
+}
+
+namespace WindowsDiskAnalysis {
+
+CountMinSketch::CountMinSketch(size_t width, size_t depth)
+    : width_(std::bit_ceil(std::max<size_t>(width, 1))),
+      depth_(std::max<size_t>(depth, 1)),
+      counters_(width_ * depth_, 0) {}
+
+size_t CountMinSketch::index(size_t row, uint64_t hash) const noexcept {
+  // Строки используют независимые перемешивания одного хэша
+  const uint64_t row_hash = mix(hash + (row + 1) * 0x9E3779B97F4A7C15ULL);
+  return row * width_ + static_cast<size_t>(row_hash & (width_ - 1));
+}
+
+void CountMinSketch::add(uint64_t hash, uint64_t count) noexcept {
+  for (size_t row = 0; row < depth_; ++row) {
+    counters_[index(row, hash)] += count;
+  }
+}
+
+uint64_t CountMinSketch::estimate(uint64_t hash) const noexcept {
+  uint64_t result = std::numeric_limits<uint64_t>::max();
+  for (size_t row = 0; row < depth_; ++row) {
+    result = std::min(result, counters_[index(row, hash)]);
+  }
+  return result;
+}
+
+void CountMinSketch::merge(const CountMinSketch& other) {
+  if (width_ != other.width_ || depth_ != other.depth_) {
+    throw std::runtime_error("Размеры объединяемых эскизов различаются");
+  }
+  for (size_t i = 0; i < counters_.size(); ++i) {
+    counters_[i] += other.counters_[i];
+  }
+}
+
+HeavyHitters::HeavyHitters(size_t capacity)
+    : capacity_(std::max<size_t>(capacity, 1)) {}
+
+void HeavyHitters::add(std::string_view key) {
+  const uint64_t hash = std::hash<std::string_view>{}(key);
+  sketch_.add(hash);
+  const uint64_t estimate = sketch_.estimate(hash);
+  if (const auto found = candidates_.find(key); found != candidates_.end()) {
+    found->second.estimate = estimate;
+    return;
+  }
+  offer(key, hash, estimate);
+}
+
+void HeavyHitters::offer(std::string_view key, uint64_t hash,
+                         uint64_t estimate) {
+  if (candidates_.size() < capacity_) {
+    candidates_.emplace(key, Candidate{hash, estimate});
+    min_estimate_ = candidates_.size() == 1
+                        ? estimate
+                        : std::min(min_estimate_, estimate);
+    return;
+  }
+  if (estimate <= min_estimate_) {
+    return;
+  }
+
+  // Оценки кандидатов только растут, поэтому запомненная нижняя граница
+  // отсекает большинство ключей без прохода по набору
+  auto smallest = candidates_.end();
+  uint64_t second = std::numeric_limits<uint64_t>::max();
+  for (auto it = candidates_.begin(); it != candidates_.end(); ++it) {
+    it->second.estimate = sketch_.estimate(it->second.hash);
+    if (smallest == candidates_.end() ||
+        it->second.estimate < smallest->second.estimate) {
+      if (smallest != candidates_.end()) {
+        second = std::min(second, smallest->second.estimate);
+      }
+      smallest = it;
+    } else {
+      second = std::min(second, it->second.estimate);
+    }
+  }
+  if (estimate <= smallest->second.estimate) {
+    min_estimate_ = smallest->second.estimate;
+    return;
+  }
+  candidates_.erase(smallest);
+  candidates_.emplace(key, Candidate{hash, estimate});
+  min_estimate_ = std::min(second, estimate);
+}
+
+void HeavyHitters::merge(const HeavyHitters& other) {
+  sketch_.merge(other.sketch_);
+
+  std::vector<std::pair<std::string, Candidate>> merged;
+  merged.reserve(candidates_.size() + other.candidates_.size());
+  for (auto& [key, candidate] : candidates_) {
+    merged.emplace_back(key, candidate);
+  }
+  for (const auto& [key, candidate] : other.candidates_) {
+    if (!candidates_.contains(key)) merged.emplace_back(key, candidate);
+  }
+  for (auto& [key, candidate] : merged) {
+    candidate.estimate = sketch_.estimate(candidate.hash);
+  }
+
+  const size_t kept = std::min(merged.size(), capacity_);
+  std::ranges::partial_sort(merged, merged.begin() + kept,
+                            [](const auto& a, const auto& b) {
+                              return a.second.estimate > b.second.estimate;
+                            });
+  candidates_.clear();
+  min_estimate_ = kept ? merged[kept - 1].second.estimate : 0;
+  for (size_t i = 0; i < kept; ++i) {
+    candidates_.emplace(std::move(merged[i].first), merged[i].second);
+  }
+}
+
+std::vector<std::pair<std::string, uint64_t>> HeavyHitters::top(
+    size_t count) const {
+  std::vector<std::pair<std::string, uint64_t>> result;
+  result.reserve(candidates_.size());
+  for (const auto& [key, candidate] : candidates_) {
+    result.emplace_back(key, sketch_.estimate(candidate.hash));
+  }
+  std::ranges::sort(result, [](const auto& a, const auto& b) {
+    return a.second != b.second ? a.second > b.second : a.first < b.first;
+  });
+  if (result.size() > count) {
+    result.resize(count);
+  }
+  return result;
+}
+
+}
@@ -0,0 +1,98 @@
+/// @file frequency_sketch.hpp
+/// @brief Вероятностные счетчики частот для потоковой сводки журналов
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "string_key_hash.hpp"
+
+namespace WindowsDiskAnalysis {
+
+/// @class CountMinSketch
+/// @brief Эскиз Count-Min: оценка частоты ключа в фиксированной памяти
+/// @details Оценка не меньше истинной частоты и превышает ее не более чем
+/// на 2N/width с вероятностью 1 - 2^-depth (N - число добавлений). Эскизы
+/// одинакового размера объединяются сложением счетчиков, поэтому каждая
+/// задача ведет свой эскиз без синхронизации.
+class CountMinSketch {
+ public:
+  /// @brief Конструктор
+  /// @param width Число счетчиков в строке (округляется до степени двойки)
+  /// @param depth Число строк (независимых хэш-функций)
+  explicit CountMinSketch(size_t width = 2048, size_t depth = 4);
+
+  /// @brief Учитывает ключ
+  /// @param hash Хэш ключа
+  /// @param count Число появлений
+  void add(uint64_t hash, uint64_t count = 1) noexcept;
+
+  /// @brief Возвращает оценку частоты ключа сверху
+  /// @param hash Хэш ключа
+  [[nodiscard]] uint64_t estimate(uint64_t hash) const noexcept;
+
+  /// @brief Прибавляет счетчики другого эскиза
+  /// @throws std::runtime_error Если размеры эскизов различаются
+  void merge(const CountMinSketch& other);
+
+ private:
+  /// @brief Возвращает позицию счетчика ключа в строке
+  [[nodiscard]] size_t index(size_t row, uint64_t hash) const noexcept;
+
+  size_t width_;                    ///< Число счетчиков в строке
+  size_t depth_;                    ///< Число строк
+  std::vector<uint64_t> counters_;  ///< Счетчики, строка за строкой
+};
+
+/// @class HeavyHitters
+/// @brief Наиболее частые строковые ключи потока
+/// @details Частоты оцениваются эскизом Count-Min, а ключи с наибольшими
+/// оценками хранятся в наборе кандидатов ограниченного размера: ключ,
+/// оценка которого превысила наименьшую в наборе, вытесняет ее владельца.
+/// Память не зависит от числа различных ключей. При объединении
+/// кандидаты обоих наборов переоцениваются по общему эскизу.
+class HeavyHitters {
+ public:
+  /// @brief Конструктор
+  /// @param capacity Размер набора кандидатов
+  explicit HeavyHitters(size_t capacity = 64);
+
+  /// @brief Учитывает ключ
+  void add(std::string_view key);
+
+  /// @brief Объединяет с набором другой задачи
+  void merge(const HeavyHitters& other);
+
+  /// @brief Возвращает наиболее частые ключи
+  /// @param count Количество ключей
+  /// @return Пары (ключ, оценка частоты) по убыванию оценки
+  [[nodiscard]] std::vector<std::pair<std::string, uint64_t>> top(
+      size_t count) const;
+
+ private:
+  /// @brief Кандидат в наиболее частые ключи
+  struct Candidate {
+    uint64_t hash = 0;      ///< Хэш ключа
+    uint64_t estimate = 0;  ///< Оценка частоты на момент обновления
+  };
+
+  /// @brief Вытесняет кандидата с наименьшей оценкой, если она меньше
+  /// @param key Ключ
+  /// @param hash Хэш ключа
+  /// @param estimate Оценка частоты ключа
+  void offer(std::string_view key, uint64_t hash, uint64_t estimate);
+
+  CountMinSketch sketch_;  ///< Оценки частот всех ключей
+  size_t capacity_;        ///< Размер набора кандидатов
+  std::unordered_map<std::string, Candidate, StringKeyHash, std::equal_to<>>
+      candidates_;             ///< Кандидаты в наиболее частые ключи
+  uint64_t min_estimate_ = 0;  ///< Нижняя граница наименьшей оценки набора
+};
+
+}
@@ -0,0 +1,187 @@
+#include "logon_session_index.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <limits>
+#include <tuple>
+
+namespace {
+
+/// @brief ID событий входа (Security 4624, XP 528/540)
+constexpr uint32_t kLogonIds[] = {4624, 528, 540};
+
+/// @brief ID событий выхода (Security 4634/4647, XP 538/551)
+constexpr uint32_t kLogoffIds[] = {4634, 4647, 538, 551};
+
+/// @brief Время выхода незавершенного сеанса
+constexpr uint64_t kOpenEnd = std::numeric_limits<uint64_t>::max();
+
+/// @brief Отсутствие открытого сеанса при построении индекса
+constexpr size_t kNoSession = std::numeric_limits<size_t>::max();
+
+/// @brief Разбирает число "0x..." (шестнадцатеричное) или десятичное
+bool parseNumber(std::string_view text, uint64_t& value) noexcept {
+  int base = 10;
+  if (text.starts_with("0x") || text.starts_with("0X")) {
+    text.remove_prefix(2);
+    base = 16;
+  }
+  const auto result =
+      std::from_chars(text.data(), text.data() + text.size(), value, base);
+  return !text.empty() && result.ec == std::errc{} &&
+         result.ptr == text.data() + text.size();
+}
+
+/// @brief Удаляет пробелы по краям
+std::string_view trimSpaces(std::string_view text) noexcept {
+  while (!text.empty() && text.front() == ' ') text.remove_prefix(1);
+  while (!text.empty() && text.back() == ' ') text.remove_suffix(1);
+  return text;
+}
+
+}
+
+namespace WindowsDiskAnalysis {
+
+uint64_t parseLogonId(std::string_view text) noexcept {
+  text = trimSpaces(text);
+
+  // EVT: "(0xСтаршая,0xМладшая)"
+  if (text.size() > 2 && text.front() == '(' && text.back() == ')') {
+    text = text.substr(1, text.size() - 2);
+    const size_t comma = text.find(',');
+    uint64_t high = 0;
+    uint64_t low = 0;
+    if (comma == std::string_view::npos ||
+        !parseNumber(trimSpaces(text.substr(0, comma)), high) ||
+        !parseNumber(trimSpaces(text.substr(comma + 1)), low) ||
+        high > 0xFFFFFFFF || low > 0xFFFFFFFF) {
+      return 0;
+    }
+    return high << 32 | low;
+  }
+
+  uint64_t value = 0;
+  return parseNumber(text, value) ? value : 0;
+}
+
+// Для EVT (528/538/551) поля передаются строками подстановки %1..%4
+// (ключи String0..String3): пользователь, домен, LogonId, тип входа
+LogonEventExtractor::LogonEventExtractor()
+    : layouts_({{"TargetLogonId", "String2"},
+                {"TargetUserName", "String0"},
+                {"TargetDomainName", "String1"},
+                {"LogonType", "String3"}}) {}
+
+void LogonEventExtractor::extract(const EventLogAnalysis::EventData& event,
+                                  std::vector<LogonEvent>& logons) {
+  const uint32_t event_id = event.getEventId();
+  const bool logoff = std::ranges::find(kLogoffIds, event_id) !=
+                      std::end(kLogoffIds);
+  if (!logoff &&
+      std::ranges::find(kLogonIds, event_id) == std::end(kLogonIds)) {
+    return;
+  }
+
+  const auto fields = event.getData();
+  const auto slots = layouts_.slotsOf(event_id, fields);
+  const auto value = [&](Role role) {
+    return EventFieldLayouts::valueAt(fields, slots[role]);
+  };
+
+  const uint64_t logon_id = parseLogonId(value(kLogonId));
+  if (logon_id == 0) {
+    return;
+  }
+
+  LogonEvent& logon = logons.emplace_back();
+  logon.logon_id = logon_id;
+  logon.time = event.getTimestamp();
+  logon.logoff = logoff;
+  if (logoff) {
+    return;
+  }
+
+  uint64_t logon_type = 0;
+  if (parseNumber(value(kLogonType), logon_type) && logon_type <= 0xFFFF) {
+    logon.logon_type = static_cast<uint32_t>(logon_type);
+  }
+  const std::string_view domain = value(kDomain);
+  if (!domain.empty() && domain != "-") {
+    logon.user.reserve(domain.size() + 1 + value(kUser).size());
+    logon.user.append(domain).append(1, '\\');
+  }
+  logon.user.append(value(kUser));
+}
+
+std::string LogonSessionIndex::Session::label() const {
+  if (logon_type == 0) {
+    return user;
+  }
+  return user + " (тип " + std::to_string(logon_type) + ")";
+}
+
+LogonSessionIndex::LogonSessionIndex(std::vector<LogonEvent> events) {
+  // Вход раньше выхода с тем же временем: иначе нулевой сеанс потеряется
+  std::ranges::sort(events, [](const LogonEvent& a, const LogonEvent& b) {
+    return std::tie(a.logon_id, a.time, a.logoff) <
+           std::tie(b.logon_id, b.time, b.logoff);
+  });
+
+  sessions_.reserve(events.size() / 2 + 1);
+  size_t open = kNoSession;  // Открытый сеанс текущего LogonId
+  for (size_t i = 0; i < events.size(); ++i) {
+    LogonEvent& event = events[i];
+    if (i > 0 && events[i - 1].logon_id != event.logon_id) {
+      open = kNoSession;
+    }
+
+    const bool has_open = open != kNoSession;
+    if (event.logoff) {
+      // Повторный выход (4647 и затем 4634) или выход без входа в
+      // сохранившейся части журнала пропускается
+      if (has_open) {
+        sessions_[open].end = event.time;
+        open = kNoSession;
+      }
+      continue;
+    }
+
+    // Новый вход с тем же LogonId (после перезагрузки) завершает прежний
+    if (has_open) {
+      sessions_[open].end = event.time;
+    }
+    open = sessions_.size();
+    sessions_.push_back({event.logon_id, event.time, kOpenEnd,
+                         event.logon_type, std::move(event.user)});
+  }
+}
+
+const LogonSessionIndex::Session* LogonSessionIndex::find(
+    uint64_t logon_id, uint64_t time) const noexcept {
+  // Последний сеанс этого LogonId, начавшийся не позже события
+  const auto after = std::ranges::upper_bound(
+      sessions_, std::tuple(logon_id, time), {},
+      [](const Session& session) {
+        return std::tuple(session.logon_id, session.start);
+      });
+  if (after != sessions_.begin()) {
+    const Session& session = *std::prev(after);
+    if (session.logon_id == logon_id && time <= session.end) {
+      return &session;
+    }
+  }
+
+  static const Session kServiceSessions[] = {
+      {0x3E7, 0, kOpenEnd, 0, "NT AUTHORITY\\SYSTEM"},
+      {0x3E4, 0, kOpenEnd, 0, "NT AUTHORITY\\NETWORK SERVICE"},
+      {0x3E5, 0, kOpenEnd, 0, "NT AUTHORITY\\LOCAL SERVICE"}};
+  for (const Session& session : kServiceSessions) {
+    if (session.logon_id == logon_id) {
+      return &session;
+    }
+  }
+  return nullptr;
+}
+
+}
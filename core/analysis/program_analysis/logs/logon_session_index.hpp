@@ -0,0 +1,95 @@
+/// @file logon_session_index.hpp
+/// @brief Сеансы входа в систему и их поиск по LogonId и времени
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../../../../parsers/event_log/model/event_data.hpp"
+#include "event_field_layouts.hpp"
+
+namespace WindowsDiskAnalysis {
+
+/// @brief Событие входа или выхода из системы
+struct LogonEvent {
+  uint64_t logon_id = 0;    ///< Идентификатор сеанса (LUID)
+  uint64_t time = 0;        ///< Время события (FILETIME)
+  uint32_t logon_type = 0;  ///< Тип входа (0 - неизвестен)
+  bool logoff = false;      ///< Событие выхода
+  std::string user;         ///< Пользователь "ДОМЕН\имя" (для входа)
+};
+
+/// @brief Разбирает LogonId из события
+/// @details Поддерживаются записи "0x3e7" (EVTX) и "(0x0,0x3E7)" (EVT)
+/// @param text Значение поля
+/// @return Идентификатор сеанса или 0, если значение не разобрано
+[[nodiscard]] uint64_t parseLogonId(std::string_view text) noexcept;
+
+/// @class LogonEventExtractor
+/// @brief Извлекает события входа и выхода (4624/4634/4647, 528/538/551)
+/// @details Поля читаются по позициям раскладки (см. EventFieldLayouts).
+/// Экземпляр не потокобезопасен: каждая задача разбора создает свой.
+class LogonEventExtractor {
+ public:
+  /// @brief Конструктор
+  LogonEventExtractor();
+
+  /// @brief Добавляет событие входа или выхода
+  /// @param event Событие
+  /// @param logons События входа журнала
+  void extract(const EventLogAnalysis::EventData& event,
+               std::vector<LogonEvent>& logons);
+
+ private:
+  /// @brief Извлекаемое поле события
+  enum Role : size_t { kLogonId, kUser, kDomain, kLogonType };
+
+  EventFieldLayouts layouts_;  ///< Позиции полей по раскладкам
+};
+
+/// @class LogonSessionIndex
+/// @brief Интервальный индекс сеансов входа
+/// @details События входа и выхода сортируются по (LogonId, время) один
+/// раз, после чего проход по каждому LogonId превращает их в интервалы
+/// [вход, выход). Повторное использование LogonId после перезагрузки дает
+/// несколько непересекающихся интервалов одного идентификатора. Поиск
+/// сеанса по LogonId и времени - двоичный поиск, O(log n), поэтому
+/// соединение с событиями о процессах не квадратично по числу входов.
+class LogonSessionIndex {
+ public:
+  /// @brief Сеанс входа
+  struct Session {
+    uint64_t logon_id = 0;    ///< Идентификатор сеанса
+    uint64_t start = 0;       ///< Время входа (FILETIME)
+    uint64_t end = 0;         ///< Время выхода (UINT64_MAX - не завершен)
+    uint32_t logon_type = 0;  ///< Тип входа (0 - неизвестен)
+    std::string user;         ///< Пользователь "ДОМЕН\имя"
+
+    /// @brief Возвращает описание сеанса "пользователь (тип N)"
+    [[nodiscard]] std::string label() const;
+  };
+
+  /// @brief Строит индекс
+  /// @param events События входа и выхода всех журналов
+  explicit LogonSessionIndex(std::vector<LogonEvent> events);
+
+  /// @brief Находит сеанс, в котором произошло событие
+  /// @details Для встроенных сеансов служб (SYSTEM, LOCAL SERVICE,
+  /// NETWORK SERVICE) без событий входа возвращается постоянный сеанс
+  /// @param logon_id Идентификатор сеанса события
+  /// @param time Время события (FILETIME)
+  /// @return Сеанс или nullptr
+  [[nodiscard]] const Session* find(uint64_t logon_id,
+                                    uint64_t time) const noexcept;
+
+  /// @brief Возвращает количество сеансов
+  [[nodiscard]] size_t size() const noexcept { return sessions_.size(); }
+
+ private:
+  std::vector<Session> sessions_;  ///< Сеансы по (LogonId, время входа)
+};
+
+}
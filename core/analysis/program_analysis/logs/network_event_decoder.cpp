@@ -0,0 +1,83 @@
+#include "network_event_decoder.hpp"
+
+#include <charconv>
+
+#include "process_event_extractor.hpp"
+
+namespace {
+
+/// @brief Разбирает десятичное число, занимающее все поле
+template <typename T>
+bool parseNumber(std::string_view text, T& value) noexcept {
+  const auto result =
+      std::from_chars(text.data(), text.data() + text.size(), value);
+  return result.ec == std::errc{} && result.ptr == text.data() + text.size();
+}
+
+/// @brief Сравнивает строки без учета регистра ASCII
+bool equalsIgnoreCase(std::string_view text, std::string_view lower) noexcept {
+  if (text.size() != lower.size()) return false;
+  for (size_t i = 0; i < text.size(); ++i) {
+    const char c = text[i];
+    if ((c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c) !=
+        lower[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// @brief Возвращает номер протокола IANA по числу или названию (Sysmon)
+uint8_t parseProtocol(std::string_view text) noexcept {
+  if (uint8_t number = 0; parseNumber(text, number)) return number;
+  if (equalsIgnoreCase(text, "tcp")) return 6;
+  if (equalsIgnoreCase(text, "udp")) return 17;
+  if (equalsIgnoreCase(text, "icmp")) return 1;
+  return 0;
+}
+
+}
+
+namespace WindowsDiskAnalysis {
+
+NetworkEventDecoder::NetworkEventDecoder()
+    : layouts_({{"Application", "Image"},
+                {"SourceAddress", "SourceIp"},
+                {"DestAddress", "DestinationIp", "Address", "Param3",
+                 "IpAddress"},
+                {"DestPort", "DestinationPort"},
+                {"Protocol"}}) {}
+
+void NetworkEventDecoder::decode(const EventLogAnalysis::EventData& event,
+                                 NetworkFlowTable& flows) {
+  const auto fields = event.getData();
+  const auto slots = layouts_.slotsOf(event.getEventId(), fields);
+  const auto value = [&](Role role) {
+    return EventFieldLayouts::valueAt(fields, slots[role]);
+  };
+
+  // Адрес, не являющийся IP (например, имя узла), сохраняется текстом
+  const auto address = [&flows](std::string_view text) {
+    if (text.empty() || text == "-") return IpAddress{};
+    if (const auto parsed = IpAddress::parse(text)) return *parsed;
+    return IpAddress::text(flows.intern(text));
+  };
+
+  NetworkFlowKey key;
+  key.remote = address(value(kRemote));
+  const std::string_view process = value(kProcess);
+  if (process.empty() && key.remote.family == IpAddress::Family::None) {
+    return;
+  }
+
+  normalizeImagePath(process, process_);
+  key.process = flows.intern(process_);
+  key.local = address(value(kLocal));
+  key.protocol = parseProtocol(value(kProtocol));
+  if (uint16_t port = 0; parseNumber(value(kPort), port)) {
+    key.port = port;
+  }
+  flows.record(key, event.getTimestamp());
+}
+
+}
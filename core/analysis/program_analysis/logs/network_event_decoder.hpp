@@ -0,0 +1,40 @@
+/// @file network_event_decoder.hpp
+/// @brief Разбор событий о сетевых подключениях в потоки
+
+#pragma once
+
+#include <string>
+
+#include "../../../../parsers/event_log/model/event_data.hpp"
+#include "event_field_layouts.hpp"
+#include "network_flow.hpp"
+
+namespace WindowsDiskAnalysis {
+
+/// @class NetworkEventDecoder
+/// @brief Извлекает сетевой поток из события и учитывает его в таблице
+/// @details Поля процесса, адресов, порта и протокола (WFP 5156/5157,
+/// Sysmon 3, RDP 1149 и т.п.) читаются по позициям раскладки (см.
+/// EventFieldLayouts). Адреса и порт разбираются в двоичный вид на месте,
+/// так что событие уже известного потока не выделяет память.
+/// Экземпляр не потокобезопасен: каждая задача разбора создает свой.
+class NetworkEventDecoder {
+ public:
+  /// @brief Конструктор
+  NetworkEventDecoder();
+
+  /// @brief Учитывает сетевое событие в таблице потоков
+  /// @param event Событие
+  /// @param flows Таблица потоков журнала
+  void decode(const EventLogAnalysis::EventData& event,
+              NetworkFlowTable& flows);
+
+ private:
+  /// @brief Извлекаемое поле события
+  enum Role : size_t { kProcess, kLocal, kRemote, kPort, kProtocol };
+
+  EventFieldLayouts layouts_;  ///< Позиции полей по раскладкам
+  std::string process_;        ///< Буфер нормализованного пути процесса
+};
+
+}
@@ -0,0 +1,337 @@
+#include "network_flow.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <tuple>
+
+#include "../../../../utils/time/filetime_formatter.hpp"
+
+namespace {
+
+/// @brief Префикс IPv6-адреса с отображенным IPv4 (::ffff:0:0/96)
+constexpr uint8_t kMappedPrefix[12] = {0, 0, 0, 0, 0,    0,
+                                       0, 0, 0, 0, 0xFF, 0xFF};
+
+/// @brief Разбирает IPv4 в точечной записи
+bool parseV4(std::string_view text, uint8_t* out) noexcept {
+  for (int part = 0; part < 4; ++part) {
+    if (part > 0) {
+      if (text.empty() || text.front() != '.') return false;
+      text.remove_prefix(1);
+    }
+    unsigned value = 0;
+    size_t digits = 0;
+    while (digits < text.size() && text[digits] >= '0' && text[digits] <= '9') {
+      value = value * 10 + static_cast<unsigned>(text[digits] - '0');
+      if (++digits > 3) return false;
+    }
+    if (digits == 0 || value > 255) return false;
+    out[part] = static_cast<uint8_t>(value);
+    text.remove_prefix(digits);
+  }
+  return text.empty();
+}
+
+/// @brief Возвращает значение шестнадцатеричной цифры или -1
+int hexDigit(char c) noexcept {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+/// @brief Разбирает IPv6 с сокращением "::" и встроенным IPv4
+bool parseV6(std::string_view text, uint8_t* out) noexcept {
+  uint16_t groups[8] = {};
+  int count = 0;
+  int gap = -1;  // Позиция сокращения "::" среди групп
+
+  if (text.starts_with("::")) {
+    gap = 0;
+    text.remove_prefix(2);
+  } else if (text.starts_with(':')) {
+    return false;
+  }
+
+  while (!text.empty()) {
+    // Последние 32 бита могут быть записаны как IPv4
+    if (text.find(':') == std::string_view::npos &&
+        text.find('.') != std::string_view::npos) {
+      uint8_t v4[4];
+      if (count > 6 || !parseV4(text, v4)) return false;
+      groups[count++] = static_cast<uint16_t>(v4[0] << 8 | v4[1]);
+      groups[count++] = static_cast<uint16_t>(v4[2] << 8 | v4[3]);
+      break;
+    }
+
+    if (count == 8) return false;
+    unsigned value = 0;
+    size_t digits = 0;
+    while (digits < text.size()) {
+      const int digit = hexDigit(text[digits]);
+      if (digit < 0) break;
+      value = value << 4 | static_cast<unsigned>(digit);
+      if (++digits > 4) return false;
+    }
+    if (digits == 0) return false;
+    groups[count++] = static_cast<uint16_t>(value);
+    text.remove_prefix(digits);
+
+    if (text.empty()) break;
+    if (text.front() != ':') return false;
+    text.remove_prefix(1);
+    if (text.starts_with(':')) {
+      if (gap >= 0) return false;
+      gap = count;
+      text.remove_prefix(1);
+    } else if (text.empty()) {
+      return false;
+    }
+  }
+
+  if (gap < 0 ? count != 8 : count > 7) return false;
+
+  uint16_t expanded[8] = {};
+  if (gap < 0) {
+    std::copy_n(groups, 8, expanded);
+  } else {
+    std::copy_n(groups, gap, expanded);
+    std::copy(groups + gap, groups + count, expanded + 8 - (count - gap));
+  }
+  for (int i = 0; i < 8; ++i) {
+    out[2 * i] = static_cast<uint8_t>(expanded[i] >> 8);
+    out[2 * i + 1] = static_cast<uint8_t>(expanded[i]);
+  }
+  return true;
+}
+
+/// @brief Дописывает IPv4 в точечной записи
+void formatV4(const uint8_t* bytes, std::string& out) {
+  char buffer[4];
+  for (int i = 0; i < 4; ++i) {
+    if (i > 0) out += '.';
+    const auto result =
+        std::to_chars(buffer, buffer + sizeof(buffer), bytes[i]);
+    out.append(buffer, result.ptr);
+  }
+}
+
+/// @brief Дописывает IPv6 в канонической записи RFC 5952
+void formatV6(const uint8_t* bytes, std::string& out) {
+  if (std::equal(std::begin(kMappedPrefix), std::end(kMappedPrefix), bytes)) {
+    out += "::ffff:";
+    formatV4(bytes + 12, out);
+    return;
+  }
+
+  uint16_t groups[8];
+  for (int i = 0; i < 8; ++i) {
+    groups[i] = static_cast<uint16_t>(bytes[2 * i] << 8 | bytes[2 * i + 1]);
+  }
+
+  // Сокращается самая длинная (первая из равных) серия из 2+ нулевых групп
+  int best_start = -1;
+  int best_length = 1;
+  for (int i = 0; i < 8;) {
+    if (groups[i] != 0) {
+      ++i;
+      continue;
+    }
+    int end = i;
+    while (end < 8 && groups[end] == 0) ++end;
+    if (end - i > best_length) {
+      best_start = i;
+      best_length = end - i;
+    }
+    i = end;
+  }
+
+  char buffer[4];
+  for (int i = 0; i < 8; ++i) {
+    if (i == best_start) {
+      out += "::";
+      i += best_length - 1;
+      continue;
+    }
+    if (i > 0 && i != best_start + best_length) out += ':';
+    const auto result =
+        std::to_chars(buffer, buffer + sizeof(buffer), groups[i], 16);
+    out.append(buffer, result.ptr);
+  }
+}
+
+}
+
+namespace WindowsDiskAnalysis {
+
+std::optional<IpAddress> IpAddress::parse(std::string_view text) noexcept {
+  if (text.size() > 2 && text.front() == '[' && text.back() == ']') {
+    text = text.substr(1, text.size() - 2);
+  }
+  if (const size_t zone = text.find('%'); zone != std::string_view::npos) {
+    text = text.substr(0, zone);
+  }
+
+  IpAddress address;
+  if (text.find(':') != std::string_view::npos) {
+    if (!parseV6(text, address.bytes.data())) return std::nullopt;
+    address.family = Family::V6;
+  } else {
+    if (!parseV4(text, address.bytes.data())) return std::nullopt;
+    address.family = Family::V4;
+  }
+  return address;
+}
+
+IpAddress IpAddress::text(uint32_t index) noexcept {
+  IpAddress address;
+  address.family = Family::Text;
+  std::memcpy(address.bytes.data(), &index, sizeof(index));
+  return address;
+}
+
+uint32_t IpAddress::textIndex() const noexcept {
+  uint32_t index = 0;
+  std::memcpy(&index, bytes.data(), sizeof(index));
+  return index;
+}
+
+void IpAddress::format(std::string& out) const {
+  switch (family) {
+    case Family::V4:
+      formatV4(bytes.data(), out);
+      break;
+    case Family::V6:
+      formatV6(bytes.data(), out);
+      break;
+    case Family::None:
+    case Family::Text:
+      break;
+  }
+}
+
+size_t NetworkFlowKeyHash::operator()(
+    const NetworkFlowKey& key) const noexcept {
+  uint64_t hash = 14695981039346656037ULL;
+  const auto mix = [&hash](const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+      hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+  };
+  mix(&key.process, sizeof(key.process));
+  mix(&key.port, sizeof(key.port));
+  mix(&key.protocol, sizeof(key.protocol));
+  for (const IpAddress* address : {&key.local, &key.remote}) {
+    mix(&address->family, sizeof(address->family));
+    mix(address->bytes.data(), address->family == IpAddress::Family::V6
+                                   ? address->bytes.size()
+                                   : sizeof(uint32_t));
+  }
+  return static_cast<size_t>(hash);
+}
+
+void NetworkFlowStats::add(uint64_t time) noexcept {
+  count++;
+  first_seen = std::min(first_seen, time);
+  last_seen = std::max(last_seen, time);
+}
+
+void NetworkFlowStats::merge(const NetworkFlowStats& other) noexcept {
+  count += other.count;
+  first_seen = std::min(first_seen, other.first_seen);
+  last_seen = std::max(last_seen, other.last_seen);
+}
+
+uint32_t NetworkFlowTable::intern(std::string_view text) {
+  if (const auto found = string_index_.find(text);
+      found != string_index_.end()) {
+    return found->second;
+  }
+  const auto index = static_cast<uint32_t>(strings_.size());
+  strings_.emplace_back(text);
+  string_index_.emplace(strings_.back(), index);
+  return index;
+}
+
+void NetworkFlowTable::record(const NetworkFlowKey& key, uint64_t time) {
+  flows_[key].add(time);
+}
+
+void NetworkFlowTable::add(const NetworkFlowKey& key,
+                           const NetworkFlowStats& stats) {
+  flows_[key].merge(stats);
+}
+
+void NetworkFlowTable::merge(const NetworkFlowTable& other) {
+  // Индексы строк другой таблицы переводятся один раз, а не для каждого потока
+  std::vector<uint32_t> indices;
+  indices.reserve(other.strings_.size());
+  for (const auto& text : other.strings_) indices.push_back(intern(text));
+
+  for (const auto& [key, stats] : other.flows_) {
+    NetworkFlowKey mapped = key;
+    mapped.process = indices[key.process];
+    for (IpAddress* address : {&mapped.local, &mapped.remote}) {
+      if (address->family == IpAddress::Family::Text) {
+        *address = IpAddress::text(indices[address->textIndex()]);
+      }
+    }
+    add(mapped, stats);
+  }
+}
+
+std::vector<NetworkConnection> NetworkFlowTable::connections() const {
+  const auto format = [this](const IpAddress& address, std::string& out) {
+    if (address.family == IpAddress::Family::Text) {
+      out = strings_[address.textIndex()];
+    } else {
+      address.format(out);
+    }
+  };
+
+  FiletimeFormatter formatter;
+  std::vector<NetworkConnection> result;
+  result.reserve(flows_.size());
+  for (const auto& [key, stats] : flows_) {
+    NetworkConnection& connection = result.emplace_back();
+    connection.process_name = strings_[key.process];
+    format(key.local, connection.local_address);
+    format(key.remote, connection.remote_address);
+    connection.port = key.port;
+    connection.protocol = protocolName(key.protocol);
+    connection.event_count = stats.count;
+    connection.first_seen = formatter.toString(stats.first_seen);
+    connection.last_seen = formatter.toString(stats.last_seen);
+  }
+
+  // Порядок хеш-таблицы не определен; сортировка делает вывод стабильным
+  std::ranges::sort(result, [](const NetworkConnection& a,
+                               const NetworkConnection& b) {
+    return std::tie(a.process_name, a.protocol, a.local_address,
+                    a.remote_address, a.port) <
+           std::tie(b.process_name, b.protocol, b.local_address,
+                    b.remote_address, b.port);
+  });
+  return result;
+}
+
+std::string protocolName(uint8_t protocol) {
+  switch (protocol) {
+    case 0:
+      return {};
+    case 1:
+      return "ICMP";
+    case 6:
+      return "TCP";
+    case 17:
+      return "UDP";
+    case 58:
+      return "ICMPv6";
+    default:
+      return std::to_string(protocol);
+  }
+}
+
+}
@@ -0,0 +1,154 @@
+/// @file network_flow.hpp
+/// @brief Агрегация сетевых событий по потокам
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../data/analysis_data.hpp"
+
+namespace WindowsDiskAnalysis {
+
+/// @brief IP-адрес в двоичном виде
+/// @details IPv4 хранится в первых 4 байтах, IPv6 - во всех 16. Адрес,
+/// который не удалось разобрать (имя узла и т.п.), хранится как индекс
+/// строки в таблице потоков (Family::Text)
+struct IpAddress {
+  /// @brief Вид адреса
+  enum class Family : uint8_t { None, V4, V6, Text };
+
+  Family family = Family::None;    ///< Вид адреса
+  std::array<uint8_t, 16> bytes{};  ///< Байты адреса в сетевом порядке
+
+  /// @brief Разбирает текстовую запись IPv4 или IPv6 без выделения памяти
+  /// @details Допускаются сокращение "::", встроенный IPv4, квадратные
+  /// скобки и суффикс зоны "%N", который отбрасывается
+  /// @param text Текст адреса
+  /// @return Адрес или std::nullopt, если текст не является IP-адресом
+  [[nodiscard]] static std::optional<IpAddress> parse(
+      std::string_view text) noexcept;
+
+  /// @brief Создает адрес, ссылающийся на строку таблицы потоков
+  /// @param index Индекс строки
+  [[nodiscard]] static IpAddress text(uint32_t index) noexcept;
+
+  /// @brief Возвращает индекс строки для адреса Family::Text
+  [[nodiscard]] uint32_t textIndex() const noexcept;
+
+  /// @brief Дописывает текстовую запись адреса (IPv6 по RFC 5952)
+  /// @details Для None и Text ничего не дописывает: строка Text хранится в
+  /// таблице потоков
+  /// @param out Строка результата
+  void format(std::string& out) const;
+
+  /// @brief Сравнивает адреса
+  bool operator==(const IpAddress&) const = default;
+};
+
+/// @brief Ключ сетевого потока
+struct NetworkFlowKey {
+  uint32_t process = 0;  ///< Индекс пути процесса в таблице строк
+  uint16_t port = 0;     ///< Порт назначения
+  uint8_t protocol = 0;  ///< Номер протокола IANA (0 - не указан)
+  IpAddress local;       ///< Локальный адрес
+  IpAddress remote;      ///< Удаленный адрес
+
+  /// @brief Сравнивает ключи
+  bool operator==(const NetworkFlowKey&) const = default;
+};
+
+/// @brief Хеш ключа сетевого потока
+struct NetworkFlowKeyHash {
+  /// @brief Вычисляет хеш ключа (FNV-1a по полям)
+  [[nodiscard]] size_t operator()(const NetworkFlowKey& key) const noexcept;
+};
+
+/// @brief Статистика сетевого потока
+struct NetworkFlowStats {
+  uint64_t count = 0;  ///< Количество событий
+  uint64_t first_seen =
+      std::numeric_limits<uint64_t>::max();  ///< Первое событие (FILETIME)
+  uint64_t last_seen = 0;  ///< Последнее событие (FILETIME)
+
+  /// @brief Учитывает событие потока
+  /// @param time Время события (FILETIME)
+  void add(uint64_t time) noexcept;
+
+  /// @brief Объединяет статистику двух частей одного потока
+  void merge(const NetworkFlowStats& other) noexcept;
+};
+
+/// @class NetworkFlowTable
+/// @brief Хеш-таблица сетевых потоков
+/// @details Каждое событие увеличивает счетчик потока с ключом (процесс,
+/// протокол, локальный адрес, удаленный адрес, порт), поэтому размер
+/// таблицы определяется числом уникальных потоков, а не числом событий.
+/// Пути процессов и неразобранные адреса хранятся в таблице строк один раз:
+/// индекс строк ссылается на элементы таблицы, адреса которых в std::deque
+/// не меняются при добавлении. Поэтому таблица перемещается, но не копируется
+class NetworkFlowTable {
+ public:
+  NetworkFlowTable() = default;
+  NetworkFlowTable(const NetworkFlowTable&) = delete;
+  NetworkFlowTable& operator=(const NetworkFlowTable&) = delete;
+  NetworkFlowTable(NetworkFlowTable&&) = default;
+  NetworkFlowTable& operator=(NetworkFlowTable&&) = default;
+
+  /// @brief Потоки по ключам
+  using Flows =
+      std::unordered_map<NetworkFlowKey, NetworkFlowStats, NetworkFlowKeyHash>;
+
+  /// @brief Возвращает индекс строки, добавляя ее при первом появлении
+  /// @param text Строка
+  [[nodiscard]] uint32_t intern(std::string_view text);
+
+  /// @brief Учитывает событие потока
+  /// @param key Ключ потока
+  /// @param time Время события (FILETIME)
+  void record(const NetworkFlowKey& key, uint64_t time);
+
+  /// @brief Добавляет статистику потока
+  /// @param key Ключ потока
+  /// @param stats Статистика
+  void add(const NetworkFlowKey& key, const NetworkFlowStats& stats);
+
+  /// @brief Добавляет потоки другой таблицы с перенумерацией строк
+  /// @param other Таблица другого журнала
+  void merge(const NetworkFlowTable& other);
+
+  /// @brief Возвращает таблицу строк
+  [[nodiscard]] const std::deque<std::string>& strings() const noexcept {
+    return strings_;
+  }
+
+  /// @brief Возвращает потоки
+  [[nodiscard]] const Flows& flows() const noexcept { return flows_; }
+
+  /// @brief Проверяет отсутствие потоков
+  [[nodiscard]] bool empty() const noexcept { return flows_.empty(); }
+
+  /// @brief Преобразует потоки в записи о подключениях
+  /// @return Записи, упорядоченные по процессу, адресам и порту
+  [[nodiscard]] std::vector<NetworkConnection> connections() const;
+
+ private:
+  std::deque<std::string> strings_;  ///< Таблица строк
+  std::unordered_map<std::string_view, uint32_t>
+      string_index_;  ///< Индексы строк (ссылки на strings_)
+  Flows flows_;       ///< Потоки
+};
+
+/// @brief Возвращает название протокола по номеру IANA
+/// @param protocol Номер протокола (0 - не указан)
+[[nodiscard]] std::string protocolName(uint8_t protocol);
+
+}
@@ -0,0 +1,167 @@
+#include "process_event_extractor.hpp"
+
+#include <algorithm>
+
+#include "../../../../utils/time/filetime_formatter.hpp"
+
+namespace {
+
+/// @brief ID событий создания процесса (Security 4688, XP 592, Sysmon 1)
+constexpr uint32_t kProcessCreationIds[] = {4688, 592, 1};
+
+}
+
+namespace WindowsDiskAnalysis {
+
+void normalizeImagePath(std::string_view path, std::string& normalized) {
+  for (const std::string_view prefix : {R"(\??\)", R"(\\?\)"}) {
+    if (path.starts_with(prefix)) {
+      path.remove_prefix(prefix.size());
+      break;
+    }
+  }
+
+  normalized.resize(path.size());
+  std::ranges::transform(path, normalized.begin(), [](char c) {
+    if (c == '/') return '\\';
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+  });
+}
+
+// Для EVT (592/593) путь к образу передается второй строкой подстановки
+// (%2, ключ String1), LogonId создателя - шестой (%6, ключ String5)
+ProcessEventExtractor::ProcessEventExtractor()
+    : layouts_({{"NewProcessName", "ProcessName", "Image", "String1"},
+                {"CommandLine"},
+                {"SubjectLogonId", "LogonId", "String5"},
+                {"TargetLogonId"}}) {}
+
+void ProcessEventExtractor::extract(const EventLogAnalysis::EventData& event,
+                                    EventLogBuffer& buffer) {
+  const auto fields = event.getData();
+  const auto slots = layouts_.slotsOf(event.getEventId(), fields);
+  const auto value = [&](Role role) {
+    return EventFieldLayouts::valueAt(fields, slots[role]);
+  };
+
+  const std::string_view image = value(kImage);
+  if (image.empty()) {
+    return;
+  }
+
+  normalizeImagePath(image, key_);
+  auto found = buffer.processes.find(std::string_view(key_));
+  if (found == buffer.processes.end()) {
+    found = buffer.processes.emplace(key_, ProcessEventGroup{}).first;
+    found->second.image = image;
+  }
+
+  ProcessEventGroup& group = found->second;
+  if (group.command.empty()) group.command = value(kCommand);
+  if (std::ranges::find(kProcessCreationIds, event.getEventId()) !=
+      std::end(kProcessCreationIds)) {
+    // Процесс выполняется в сеансе TargetLogonId, если он указан (4688
+    // начиная с Windows 10), иначе в сеансе создателя
+    uint64_t logon_id = parseLogonId(value(kTargetLogonId));
+    if (logon_id == 0) logon_id = parseLogonId(value(kSubjectLogonId));
+    group.creation_times.push_back(event.getTimestamp());
+    group.logon_ids.push_back(logon_id);
+  }
+}
+
+ProcessDataIndex::ProcessDataIndex(
+    std::map<std::string, ProcessInfo>& process_data)
+    : process_data_(process_data) {
+  by_path_.reserve(process_data_.size());
+  std::string key;
+  for (auto& [name, info] : process_data_) {
+    normalizeImagePath(name, key);
+    by_path_.try_emplace(key, &info);
+  }
+}
+
+void ProcessDataIndex::join(ProcessEventGroups&& groups,
+                            const LogonSessionIndex& sessions) {
+  FiletimeFormatter formatter;
+  for (auto& [key, group] : groups) {
+    ProcessInfo* info = &resolve(key, group.image);
+    if (info->command.empty() && !group.command.empty()) {
+      info->command = std::move(group.command);
+    }
+    formatter.appendBatch(group.creation_times, info->run_times);
+    for (size_t i = 0; i < group.creation_times.size(); ++i) {
+      const auto* session =
+          sessions.find(group.logon_ids[i], group.creation_times[i]);
+      if (!session) continue;
+      std::string label = session->label();
+      if (std::ranges::find(info->logon_sessions, label) ==
+          info->logon_sessions.end()) {
+        info->logon_sessions.push_back(std::move(label));
+      }
+    }
+    info->run_count += static_cast<uint32_t>(group.creation_times.size());
+  }
+}
+
+void ProcessDataIndex::join(const SysmonActivityTable& activity) {
+  const auto& strings = activity.strings();
+  const auto append = [&strings](const std::unordered_set<uint32_t>& indices,
+                                 std::vector<std::string>& values) {
+    values.reserve(values.size() + indices.size());
+    for (const uint32_t index : indices) values.push_back(strings[index]);
+    std::ranges::sort(values);
+    const auto duplicates = std::ranges::unique(values);
+    values.erase(duplicates.begin(), duplicates.end());
+  };
+
+  FiletimeFormatter formatter;
+  std::vector<const SysmonRecord*> records;
+  for (const auto& [key, stats] : activity.images()) {
+    SysmonActivity& sysmon = resolve(strings[key], strings[stats.image]).sysmon;
+    sysmon.event_count += stats.events;
+    sysmon.image_loads += stats.image_loads;
+    sysmon.file_creates += stats.file_creates;
+    sysmon.registry_sets += stats.registry_sets;
+    sysmon.dns_queries += stats.dns_queries;
+
+    // Время в формате "ГГГГ-ММ-ДД чч:мм:сс" упорядочено как строка
+    const std::string first = formatter.toString(stats.first_seen);
+    const std::string last = formatter.toString(stats.last_seen);
+    if (sysmon.first_seen.empty() || first < sysmon.first_seen) {
+      sysmon.first_seen = first;
+    }
+    sysmon.last_seen = std::max(sysmon.last_seen, last);
+
+    append(stats.hashes, sysmon.hashes);
+    append(stats.modules, sysmon.loaded_modules);
+    append(stats.domains, sysmon.dns_names);
+
+    records.clear();
+    for (const auto& record : stats.records) records.push_back(&record);
+    std::ranges::stable_sort(records, {}, &SysmonRecord::time);
+    for (const SysmonRecord* record : records) {
+      sysmon.events.push_back("ID " + std::to_string(record->event_id) + " " +
+                              formatter.toString(record->time) + ": " +
+                              record->details);
+    }
+  }
+}
+
+ProcessInfo& ProcessDataIndex::resolve(const std::string& key,
+                                       const std::string& image) {
+  ProcessInfo* info = nullptr;
+  if (const auto found = by_path_.find(std::string_view(key));
+      found != by_path_.end()) {
+    info = found->second;
+  } else {
+    info = &process_data_[image];
+    by_path_.emplace(key, info);
+  }
+
+  if (info->filename.empty()) {
+    info->filename = image;
+  }
+  return *info;
+}
+
+}
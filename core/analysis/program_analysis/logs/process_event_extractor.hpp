@@ -0,0 +1,92 @@
+/// @file process_event_extractor.hpp
+/// @brief Извлечение событий о процессах и соединение с данными о процессах
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "../../../../parsers/event_log/model/event_data.hpp"
+#include "../data/analysis_data.hpp"
+#include "event_field_layouts.hpp"
+#include "eventlog_checkpoint.hpp"
+#include "logon_session_index.hpp"
+#include "sysmon_activity.hpp"
+
+namespace WindowsDiskAnalysis {
+
+/// @brief Нормализует путь к образу для сопоставления
+/// @details Нижний регистр ASCII, разделитель "\", без префиксов "\??\" и
+/// "\\?\"
+/// @param path Путь из события
+/// @param normalized Буфер результата (перезаписывается)
+void normalizeImagePath(std::string_view path, std::string& normalized);
+
+/// @class ProcessEventExtractor
+/// @brief Извлекает поля событий о процессах по их позициям
+/// @details Поля образа, командной строки, родительского процесса и SID
+/// субъекта (4688/4689, 592/593, Sysmon 1) читаются по позициям раскладки
+/// (см. EventFieldLayouts). События группируются по нормализованному пути
+/// образа; для уже известного образа событие не выделяет память.
+/// Экземпляр не потокобезопасен: каждая задача разбора создает свой.
+class ProcessEventExtractor {
+ public:
+  /// @brief Конструктор
+  ProcessEventExtractor();
+
+  /// @brief Добавляет событие о процессе в буфер
+  /// @param event Событие
+  /// @param buffer Буфер результатов журнала
+  void extract(const EventLogAnalysis::EventData& event,
+               EventLogBuffer& buffer);
+
+ private:
+  /// @brief Извлекаемое поле события
+  enum Role : size_t { kImage, kCommand, kSubjectLogonId, kTargetLogonId };
+
+  EventFieldLayouts layouts_;  ///< Позиции полей по раскладкам
+  std::string key_;            ///< Буфер нормализованного пути
+};
+
+/// @class ProcessDataIndex
+/// @brief Хеш-индекс данных о процессах по нормализованному пути образа
+/// @details Строится один раз по уже собранным данным (Prefetch) и
+/// пополняется новыми образами, так что группа событий соединяется с
+/// записью за O(1) вместо поиска в упорядоченной карте по исходному пути.
+/// Пути, различающиеся регистром или префиксом, попадают в одну запись.
+class ProcessDataIndex {
+ public:
+  /// @brief Строит индекс
+  /// @param process_data Карта данных о процессах (пополняется при join)
+  explicit ProcessDataIndex(std::map<std::string, ProcessInfo>& process_data);
+
+  /// @brief Соединяет группы событий журнала с данными о процессах
+  /// @details Командная строка заполняется, если еще пуста; время каждого
+  /// события создания добавляется к запускам, а сеанс входа, в котором
+  /// создан процесс, - к сеансам процесса
+  /// @param groups Группы событий по нормализованному пути образа
+  /// @param sessions Индекс сеансов входа
+  void join(ProcessEventGroups&& groups, const LogonSessionIndex& sessions);
+
+  /// @brief Добавляет к данным о процессах активность по Sysmon
+  /// @details Счетчики суммируются, множества объединяются и сортируются,
+  /// сохраненные события выводятся в порядке времени
+  /// @param activity Активность образов всех журналов Sysmon
+  void join(const SysmonActivityTable& activity);
+
+ private:
+  /// @brief Возвращает запись процесса, создавая ее для нового образа
+  /// @param key Нормализованный путь к образу
+  /// @param image Исходный путь к образу
+  [[nodiscard]] ProcessInfo& resolve(const std::string& key,
+                                     const std::string& image);
+
+
+  std::map<std::string, ProcessInfo>& process_data_;  ///< Данные о процессах
+  std::unordered_map<std::string, ProcessInfo*, StringKeyHash, std::equal_to<>>
+      by_path_;  ///< Записи по нормализованному пути
+};
+
+}
@@ -0,0 +1,766 @@
+#include "provider_message_resolver.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include "../../../../parsers/event_log/formats/common/crc32.hpp"
+#include "../../../../parsers/event_log/formats/common/mapped_file.hpp"
+#include "../../../../utils/config/config.hpp"
+#include "../../../../utils/logging/logger.hpp"
+#include "../../../../utils/utils.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char kMagic[8] = {'E', 'v', 't', 'M', 's', 'g', 'C', '1'};
+
+/// @brief Раздел издателей манифестов в кусте SOFTWARE
+constexpr std::string_view kPublishersKey =
+    "Microsoft/Windows/CurrentVersion/WINEVT/Publishers";
+
+/// @brief Размер заголовка куста, входящего в сумму образа для кэша
+constexpr size_t kHiveHeaderSize = 4096;
+
+/// @brief Возможные значения серьезности в старших битах ID сообщения
+constexpr uint32_t kSeverities[] = {0x40000000, 0x80000000, 0xC0000000};
+
+/// @brief Язык файлов локализации, проверяемый первым
+constexpr std::string_view kPreferredLocale = "en-US";
+
+/// @brief Переменные окружения путей к файлам сообщений
+constexpr std::pair<std::string_view, std::string_view> kPathVariables[] = {
+    {"%systemroot%", "Windows"},
+    {"%windir%", "Windows"},
+    {"%systemdrive%", ""},
+    {"%programfiles%", "Program Files"},
+    {"%programfiles(x86)%", "Program Files (x86)"},
+    {"%commonprogramfiles%", "Program Files/Common Files"},
+    {"%programdata%", "ProgramData"},
+    {"/systemroot", "Windows"},
+    {"//?/", ""},
+    {"/\?\?/", ""}};
+
+/// @brief Последовательная запись полей кэша
+class CacheWriter {
+ public:
+  template <typename T>
+  void value(T value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    out_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  void string(std::string_view text) {
+    value(static_cast<uint32_t>(text.size()));
+    out_ += text;
+  }
+
+  [[nodiscard]] const std::string& bytes() const noexcept { return out_; }
+
+ private:
+  std::string out_;
+};
+
+/// @brief Последовательное чтение полей кэша
+/// @details Выход за конец данных означает поврежденный файл
+class CacheReader {
+ public:
+  explicit CacheReader(const std::string& bytes) : bytes_(bytes) {}
+
+  template <typename T>
+  T value() {
+    static_assert(std::is_trivially_copyable_v<T>);
+    T result;
+    std::memcpy(&result, take(sizeof(T)), sizeof(T));
+    return result;
+  }
+
+  std::string string() {
+    const auto size = value<uint32_t>();
+    return std::string(take(size), size);
+  }
+
+  [[nodiscard]] bool atEnd() const noexcept { return pos_ == bytes_.size(); }
+
+ private:
+  const char* take(size_t size) {
+    if (bytes_.size() - pos_ < size) {
+      throw std::runtime_error("Кэш сообщений обрезан");
+    }
+    const char* data = bytes_.data() + pos_;
+    pos_ += size;
+    return data;
+  }
+
+  const std::string& bytes_;
+  size_t pos_ = 0;
+};
+
+/// @brief Записывает шаблоны сообщений в кэш
+void writeTemplates(CacheWriter& writer,
+                    const EventLogAnalysis::MessageTemplates& templates) {
+  writer.value(static_cast<uint32_t>(templates.size()));
+  for (const auto& [id, text] : templates) {
+    writer.value(id);
+    writer.string(text);
+  }
+}
+
+/// @brief Читает шаблоны сообщений из кэша
+void readTemplates(CacheReader& reader,
+                   EventLogAnalysis::MessageTemplates& templates) {
+  const auto count = reader.value<uint32_t>();
+  for (uint32_t i = 0; i < count; ++i) {
+    const auto id = reader.value<uint32_t>();
+    templates.emplace(id, reader.string());
+  }
+}
+
+/// @brief Сравнивает строки ASCII без учета регистра
+bool equalsIgnoreCase(std::string_view a, std::string_view b) noexcept {
+  return std::ranges::equal(a, b, [](unsigned char x, unsigned char y) {
+    return std::tolower(x) == std::tolower(y);
+  });
+}
+
+/// @brief Находит существующий путь от корня диска без учета регистра
+/// @details Образы с файловых систем Windows монтируются с сохранением
+/// регистра, а пути в реестре записаны в произвольном регистре
+/// @param root Корень диска
+/// @param relative Путь от корня через '/'
+/// @return Путь на диске или пустая строка
+std::string resolveOnDisk(const std::string& root, std::string_view relative) {
+  fs::path current(root);
+  std::error_code error;
+  size_t pos = 0;
+  while (pos < relative.size()) {
+    size_t end = relative.find('/', pos);
+    if (end == std::string_view::npos) end = relative.size();
+    const std::string_view part = relative.substr(pos, end - pos);
+    pos = end + 1;
+    if (part.empty() || part == ".") {
+      continue;
+    }
+
+    fs::path exact = current / part;
+    if (fs::exists(exact, error)) {
+      current = std::move(exact);
+      continue;
+    }
+    bool found = false;
+    for (fs::directory_iterator it(current, error), last;
+         !error && it != last; it.increment(error)) {
+      if (equalsIgnoreCase(it->path().filename().string(), part)) {
+        current = it->path();
+        found = true;
+        break;
+      }
+    }
+    if (!found) {
+      return {};
+    }
+  }
+  return current.string();
+}
+
+/// @brief Преобразует путь Windows из реестра в путь от корня образа
+/// @details Раскрываются переменные окружения системных каталогов,
+/// отбрасывается буква диска; имя без каталога ищется в System32
+std::string toImagePath(std::string_view windows_path) {
+  std::string path(windows_path);
+  trim(path);
+  path.erase(std::remove(path.begin(), path.end(), '"'), path.end());
+  std::replace(path.begin(), path.end(), '\\', '/');
+
+  std::string lower = to_lower(path);
+  for (const auto& [variable, replacement] : kPathVariables) {
+    if (lower.starts_with(variable)) {
+      path = std::string(replacement) + path.substr(variable.size());
+      lower = to_lower(path);
+      break;
+    }
+  }
+  if (path.size() >= 2 && path[1] == ':') {
+    path.erase(0, 2);
+    lower.erase(0, 2);
+  }
+  const size_t start = path.find_first_not_of('/');
+  if (start == std::string::npos) {
+    return {};
+  }
+  path.erase(0, start);
+  lower.erase(0, start);
+
+  if (path.find('/') == std::string::npos) {
+    return "Windows/System32/" + path;
+  }
+  if (lower.starts_with("system32/") || lower.starts_with("syswow64/")) {
+    return "Windows/" + path;
+  }
+  return path;
+}
+
+/// @brief Разбивает список файлов сообщений, разделенных ';'
+std::vector<std::string> splitFiles(const std::string& list) {
+  std::vector<std::string> files;
+  for (auto& file : split(list, ';')) {
+    trim(file);
+    if (!file.empty()) files.push_back(std::move(file));
+  }
+  return files;
+}
+
+/// @brief Возвращает имя значения реестра из полного пути "раздел/имя"
+std::string_view valueName(const std::string& full_path) {
+  const size_t slash = full_path.rfind('/');
+  return slash == std::string::npos
+             ? std::string_view(full_path)
+             : std::string_view(full_path).substr(slash + 1);
+}
+
+/// @brief Дописывает строку подстановки, раскрывая ссылки "%%N"
+/// @details Строки параметров (например, права доступа в событиях аудита)
+/// ищутся в файле параметров, затем в сообщениях провайдера
+void appendInsert(std::string_view value,
+                  const WindowsDiskAnalysis::ProviderMessages& messages,
+                  std::string& out) {
+  size_t pos = 0;
+  while (pos < value.size()) {
+    const size_t ref = value.find("%%", pos);
+    if (ref == std::string_view::npos) {
+      break;
+    }
+    size_t end = ref + 2;
+    uint64_t id = 0;
+    while (end < value.size() && end - ref < 12 &&
+           std::isdigit(static_cast<unsigned char>(value[end]))) {
+      id = id * 10 + static_cast<uint64_t>(value[end] - '0');
+      ++end;
+    }
+    out.append(value.substr(pos, ref - pos));
+    pos = end;
+
+    const std::string* text = nullptr;
+    if (end > ref + 2 && id <= UINT32_MAX) {
+      const auto key = static_cast<uint32_t>(id);
+      if (const auto found = messages.parameters.find(key);
+          found != messages.parameters.end()) {
+        text = &found->second;
+      } else if (const auto message = messages.messages.find(key);
+                 message != messages.messages.end()) {
+        text = &message->second;
+      }
+    }
+    if (text) {
+      out += *text;
+    } else {
+      out.append(value.substr(ref, end - ref));
+    }
+  }
+  out.append(value.substr(pos));
+}
+
+}
+
+namespace WindowsDiskAnalysis {
+
+const std::string* ProviderMessages::find(uint32_t event_id) const {
+  if (const auto event = events.find(event_id & 0xFFFF);
+      event != events.end()) {
+    const auto message = messages.find(event->second);
+    return message != messages.end() ? &message->second : nullptr;
+  }
+  if (const auto message = messages.find(event_id);
+      message != messages.end()) {
+    return &message->second;
+  }
+  if ((event_id & 0xFFFF0000) == 0) {
+    for (const uint32_t severity : kSeverities) {
+      if (const auto message = messages.find(event_id | severity);
+          message != messages.end()) {
+        return &message->second;
+      }
+    }
+  }
+  return nullptr;
+}
+
+ProviderMessageResolver::ProviderMessageResolver(
+    std::unique_ptr<RegistryAnalysis::IRegistryParser> parser,
+    std::string disk_root, MessageResolverConfig config)
+    : parser_(std::move(parser)),
+      disk_root_(std::move(disk_root)),
+      config_(std::move(config)) {
+  const auto logger = GlobalLogger::get();
+
+  // Куст SYSTEM лежит в одном каталоге с SOFTWARE
+  if (!config_.software_hive.empty()) {
+    software_hive_ = resolveOnDisk(disk_root_, config_.software_hive);
+    const size_t slash = config_.software_hive.rfind('/');
+    const std::string directory =
+        config_.software_hive.substr(0, slash == std::string::npos ? 0 : slash);
+    system_hive_ = resolveOnDisk(disk_root_, directory + "/SYSTEM");
+  }
+  if (software_hive_.empty() && system_hive_.empty()) {
+    logger->warn("Кусты реестра для описаний событий не найдены");
+  }
+
+  cache_path_ = cachePath();
+  loadCache();
+}
+
+MessageResolverConfig ProviderMessageResolver::createConfig(
+    const std::string& ini_path, const std::string& os_version) {
+  Config config(ini_path);
+  MessageResolverConfig cfg;
+  cfg.enabled = config.getBool("General", "EventMessageResolution", false);
+  cfg.cache_dir = config.getString("General", "EventMessageCacheDir", "");
+  trim(cfg.cache_dir);
+
+  std::string version = os_version;
+  trim(version);
+  if (!version.empty()) {
+    cfg.software_hive = config.getString(version, "RegistryPath", "");
+    trim(cfg.software_hive);
+    std::replace(cfg.software_hive.begin(), cfg.software_hive.end(), '\\',
+                 '/');
+  }
+  return cfg;
+}
+
+fs::path ProviderMessageResolver::cachePath() const {
+  if (config_.cache_dir.empty() || software_hive_.empty()) {
+    return {};
+  }
+
+  // Заголовок куста содержит счетчики и время последней записи, поэтому
+  // сумма заголовков различает образы и состояния одного образа
+  uint32_t identity = 0;
+  for (const auto* hive : {&software_hive_, &system_hive_}) {
+    if (hive->empty()) continue;
+    identity = EventLogAnalysis::Crc32::compute(
+        EventLogAnalysis::readFilePrefix(*hive, kHiveHeaderSize), identity);
+  }
+
+  constexpr char kHex[] = "0123456789abcdef";
+  std::string name = "messages_";
+  for (int shift = 28; shift >= 0; shift -= 4) {
+    name += kHex[(identity >> shift) & 0xF];
+  }
+  return fs::path(config_.cache_dir) / (name + ".cache");
+}
+
+void ProviderMessageResolver::loadCache() {
+  if (cache_path_.empty()) {
+    return;
+  }
+  std::ifstream in(cache_path_, std::ios::binary);
+  if (!in) {
+    return;
+  }
+  const std::string bytes((std::istreambuf_iterator<char>(in)),
+                          std::istreambuf_iterator<char>());
+
+  try {
+    CacheReader reader(bytes);
+    char magic[sizeof(kMagic)];
+    for (char& c : magic) c = reader.value<char>();
+    if (!std::equal(std::begin(magic), std::end(magic), kMagic)) {
+      return;
+    }
+
+    decltype(providers_) providers;
+    const auto count = reader.value<uint32_t>();
+    for (uint32_t i = 0; i < count; ++i) {
+      std::string name = reader.string();
+      auto messages = std::make_shared<ProviderMessages>();
+      readTemplates(reader, messages->messages);
+      const auto event_count = reader.value<uint32_t>();
+      for (uint32_t j = 0; j < event_count; ++j) {
+        const auto event_id = reader.value<uint32_t>();
+        messages->events.emplace(event_id, reader.value<uint32_t>());
+      }
+      readTemplates(reader, messages->parameters);
+      providers.emplace(std::move(name), std::move(messages));
+    }
+    if (!reader.atEnd()) {
+      throw std::runtime_error("Лишние данные в конце кэша сообщений");
+    }
+
+    std::unique_lock lock(mutex_);
+    providers_ = std::move(providers);
+    GlobalLogger::get()->debug("Загружен кэш сообщений {} провайдеров: \"{}\"",
+                               providers_.size(), cache_path_.string());
+  } catch (const std::exception& e) {
+    GlobalLogger::get()->warn("Кэш сообщений \"{}\" не использован: \"{}\"",
+                              cache_path_.string(), e.what());
+  }
+}
+
+void ProviderMessageResolver::save() {
+  if (cache_path_.empty()) {
+    return;
+  }
+
+  CacheWriter writer;
+  {
+    std::shared_lock lock(mutex_);
+    if (!dirty_) {
+      return;
+    }
+    for (const char c : kMagic) writer.value(c);
+    writer.value(static_cast<uint32_t>(providers_.size()));
+    for (const auto& [name, messages] : providers_) {
+      writer.string(name);
+      writeTemplates(writer, messages->messages);
+      writer.value(static_cast<uint32_t>(messages->events.size()));
+      for (const auto& [event_id, message_id] : messages->events) {
+        writer.value(event_id);
+        writer.value(message_id);
+      }
+      writeTemplates(writer, messages->parameters);
+    }
+  }
+
+  // Запись через временный файл: прерванная запись не портит кэш
+  std::error_code error;
+  fs::create_directories(cache_path_.parent_path(), error);
+  fs::path temp_path = cache_path_;
+  temp_path += ".tmp";
+  {
+    std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+    out.write(writer.bytes().data(),
+              static_cast<std::streamsize>(writer.bytes().size()));
+    if (!out) {
+      throw std::runtime_error("Не удалось записать кэш сообщений: " +
+                               temp_path.string());
+    }
+  }
+  fs::rename(temp_path, cache_path_, error);
+  if (error) {
+    fs::remove(temp_path, error);
+    throw std::runtime_error("Не удалось сохранить кэш сообщений: " +
+                             cache_path_.string());
+  }
+
+  std::unique_lock lock(mutex_);
+  dirty_ = false;
+}
+
+bool ProviderMessageResolver::describe(const EventLogAnalysis::EventData& event,
+                                       std::string& out) {
+  const auto messages = providerOf(event.getProvider());
+  if (!messages) {
+    return false;
+  }
+  const std::string* pattern = messages->find(event.getEventId());
+  if (!pattern) {
+    return false;
+  }
+  out.clear();
+  format(*pattern, event.getData(), *messages, out);
+  return true;
+}
+
+std::shared_ptr<const ProviderMessages> ProviderMessageResolver::providerOf(
+    std::string_view provider) {
+  if (provider.empty()) {
+    return nullptr;
+  }
+  {
+    std::shared_lock lock(mutex_);
+    if (const auto found = providers_.find(provider);
+        found != providers_.end()) {
+      return found->second;
+    }
+  }
+
+  // Провайдер загружается одним потоком; остальные ждут и берут результат
+  std::lock_guard load_lock(load_mutex_);
+  {
+    std::shared_lock lock(mutex_);
+    if (const auto found = providers_.find(provider);
+        found != providers_.end()) {
+      return found->second;
+    }
+  }
+  auto messages = loadProvider(std::string(provider));
+
+  std::unique_lock lock(mutex_);
+  providers_.emplace(std::string(provider), messages);
+  dirty_ = true;
+  return messages;
+}
+
+void ProviderMessageResolver::loadRegistrations() {
+  registrations_loaded_ = true;
+  const auto logger = GlobalLogger::get();
+
+  // Издатели манифестов: имя - значение по умолчанию раздела {GUID}
+  if (!software_hive_.empty()) {
+    const std::string publishers(kPublishersKey);
+    try {
+      const auto guids = parser_->listSubkeys(software_hive_, publishers);
+      for (const auto& guid : guids) {
+        Registration registration;
+        registration.guid = guid;
+        std::string name;
+        for (const auto& value :
+             parser_->getKeyValues(software_hive_, publishers + "/" + guid)) {
+          const auto leaf = valueName(value->getName());
+          if (leaf.empty()) {
+            name = value->getDataAsString();
+          } else if (equalsIgnoreCase(leaf, "MessageFileName")) {
+            registration.message_files =
+                splitFiles(value->getDataAsString());
+          } else if (equalsIgnoreCase(leaf, "ParameterFileName")) {
+            registration.parameter_files =
+                splitFiles(value->getDataAsString());
+          }
+        }
+        trim(name);
+        if (!name.empty()) {
+          guids_.emplace(to_lower(guid), to_lower(name));
+          publishers_.emplace(to_lower(name), std::move(registration));
+        }
+      }
+    } catch (const std::exception& e) {
+      logger->debug("Издатели событий не прочитаны: \"{}\"", e.what());
+    }
+  }
+
+  // Классические источники: индекс разделов, значения читаются по запросу
+  if (!system_hive_.empty()) {
+    uint32_t current = 1;
+    try {
+      if (const auto value =
+              parser_->getSpecificValue(system_hive_, "Select/Current")) {
+        current = value->getAsDword();
+      }
+    } catch (const std::exception&) {
+    }
+    std::string control_set = std::to_string(current);
+    control_set.insert(0, control_set.size() < 3 ? 3 - control_set.size() : 0,
+                       '0');
+    const std::string event_log =
+        "ControlSet" + control_set + "/Services/EventLog";
+    try {
+      for (const auto& log : parser_->listSubkeys(system_hive_, event_log)) {
+        const std::string log_key = event_log + "/" + log;
+        for (const auto& source : parser_->listSubkeys(system_hive_, log_key)) {
+          sources_.try_emplace(to_lower(source), log_key + "/" + source);
+        }
+      }
+    } catch (const std::exception& e) {
+      logger->debug("Источники событий не прочитаны: \"{}\"", e.what());
+    }
+  }
+
+  logger->debug("Регистрации провайдеров: {} издателей, {} источников",
+                publishers_.size(), sources_.size());
+}
+
+ProviderMessageResolver::Registration ProviderMessageResolver::registrationOf(
+    const std::string& provider) {
+  if (!registrations_loaded_) {
+    loadRegistrations();
+  }
+
+  const std::string key = to_lower(provider);
+  Registration registration;
+  if (const auto found = publishers_.find(key); found != publishers_.end()) {
+    registration = found->second;
+  }
+
+  const auto source = sources_.find(key);
+  if (source == sources_.end()) {
+    return registration;
+  }
+  try {
+    for (const auto& value :
+         parser_->getKeyValues(system_hive_, source->second)) {
+      const auto leaf = valueName(value->getName());
+      if (equalsIgnoreCase(leaf, "EventMessageFile")) {
+        std::ranges::move(splitFiles(value->getDataAsString()),
+                          std::back_inserter(registration.message_files));
+      } else if (equalsIgnoreCase(leaf, "ParameterMessageFile")) {
+        std::ranges::move(splitFiles(value->getDataAsString()),
+                          std::back_inserter(registration.parameter_files));
+      } else if (equalsIgnoreCase(leaf, "ProviderGuid") &&
+                 registration.guid.empty()) {
+        // Источник, ссылающийся на издателя манифеста
+        const auto name = guids_.find(to_lower(value->getDataAsString()));
+        if (name == guids_.end()) continue;
+        const auto& publisher = publishers_.at(name->second);
+        registration.guid = publisher.guid;
+        registration.message_files.insert(registration.message_files.end(),
+                                          publisher.message_files.begin(),
+                                          publisher.message_files.end());
+        registration.parameter_files.insert(
+            registration.parameter_files.end(),
+            publisher.parameter_files.begin(), publisher.parameter_files.end());
+      }
+    }
+  } catch (const std::exception& e) {
+    GlobalLogger::get()->debug("Источник \"{}\" не прочитан: \"{}\"",
+                               provider, e.what());
+  }
+  return registration;
+}
+
+std::shared_ptr<const ProviderMessages> ProviderMessageResolver::loadProvider(
+    const std::string& provider) {
+  auto messages = std::make_shared<ProviderMessages>();
+  const auto registration = registrationOf(provider);
+  for (const auto& file : registration.message_files) {
+    readMessageFile(file, registration.guid, messages->messages,
+                    &messages->events);
+  }
+  for (const auto& file : registration.parameter_files) {
+    readMessageFile(file, {}, messages->parameters, nullptr);
+  }
+
+  GlobalLogger::get()->debug(
+      "Сообщения провайдера \"{}\": {} шаблонов, {} событий манифеста",
+      provider, messages->messages.size(), messages->events.size());
+  return messages;
+}
+
+void ProviderMessageResolver::readMessageFile(
+    const std::string& windows_path, const std::string& guid,
+    EventLogAnalysis::MessageTemplates& messages,
+    std::unordered_map<uint32_t, uint32_t>* events) const {
+  const std::string relative = toImagePath(windows_path);
+  const std::string path =
+      relative.empty() ? "" : resolveOnDisk(disk_root_, relative);
+  if (path.empty()) {
+    GlobalLogger::get()->debug("Файл сообщений не найден: \"{}\"",
+                               windows_path);
+    return;
+  }
+
+  try {
+    EventLogAnalysis::MessageResourceFile file(path);
+    if (events && !guid.empty()) {
+      file.readEventMessages(guid, *events);
+    }
+    if (file.hasMessageTable()) {
+      file.readMessages(messages);
+      return;
+    }
+  } catch (const std::exception& e) {
+    GlobalLogger::get()->debug("Файл сообщений \"{}\" не разобран: \"{}\"",
+                               path, e.what());
+    return;
+  }
+
+  // Таблица сообщений в файле локализации: <каталог>/<язык>/<файл>.mui
+  const fs::path file_path(path);
+  const std::string mui_name = file_path.filename().string() + ".mui";
+  std::string mui =
+      resolveOnDisk(file_path.parent_path().string(),
+                    std::string(kPreferredLocale) + "/" + mui_name);
+  std::error_code error;
+  for (fs::directory_iterator it(file_path.parent_path(), error), last;
+       mui.empty() && !error && it != last; it.increment(error)) {
+    if (it->is_directory(error)) {
+      mui = resolveOnDisk(it->path().string(), mui_name);
+    }
+  }
+  if (mui.empty()) {
+    return;
+  }
+
+  try {
+    EventLogAnalysis::MessageResourceFile(mui).readMessages(messages);
+  } catch (const std::exception& e) {
+    GlobalLogger::get()->debug("Файл локализации \"{}\" не разобран: \"{}\"",
+                               mui, e.what());
+  }
+}
+
+void ProviderMessageResolver::format(
+    std::string_view pattern,
+    std::span<const EventLogAnalysis::EventField> fields,
+    const ProviderMessages& messages, std::string& out) {
+  out.reserve(out.size() + pattern.size());
+
+  size_t pos = 0;
+  while (pos < pattern.size()) {
+    const size_t percent = pattern.find('%', pos);
+    if (percent == std::string_view::npos) {
+      out.append(pattern.substr(pos));
+      break;
+    }
+    out.append(pattern.substr(pos, percent - pos));
+    pos = percent + 1;
+    if (pos == pattern.size()) {
+      out += '%';
+      break;
+    }
+
+    const char c = pattern[pos];
+    if (c >= '1' && c <= '9') {
+      size_t index = static_cast<size_t>(c - '0');
+      ++pos;
+      if (pos < pattern.size() &&
+          std::isdigit(static_cast<unsigned char>(pattern[pos]))) {
+        index = index * 10 + static_cast<size_t>(pattern[pos] - '0');
+        ++pos;
+      }
+      const size_t insert_end = pos;
+      // Спецификация формата "!S!" и т.п. к строкам не применяется
+      if (pos < pattern.size() && pattern[pos] == '!') {
+        const size_t close = pattern.find('!', pos + 1);
+        if (close != std::string_view::npos) pos = close + 1;
+      }
+      if (index <= fields.size()) {
+        appendInsert(fields[index - 1].value(), messages, out);
+      } else {
+        out.append(pattern.substr(percent, insert_end - percent));
+      }
+      continue;
+    }
+
+    ++pos;
+    switch (c) {
+      case 'n':
+        out += '\n';
+        break;
+      case 't':
+        out += '\t';
+        break;
+      case 'r':
+        out += '\r';
+        break;
+      case 'b':
+        out += ' ';
+        break;
+      case '0':
+        pos = pattern.size();
+        break;
+      case '%':
+      case '.':
+      case '!':
+        out += c;
+        break;
+      default:
+        out += '%';
+        out += c;
+        break;
+    }
+  }
+
+  // Шаблоны таблиц завершаются переводом строки
+  const size_t end = out.find_last_not_of(" \t\r\n");
+  out.resize(end == std::string::npos ? 0 : end + 1);
+}
+
+}
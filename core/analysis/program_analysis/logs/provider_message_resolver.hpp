@@ -0,0 +1,165 @@
+/// @file provider_message_resolver.hpp
+/// @brief Описания событий по ресурсам сообщений провайдеров образа
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../../../../parsers/event_log/formats/pe/message_resources.hpp"
+#include "../../../../parsers/event_log/model/event_data.hpp"
+#include "../../../../parsers/registry/parser/iparser.hpp"
+#include "string_key_hash.hpp"
+
+namespace WindowsDiskAnalysis {
+
+/// @brief Конфигурация разрешения описаний событий
+struct MessageResolverConfig {
+  bool enabled = false;       ///< Разрешать описания по ресурсам провайдеров
+  std::string software_hive;  ///< Путь к кусту SOFTWARE от корня диска
+  std::string cache_dir;      ///< Каталог кэша сообщений (пусто - нет)
+};
+
+/// @brief Сообщения одного провайдера событий
+struct ProviderMessages {
+  EventLogAnalysis::MessageTemplates messages;  ///< Шаблоны по ID сообщения
+  std::unordered_map<uint32_t, uint32_t>
+      events;  ///< ID сообщения по ID события (манифест)
+  EventLogAnalysis::MessageTemplates
+      parameters;  ///< Строки параметров "%%N" по ID
+
+  /// @brief Возвращает шаблон описания события
+  /// @details Сообщение ищется по манифесту, затем по ID события как ID
+  /// сообщения. В EVTX старшие биты ID (серьезность, Qualifiers) не
+  /// сохраняются, поэтому для классических провайдеров перебираются
+  /// возможные значения серьезности
+  /// @param event_id ID события
+  /// @return Шаблон или nullptr
+  [[nodiscard]] const std::string* find(uint32_t event_id) const;
+};
+
+/// @class ProviderMessageResolver
+/// @brief Формирует описания событий по шаблонам сообщений провайдеров
+/// @details Журнал хранит только строки подстановки; текст описания
+/// находится в ресурсах файла сообщений провайдера. Файл определяется по
+/// регистрации в образе: издатели манифестов в SOFTWARE
+/// (WINEVT\\Publishers\\{GUID}) и классические источники в SYSTEM
+/// (Services\\EventLog\\<журнал>\\<источник>). Ресурсы провайдера
+/// разбираются один раз при первом его событии и хранятся в памяти;
+/// кэш на диске, привязанный к заголовкам кустов образа, избавляет
+/// повторные запуски от обхода реестра и разбора файлов. Поэтому
+/// описание события стоит одного поиска в таблицах и подстановки строк.
+/// Методы потокобезопасны.
+class ProviderMessageResolver {
+ public:
+  /// @brief Конструктор
+  /// @details Загружает кэш сообщений образа, если он задан и совпадает
+  /// @param parser Парсер реестра для чтения регистраций провайдеров
+  /// @param disk_root Корневой путь анализируемого диска
+  /// @param config Конфигурация
+  ProviderMessageResolver(
+      std::unique_ptr<RegistryAnalysis::IRegistryParser> parser,
+      std::string disk_root, MessageResolverConfig config);
+
+  /// @brief Создает конфигурацию на основе INI файла и версии ОС
+  /// @param ini_path Путь к INI файлу
+  /// @param os_version Версия ОС
+  /// @return Сформированная конфигурация
+  static MessageResolverConfig createConfig(const std::string& ini_path,
+                                            const std::string& os_version);
+
+  /// @brief Формирует описание события
+  /// @param event Событие
+  /// @param out Описание (перезаписывается)
+  /// @return false, если шаблон сообщения события не найден
+  bool describe(const EventLogAnalysis::EventData& event, std::string& out);
+
+  /// @brief Сохраняет кэш сообщений образа, если появились новые провайдеры
+  /// @throws std::runtime_error Если файл кэша не удалось записать
+  void save();
+
+  /// @brief Подставляет строки события в шаблон сообщения
+  /// @details Поддерживаются вставки %1..%99 (спецификация формата
+  /// "!...!" отбрасывается) и управляющие последовательности FormatMessage
+  /// (%n, %t, %r, %b, %%, %0). Ссылки "%%N" в строках подстановки
+  /// заменяются строками параметров провайдера
+  /// @param pattern Шаблон
+  /// @param fields Поля события в порядке вставок
+  /// @param messages Сообщения провайдера
+  /// @param out Строка-приемник
+  static void format(std::string_view pattern,
+                     std::span<const EventLogAnalysis::EventField> fields,
+                     const ProviderMessages& messages, std::string& out);
+
+ private:
+  /// @brief Регистрация провайдера в реестре образа
+  struct Registration {
+    std::string guid;                          ///< GUID издателя манифеста
+    std::vector<std::string> message_files;    ///< Файлы сообщений
+    std::vector<std::string> parameter_files;  ///< Файлы строк параметров
+  };
+
+  /// @brief Возвращает сообщения провайдера, загружая их при первом запросе
+  [[nodiscard]] std::shared_ptr<const ProviderMessages> providerOf(
+      std::string_view provider);
+
+  /// @brief Читает регистрации издателей и индекс классических источников
+  /// @details Вызывается один раз под блокировкой загрузки
+  void loadRegistrations();
+
+  /// @brief Возвращает регистрацию провайдера по имени
+  [[nodiscard]] Registration registrationOf(const std::string& provider);
+
+  /// @brief Загружает сообщения провайдера из его файлов
+  [[nodiscard]] std::shared_ptr<const ProviderMessages> loadProvider(
+      const std::string& provider);
+
+  /// @brief Дописывает сообщения файла провайдера
+  /// @details Таблица сообщений, отсутствующая в файле, берется из файла
+  /// локализации MUI
+  /// @param windows_path Путь к файлу в образе в нотации Windows
+  /// @param guid GUID издателя манифеста (пусто - без манифеста)
+  /// @param messages Шаблоны сообщений (пополняются)
+  /// @param events ID сообщений событий (пополняются)
+  void readMessageFile(const std::string& windows_path,
+                       const std::string& guid,
+                       EventLogAnalysis::MessageTemplates& messages,
+                       std::unordered_map<uint32_t, uint32_t>* events) const;
+
+  /// @brief Возвращает путь к файлу кэша образа (пусто - кэш не ведется)
+  [[nodiscard]] std::filesystem::path cachePath() const;
+
+  /// @brief Загружает кэш сообщений образа
+  void loadCache();
+
+  std::unique_ptr<RegistryAnalysis::IRegistryParser>
+      parser_;                        ///< Парсер реестра
+  std::string disk_root_;             ///< Корневой путь диска
+  MessageResolverConfig config_;      ///< Конфигурация
+  std::string software_hive_;         ///< Файл куста SOFTWARE (пусто - нет)
+  std::string system_hive_;           ///< Файл куста SYSTEM (пусто - нет)
+  std::filesystem::path cache_path_;  ///< Файл кэша (пусто - нет)
+  std::mutex load_mutex_;             ///< Загрузка провайдеров по одному
+  bool registrations_loaded_ = false;  ///< Регистрации прочитаны
+  std::unordered_map<std::string, Registration>
+      publishers_;  ///< Издатели по имени в нижнем регистре
+  std::unordered_map<std::string, std::string>
+      guids_;  ///< Имена издателей по GUID в нижнем регистре
+  std::unordered_map<std::string, std::string>
+      sources_;  ///< Разделы классических источников по имени
+  mutable std::shared_mutex mutex_;  ///< Защита таблицы провайдеров
+  std::unordered_map<std::string, std::shared_ptr<const ProviderMessages>,
+                     StringKeyHash, std::equal_to<>>
+      providers_;       ///< Сообщения по имени провайдера
+  bool dirty_ = false;  ///< Есть провайдеры, не сохраненные в кэше
+};
+
+}
@@ -0,0 +1,22 @@
+/// @file string_key_hash.hpp
+/// @brief Хеш строковых ключей с поиском без копирования
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string_view>
+
+namespace WindowsDiskAnalysis {
+
+/// @brief Хеш строк с поиском по std::string_view без копирования ключа
+struct StringKeyHash {
+  using is_transparent = void;  ///< Разрешает поиск по std::string_view
+
+  /// @brief Вычисляет хеш строки
+  [[nodiscard]] size_t operator()(std::string_view text) const noexcept {
+    return std::hash<std::string_view>{}(text);
+  }
+};
+
+}
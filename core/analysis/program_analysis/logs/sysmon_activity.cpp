@@ -0,0 +1,87 @@
+#include "sysmon_activity.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace WindowsDiskAnalysis {
+
+void SysmonImageStats::add(uint64_t time) noexcept {
+  events++;
+  first_seen = std::min(first_seen, time);
+  last_seen = std::max(last_seen, time);
+}
+
+uint32_t SysmonActivityTable::intern(std::string_view text) {
+  if (const auto found = string_index_.find(text);
+      found != string_index_.end()) {
+    return found->second;
+  }
+  const auto index = static_cast<uint32_t>(strings_.size());
+  strings_.emplace_back(text);
+  string_index_.emplace(strings_.back(), index);
+  return index;
+}
+
+SysmonImageStats& SysmonActivityTable::image(std::string_view key,
+                                             std::string_view image) {
+  const auto [found, inserted] = images_.try_emplace(intern(key));
+  if (inserted) {
+    found->second.image = intern(image);
+  }
+  return found->second;
+}
+
+void SysmonActivityTable::add(uint32_t key, SysmonImageStats&& stats) {
+  const auto [found, inserted] = images_.try_emplace(key, std::move(stats));
+  if (inserted) {
+    return;
+  }
+
+  SysmonImageStats& target = found->second;
+  target.first_seen = std::min(target.first_seen, stats.first_seen);
+  target.last_seen = std::max(target.last_seen, stats.last_seen);
+  target.events += stats.events;
+  target.image_loads += stats.image_loads;
+  target.file_creates += stats.file_creates;
+  target.registry_sets += stats.registry_sets;
+  target.dns_queries += stats.dns_queries;
+  target.hashes.merge(stats.hashes);
+  target.modules.merge(stats.modules);
+  target.domains.merge(stats.domains);
+  target.records.insert(target.records.end(),
+                        std::make_move_iterator(stats.records.begin()),
+                        std::make_move_iterator(stats.records.end()));
+}
+
+void SysmonActivityTable::merge(const SysmonActivityTable& other) {
+  // Индексы строк другой таблицы переводятся один раз, а не для каждого
+  // элемента множеств
+  std::vector<uint32_t> indices;
+  indices.reserve(other.strings_.size());
+  for (const auto& text : other.strings_) indices.push_back(intern(text));
+
+  const auto remap = [&indices](const std::unordered_set<uint32_t>& from,
+                                std::unordered_set<uint32_t>& to) {
+    to.reserve(from.size());
+    for (const uint32_t index : from) to.insert(indices[index]);
+  };
+
+  for (const auto& [key, stats] : other.images_) {
+    SysmonImageStats mapped;
+    mapped.image = indices[stats.image];
+    mapped.first_seen = stats.first_seen;
+    mapped.last_seen = stats.last_seen;
+    mapped.events = stats.events;
+    mapped.image_loads = stats.image_loads;
+    mapped.file_creates = stats.file_creates;
+    mapped.registry_sets = stats.registry_sets;
+    mapped.dns_queries = stats.dns_queries;
+    remap(stats.hashes, mapped.hashes);
+    remap(stats.modules, mapped.modules);
+    remap(stats.domains, mapped.domains);
+    mapped.records = stats.records;
+    add(indices[key], std::move(mapped));
+  }
+}
+
+}
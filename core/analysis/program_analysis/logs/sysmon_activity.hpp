@@ -0,0 +1,100 @@
+/// @file sysmon_activity.hpp
+/// @brief Накопленная активность образов по событиям Sysmon
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace WindowsDiskAnalysis {
+
+/// @brief Событие Sysmon, сохраненное целиком
+struct SysmonRecord {
+  uint32_t event_id = 0;  ///< ID события
+  uint64_t time = 0;      ///< Время события (FILETIME)
+  std::string details;    ///< Поля события "Имя=Значение; ..."
+};
+
+/// @brief Накопленная активность одного образа
+/// @details Множества хранят индексы таблицы строк, поэтому повтор уже
+/// известного модуля, хэша или имени не выделяет память
+struct SysmonImageStats {
+  uint32_t image = 0;  ///< Исходный путь к образу (индекс строки)
+  uint64_t first_seen =
+      std::numeric_limits<uint64_t>::max();  ///< Первое событие (FILETIME)
+  uint64_t last_seen = 0;                ///< Последнее событие (FILETIME)
+  uint64_t events = 0;                   ///< Количество событий
+  uint64_t image_loads = 0;              ///< Загрузки модулей (ID 7)
+  uint64_t file_creates = 0;             ///< Созданные файлы (ID 11)
+  uint64_t registry_sets = 0;            ///< Изменения реестра (ID 13)
+  uint64_t dns_queries = 0;              ///< DNS-запросы (ID 22)
+  std::unordered_set<uint32_t> hashes;   ///< Хэши образа (ID 1)
+  std::unordered_set<uint32_t> modules;  ///< Загруженные модули (ID 7)
+  std::unordered_set<uint32_t> domains;  ///< Запрошенные имена (ID 22)
+  std::vector<SysmonRecord> records;     ///< Сохраненные события
+
+  /// @brief Учитывает время события
+  void add(uint64_t time) noexcept;
+};
+
+/// @class SysmonActivityTable
+/// @brief Активность образов по нормализованному пути
+/// @details Пути, модули, хэши и имена хранятся в таблице строк один раз;
+/// события не накапливаются, кроме явно выбранных для сохранения. Индекс
+/// строк ссылается на элементы std::deque, поэтому таблица не копируется
+class SysmonActivityTable {
+ public:
+  SysmonActivityTable() = default;
+  SysmonActivityTable(const SysmonActivityTable&) = delete;
+  SysmonActivityTable& operator=(const SysmonActivityTable&) = delete;
+  SysmonActivityTable(SysmonActivityTable&&) = default;
+  SysmonActivityTable& operator=(SysmonActivityTable&&) = default;
+
+  /// @brief Активность по индексу нормализованного пути образа
+  using Images = std::unordered_map<uint32_t, SysmonImageStats>;
+
+  /// @brief Возвращает индекс строки, добавляя ее при первом появлении
+  /// @param text Строка
+  [[nodiscard]] uint32_t intern(std::string_view text);
+
+  /// @brief Возвращает активность образа, создавая ее при первом появлении
+  /// @param key Нормализованный путь к образу
+  /// @param image Исходный путь к образу
+  [[nodiscard]] SysmonImageStats& image(std::string_view key,
+                                        std::string_view image);
+
+  /// @brief Добавляет активность образа
+  /// @param key Индекс нормализованного пути
+  /// @param stats Активность с индексами строк этой таблицы
+  void add(uint32_t key, SysmonImageStats&& stats);
+
+  /// @brief Добавляет активность другой таблицы с перенумерацией строк
+  /// @param other Таблица другого журнала
+  void merge(const SysmonActivityTable& other);
+
+  /// @brief Возвращает таблицу строк
+  [[nodiscard]] const std::deque<std::string>& strings() const noexcept {
+    return strings_;
+  }
+
+  /// @brief Возвращает активность образов
+  [[nodiscard]] const Images& images() const noexcept { return images_; }
+
+  /// @brief Проверяет отсутствие активности
+  [[nodiscard]] bool empty() const noexcept { return images_.empty(); }
+
+ private:
+  std::deque<std::string> strings_;  ///< Таблица строк
+  std::unordered_map<std::string_view, uint32_t>
+      string_index_;  ///< Индексы строк (ссылки на strings_)
+  Images images_;     ///< Активность образов
+};
+
+}
@@ -0,0 +1,104 @@
+#include "sysmon_event_extractor.hpp"
+
+#include "process_event_extractor.hpp"
+
+namespace {
+
+/// @brief Провайдер событий Sysmon
+constexpr std::string_view kSysmonProvider = "Microsoft-Windows-Sysmon";
+
+/// @brief ID событий Sysmon
+enum SysmonEventId : uint32_t {
+  kProcessCreate = 1,
+  kImageLoad = 7,
+  kFileCreate = 11,
+  kRegistryValueSet = 13,
+  kDnsQuery = 22,
+};
+
+/// @brief Собирает поля события в строку "Имя=Значение; ..."
+std::string describe(const EventLogAnalysis::EventData& event) {
+  std::string details;
+  for (const auto& field : event.getData()) {
+    if (!details.empty()) details += "; ";
+    details.append(field.name.view()).append(1, '=').append(field.value());
+  }
+  return details;
+}
+
+}
+
+namespace WindowsDiskAnalysis {
+
+// ImageLoaded (7), TargetFilename (11), TargetObject (13) и QueryName (22)
+// не встречаются в одном событии и занимают одну роль
+SysmonEventExtractor::SysmonEventExtractor()
+    : layouts_({{"Image"},
+                {"ImageLoaded", "TargetFilename", "TargetObject",
+                 "QueryName"},
+                {"Hashes"}}) {}
+
+bool SysmonEventExtractor::matches(
+    const EventLogAnalysis::EventData& event) noexcept {
+  return event.getProvider() == kSysmonProvider;
+}
+
+void SysmonEventExtractor::extract(const EventLogAnalysis::EventData& event,
+                                   SysmonActivityTable& activity,
+                                   bool retain) {
+  const uint32_t event_id = event.getEventId();
+  const auto fields = event.getData();
+  const auto slots = layouts_.slotsOf(event_id, fields);
+  const auto value = [&](Role role) {
+    return EventFieldLayouts::valueAt(fields, slots[role]);
+  };
+
+  const std::string_view image = value(kImage);
+  if (image.empty()) {
+    return;
+  }
+  normalizeImagePath(image, key_);
+  SysmonImageStats& stats = activity.image(key_, image);
+  stats.add(event.getTimestamp());
+
+  switch (event_id) {
+    case kProcessCreate: {
+      // "SHA1=...,MD5=...,SHA256=...,IMPHASH=..."; в ID 7 поле Hashes
+      // относится к модулю, а не к образу
+      std::string_view hashes = value(kHashes);
+      while (!hashes.empty()) {
+        const size_t comma = hashes.find(',');
+        const std::string_view hash = hashes.substr(0, comma);
+        if (!hash.empty()) stats.hashes.insert(activity.intern(hash));
+        if (comma == std::string_view::npos) break;
+        hashes.remove_prefix(comma + 1);
+      }
+      break;
+    }
+    case kImageLoad:
+      stats.image_loads++;
+      normalizeImagePath(value(kTarget), target_);
+      if (!target_.empty()) stats.modules.insert(activity.intern(target_));
+      break;
+    case kFileCreate:
+      stats.file_creates++;
+      break;
+    case kRegistryValueSet:
+      stats.registry_sets++;
+      break;
+    case kDnsQuery:
+      stats.dns_queries++;
+      if (const std::string_view name = value(kTarget); !name.empty()) {
+        stats.domains.insert(activity.intern(name));
+      }
+      break;
+    default:
+      break;
+  }
+
+  if (retain) {
+    stats.records.push_back({event_id, event.getTimestamp(), describe(event)});
+  }
+}
+
+}
@@ -0,0 +1,52 @@
+/// @file sysmon_event_extractor.hpp
+/// @brief Потоковая агрегация событий Sysmon
+
+#pragma once
+
+#include <string>
+
+#include "../../../../parsers/event_log/model/event_data.hpp"
+#include "event_field_layouts.hpp"
+#include "sysmon_activity.hpp"
+
+namespace WindowsDiskAnalysis {
+
+/// @class SysmonEventExtractor
+/// @brief Учитывает события Sysmon в накопленной активности образов
+/// @details Журнал Sysmon содержит десятки миллионов записей (в основном
+/// ImageLoad, ID 7), поэтому события не сохраняются: для каждого образа
+/// обновляются множества хэшей (ID 1), загруженных модулей (ID 7) и
+/// запрошенных имен (ID 22), счетчики созданных файлов (ID 11) и изменений
+/// реестра (ID 13), время первого и последнего события. Целиком
+/// сохраняются только события выбранных ID. Создание процессов (ID 1) и
+/// сетевые подключения (ID 3) дополнительно разбираются общими
+/// извлекателями. Экземпляр не потокобезопасен: каждая задача разбора
+/// создает свой.
+class SysmonEventExtractor {
+ public:
+  /// @brief Конструктор
+  SysmonEventExtractor();
+
+  /// @brief Проверяет, что событие записано Sysmon
+  /// @details ID событий Sysmon (1, 3, 7...) совпадают с ID других
+  /// провайдеров, поэтому событие отбирается по провайдеру
+  [[nodiscard]] static bool matches(
+      const EventLogAnalysis::EventData& event) noexcept;
+
+  /// @brief Учитывает событие в активности образа
+  /// @param event Событие Sysmon
+  /// @param activity Активность образов журнала
+  /// @param retain Сохранить событие целиком
+  void extract(const EventLogAnalysis::EventData& event,
+               SysmonActivityTable& activity, bool retain);
+
+ private:
+  /// @brief Извлекаемое поле события
+  enum Role : size_t { kImage, kTarget, kHashes };
+
+  EventFieldLayouts layouts_;  ///< Позиции полей по раскладкам
+  std::string key_;            ///< Буфер нормализованного пути образа
+  std::string target_;         ///< Буфер нормализованного пути модуля
+};
+
+}
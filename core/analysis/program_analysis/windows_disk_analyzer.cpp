@@ -3,16 +3,89 @@
 #include <filesystem>
 #include <utility>
 
+#include "../../../parsers/event_log/formats/evt/native_parser.hpp"
 #include "../../../parsers/event_log/formats/evt/parser.hpp"
+#include "../../../parsers/event_log/formats/evtx/native_parser.hpp"
 #include "../../../parsers/event_log/formats/evtx/parser.hpp"
 #include "../../../parsers/registry/parser/parser.hpp"
 #include "../../../utils/export/csv_exporter.hpp"
 #include "../../../utils/logging/logger.hpp"
+#include "../../../utils/utils.hpp"
 #include "../os_detection/os_detection.hpp"
 
 namespace fs = std::filesystem;
 using namespace WindowsDiskAnalysis;
 
+namespace {
+
+/// @brief Читает политику сохранения XML событий из раздела версии ОС
+/// @details EventLogXml = never | always | matching; для режима matching
+/// идентификаторы перечисляются в EventLogXmlIDs
+EventLogAnalysis::XmlRetention loadXmlRetention(const Config& config,
+                                                const std::string& section) {
+  const auto logger = GlobalLogger::get();
+  EventLogAnalysis::XmlRetention retention;
+
+  const std::string mode = config.getString(section, "EventLogXml", "never");
+  if (const auto parsed = EventLogAnalysis::XmlRetention::parseMode(mode)) {
+    retention.mode = *parsed;
+  } else {
+    logger->warn("Неизвестный режим сохранения XML \"{}\", XML не сохраняется",
+                 mode);
+  }
+
+  for (const auto& id_str :
+       split(config.getString(section, "EventLogXmlIDs", ""), ',')) {
+    try {
+      retention.event_ids.add(static_cast<uint32_t>(std::stoul(id_str)));
+    } catch (...) {
+      logger->debug("Некорректный ID события для XML: \"{}\"", id_str);
+    }
+  }
+  return retention;
+}
+
+/// @brief Читает имя компьютера из куста SYSTEM образа
+/// @param disk_root Корневой путь диска
+/// @param software_hive Путь к кусту SOFTWARE от корня диска; SYSTEM лежит
+/// в том же каталоге
+/// @return Имя компьютера или пустая строка, если его не удалось прочитать
+std::string readComputerName(const std::string& disk_root,
+                             const std::string& software_hive) {
+  const size_t slash = software_hive.find_last_of("/\\");
+  const std::string system_hive =
+      disk_root +
+      software_hive.substr(0, slash == std::string::npos ? 0 : slash + 1) +
+      "SYSTEM";
+  if (!fs::exists(system_hive)) {
+    return {};
+  }
+
+  try {
+    RegistryAnalysis::RegistryParser parser;
+    uint32_t current = 1;
+    if (const auto value = parser.getSpecificValue(system_hive,
+                                                   "Select/Current")) {
+      current = value->getAsDword();
+    }
+    std::string control_set = std::to_string(current);
+    control_set.insert(0, control_set.size() < 3 ? 3 - control_set.size() : 0,
+                       '0');
+    if (const auto value = parser.getSpecificValue(
+            system_hive, "ControlSet" + control_set +
+                             "/Control/ComputerName/ComputerName/"
+                             "ComputerName")) {
+      return value->getAsString();
+    }
+  } catch (const std::exception& e) {
+    GlobalLogger::get()->debug("Имя компьютера не прочитано: \"{}\"",
+                               e.what());
+  }
+  return {};
+}
+
+}
+
 WindowsDiskAnalyzer::WindowsDiskAnalyzer(std::string disk_root,
                                          const std::string& config_path)
     : disk_root_(std::move(disk_root)), config_path_(config_path) {
@@ -37,8 +110,60 @@ void WindowsDiskAnalyzer::initializeComponents() {
   // Инициализация парсеров
   auto registry_parser = std::make_unique<RegistryAnalysis::RegistryParser>();
   auto prefetch_parser = std::make_unique<PrefetchAnalysis::PrefetchParser>();
-  auto evt_parser = std::make_unique<EventLogAnalysis::EvtParser>();
-  auto evtx_parser = std::make_unique<EventLogAnalysis::EvtxParser>();
+  EventLogParserFactory evt_factory;
+  EventLogParserFactory evtx_factory;
+
+  // Собственные парсеры EVT и EVTX разбирают файл параллельно; libevt и
+  // libevtx остаются доступны как запасной вариант
+  Config config(config_path_);
+  const bool recover = config.getBool("General", "EventLogRecovery", false);
+  eventlog_summary_path_ =
+      config.getString("General", "EventLogSummaryFile", "");
+  trim(eventlog_summary_path_);
+  eventlog_summary_only_ =
+      !eventlog_summary_path_.empty() &&
+      config.getBool("General", "EventLogSummaryOnly", false);
+  eventlog_timeline_path_ =
+      config.getString("General", "EventLogTimelineFile", "");
+  trim(eventlog_timeline_path_);
+  if (config.getBool("General", "NativeEvtParser", true)) {
+    EventLogAnalysis::EvtNativeParserOptions evt_options;
+    const int record_threads = config.getInt("General", "EvtRecordThreads", 0);
+    evt_options.worker_threads =
+        record_threads > 0 ? static_cast<size_t>(record_threads) : 0;
+    evt_options.recover = recover;
+    evt_factory = [evt_options]()
+        -> std::unique_ptr<EventLogAnalysis::IEventLogParser> {
+      return std::make_unique<EventLogAnalysis::EvtNativeParser>(evt_options);
+    };
+  } else {
+    evt_factory = []() -> std::unique_ptr<EventLogAnalysis::IEventLogParser> {
+      return std::make_unique<EventLogAnalysis::EvtParser>();
+    };
+  }
+
+  const auto xml_retention = loadXmlRetention(config, os_info_.ini_version);
+  if (config.getBool("General", "NativeEvtxParser", true)) {
+    EventLogAnalysis::EvtxNativeParserOptions evtx_options;
+    evtx_options.xml = xml_retention;
+    const int chunk_threads = config.getInt("General", "EvtxChunkThreads", 0);
+    evtx_options.worker_threads =
+        chunk_threads > 0 ? static_cast<size_t>(chunk_threads) : 0;
+    evtx_options.index_dir =
+        config.getString("General", "EventLogIndexDir", "");
+    evtx_options.recover = recover;
+    evtx_factory = [evtx_options]()
+        -> std::unique_ptr<EventLogAnalysis::IEventLogParser> {
+      return std::make_unique<EventLogAnalysis::EvtxNativeParser>(evtx_options);
+    };
+  } else {
+    EventLogAnalysis::EvtxParserOptions evtx_options;
+    evtx_options.xml = xml_retention;
+    evtx_factory = [evtx_options]()
+        -> std::unique_ptr<EventLogAnalysis::IEventLogParser> {
+      return std::make_unique<EventLogAnalysis::EvtxParser>(evtx_options);
+    };
+  }
 
   // Создание анализаторов
   auto autorun_config =
@@ -50,8 +175,39 @@ void WindowsDiskAnalyzer::initializeComponents() {
       std::move(prefetch_parser), os_info_.ini_version, config_path_);
 
   eventlog_analyzer_ = std::make_unique<EventLogAnalyzer>(
-      std::move(evt_parser), std::move(evtx_parser), os_info_.ini_version,
+      std::move(evt_factory), std::move(evtx_factory), os_info_.ini_version,
       config_path_);
+  // Контрольные точки журналов привязываются к узлу: общий каталог точек
+  // может использоваться для образов разных компьютеров
+  std::string checkpoint_dir =
+      config.getString("General", "EventLogCheckpointDir", "");
+  trim(checkpoint_dir);
+  if (!checkpoint_dir.empty()) {
+    std::string software_hive =
+        config.getString(os_info_.ini_version, "RegistryPath", "");
+    trim(software_hive);
+    std::string computer_name = readComputerName(disk_root_, software_hive);
+    if (computer_name.empty()) {
+      GlobalLogger::get()->warn(
+          "Имя компьютера образа не найдено, контрольные точки журналов "
+          "привязываются к пути образа");
+    }
+    eventlog_analyzer_->setHostIdentity(std::move(computer_name));
+  }
+  // Описания по сообщениям провайдеров выводятся в хронологию событий,
+  // поэтому без нее ресурсы провайдеров не загружаются
+  auto message_config = ProviderMessageResolver::createConfig(
+      config_path_, os_info_.ini_version);
+  if (message_config.enabled && eventlog_timeline_path_.empty()) {
+    GlobalLogger::get()->warn(
+        "EventMessageResolution не используется: не задан "
+        "EventLogTimelineFile");
+  } else if (message_config.enabled) {
+    eventlog_analyzer_->setMessageResolver(
+        std::make_shared<ProviderMessageResolver>(
+            std::make_unique<RegistryAnalysis::RegistryParser>(), disk_root_,
+            std::move(message_config)));
+  }
 
   // Добавленная инициализация AmcacheAnalyzer
   auto amcache_registry_parser =
@@ -83,9 +239,20 @@ void WindowsDiskAnalyzer::analyze(const std::string& output_path,
     result.process_data[info.filename] = std::move(info);
   }
 
-  // 4. Анализ журналов событий
-  eventlog_analyzer_->collect(disk_root_, result.process_data,
-                              result.network_connections);
+  // 4. Анализ журналов событий: сводка по каналам, хронология и (или)
+  // полный разбор
+  if (!eventlog_summary_path_.empty()) {
+    ensureDirectoryExists(eventlog_summary_path_);
+    eventlog_analyzer_->summarize(disk_root_, eventlog_summary_path_);
+  }
+  if (!eventlog_timeline_path_.empty()) {
+    ensureDirectoryExists(eventlog_timeline_path_);
+    eventlog_analyzer_->exportTimeline(disk_root_, eventlog_timeline_path_);
+  }
+  if (!eventlog_summary_only_) {
+    eventlog_analyzer_->collect(disk_root_, result.process_data,
+                                result.network_connections);
+  }
 
   // 5. Экспорт результатов
   ensureDirectoryExists(output_path);
@@ -45,9 +45,12 @@ class WindowsDiskAnalyzer {
   /// @param[in] path Путь к файлу или директории
   static void ensureDirectoryExists(const std::string& path);
 
-  std::string disk_root_;    ///< Корневой путь к диску
-  std::string config_path_;  ///< Путь к конфигурации
-  OSInfo os_info_;           ///< Информация об ОС
+  std::string disk_root_;               ///< Корневой путь к диску
+  std::string config_path_;             ///< Путь к конфигурации
+  OSInfo os_info_;                      ///< Информация об ОС
+  std::string eventlog_summary_path_;   ///< Файл сводки журналов (пусто - нет)
+  bool eventlog_summary_only_ = false;  ///< Только сводка журналов
+  std::string eventlog_timeline_path_;  ///< Файл хронологии (пусто - нет)
 
   std::unique_ptr<AutorunAnalyzer>
       autorun_analyzer_;  ///< Анализатор автозагрузки
@@ -0,0 +1,43 @@
+/// @file byte_order.hpp
+/// @brief Чтение little-endian значений из двоичных буферов
+
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+/// @namespace EventLogAnalysis
+/// @brief Пространство имен для работы с журналами событий Windows
+namespace EventLogAnalysis {
+
+/// @brief Читает little-endian значение по невыровненному адресу
+/// @tparam T Целочисленный тип значения
+/// @param data Указатель на первый байт значения
+/// @return Прочитанное значение
+template <typename T>
+[[nodiscard]] inline T readLittleEndian(const uint8_t* data) noexcept {
+  static_assert(std::is_integral_v<T>, "Ожидается целочисленный тип");
+
+  T value;
+  std::memcpy(&value, data, sizeof(T));
+  if constexpr (std::endian::native == std::endian::big && sizeof(T) > 1) {
+    value = std::byteswap(value);
+  }
+  return value;
+}
+
+/// @brief Читает little-endian значение из буфера по смещению
+/// @tparam T Целочисленный тип значения
+/// @param data Буфер
+/// @param offset Смещение значения (вызывающий проверяет границы)
+/// @return Прочитанное значение
+template <typename T>
+[[nodiscard]] inline T readLittleEndian(std::span<const uint8_t> data,
+                                        size_t offset) noexcept {
+  return readLittleEndian<T>(data.data() + offset);
+}
+
+}
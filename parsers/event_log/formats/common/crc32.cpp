@@ -0,0 +1,62 @@
+#include "crc32.hpp"
+
+#include <array>
+
+#include "byte_order.hpp"
+
+namespace EventLogAnalysis {
+
+namespace {
+
+using CrcTables = std::array<std::array<uint32_t, 256>, 8>;
+
+constexpr CrcTables makeTables() {
+  CrcTables tables{};
+
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint32_t crc = i;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320U : 0);
+    }
+    tables[0][i] = crc;
+  }
+
+  for (uint32_t i = 0; i < 256; ++i) {
+    for (size_t slice = 1; slice < tables.size(); ++slice) {
+      const uint32_t prev = tables[slice - 1][i];
+      tables[slice][i] = (prev >> 8) ^ tables[0][prev & 0xFF];
+    }
+  }
+
+  return tables;
+}
+
+constexpr CrcTables kTables = makeTables();
+
+}
+
+uint32_t Crc32::compute(std::span<const uint8_t> data, uint32_t crc) noexcept {
+  crc = ~crc;
+
+  const uint8_t* cursor = data.data();
+  size_t remaining = data.size();
+
+  while (remaining >= 8) {
+    const uint32_t low = readLittleEndian<uint32_t>(cursor) ^ crc;
+    const uint32_t high = readLittleEndian<uint32_t>(cursor + 4);
+    crc = kTables[7][low & 0xFF] ^ kTables[6][(low >> 8) & 0xFF] ^
+          kTables[5][(low >> 16) & 0xFF] ^ kTables[4][low >> 24] ^
+          kTables[3][high & 0xFF] ^ kTables[2][(high >> 8) & 0xFF] ^
+          kTables[1][(high >> 16) & 0xFF] ^ kTables[0][high >> 24];
+    cursor += 8;
+    remaining -= 8;
+  }
+
+  while (remaining-- > 0) {
+    crc = (crc >> 8) ^ kTables[0][(crc ^ *cursor++) & 0xFF];
+  }
+
+  return ~crc;
+}
+
+}
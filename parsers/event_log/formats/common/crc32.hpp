@@ -0,0 +1,26 @@
+/// @file crc32.hpp
+/// @brief Вычисление контрольной суммы CRC-32 (IEEE 802.3)
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+/// @namespace EventLogAnalysis
+/// @brief Пространство имен для работы с журналами событий Windows
+namespace EventLogAnalysis {
+
+/// @class Crc32
+/// @brief CRC-32 с полиномом 0xEDB88320, используемый в заголовках EVTX
+/// @details Таблично, по 8 байт за итерацию (slicing-by-8)
+class Crc32 {
+ public:
+  /// @brief Вычисляет CRC-32 блока данных
+  /// @param data Данные
+  /// @param crc Контрольная сумма предыдущих блоков для продолжения расчета
+  /// @return Контрольная сумма
+  [[nodiscard]] static uint32_t compute(std::span<const uint8_t> data,
+                                        uint32_t crc = 0) noexcept;
+};
+
+}
@@ -0,0 +1,85 @@
+#include "mapped_file.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace EventLogAnalysis {
+
+MappedFile::MappedFile(const std::string& file_path) {
+  const int fd = ::open(file_path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Не удалось открыть файл: " + file_path);
+  }
+
+  struct stat info {};
+  if (::fstat(fd, &info) != 0) {
+    ::close(fd);
+    throw std::runtime_error("Не удалось получить размер файла: " + file_path);
+  }
+
+  size_ = static_cast<size_t>(info.st_size);
+  if (size_ == 0) {
+    ::close(fd);
+    return;
+  }
+
+  void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  // Дескриптор не нужен после создания отображения
+  ::close(fd);
+
+  if (mapping == MAP_FAILED) {
+    size_ = 0;
+    throw std::runtime_error("Не удалось отобразить файл в память: " +
+                             file_path);
+  }
+
+  data_ = static_cast<const uint8_t*>(mapping);
+  ::posix_madvise(mapping, size_, POSIX_MADV_SEQUENTIAL);
+}
+
+MappedFile::~MappedFile() { release(); }
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    release();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+  }
+  return *this;
+}
+
+std::span<const uint8_t> MappedFile::bytes() const noexcept {
+  return {data_, size_};
+}
+
+size_t MappedFile::size() const noexcept { return size_; }
+
+void MappedFile::release() noexcept {
+  if (data_) {
+    ::munmap(const_cast<uint8_t*>(data_), size_);
+    data_ = nullptr;
+  }
+  size_ = 0;
+}
+
+std::vector<uint8_t> readFilePrefix(const std::string& file_path,
+                                    size_t size) {
+  std::vector<uint8_t> bytes(size);
+  std::ifstream in(file_path, std::ios::binary);
+  in.read(reinterpret_cast<char*>(bytes.data()),
+          static_cast<std::streamsize>(size));
+  bytes.resize(static_cast<size_t>(in.gcount()));
+  return bytes;
+}
+
+}
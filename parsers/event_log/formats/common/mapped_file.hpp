@@ -0,0 +1,67 @@
+/// @file mapped_file.hpp
+/// @brief Отображение файла журнала в память только для чтения
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+/// @namespace EventLogAnalysis
+/// @brief Пространство имен для работы с журналами событий Windows
+namespace EventLogAnalysis {
+
+/// @class MappedFile
+/// @brief Файл, отображенный в память (mmap) только для чтения
+/// @details Страницы подгружаются ядром по мере обращения, поэтому несколько
+/// потоков могут разбирать разные участки файла без копирования в буферы
+class MappedFile {
+ public:
+  /// @brief Отображает файл в память
+  /// @param file_path Путь к файлу
+  /// @throws std::runtime_error Если файл не удалось открыть или отобразить
+  explicit MappedFile(const std::string& file_path);
+
+  /// @brief Деструктор, снимает отображение
+  ~MappedFile();
+
+  /// @brief Конструктор копирования (запрещен)
+  MappedFile(const MappedFile&) = delete;
+
+  /// @brief Оператор присваивания копированием (запрещен)
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /// @brief Конструктор перемещения
+  MappedFile(MappedFile&& other) noexcept;
+
+  /// @brief Оператор присваивания перемещением
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  /// @brief Возвращает содержимое файла
+  /// @return Диапазон байтов отображения (пустой для пустого файла)
+  [[nodiscard]] std::span<const uint8_t> bytes() const noexcept;
+
+  /// @brief Возвращает размер файла
+  /// @return Размер в байтах
+  [[nodiscard]] size_t size() const noexcept;
+
+ private:
+  /// @brief Снимает отображение
+  void release() noexcept;
+
+  const uint8_t* data_ = nullptr;  ///< Начало отображения
+  size_t size_ = 0;                ///< Размер отображения
+};
+
+/// @brief Читает начало файла без отображения в память
+/// @details Используется для заголовков: чтение нескольких килобайт
+/// дешевле создания отображения всего файла
+/// @param file_path Путь к файлу
+/// @param size Количество байтов
+/// @return Прочитанные байты (меньше size для короткого файла, пусто -
+/// если файл не удалось открыть)
+[[nodiscard]] std::vector<uint8_t> readFilePrefix(const std::string& file_path,
+                                                  size_t size);
+
+}
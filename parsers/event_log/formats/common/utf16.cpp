@@ -0,0 +1,78 @@
+#include "utf16.hpp"
+
+#include "byte_order.hpp"
+
+namespace EventLogAnalysis {
+
+namespace {
+
+constexpr uint32_t kReplacementCharacter = 0xFFFD;
+
+void appendCodePoint(std::string& out, uint32_t code_point) {
+  if (code_point < 0x80) {
+    out += static_cast<char>(code_point);
+  } else if (code_point < 0x800) {
+    out += static_cast<char>(0xC0 | (code_point >> 6));
+    out += static_cast<char>(0x80 | (code_point & 0x3F));
+  } else if (code_point < 0x10000) {
+    out += static_cast<char>(0xE0 | (code_point >> 12));
+    out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (code_point & 0x3F));
+  } else {
+    out += static_cast<char>(0xF0 | (code_point >> 18));
+    out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+    out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (code_point & 0x3F));
+  }
+}
+
+}
+
+void Utf16::appendUtf8(std::string& out, std::span<const uint8_t> utf16) {
+  const size_t units = utf16.size() / 2;
+  out.reserve(out.size() + units);
+
+  for (size_t i = 0; i < units; ++i) {
+    const uint16_t unit = readLittleEndian<uint16_t>(utf16, i * 2);
+
+    // Основной случай в журналах - ASCII
+    if (unit < 0x80) {
+      out += static_cast<char>(unit);
+      continue;
+    }
+
+    if (unit >= 0xD800 && unit <= 0xDBFF && i + 1 < units) {
+      const uint16_t low = readLittleEndian<uint16_t>(utf16, (i + 1) * 2);
+      if (low >= 0xDC00 && low <= 0xDFFF) {
+        appendCodePoint(out, 0x10000 + ((static_cast<uint32_t>(unit) - 0xD800)
+                                        << 10) +
+                                 (static_cast<uint32_t>(low) - 0xDC00));
+        ++i;
+        continue;
+      }
+    }
+
+    if (unit >= 0xD800 && unit <= 0xDFFF) {
+      appendCodePoint(out, kReplacementCharacter);
+    } else {
+      appendCodePoint(out, unit);
+    }
+  }
+}
+
+std::string Utf16::toUtf8(std::span<const uint8_t> utf16) {
+  std::string result;
+  appendUtf8(result, utf16);
+  return result;
+}
+
+std::span<const uint8_t> Utf16::trimNulls(
+    std::span<const uint8_t> utf16) noexcept {
+  size_t size = utf16.size() & ~static_cast<size_t>(1);
+  while (size >= 2 && utf16[size - 1] == 0 && utf16[size - 2] == 0) {
+    size -= 2;
+  }
+  return utf16.first(size);
+}
+
+}
@@ -0,0 +1,37 @@
+/// @file utf16.hpp
+/// @brief Преобразование строк UTF-16LE из двоичных форматов в UTF-8
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+
+/// @namespace EventLogAnalysis
+/// @brief Пространство имен для работы с журналами событий Windows
+namespace EventLogAnalysis {
+
+/// @class Utf16
+/// @brief Конвертер строк UTF-16LE, хранящихся в файлах журналов
+class Utf16 {
+ public:
+  /// @brief Дописывает строку UTF-16LE в строку UTF-8
+  /// @details Суррогатные пары объединяются, одиночные суррогаты заменяются
+  /// символом U+FFFD. Нечетный завершающий байт игнорируется.
+  /// @param out Строка-приемник
+  /// @param utf16 Байты строки UTF-16LE
+  static void appendUtf8(std::string& out, std::span<const uint8_t> utf16);
+
+  /// @brief Преобразует строку UTF-16LE в UTF-8
+  /// @param utf16 Байты строки UTF-16LE
+  /// @return Строка UTF-8
+  [[nodiscard]] static std::string toUtf8(std::span<const uint8_t> utf16);
+
+  /// @brief Обрезает завершающие нулевые символы UTF-16
+  /// @param utf16 Байты строки UTF-16LE
+  /// @return Диапазон без завершающих нулей
+  [[nodiscard]] static std::span<const uint8_t> trimNulls(
+      std::span<const uint8_t> utf16) noexcept;
+};
+
+}
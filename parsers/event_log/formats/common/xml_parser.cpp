@@ -1,50 +1,227 @@
 #include "xml_parser.hpp"
 
+#include <cstring>
+
 namespace EventLogAnalysis {
 
+namespace {
+
+constexpr std::string_view kDataOpen = "Data";
+constexpr std::string_view kNameAttribute = "Name=\"";
+constexpr std::string_view kDataClose = "</Data>";
+constexpr std::string_view kDescriptionOpen = "<Description>";
+constexpr std::string_view kDescriptionClose = "</Description>";
+constexpr size_t kMaxEntityLength = 10;  ///< Окно поиска ';' ("#x10FFFF;")
+
+/// @brief Ищет символ начиная с позиции (memchr векторизован в libc)
+size_t findChar(std::string_view text, size_t pos, char ch) noexcept {
+  if (pos >= text.size()) return std::string_view::npos;
+  const void* found = std::memchr(text.data() + pos, ch, text.size() - pos);
+  return found ? static_cast<size_t>(static_cast<const char*>(found) -
+                                     text.data())
+               : std::string_view::npos;
+}
+
+bool isXmlSpace(char ch) noexcept {
+  return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n';
+}
+
+/// @brief Кодирует кодовую точку Unicode в UTF-8
+void appendUtf8(std::string& out, uint32_t code_point) {
+  if (code_point < 0x80) {
+    out += static_cast<char>(code_point);
+  } else if (code_point < 0x800) {
+    out += static_cast<char>(0xC0 | (code_point >> 6));
+    out += static_cast<char>(0x80 | (code_point & 0x3F));
+  } else if (code_point < 0x10000) {
+    out += static_cast<char>(0xE0 | (code_point >> 12));
+    out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (code_point & 0x3F));
+  } else {
+    out += static_cast<char>(0xF0 | (code_point >> 18));
+    out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+    out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (code_point & 0x3F));
+  }
+}
+
+}
+
 std::unordered_map<std::string, std::string> XmlEventParser::parseEventData(
-    const std::string& xml) {
+    std::string_view xml) {
   std::unordered_map<std::string, std::string> result;
 
-  try {
-    auto it = std::sregex_iterator(xml.begin(), xml.end(), DATA_REGEX);
+  forEachDataField(xml, [&result](std::string_view name,
+                                  std::string_view raw_value) {
+    std::string value;
+    appendDecoded(value, raw_value);
+    result.emplace(std::string(name), std::move(value));
+  });
 
-    for (auto end = std::sregex_iterator(); it != end; ++it) {
-      if (const std::smatch& match = *it; match.size() == 3) {
-        std::string name = match[1].str();
-        std::string value = decodeXmlEntities(match[2].str());
-        result.emplace(std::move(name), std::move(value));
-      }
+  return result;
+}
+
+void XmlEventParser::forEachDataField(std::string_view xml,
+                                      const DataFieldVisitor& visitor) {
+  size_t pos = 0;
+
+  while ((pos = findChar(xml, pos, '<')) != std::string_view::npos) {
+    ++pos;
+
+    std::string_view name;
+    std::string_view value;
+    if (parseDataElement(xml, pos, name, value)) {
+      visitor(name, value);
     }
-  } catch (const std::regex_error&) {
-    // Игнорируем ошибки regex
   }
+}
 
-  return result;
+bool XmlEventParser::parseDataElement(std::string_view xml, size_t& pos,
+                                      std::string_view& name,
+                                      std::string_view& value) {
+  // <Data\s+Name="имя">значение</Data> или <Data Name="имя"/>
+  if (xml.compare(pos, kDataOpen.size(), kDataOpen) != 0) {
+    return false;
+  }
+
+  size_t cursor = pos + kDataOpen.size();
+  if (cursor >= xml.size() || !isXmlSpace(xml[cursor])) {
+    return false;
+  }
+  while (cursor < xml.size() && isXmlSpace(xml[cursor])) {
+    ++cursor;
+  }
+
+  if (xml.compare(cursor, kNameAttribute.size(), kNameAttribute) != 0) {
+    return false;
+  }
+  cursor += kNameAttribute.size();
+
+  const size_t name_end = findChar(xml, cursor, '"');
+  if (name_end == std::string_view::npos || name_end == cursor) {
+    return false;
+  }
+  name = xml.substr(cursor, name_end - cursor);
+  cursor = name_end + 1;
+
+  if (xml.compare(cursor, 2, "/>") == 0) {
+    value = {};
+    pos = cursor + 2;
+    return true;
+  }
+  if (cursor >= xml.size() || xml[cursor] != '>') {
+    return false;
+  }
+  ++cursor;
+
+  const size_t value_end = findChar(xml, cursor, '<');
+  if (value_end == std::string_view::npos ||
+      xml.compare(value_end, kDataClose.size(), kDataClose) != 0) {
+    return false;
+  }
+
+  value = xml.substr(cursor, value_end - cursor);
+  pos = value_end + kDataClose.size();
+  return true;
 }
 
-std::string XmlEventParser::parseDescription(const std::string& xml) {
-  try {
-    std::smatch match;
-    if (std::regex_search(xml, match, DESC_REGEX) && match.size() > 1) {
-      return decodeXmlEntities(match[1].str());
-    }
-  } catch (const std::regex_error&) {
-    // Игнорируем ошибки regex
+std::string XmlEventParser::parseDescription(std::string_view xml) {
+  const size_t open = xml.find(kDescriptionOpen);
+  if (open == std::string_view::npos) {
+    return "";
   }
 
-  return "";
+  const size_t begin = open + kDescriptionOpen.size();
+  const size_t end = findChar(xml, begin, '<');
+  if (end == std::string_view::npos || end == begin ||
+      xml.compare(end, kDescriptionClose.size(), kDescriptionClose) != 0) {
+    return "";
+  }
+
+  std::string description;
+  appendDecoded(description, xml.substr(begin, end - begin));
+  return description;
 }
 
 std::string XmlEventParser::decodeXmlEntities(std::string text) {
-  for (const auto& [entity, replacement] : XML_ENTITIES) {
-    size_t pos = 0;
-    while ((pos = text.find(entity, pos)) != std::string::npos) {
-      text.replace(pos, entity.length(), replacement);
-      pos += replacement.length();
+  if (findChar(text, 0, '&') == std::string_view::npos) {
+    return text;
+  }
+
+  std::string result;
+  appendDecoded(result, text);
+  return result;
+}
+
+void XmlEventParser::appendDecoded(std::string& out, std::string_view text) {
+  out.reserve(out.size() + text.size());
+
+  size_t pos = 0;
+  while (pos < text.size()) {
+    const size_t amp = findChar(text, pos, '&');
+    if (amp == std::string_view::npos) {
+      out.append(text.substr(pos));
+      return;
+    }
+
+    out.append(text.substr(pos, amp - pos));
+
+    // ';' ищется только в окне длины самой длинной сущности: значение с
+    // множеством одиночных '&' декодируется за линейное время
+    const std::string_view window = text.substr(amp + 1, kMaxEntityLength);
+    const size_t length = window.find(';');
+    if (length == std::string_view::npos ||
+        !appendEntity(window.substr(0, length), out)) {
+      out += '&';
+      pos = amp + 1;
+      continue;
+    }
+
+    pos = amp + length + 2;
+  }
+}
+
+bool XmlEventParser::appendEntity(std::string_view entity, std::string& out) {
+  if (entity == "amp") {
+    out += '&';
+  } else if (entity == "lt") {
+    out += '<';
+  } else if (entity == "gt") {
+    out += '>';
+  } else if (entity == "quot") {
+    out += '"';
+  } else if (entity == "apos") {
+    out += '\'';
+  } else if (entity.size() > 1 && entity[0] == '#') {
+    const bool hex = entity[1] == 'x' || entity[1] == 'X';
+    const std::string_view digits = entity.substr(hex ? 2 : 1);
+    if (digits.empty()) {
+      return false;
     }
+
+    uint32_t code_point = 0;
+    for (const char ch : digits) {
+      uint32_t digit = 0;
+      if (ch >= '0' && ch <= '9') {
+        digit = static_cast<uint32_t>(ch - '0');
+      } else if (hex && ch >= 'a' && ch <= 'f') {
+        digit = static_cast<uint32_t>(ch - 'a' + 10);
+      } else if (hex && ch >= 'A' && ch <= 'F') {
+        digit = static_cast<uint32_t>(ch - 'A' + 10);
+      } else {
+        return false;
+      }
+      code_point = code_point * (hex ? 16 : 10) + digit;
+      if (code_point > 0x10FFFF) {
+        return false;
+      }
+    }
+    appendUtf8(out, code_point);
+  } else {
+    return false;
   }
-  return text;
+
+  return true;
 }
 
 }
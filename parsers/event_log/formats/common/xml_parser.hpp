@@ -3,8 +3,9 @@
 
 #pragma once
 
-#include <regex>
+#include <functional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
 /// @namespace EventLogAnalysis
@@ -13,42 +14,62 @@ namespace EventLogAnalysis {
 
 /// @class XmlEventParser
 /// @brief Парсер XML данных из событий Windows
+/// @details Разбор выполняется за один проход без регулярных выражений:
+/// поиск '<' и '&' ведется через memchr (векторизованный в libc), найденные
+/// элементы передаются как представления исходной строки, сущности
+/// декодируются при копировании значения.
 class XmlEventParser {
  public:
+  /// @brief Обработчик пары <Data Name="имя">значение</Data>
+  /// @details Значение передается в исходном виде, с XML-сущностями
+  using DataFieldVisitor =
+      std::function<void(std::string_view name, std::string_view raw_value)>;
+
   /// @brief Извлекает данные события из XML
   /// @param xml Строка с XML-представлением события
   /// @return Словарь с извлеченными данными (имя параметра -> значение)
   static std::unordered_map<std::string, std::string> parseEventData(
-      const std::string& xml);
+      std::string_view xml);
+
+  /// @brief Перебирает элементы <Data Name="..."> без копирования
+  /// @param xml Строка с XML-представлением события
+  /// @param visitor Обработчик пар (имя, значение)
+  static void forEachDataField(std::string_view xml,
+                               const DataFieldVisitor& visitor);
 
   /// @brief Извлекает описание события из XML
   /// @param xml Строка с XML-представлением события
   /// @return Строка с описанием события или пустая строка если не найдено
-  static std::string parseDescription(const std::string& xml);
+  static std::string parseDescription(std::string_view xml);
 
   /// @brief Декодирует XML entities
   /// @param text Текст с XML-сущностями для декодирования
   /// @return Текст с декодированными XML-сущностями
   static std::string decodeXmlEntities(std::string text);
 
+  /// @brief Дописывает текст в строку, декодируя XML-сущности
+  /// @details Поддерживаются именованные сущности amp, lt, gt, quot, apos и
+  /// числовые ссылки &#N; / &#xN;. Нераспознанные сущности копируются как есть.
+  /// @param out Строка-приемник
+  /// @param text Исходный текст
+  static void appendDecoded(std::string& out, std::string_view text);
+
  private:
-  inline static const std::regex DATA_REGEX{
-      R"xml(<Data\s+Name="([^"]+)">([^<]*)</Data>)xml"};  ///< Регулярное
-                                                          ///< выражение для
-                                                          ///< поиска тегов
-                                                          ///< <Data>
-
-  inline static const std::regex DESC_REGEX{
-      R"xml(<Description>([^<]+)</Description>)xml"};  ///< Регулярное выражение
-                                                       ///< для поиска тега
-                                                       ///< <Description>
-
-  inline static const std::unordered_map<std::string, std::string> XML_ENTITIES{
-      {"&amp;", "&"},
-      {"&lt;", "<"},
-      {"&gt;", ">"},
-      {"&quot;", "\""},
-      {"&apos;", "'"}};  ///< Карта XML-сущностей для декодирования
+  /// @brief Разбирает элемент <Data> начиная с позиции после '<'
+  /// @param xml Исходный XML
+  /// @param pos Позиция сразу после '<'; при успехе сдвигается за </Data>
+  /// @param name Имя поля (результат)
+  /// @param value Значение поля в исходном виде (результат)
+  /// @return true если элемент разобран
+  static bool parseDataElement(std::string_view xml, size_t& pos,
+                               std::string_view& name,
+                               std::string_view& value);
+
+  /// @brief Декодирует одну XML-сущность
+  /// @param entity Текст сущности между '&' и ';'
+  /// @param out Строка-приемник
+  /// @return true если сущность распознана
+  static bool appendEntity(std::string_view entity, std::string& out);
 };
 
 }
@@ -0,0 +1,366 @@
+#include "native_parser.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <future>
+
+#include "../../../../utils/concurrency/thread_pool.hpp"
+#include "../../../../utils/logging/logger.hpp"
+#include "../../model/event_data_builder.hpp"
+#include "../common/byte_order.hpp"
+#include "../common/crc32.hpp"
+#include "../common/time_converter.hpp"
+#include "../common/utf16.hpp"
+
+namespace EventLogAnalysis {
+
+namespace {
+
+// Типы событий EVT
+constexpr uint16_t kEventTypeError = 0x0001;
+constexpr uint16_t kEventTypeWarning = 0x0002;
+constexpr uint16_t kEventTypeInformation = 0x0004;
+constexpr uint16_t kEventTypeAuditSuccess = 0x0008;
+constexpr uint16_t kEventTypeAuditFailure = 0x0010;
+
+/// @brief Возвращает ключ поля строки события по номеру
+Symbol stringKey(size_t index) {
+  static const auto kKeys = [] {
+    std::array<Symbol, 32> keys;
+    for (size_t i = 0; i < keys.size(); ++i) {
+      keys[i] = Symbol::intern("String" + std::to_string(i));
+    }
+    return keys;
+  }();
+  return index < kKeys.size()
+             ? kKeys[index]
+             : Symbol::intern("String" + std::to_string(index));
+}
+
+/// @brief Выделяет строку UTF-16 с завершающим нулем
+/// @param record Байты записи
+/// @param pos Позиция строки, после вызова - позиция следующей строки
+/// @param end Граница области строк
+/// @return Байты строки без завершающего нуля
+std::span<const uint8_t> nextString(std::span<const uint8_t> record,
+                                    size_t& pos, size_t end) noexcept {
+  const size_t begin = pos;
+  while (pos + 2 <= end) {
+    if (record[pos] == 0 && record[pos + 1] == 0) {
+      pos += 2;
+      return record.subspan(begin, pos - 2 - begin);
+    }
+    pos += 2;
+  }
+  pos = end;
+  return record.subspan(begin, end - begin);
+}
+
+}
+
+EvtNativeParser::EvtNativeParser(EvtNativeParserOptions options)
+    : options_(options) {}
+
+std::vector<EventData> EvtNativeParser::parse(const std::string& file_path) {
+  std::vector<EventData> events;
+  forEachRecord(file_path, [&events](EventData&& event) {
+    events.push_back(std::move(event));
+    return true;
+  });
+  return events;
+}
+
+bool EvtNativeParser::forEachRecord(const std::string& file_path,
+                                    const EventRecordVisitor& visitor) {
+  return scanRecords(file_path, EventLogQuery{}, visitor);
+}
+
+bool EvtNativeParser::forEachRecord(const std::string& file_path,
+                                    const EventIdFilter& event_ids,
+                                    const EventRecordVisitor& visitor) {
+  EventLogQuery query;
+  query.event_ids = event_ids;
+  return scanRecords(file_path, query, visitor);
+}
+
+bool EvtNativeParser::queryRecords(const std::string& file_path,
+                                   const EventLogQuery& query,
+                                   const EventRecordVisitor& visitor) {
+  return scanRecords(file_path, query, visitor);
+}
+
+std::optional<EventLogTail> EvtNativeParser::locateRecord(
+    const std::string& file_path, uint64_t record_id) {
+  const MappedFile file(file_path);
+  const auto records = locateRecords(file.bytes(), file_path, false);
+
+  // Номера текущих записей возрастают по кольцу, последняя запись - с
+  // наибольшим номером
+  const auto found =
+      record_id == EventLogTail::kLastRecord
+          ? std::ranges::max_element(records, {},
+                                     &EvtRecordLocation::record_number)
+          : std::ranges::find(records, record_id,
+                              &EvtRecordLocation::record_number);
+  if (found == records.end()) {
+    return std::nullopt;
+  }
+
+  std::vector<uint8_t> wrapped;
+  return EventLogTail{
+      found->record_number, found->offset,
+      Crc32::compute(EvtRecordScanner::recordBytes(file.bytes(), *found,
+                                                   wrapped))};
+}
+
+std::optional<EventLogSummary> EvtNativeParser::readSummary(
+    const std::string& file_path) {
+  const auto header = EvtFileHeader::read(file_path);
+  if (!header) {
+    return std::nullopt;
+  }
+  return header->summary();
+}
+
+std::unique_ptr<IEventRecordReader> EvtNativeParser::openReader(
+    const std::string& file_path) {
+  return std::make_unique<EvtNativeRecordReader>(file_path, options_);
+}
+
+std::vector<EventData> EvtNativeParser::filterByEventId(
+    const std::string& file_path, uint32_t event_id) {
+  return filterByEventIds(file_path, EventIdFilter{event_id});
+}
+
+std::vector<EventData> EvtNativeParser::filterByEventIds(
+    const std::string& file_path, const EventIdFilter& event_ids) {
+  std::vector<EventData> events;
+  forEachRecord(file_path, event_ids, [&events](EventData&& event) {
+    events.push_back(std::move(event));
+    return true;
+  });
+  return events;
+}
+
+bool EvtNativeParser::supports(const std::string& file_path) const {
+  return file_path.length() > 4 &&
+         file_path.substr(file_path.length() - 4) == ".evt";
+}
+
+std::string EvtNativeParser::formatName() const {
+  return "Журнал событий Windows (EVT, собственный парсер)";
+}
+
+std::vector<std::string> EvtNativeParser::supportedExtensions() const {
+  return {".evt"};
+}
+
+std::vector<EvtRecordLocation> EvtNativeParser::locateRecords(
+    std::span<const uint8_t> file, const std::string& file_path,
+    bool recover) {
+  const auto logger = GlobalLogger::get();
+
+  auto header = EvtFileHeader::parse(file);
+  if (!header) {
+    if (!recover) {
+      throw std::runtime_error("Файл не является журналом EVT: " + file_path);
+    }
+    // Без заголовка область журнала неизвестна: записи выдаются по номерам
+    header = EvtFileHeader{};
+  }
+  if (header->isDirty()) {
+    logger->debug("Журнал EVT не был корректно закрыт: \"{}\"", file_path);
+  }
+
+  EvtRecordScan scan = EvtRecordScanner(file, *header).scan();
+  logger->debug(
+      "Журнал \"{}\": {} записей, {} записей вне области журнала{}", file_path,
+      scan.live.size(), scan.recovered.size(),
+      scan.cursor_found ? "" : ", запись конца журнала не найдена");
+
+  if (recover) {
+    scan.live.insert(scan.live.end(), scan.recovered.begin(),
+                     scan.recovered.end());
+  }
+  return std::move(scan.live);
+}
+
+std::vector<EventData> EvtNativeParser::decodeBatch(
+    std::span<const uint8_t> file, std::span<const EvtRecordLocation> batch,
+    const EventLogQuery& query) {
+  std::vector<EventData> events;
+  events.reserve(batch.size());
+
+  // Значения записей пакета размещаются в одной арене, повторы коротких
+  // значений (источник, компьютер, типовые строки) хранятся один раз
+  auto arena = std::make_shared<EventArena>(true);
+  std::vector<uint8_t> wrapped;
+  std::string text;
+  for (const auto& location : batch) {
+    EventData event = decodeRecord(
+        EvtRecordScanner::recordBytes(file, location, wrapped), arena, text);
+    if (query.accepts(event)) {
+      events.push_back(std::move(event));
+    }
+  }
+  arena->releaseSharing();
+  return events;
+}
+
+EventData EvtNativeParser::decodeRecord(std::span<const uint8_t> record,
+                                        std::shared_ptr<EventArena> arena,
+                                        std::string& text) {
+  EventDataBuilder builder(std::move(arena));
+  builder.setEventId(readLittleEndian<uint32_t>(record, 20))
+      .setTimestamp(TimeConverter::secondsSince1970ToFiletime(
+          readLittleEndian<uint32_t>(record, 16)))
+      .setRecordId(readLittleEndian<uint32_t>(record, 8))
+      .setLevel(convertEventType(readLittleEndian<uint16_t>(record, 24)));
+
+  // Имена источника и компьютера следуют за заголовком записи
+  const size_t end = record.size() - 4;
+  size_t pos = EvtRecordScanner::kRecordHeaderSize;
+  text.clear();
+  Utf16::appendUtf8(text, nextString(record, pos, end));
+  if (!text.empty()) builder.setProvider(text);
+  text.clear();
+  Utf16::appendUtf8(text, nextString(record, pos, end));
+  if (!text.empty()) builder.setComputer(text);
+
+  // Строки подстановки: поля StringN и описание через " | "
+  const uint16_t string_count = readLittleEndian<uint16_t>(record, 26);
+  pos = readLittleEndian<uint32_t>(record, 36);
+  std::string description;
+  for (uint16_t i = 0; i < string_count && pos < end; ++i) {
+    text.clear();
+    Utf16::appendUtf8(text, nextString(record, pos, end));
+    builder.addData(stringKey(i), text);
+
+    if (i > 0) description += " | ";
+    description += text;
+  }
+  if (!description.empty()) {
+    builder.setDescription(description);
+  }
+
+  return std::move(builder).build();
+}
+
+EventLevel EvtNativeParser::convertEventType(uint16_t event_type) noexcept {
+  switch (event_type) {
+    case kEventTypeError:
+      return EventLevel::Error;
+    case kEventTypeWarning:
+      return EventLevel::Warning;
+    case kEventTypeInformation:
+    case kEventTypeAuditSuccess:
+    case kEventTypeAuditFailure:
+      return EventLevel::Info;
+    default:
+      return EventLevel::LogAlways;
+  }
+}
+
+bool EvtNativeParser::scanRecords(const std::string& file_path,
+                                  const EventLogQuery& query,
+                                  const EventRecordVisitor& visitor) {
+  const MappedFile file(file_path);
+  std::vector<EvtRecordLocation> records =
+      locateRecords(file.bytes(), file_path, options_.recover);
+
+  // Номер, время и ID известны из заголовков записей: выборка отбирается
+  // до декодирования строк
+  const EventIdFilter* event_ids = query.eventIds();
+  if (event_ids || query.hasTimeWindow() || query.hasRecordRange()) {
+    std::erase_if(records, [&](const EvtRecordLocation& record) {
+      return !query.matches(record.record_number,
+                            TimeConverter::secondsSince1970ToFiletime(
+                                record.written_time)) ||
+             (event_ids && !event_ids->contains(record.event_id));
+    });
+  }
+  if (records.empty()) {
+    return true;
+  }
+
+  const std::span<const EvtRecordLocation> all = records;
+  const size_t batch_count = (records.size() + kBatchSize - 1) / kBatchSize;
+
+  // Флаг отмены объявлен до пула: задачи, оставшиеся в очереди при досрочной
+  // остановке, завершаются в деструкторе пула и обращаются к нему
+  std::atomic<bool> cancelled = false;
+  ThreadPool pool(
+      ThreadPool::resolveThreadCount(options_.worker_threads, batch_count));
+
+  // Окно задач ограничивает число декодированных, но не отданных пакетов
+  const size_t window = pool.size() * 2;
+  const auto bytes = file.bytes();
+  std::deque<std::future<std::vector<EventData>>> pending;
+  size_t next_batch = 0;
+
+  const auto submit_next = [&]() {
+    const size_t begin = next_batch++ * kBatchSize;
+    const auto batch =
+        all.subspan(begin, std::min(kBatchSize, all.size() - begin));
+    pending.push_back(pool.submit([bytes, batch, &query, &cancelled]() {
+      if (cancelled.load(std::memory_order_relaxed)) {
+        return std::vector<EventData>{};
+      }
+      return decodeBatch(bytes, batch, query);
+    }));
+  };
+
+  try {
+    while (next_batch < batch_count && pending.size() < window) {
+      submit_next();
+    }
+
+    while (!pending.empty()) {
+      std::vector<EventData> events = pending.front().get();
+      pending.pop_front();
+      if (next_batch < batch_count) {
+        submit_next();
+      }
+
+      for (auto& event : events) {
+        if (!visitor(std::move(event))) {
+          cancelled = true;
+          return false;
+        }
+      }
+    }
+  } catch (...) {
+    cancelled = true;
+    throw;
+  }
+  return true;
+}
+
+EvtNativeRecordReader::EvtNativeRecordReader(const std::string& file_path,
+                                             EvtNativeParserOptions options)
+    : file_(file_path),
+      records_(EvtNativeParser::locateRecords(file_.bytes(), file_path,
+                                              options.recover)) {}
+
+std::optional<EventData> EvtNativeRecordReader::next() {
+  while (pending_index_ == pending_.size()) {
+    if (next_record_ == records_.size()) {
+      return std::nullopt;
+    }
+    const size_t count =
+        std::min(EvtNativeParser::kBatchSize, records_.size() - next_record_);
+    pending_ = EvtNativeParser::decodeBatch(
+        file_.bytes(),
+        std::span<const EvtRecordLocation>(records_).subspan(next_record_,
+                                                             count),
+        EventLogQuery{});
+    next_record_ += count;
+    pending_index_ = 0;
+  }
+
+  return std::move(pending_[pending_index_++]);
+}
+
+}
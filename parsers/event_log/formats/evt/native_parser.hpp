@@ -0,0 +1,196 @@
+/// @file native_parser.hpp
+/// @brief Собственный многопоточный парсер EVT без libevt
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../../interfaces/iparser.hpp"
+#include "../../model/event_arena.hpp"
+#include "../../model/event_data.hpp"
+#include "../common/mapped_file.hpp"
+#include "record.hpp"
+
+/// @namespace EventLogAnalysis
+/// @brief Пространство имен для работы с журналами событий Windows
+namespace EventLogAnalysis {
+
+/// @brief Параметры собственного парсера EVT
+struct EvtNativeParserOptions {
+  size_t worker_threads = 0;  ///< Потоки разбора пакетов (0 - по числу ядер)
+  bool recover = false;       ///< Выдавать записи вне текущей области журнала
+};
+
+/// @class EvtNativeParser
+/// @brief Парсер EVT, разбирающий пакеты записей параллельно
+/// @details Файл отображается в память, записи находятся просмотром всего
+/// кольцевого буфера (см. EvtRecordScanner), в том числе записи на границе
+/// кольца. Номер, время и ID записи читаются при просмотре, поэтому выборка
+/// отбирается до разбора строк. Отобранные записи делятся на пакеты, которые
+/// декодируются задачами пула потоков; результаты передаются обработчику в
+/// порядке записей журнала. В режиме восстановления после них выдаются целые
+/// записи вне текущей области журнала в порядке номеров.
+class EvtNativeParser final : public IEventLogParser {
+ public:
+  /// @brief Конструктор
+  /// @param options Параметры разбора
+  explicit EvtNativeParser(EvtNativeParserOptions options = {});
+
+  /// @brief Парсит все события из EVT файла
+  /// @param file_path Путь к EVT файлу
+  /// @return Вектор разобранных событий
+  std::vector<EventData> parse(const std::string& file_path) override;
+
+  /// @brief Потоково обходит записи EVT файла
+  /// @param file_path Путь к EVT файлу
+  /// @param visitor Обработчик записей (false прекращает обход)
+  /// @return true если файл обойден полностью
+  bool forEachRecord(const std::string& file_path,
+                     const EventRecordVisitor& visitor) override;
+
+  /// @brief Открывает курсор для построчного чтения EVT файла
+  /// @details Курсор декодирует пакеты последовательно в вызывающем потоке
+  /// @param file_path Путь к EVT файлу
+  /// @return Курсор записей
+  /// @throws std::runtime_error Если файл не является журналом EVT
+  std::unique_ptr<IEventRecordReader> openReader(
+      const std::string& file_path) override;
+
+  /// @brief Фильтрует события по идентификатору из EVT файла
+  /// @param file_path Путь к EVT файлу
+  /// @param event_id Идентификатор события для фильтрации
+  /// @return Вектор событий с указанным идентификатором
+  std::vector<EventData> filterByEventId(const std::string& file_path,
+                                         uint32_t event_id) override;
+
+  /// @brief Фильтрует события по множеству идентификаторов из EVT файла
+  /// @param file_path Путь к EVT файлу
+  /// @param event_ids Множество идентификаторов событий
+  /// @return Вектор событий с подходящими идентификаторами
+  std::vector<EventData> filterByEventIds(
+      const std::string& file_path, const EventIdFilter& event_ids) override;
+
+  /// @brief Потоково обходит записи EVT файла с заданными идентификаторами
+  /// @param file_path Путь к EVT файлу
+  /// @param event_ids Множество идентификаторов событий
+  /// @param visitor Обработчик записей (false прекращает обход)
+  /// @return true если файл обойден полностью
+  bool forEachRecord(const std::string& file_path,
+                     const EventIdFilter& event_ids,
+                     const EventRecordVisitor& visitor) override;
+
+  /// @brief Потоково обходит записи EVT файла, попадающие в выборку
+  /// @details Номер, время и ID записи проверяются до декодирования строк
+  /// @param file_path Путь к EVT файлу
+  /// @param query Окно времени, диапазон номеров и идентификаторы событий
+  /// @param visitor Обработчик записей (false прекращает обход)
+  /// @return true если выборка обойдена полностью
+  bool queryRecords(const std::string& file_path, const EventLogQuery& query,
+                    const EventRecordVisitor& visitor) override;
+
+  /// @brief Находит запись журнала и контрольную сумму ее блока
+  /// @details Блоков в EVT нет: сумма вычисляется по байтам самой записи
+  /// @param file_path Путь к EVT файлу
+  /// @param record_id Номер записи или EventLogTail::kLastRecord
+  /// @return Положение записи или std::nullopt, если запись не найдена
+  std::optional<EventLogTail> locateRecord(const std::string& file_path,
+                                           uint64_t record_id) override;
+
+  /// @brief Читает сведения о журнале только из заголовка файла
+  /// @param file_path Путь к EVT файлу
+  /// @return Сведения или std::nullopt, если заголовок не разобран
+  std::optional<EventLogSummary> readSummary(
+      const std::string& file_path) override;
+
+  /// @brief Проверяет поддержку формата файла
+  /// @param file_path Путь к файлу для проверки
+  /// @return true если файл имеет расширение .evt
+  [[nodiscard]] bool supports(const std::string& file_path) const override;
+
+  /// @brief Возвращает название формата
+  /// @return Строка с названием формата
+  [[nodiscard]] std::string formatName() const override;
+
+  /// @brief Возвращает поддерживаемые расширения файлов
+  /// @return Вектор расширений {".evt"}
+  [[nodiscard]] std::vector<std::string> supportedExtensions() const override;
+
+ private:
+  friend class EvtNativeRecordReader;  ///< Курсор использует разбор пакетов
+
+  static constexpr size_t kBatchSize = 1024;  ///< Записей в пакете
+
+  /// @brief Проверяет заголовок файла и находит записи
+  /// @param file Содержимое файла
+  /// @param file_path Путь к файлу (для сообщений)
+  /// @param recover Добавлять записи вне текущей области журнала
+  /// @return Записи в порядке выдачи
+  /// @throws std::runtime_error Если сигнатура файла не совпала (вне режима
+  /// восстановления)
+  [[nodiscard]] static std::vector<EvtRecordLocation> locateRecords(
+      std::span<const uint8_t> file, const std::string& file_path,
+      bool recover);
+
+  /// @brief Декодирует пакет записей
+  /// @param file Содержимое файла
+  /// @param batch Записи пакета
+  /// @param query Выборка (проверяется выражение фильтра)
+  /// @return События пакета, подходящие под выражение, в порядке записей
+  [[nodiscard]] static std::vector<EventData> decodeBatch(
+      std::span<const uint8_t> file, std::span<const EvtRecordLocation> batch,
+      const EventLogQuery& query);
+
+  /// @brief Декодирует одну запись
+  /// @param record Байты записи
+  /// @param arena Арена пакета
+  /// @param text Буфер преобразования строк
+  /// @return Событие
+  [[nodiscard]] static EventData decodeRecord(
+      std::span<const uint8_t> record, std::shared_ptr<EventArena> arena,
+      std::string& text);
+
+  /// @brief Конвертирует тип события EVT в уровень важности
+  /// @param event_type Тип события
+  /// @return Уровень важности EventLevel
+  [[nodiscard]] static EventLevel convertEventType(
+      uint16_t event_type) noexcept;
+
+  /// @brief Обходит записи файла в пуле потоков
+  /// @param file_path Путь к EVT файлу
+  /// @param query Выборка записей
+  /// @param visitor Обработчик записей (false прекращает обход)
+  /// @return true если выборка обойдена полностью
+  bool scanRecords(const std::string& file_path, const EventLogQuery& query,
+                   const EventRecordVisitor& visitor);
+
+  EvtNativeParserOptions options_;  ///< Параметры разбора
+};
+
+/// @class EvtNativeRecordReader
+/// @brief Курсор для построчного чтения записей EVT без libevt
+class EvtNativeRecordReader final : public IEventRecordReader {
+ public:
+  /// @brief Открывает EVT файл для чтения
+  /// @param file_path Путь к EVT файлу
+  /// @param options Параметры разбора
+  /// @throws std::runtime_error Если файл не является журналом EVT
+  EvtNativeRecordReader(const std::string& file_path,
+                        EvtNativeParserOptions options);
+
+  /// @brief Читает следующую запись
+  /// @return Разобранная запись или std::nullopt по достижении конца файла
+  std::optional<EventData> next() override;
+
+ private:
+  MappedFile file_;                          ///< Отображение файла
+  std::vector<EvtRecordLocation> records_;  ///< Записи в порядке выдачи
+  size_t next_record_ = 0;                   ///< Индекс следующей записи
+  std::vector<EventData> pending_;           ///< Записи текущего пакета
+  size_t pending_index_ = 0;                 ///< Индекс следующей записи пакета
+};
+
+}
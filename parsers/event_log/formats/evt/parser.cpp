@@ -5,6 +5,7 @@
 
 #include "../common/time_converter.hpp"
 #include "../../model/event_data_builder.hpp"
+#include "record.hpp"
 
 namespace EventLogAnalysis {
 
@@ -24,46 +25,50 @@ EvtParser::~EvtParser() {
 }
 
 std::vector<EventData> EvtParser::parse(const std::string& file_path) {
-  openFile(file_path);
+  std::vector<EventData> events;
+  forEachRecord(file_path, [&events](EventData&& event) {
+    events.push_back(std::move(event));
+    return true;
+  });
+  return events;
+}
 
-  try {
-    libevt_error_t* error = nullptr;
-    int record_count = 0;
+bool EvtParser::forEachRecord(const std::string& file_path,
+                              const EventRecordVisitor& visitor) {
+  return scanRecords(file_path, EventLogQuery{}, visitor);
+}
 
-    if (libevt_file_get_number_of_records(evt_file_, &record_count, &error) !=
-        1) {
-      handleLibEvtError("Не удалось получить количество записей", error);
-      throw std::runtime_error("Не удалось прочитать EVT файл");
-    }
+bool EvtParser::forEachRecord(const std::string& file_path,
+                              const EventIdFilter& event_ids,
+                              const EventRecordVisitor& visitor) {
+  EventLogQuery query;
+  query.event_ids = event_ids;
+  return scanRecords(file_path, query, visitor);
+}
 
-    std::vector<EventData> events;
-    events.reserve(record_count);
+bool EvtParser::queryRecords(const std::string& file_path,
+                             const EventLogQuery& query,
+                             const EventRecordVisitor& visitor) {
+  return scanRecords(file_path, query, visitor);
+}
 
-    for (int i = 0; i < record_count; ++i) {
-      libevt_record_t* record = nullptr;
-      if (libevt_file_get_record_by_index(evt_file_, i, &record, &error) == 1) {
-        events.push_back(parseRecord(record));
-        libevt_record_free(&record, nullptr);
-      } else {
-        // Log error but continue processing other records
-        if (error) {
-            char buffer[256];
-            libevt_error_sprint(error, buffer, sizeof(buffer));
-            libevt_error_free(&error);
-            // TODO: Log warning
-        }
-      }
-    }
+std::optional<EventLogTail> EvtParser::locateRecord(const std::string&,
+                                                    uint64_t) {
+  return std::nullopt;
+}
 
-    return events;
-  } catch (...) {
-    closeFile();
-    throw;
+std::optional<EventLogSummary> EvtParser::readSummary(
+    const std::string& file_path) {
+  const auto header = EvtFileHeader::read(file_path);
+  if (!header) {
+    return std::nullopt;
   }
+  return header->summary();
 }
 
-std::vector<EventData> EvtParser::filterByEventId(const std::string& file_path,
-                                                  uint32_t event_id) {
+bool EvtParser::scanRecords(const std::string& file_path,
+                            const EventLogQuery& query,
+                            const EventRecordVisitor& visitor) {
   openFile(file_path);
 
   try {
@@ -76,32 +81,78 @@ std::vector<EventData> EvtParser::filterByEventId(const std::string& file_path,
       throw std::runtime_error("Не удалось прочитать EVT файл");
     }
 
-    std::vector<EventData> events;
+    const EventIdFilter* event_ids = query.eventIds();
+    const bool bounded = query.hasTimeWindow() || query.hasRecordRange();
 
-    for (int i = 0; i < record_count; ++i) {
+    bool completed = true;
+    for (int i = 0; i < record_count && completed; ++i) {
       libevt_record_t* record = nullptr;
-      if (libevt_file_get_record_by_index(evt_file_, i, &record, &error) == 1) {
-        uint32_t current_id = 0;
-        if (libevt_record_get_event_identifier(record, &current_id, nullptr) ==
-                1 &&
-            current_id == event_id) {
-          events.push_back(parseRecord(record));
+      if (libevt_file_get_record_by_index(evt_file_, i, &record, &error) != 1) {
+        // Повреждённая запись пропускается, обход продолжается
+        if (error) libevt_error_free(&error);
+        continue;
+      }
+
+      // Номер, время и идентификатор проверяются до разбора остальных полей
+      if (bounded) {
+        uint32_t record_number = 0;
+        uint32_t written_time = 0;
+        if (libevt_record_get_identifier(record, &record_number, nullptr) !=
+                1 ||
+            libevt_record_get_written_time(record, &written_time, nullptr) !=
+                1 ||
+            !query.matches(
+                record_number,
+                TimeConverter::secondsSince1970ToFiletime(written_time))) {
+          libevt_record_free(&record, nullptr);
+          continue;
         }
-        libevt_record_free(&record, nullptr);
-      } else {
-         if (error) {
-            libevt_error_free(&error);
+      }
+      if (event_ids) {
+        uint32_t event_id = 0;
+        if (libevt_record_get_event_identifier(record, &event_id, nullptr) !=
+                1 ||
+            !event_ids->contains(event_id)) {
+          libevt_record_free(&record, nullptr);
+          continue;
         }
       }
+
+      EventData event = parseRecord(record);
+      libevt_record_free(&record, nullptr);
+      if (query.accepts(event)) {
+        completed = visitor(std::move(event));
+      }
     }
 
-    return events;
+    closeFile();
+    return completed;
   } catch (...) {
     closeFile();
     throw;
   }
 }
 
+std::unique_ptr<IEventRecordReader> EvtParser::openReader(
+    const std::string& file_path) {
+  return std::make_unique<EvtRecordReader>(file_path);
+}
+
+std::vector<EventData> EvtParser::filterByEventId(const std::string& file_path,
+                                                  uint32_t event_id) {
+  return filterByEventIds(file_path, EventIdFilter{event_id});
+}
+
+std::vector<EventData> EvtParser::filterByEventIds(
+    const std::string& file_path, const EventIdFilter& event_ids) {
+  std::vector<EventData> events;
+  forEachRecord(file_path, event_ids, [&events](EventData&& event) {
+    events.push_back(std::move(event));
+    return true;
+  });
+  return events;
+}
+
 bool EvtParser::supports(const std::string& file_path) const {
   return file_path.length() > 4 &&
          file_path.substr(file_path.length() - 4) == ".evt";
@@ -155,6 +206,13 @@ EventData EvtParser::parseRecord(libevt_record_t* record) {
       libevt_error_free(&error);
   }
 
+  uint32_t record_number = 0;
+  if (libevt_record_get_identifier(record, &record_number, &error) == 1) {
+    builder.setRecordId(record_number);
+  } else if (error) {
+    libevt_error_free(&error);
+  }
+
   uint16_t event_type = 0;
   if (libevt_record_get_event_type(record, &event_type, &error) == 1) {
     builder.setLevel(convertEventType(event_type));
@@ -167,7 +225,7 @@ EventData EvtParser::parseRecord(libevt_record_t* record) {
   if (libevt_record_get_utf8_source_name_size(record, &size, &error) == 1 && size > 0) {
       std::vector<char> buffer(size);
       if (libevt_record_get_utf8_source_name(record, reinterpret_cast<uint8_t*>(buffer.data()), size, &error) == 1) {
-          builder.setProvider(std::string(buffer.data()));
+          builder.setProvider(buffer.data());
       }
       if (error) libevt_error_free(&error);
   } else if (error) {
@@ -177,7 +235,7 @@ EventData EvtParser::parseRecord(libevt_record_t* record) {
   if (libevt_record_get_utf8_computer_name_size(record, &size, &error) == 1 && size > 0) {
       std::vector<char> buffer(size);
       if (libevt_record_get_utf8_computer_name(record, reinterpret_cast<uint8_t*>(buffer.data()), size, &error) == 1) {
-          builder.setComputer(std::string(buffer.data()));
+          builder.setComputer(buffer.data());
       }
       if (error) libevt_error_free(&error);
   } else if (error) {
@@ -244,4 +302,66 @@ void EvtParser::handleLibEvtError(const std::string& context,
   }
 }
 
+EvtRecordReader::EvtRecordReader(const std::string& file_path) {
+  libevt_error_t* error = nullptr;
+
+  try {
+    if (libevt_file_initialize(&evt_file_, &error) != 1) {
+      EvtParser::handleLibEvtError("Не удалось инициализировать libevt", error);
+      throw std::runtime_error("Не удалось инициализировать курсор EVT");
+    }
+
+    if (libevt_file_open(evt_file_, file_path.c_str(), LIBEVT_ACCESS_FLAG_READ,
+                         &error) != 1) {
+      EvtParser::handleLibEvtError("Не удалось открыть файл: " + file_path,
+                                   error);
+      throw std::runtime_error("Не удалось открыть файл EVT");
+    }
+    file_opened_ = true;
+
+    if (libevt_file_get_number_of_records(evt_file_, &record_count_, &error) !=
+        1) {
+      EvtParser::handleLibEvtError("Не удалось получить количество записей",
+                                   error);
+      throw std::runtime_error("Не удалось прочитать EVT файл");
+    }
+  } catch (...) {
+    release();
+    throw;
+  }
+}
+
+EvtRecordReader::~EvtRecordReader() { release(); }
+
+std::optional<EventData> EvtRecordReader::next() {
+  libevt_error_t* error = nullptr;
+
+  while (next_index_ < record_count_) {
+    libevt_record_t* record = nullptr;
+    const int index = next_index_++;
+
+    if (libevt_file_get_record_by_index(evt_file_, index, &record, &error) ==
+        1) {
+      EventData event = EvtParser::parseRecord(record);
+      libevt_record_free(&record, nullptr);
+      return event;
+    }
+    if (error) {
+      libevt_error_free(&error);
+    }
+  }
+
+  return std::nullopt;
+}
+
+void EvtRecordReader::release() noexcept {
+  if (file_opened_ && evt_file_) {
+    libevt_file_close(evt_file_, nullptr);
+    file_opened_ = false;
+  }
+  if (evt_file_) {
+    libevt_file_free(&evt_file_, nullptr);
+  }
+}
+
 }
@@ -5,6 +5,8 @@
 
 #include <libevt.h>
 
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -36,6 +38,20 @@ class EvtParser final : public IEventLogParser {
   /// @return Вектор разобранных событий
   std::vector<EventData> parse(const std::string& file_path) override;
 
+  /// @brief Потоково обходит записи EVT файла
+  /// @param file_path Путь к EVT файлу
+  /// @param visitor Обработчик записей (false прекращает обход)
+  /// @return true если файл обойден полностью
+  bool forEachRecord(const std::string& file_path,
+                     const EventRecordVisitor& visitor) override;
+
+  /// @brief Открывает курсор для построчного чтения EVT файла
+  /// @param file_path Путь к EVT файлу
+  /// @return Курсор записей
+  /// @throws std::runtime_error Если не удалось открыть файл
+  std::unique_ptr<IEventRecordReader> openReader(
+      const std::string& file_path) override;
+
   /// @brief Фильтрует события по идентификатору из EVT файла
   /// @param file_path Путь к EVT файлу
   /// @param event_id Идентификатор события для фильтрации
@@ -43,6 +59,46 @@ class EvtParser final : public IEventLogParser {
   std::vector<EventData> filterByEventId(const std::string& file_path,
                                          uint32_t event_id) override;
 
+  /// @brief Фильтрует события по множеству идентификаторов из EVT файла
+  /// @param file_path Путь к EVT файлу
+  /// @param event_ids Множество идентификаторов событий
+  /// @return Вектор событий с подходящими идентификаторами
+  std::vector<EventData> filterByEventIds(
+      const std::string& file_path, const EventIdFilter& event_ids) override;
+
+  /// @brief Потоково обходит записи EVT файла с заданными идентификаторами
+  /// @param file_path Путь к EVT файлу
+  /// @param event_ids Множество идентификаторов событий
+  /// @param visitor Обработчик записей (false прекращает обход)
+  /// @return true если файл обойден полностью
+  bool forEachRecord(const std::string& file_path,
+                     const EventIdFilter& event_ids,
+                     const EventRecordVisitor& visitor) override;
+
+  /// @brief Потоково обходит записи EVT файла, попадающие в выборку
+  /// @details Номер и время записи читаются до разбора остальных полей
+  /// @param file_path Путь к EVT файлу
+  /// @param query Окно времени, диапазон номеров и идентификаторы событий
+  /// @param visitor Обработчик записей (false прекращает обход)
+  /// @return true если файл обойден полностью
+  bool queryRecords(const std::string& file_path, const EventLogQuery& query,
+                    const EventRecordVisitor& visitor) override;
+
+  /// @brief Находит запись журнала и контрольную сумму ее блока
+  /// @details libevt не предоставляет исходные байты записей, поэтому
+  /// контрольные точки не поддерживаются
+  /// @param file_path Путь к EVT файлу
+  /// @param record_id Номер записи или EventLogTail::kLastRecord
+  /// @return std::nullopt
+  std::optional<EventLogTail> locateRecord(const std::string& file_path,
+                                           uint64_t record_id) override;
+
+  /// @brief Читает сведения о журнале только из заголовка файла
+  /// @param file_path Путь к EVT файлу
+  /// @return Сведения или std::nullopt, если заголовок не разобран
+  std::optional<EventLogSummary> readSummary(
+      const std::string& file_path) override;
+
   /// @brief Проверяет поддержку формата файла
   /// @param file_path Путь к файлу для проверки
   /// @return true если файл имеет расширение .evt
@@ -57,6 +113,8 @@ class EvtParser final : public IEventLogParser {
   [[nodiscard]] std::vector<std::string> supportedExtensions() const override;
 
  private:
+  friend class EvtRecordReader;  ///< Курсор использует разбор записей
+
   /// @brief Открывает EVT файл для чтения
   /// @param file_path Путь к EVT файлу
   /// @throws std::runtime_error Если не удалось открыть файл
@@ -65,6 +123,14 @@ class EvtParser final : public IEventLogParser {
   /// @brief Закрывает открытый EVT файл
   void closeFile() noexcept;
 
+  /// @brief Последовательно обходит записи открытого файла
+  /// @param file_path Путь к EVT файлу
+  /// @param query Выборка записей
+  /// @param visitor Обработчик записей (false прекращает обход)
+  /// @return true если файл обойден полностью
+  bool scanRecords(const std::string& file_path, const EventLogQuery& query,
+                   const EventRecordVisitor& visitor);
+
   /// @brief Парсит одну запись из EVT файла
   /// @param record Указатель на запись libevt
   /// @return Объект EventData с разобранными данными
@@ -87,4 +153,36 @@ class EvtParser final : public IEventLogParser {
   bool file_opened_ = false;           ///< Флаг открытого состояния файла
 };
 
+/// @class EvtRecordReader
+/// @brief Курсор для построчного чтения записей EVT файла
+class EvtRecordReader final : public IEventRecordReader {
+ public:
+  /// @brief Открывает EVT файл для чтения
+  /// @param file_path Путь к EVT файлу
+  /// @throws std::runtime_error Если не удалось открыть файл
+  explicit EvtRecordReader(const std::string& file_path);
+
+  /// @brief Деструктор, закрывает файл
+  ~EvtRecordReader() override;
+
+  /// @brief Конструктор копирования (запрещен)
+  EvtRecordReader(const EvtRecordReader&) = delete;
+
+  /// @brief Оператор присваивания копированием (запрещен)
+  EvtRecordReader& operator=(const EvtRecordReader&) = delete;
+
+  /// @brief Читает следующую запись
+  /// @return Разобранная запись или std::nullopt по достижении конца файла
+  std::optional<EventData> next() override;
+
+ private:
+  /// @brief Освобождает ресурсы libevt
+  void release() noexcept;
+
+  libevt_file_t* evt_file_ = nullptr;  ///< Файловый объект libevt
+  bool file_opened_ = false;           ///< Флаг открытого состояния файла
+  int record_count_ = 0;               ///< Количество записей в файле
+  int next_index_ = 0;                 ///< Индекс следующей записи
+};
+
 }
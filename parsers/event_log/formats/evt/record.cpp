@@ -0,0 +1,258 @@
+#include "record.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+
+#include "../common/byte_order.hpp"
+#include "../common/mapped_file.hpp"
+
+namespace EventLogAnalysis {
+
+namespace {
+
+constexpr uint8_t kSignature[] = {'L', 'f', 'L', 'e'};
+
+// Запись конца журнала: размер 0x28 и четыре слова-маркера
+constexpr uint8_t kCursorMarker[] = {0x11, 0x11, 0x11, 0x11, 0x22, 0x22,
+                                     0x22, 0x22, 0x33, 0x33, 0x33, 0x33,
+                                     0x44, 0x44, 0x44, 0x44};
+constexpr uint32_t kCursorSize = 0x28;
+
+constexpr size_t kNotFound = std::string_view::npos;
+
+/// @brief Находит сигнатуру начиная с позиции
+size_t findSignature(std::span<const uint8_t> data, size_t from,
+                     std::span<const uint8_t> signature) noexcept {
+  while (from + signature.size() <= data.size()) {
+    const void* found = std::memchr(data.data() + from, signature[0],
+                                    data.size() - from - signature.size() + 1);
+    if (found == nullptr) {
+      return kNotFound;
+    }
+    const size_t pos =
+        static_cast<size_t>(static_cast<const uint8_t*>(found) - data.data());
+    if (std::memcmp(data.data() + pos, signature.data(), signature.size()) ==
+        0) {
+      return pos;
+    }
+    from = pos + 1;
+  }
+  return kNotFound;
+}
+
+}
+
+std::optional<EvtFileHeader> EvtFileHeader::parse(
+    std::span<const uint8_t> file) noexcept {
+  if (file.size() < kSize ||
+      std::memcmp(file.data() + 4, kSignature, sizeof(kSignature)) != 0 ||
+      readLittleEndian<uint32_t>(file, 0) != kSize) {
+    return std::nullopt;
+  }
+
+  EvtFileHeader header;
+  header.first_record_offset = readLittleEndian<uint32_t>(file, 16);
+  header.end_of_file_offset = readLittleEndian<uint32_t>(file, 20);
+  header.next_record_number = readLittleEndian<uint32_t>(file, 24);
+  header.oldest_record_number = readLittleEndian<uint32_t>(file, 28);
+  header.flags = readLittleEndian<uint32_t>(file, 36);
+  return header;
+}
+
+std::optional<EvtFileHeader> EvtFileHeader::read(
+    const std::string& file_path) {
+  return parse(readFilePrefix(file_path, kSize));
+}
+
+bool EvtFileHeader::isDirty() const noexcept {
+  return (flags & kFlagDirty) != 0;
+}
+
+EventLogSummary EvtFileHeader::summary() const noexcept {
+  EventLogSummary result;
+  const uint32_t oldest = std::max<uint32_t>(oldest_record_number, 1);
+  result.record_count =
+      next_record_number > oldest ? next_record_number - oldest : 0;
+  result.dirty = isDirty();
+  return result;
+}
+
+EvtRecordScanner::EvtRecordScanner(std::span<const uint8_t> file,
+                                   const EvtFileHeader& header) noexcept
+    : file_(file), header_(header) {}
+
+EvtRecordScan EvtRecordScanner::scan() const {
+  EvtRecordScan result;
+  if (file_.size() <= EvtFileHeader::kSize) {
+    return result;
+  }
+
+  std::vector<EvtRecordLocation> found;
+  uint64_t wrapped_tail_end = 0;
+  for (size_t pos = findSignature(file_, EvtFileHeader::kSize + 4, kSignature);
+       pos != kNotFound; pos = findSignature(file_, pos, kSignature)) {
+    EvtRecordLocation location;
+    if (!validateRecord(pos - 4, location)) {
+      pos += sizeof(kSignature);
+      continue;
+    }
+    found.push_back(location);
+    if (location.wrapped) {
+      // Продолжение записи лежит в начале буфера и уже просмотрено
+      wrapped_tail_end = location.offset + location.size - file_.size() +
+                         EvtFileHeader::kSize;
+      break;
+    }
+    pos = location.offset + location.size;
+  }
+
+  // Сигнатура записи, начатой в последних байтах буфера, сама переходит
+  // через границу кольца и линейным поиском не находится
+  if (wrapped_tail_end == 0) {
+    const uint32_t signature = readLittleEndian<uint32_t>(kSignature);
+    const size_t tail = std::min(file_.size() - EvtFileHeader::kSize,
+                                 sizeof(kSignature) + 3);
+    for (uint64_t offset = file_.size() - tail; offset < file_.size();
+         ++offset) {
+      EvtRecordLocation location;
+      if (readCircular(offset + 4) == signature &&
+          validateRecord(offset, location) && location.wrapped) {
+        found.push_back(location);
+        wrapped_tail_end = location.offset + location.size - file_.size() +
+                           EvtFileHeader::kSize;
+        break;
+      }
+    }
+  }
+
+  // Сигнатуры внутри продолжения записи на границе кольца - ее данные
+  if (wrapped_tail_end != 0) {
+    std::erase_if(found, [wrapped_tail_end](const EvtRecordLocation& record) {
+      return !record.wrapped && record.offset < wrapped_tail_end;
+    });
+  }
+
+  const Bounds bounds = locateBounds(result.cursor_found);
+  const auto by_number = [](const EvtRecordLocation& a,
+                            const EvtRecordLocation& b) {
+    return a.record_number < b.record_number;
+  };
+  if (!bounds.valid) {
+    // Смещения области недостоверны: все записи считаются текущими
+    result.live = std::move(found);
+    std::stable_sort(result.live.begin(), result.live.end(), by_number);
+    return result;
+  }
+
+  const uint64_t ring_size = file_.size() - EvtFileHeader::kSize;
+  const uint64_t live_size =
+      (bounds.end + ring_size - bounds.first) % ring_size;
+  const auto distance = [&](const EvtRecordLocation& record) {
+    return (record.offset + ring_size - bounds.first) % ring_size;
+  };
+  for (const auto& record : found) {
+    (distance(record) < live_size ? result.live : result.recovered)
+        .push_back(record);
+  }
+
+  // Текущие записи идут от самой старой по кольцу
+  std::sort(result.live.begin(), result.live.end(),
+            [&](const EvtRecordLocation& a, const EvtRecordLocation& b) {
+              return distance(a) < distance(b);
+            });
+  std::stable_sort(result.recovered.begin(), result.recovered.end(),
+                   by_number);
+  return result;
+}
+
+std::span<const uint8_t> EvtRecordScanner::recordBytes(
+    std::span<const uint8_t> file, const EvtRecordLocation& location,
+    std::vector<uint8_t>& buffer) {
+  if (!location.wrapped) {
+    return file.subspan(location.offset, location.size);
+  }
+
+  const size_t head = file.size() - location.offset;
+  buffer.assign(file.begin() + static_cast<ptrdiff_t>(location.offset),
+                file.end());
+  buffer.insert(buffer.end(), file.begin() + EvtFileHeader::kSize,
+                file.begin() + EvtFileHeader::kSize +
+                    static_cast<ptrdiff_t>(location.size - head));
+  return buffer;
+}
+
+uint32_t EvtRecordScanner::readCircular(uint64_t position) const noexcept {
+  const uint64_t ring_size = file_.size() - EvtFileHeader::kSize;
+  uint8_t bytes[4];
+  for (size_t i = 0; i < sizeof(bytes); ++i) {
+    uint64_t physical = position + i;
+    if (physical >= file_.size()) physical -= ring_size;
+    bytes[i] = file_[physical];
+  }
+  return readLittleEndian<uint32_t>(bytes);
+}
+
+bool EvtRecordScanner::validateRecord(
+    uint64_t offset, EvtRecordLocation& location) const noexcept {
+  const uint64_t ring_size = file_.size() - EvtFileHeader::kSize;
+  if (offset < EvtFileHeader::kSize) {
+    return false;
+  }
+
+  const uint32_t size = readCircular(offset);
+  if (size < kRecordHeaderSize + 4 || size % 4 != 0 || size > ring_size ||
+      readCircular(offset + size - 4) != size) {
+    return false;
+  }
+
+  // Смещение строк указывает внутрь записи
+  const uint32_t strings_offset = readCircular(offset + 36);
+  if (strings_offset < kRecordHeaderSize || strings_offset > size - 4) {
+    return false;
+  }
+
+  location.offset = offset;
+  location.size = size;
+  location.record_number = readCircular(offset + 8);
+  location.written_time = readCircular(offset + 16);
+  location.event_id = readCircular(offset + 20);
+  location.wrapped = offset + size > file_.size();
+  return location.record_number != 0;
+}
+
+EvtRecordScanner::Bounds EvtRecordScanner::locateBounds(
+    bool& cursor_found) const noexcept {
+  Bounds bounds;
+  cursor_found = false;
+
+  // Запись конца журнала обновляется при каждой записи, заголовок "грязного"
+  // файла - нет. Выбирается запись, указывающая на собственное смещение
+  for (size_t pos = findSignature(file_, EvtFileHeader::kSize, kCursorMarker);
+       pos != kNotFound;
+       pos = findSignature(file_, pos + sizeof(kCursorMarker), kCursorMarker)) {
+    const size_t cursor = pos - 4;
+    if (cursor < EvtFileHeader::kSize || cursor + kCursorSize > file_.size() ||
+        readLittleEndian<uint32_t>(file_, cursor) != kCursorSize ||
+        readLittleEndian<uint32_t>(file_, cursor + kCursorSize - 4) !=
+            kCursorSize) {
+      continue;
+    }
+    bounds.first = readLittleEndian<uint32_t>(file_, cursor + 20);
+    bounds.end = readLittleEndian<uint32_t>(file_, cursor + 24);
+    cursor_found = true;
+    if (bounds.end == cursor) break;
+  }
+
+  if (!cursor_found) {
+    bounds.first = header_.first_record_offset;
+    bounds.end = header_.end_of_file_offset;
+  }
+  bounds.valid = bounds.first >= EvtFileHeader::kSize &&
+                 bounds.first < file_.size() &&
+                 bounds.end >= EvtFileHeader::kSize &&
+                 bounds.end < file_.size();
+  return bounds;
+}
+
+}
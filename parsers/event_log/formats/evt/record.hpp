@@ -0,0 +1,135 @@
+/// @file record.hpp
+/// @brief Заголовок и записи файла EVT (Windows NT - Server 2003)
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../../model/event_log_summary.hpp"
+
+/// @namespace EventLogAnalysis
+/// @brief Пространство имен для работы с журналами событий Windows
+namespace EventLogAnalysis {
+
+/// @brief Заголовок файла EVT ("LfLe")
+struct EvtFileHeader {
+  static constexpr size_t kSize = 0x30;            ///< Размер заголовка
+  static constexpr uint32_t kFlagDirty = 0x0001;   ///< Файл не был закрыт
+  static constexpr uint32_t kFlagWrapped = 0x0002;  ///< Буфер перезаписан
+  static constexpr uint32_t kFlagFull = 0x0004;    ///< Журнал заполнен
+
+  uint32_t first_record_offset = 0;   ///< Смещение самой старой записи
+  uint32_t end_of_file_offset = 0;    ///< Смещение записи конца журнала
+  uint32_t next_record_number = 0;    ///< Номер следующей записи
+  uint32_t oldest_record_number = 0;  ///< Номер самой старой записи
+  uint32_t flags = 0;                 ///< Флаги файла
+
+  /// @brief Разбирает заголовок файла
+  /// @param file Содержимое файла
+  /// @return Заголовок или std::nullopt, если сигнатура не совпала
+  [[nodiscard]] static std::optional<EvtFileHeader> parse(
+      std::span<const uint8_t> file) noexcept;
+
+  /// @brief Читает и разбирает заголовок, не отображая файл в память
+  /// @param file_path Путь к файлу
+  /// @return Заголовок или std::nullopt, если сигнатура не совпала
+  [[nodiscard]] static std::optional<EvtFileHeader> read(
+      const std::string& file_path);
+
+  /// @brief Проверяет флаг незавершенной записи
+  /// @return true если файл не был корректно закрыт
+  [[nodiscard]] bool isDirty() const noexcept;
+
+  /// @brief Возвращает сведения о журнале по заголовку
+  /// @details Количество записей - разность номеров следующей и самой
+  /// старой записи (номер 0 у пустого журнала считается первым)
+  [[nodiscard]] EventLogSummary summary() const noexcept;
+};
+
+/// @brief Положение записи события в файле
+struct EvtRecordLocation {
+  uint64_t offset = 0;         ///< Смещение записи в файле
+  uint32_t size = 0;           ///< Полный размер записи
+  uint32_t record_number = 0;  ///< Номер записи
+  uint32_t written_time = 0;   ///< Время записи (секунды с 1970)
+  uint32_t event_id = 0;       ///< Идентификатор события
+  bool wrapped = false;        ///< Запись продолжается после заголовка файла
+};
+
+/// @brief Результат просмотра файла
+struct EvtRecordScan {
+  /// @brief Записи между самой старой записью и концом журнала по порядку
+  std::vector<EvtRecordLocation> live;
+  /// @brief Целые записи вне этой области (удаленные очисткой или частично
+  /// перезаписанные при переполнении) в порядке номеров
+  std::vector<EvtRecordLocation> recovered;
+  bool cursor_found = false;  ///< Найдена запись конца журнала
+};
+
+/// @class EvtRecordScanner
+/// @brief Поиск записей в циклическом буфере файла EVT
+/// @details Файл EVT - кольцевой буфер после 48-байтного заголовка: при
+/// переполнении запись продолжается сразу после заголовка. Записи
+/// находятся по сигнатуре "LfLe" (memchr, векторизованный в libc) по всему
+/// файлу, а не обходом от смещения в заголовке: так находятся записи
+/// "грязных" файлов, у которых заголовок не обновлен, и целые записи вне
+/// текущей области журнала. Кандидат принимается, если размер записи
+/// совпадает с копией в ее конце. Границы области берутся из записи конца
+/// журнала (она обновляется при каждой записи), а при ее отсутствии - из
+/// заголовка.
+class EvtRecordScanner {
+ public:
+  static constexpr size_t kRecordHeaderSize = 56;  ///< Заголовок записи
+
+  /// @brief Создает поиск по файлу
+  /// @param file Содержимое файла
+  /// @param header Заголовок файла
+  EvtRecordScanner(std::span<const uint8_t> file,
+                   const EvtFileHeader& header) noexcept;
+
+  /// @brief Находит записи файла
+  [[nodiscard]] EvtRecordScan scan() const;
+
+  /// @brief Возвращает непрерывные байты записи
+  /// @details Байты записи, продолжающейся после заголовка, собираются в
+  /// буфер
+  /// @param file Содержимое файла
+  /// @param location Положение записи
+  /// @param buffer Буфер для записи на границе кольца
+  /// @return Байты записи
+  [[nodiscard]] static std::span<const uint8_t> recordBytes(
+      std::span<const uint8_t> file, const EvtRecordLocation& location,
+      std::vector<uint8_t>& buffer);
+
+ private:
+  /// @brief Область журнала из записи конца журнала или заголовка
+  struct Bounds {
+    uint64_t first = 0;  ///< Смещение самой старой записи
+    uint64_t end = 0;    ///< Смещение записи конца журнала
+    bool valid = false;  ///< Смещения лежат внутри буфера
+  };
+
+  /// @brief Читает 32-битное значение с учетом перехода через конец буфера
+  /// @param position Логическая позиция (может выходить за конец файла)
+  [[nodiscard]] uint32_t readCircular(uint64_t position) const noexcept;
+
+  /// @brief Проверяет кандидата в запись
+  /// @param offset Смещение записи
+  /// @param location Положение записи (результат)
+  /// @return true если размеры записи согласованы
+  [[nodiscard]] bool validateRecord(uint64_t offset,
+                                    EvtRecordLocation& location) const noexcept;
+
+  /// @brief Определяет область журнала
+  /// @param cursor_found Найдена ли запись конца журнала (результат)
+  [[nodiscard]] Bounds locateBounds(bool& cursor_found) const noexcept;
+
+  std::span<const uint8_t> file_;  ///< Содержимое файла
+  EvtFileHeader header_;           ///< Заголовок файла
+};
+
+}
@@ -0,0 +1,834 @@
+#include "binxml.hpp"
+
+#include <charconv>
+#include <chrono>
+#include <stdexcept>
+
+#include "../common/byte_order.hpp"
+#include "../common/utf16.hpp"
+#include "chunk.hpp"
+#include "template_plan.hpp"
+
+namespace EventLogAnalysis {
+
+namespace {
+
+// Токены BinXml; бит 0x40 означает "есть продолжение" (атрибуты, данные)
+constexpr uint8_t kTokenFlagMore = 0x40;
+constexpr uint8_t kTokenEof = 0x00;
+constexpr uint8_t kTokenOpenStartElement = 0x01;
+constexpr uint8_t kTokenCloseStartElement = 0x02;
+constexpr uint8_t kTokenCloseEmptyElement = 0x03;
+constexpr uint8_t kTokenEndElement = 0x04;
+constexpr uint8_t kTokenValue = 0x05;
+constexpr uint8_t kTokenAttribute = 0x06;
+constexpr uint8_t kTokenCData = 0x07;
+constexpr uint8_t kTokenCharRef = 0x08;
+constexpr uint8_t kTokenEntityRef = 0x09;
+constexpr uint8_t kTokenPiTarget = 0x0A;
+constexpr uint8_t kTokenPiData = 0x0B;
+constexpr uint8_t kTokenTemplateInstance = 0x0C;
+constexpr uint8_t kTokenNormalSubstitution = 0x0D;
+constexpr uint8_t kTokenOptionalSubstitution = 0x0E;
+constexpr uint8_t kTokenFragmentHeader = 0x0F;
+
+constexpr int kMaxDepth = 64;
+constexpr uint32_t kTemplateHeaderSize = 24;  // next(4) + GUID(16) + size(4)
+constexpr uint32_t kNameHeaderSize = 8;       // next(4) + hash(2) + count(2)
+
+constexpr uint64_t kTicksPerSecond = 10000000ULL;
+constexpr uint64_t kSecondsPerDay = 86400ULL;
+constexpr int64_t kDaysFrom1601To1970 = 134774;
+
+constexpr uint8_t baseToken(uint8_t token) noexcept {
+  return static_cast<uint8_t>(token & ~kTokenFlagMore);
+}
+
+void appendPadded(std::string& out, uint64_t value, int width) {
+  char buffer[20];
+  for (int i = width - 1; i >= 0; --i) {
+    buffer[i] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  }
+  out.append(buffer, static_cast<size_t>(width));
+}
+
+template <typename T>
+void appendNumber(std::string& out, T value) {
+  char buffer[32];
+  const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  out.append(buffer, result.ptr);
+}
+
+void appendHex(std::string& out, uint64_t value) {
+  char buffer[16];
+  const auto result =
+      std::to_chars(buffer, buffer + sizeof(buffer), value, 16);
+  out += "0x";
+  out.append(buffer, result.ptr);
+}
+
+void appendHexBytes(std::string& out, std::span<const uint8_t> bytes) {
+  static constexpr char kDigits[] = "0123456789ABCDEF";
+  out.reserve(out.size() + bytes.size() * 2);
+  for (const uint8_t byte : bytes) {
+    out += kDigits[byte >> 4];
+    out += kDigits[byte & 0x0F];
+  }
+}
+
+void appendHexField(std::string& out, uint64_t value, int digits) {
+  static constexpr char kDigits[] = "0123456789ABCDEF";
+  for (int shift = (digits - 1) * 4; shift >= 0; shift -= 4) {
+    out += kDigits[(value >> shift) & 0x0F];
+  }
+}
+
+void appendGuid(std::string& out, std::span<const uint8_t> data) {
+  out += '{';
+  appendHexField(out, readLittleEndian<uint32_t>(data, 0), 8);
+  out += '-';
+  appendHexField(out, readLittleEndian<uint16_t>(data, 4), 4);
+  out += '-';
+  appendHexField(out, readLittleEndian<uint16_t>(data, 6), 4);
+  out += '-';
+  appendHexBytes(out, data.subspan(8, 2));
+  out += '-';
+  appendHexBytes(out, data.subspan(10, 6));
+  out += '}';
+}
+
+void appendDate(std::string& out, int64_t days_since_1970) {
+  const std::chrono::year_month_day date{
+      std::chrono::sys_days{std::chrono::days{days_since_1970}}};
+  appendPadded(out, static_cast<uint64_t>(static_cast<int>(date.year())), 4);
+  out += '-';
+  appendPadded(out, static_cast<unsigned>(date.month()), 2);
+  out += '-';
+  appendPadded(out, static_cast<unsigned>(date.day()), 2);
+}
+
+void appendFileTime(std::string& out, uint64_t filetime) {
+  const uint64_t seconds = filetime / kTicksPerSecond;
+  const uint64_t fraction = filetime % kTicksPerSecond;
+  const uint64_t seconds_of_day = seconds % kSecondsPerDay;
+
+  appendDate(out, static_cast<int64_t>(seconds / kSecondsPerDay) -
+                      kDaysFrom1601To1970);
+  out += 'T';
+  appendPadded(out, seconds_of_day / 3600, 2);
+  out += ':';
+  appendPadded(out, seconds_of_day / 60 % 60, 2);
+  out += ':';
+  appendPadded(out, seconds_of_day % 60, 2);
+  out += '.';
+  appendPadded(out, fraction, 7);
+  out += 'Z';
+}
+
+void appendSystemTime(std::string& out, std::span<const uint8_t> data) {
+  const auto field = [&data](size_t index) {
+    return readLittleEndian<uint16_t>(data, index * 2);
+  };
+
+  // year, month, day of week, day, hour, minute, second, milliseconds
+  appendPadded(out, field(0), 4);
+  out += '-';
+  appendPadded(out, field(1), 2);
+  out += '-';
+  appendPadded(out, field(3), 2);
+  out += 'T';
+  appendPadded(out, field(4), 2);
+  out += ':';
+  appendPadded(out, field(5), 2);
+  out += ':';
+  appendPadded(out, field(6), 2);
+  out += '.';
+  appendPadded(out, field(7), 3);
+  out += 'Z';
+}
+
+void appendSid(std::string& out, std::span<const uint8_t> data) {
+  if (data.size() < 8) return;
+
+  const uint8_t sub_authority_count = data[1];
+  if (data.size() < 8 + static_cast<size_t>(sub_authority_count) * 4) return;
+
+  uint64_t authority = 0;
+  for (size_t i = 2; i < 8; ++i) {
+    authority = (authority << 8) | data[i];
+  }
+
+  out += "S-";
+  appendNumber(out, static_cast<unsigned>(data[0]));
+  out += '-';
+  if (authority >> 32) {
+    appendHex(out, authority);
+  } else {
+    appendNumber(out, authority);
+  }
+  for (size_t i = 0; i < sub_authority_count; ++i) {
+    out += '-';
+    appendNumber(out, readLittleEndian<uint32_t>(data, 8 + i * 4));
+  }
+}
+
+/// @brief Размер элемента фиксированного размера (0 - переменный размер)
+size_t fixedSize(BinXmlValueType type) noexcept {
+  switch (type) {
+    case BinXmlValueType::Int8:
+    case BinXmlValueType::UInt8:
+      return 1;
+    case BinXmlValueType::Int16:
+    case BinXmlValueType::UInt16:
+      return 2;
+    case BinXmlValueType::Int32:
+    case BinXmlValueType::UInt32:
+    case BinXmlValueType::Real32:
+    case BinXmlValueType::Bool:
+    case BinXmlValueType::HexInt32:
+      return 4;
+    case BinXmlValueType::Int64:
+    case BinXmlValueType::UInt64:
+    case BinXmlValueType::Real64:
+    case BinXmlValueType::FileTime:
+    case BinXmlValueType::HexInt64:
+      return 8;
+    case BinXmlValueType::Guid:
+    case BinXmlValueType::SysTime:
+      return 16;
+    default:
+      return 0;
+  }
+}
+
+/// @brief Дописывает скалярное значение
+void appendScalar(std::string& out, BinXmlValueType type,
+                  std::span<const uint8_t> data) {
+  const size_t width = fixedSize(type);
+  if (width != 0 && data.size() < width) {
+    return;
+  }
+
+  switch (type) {
+    case BinXmlValueType::Null:
+    case BinXmlValueType::Placeholder:
+    case BinXmlValueType::BinXml:
+    case BinXmlValueType::ArrayFlag:
+      break;
+    case BinXmlValueType::String:
+      Utf16::appendUtf8(out, Utf16::trimNulls(data));
+      break;
+    case BinXmlValueType::AnsiString:
+    case BinXmlValueType::Utf8Text: {
+      size_t size = 0;
+      while (size < data.size() && data[size] != 0) ++size;
+      out.append(reinterpret_cast<const char*>(data.data()), size);
+      break;
+    }
+    case BinXmlValueType::Int8:
+      appendNumber(out, static_cast<int>(static_cast<int8_t>(data[0])));
+      break;
+    case BinXmlValueType::UInt8:
+      appendNumber(out, static_cast<unsigned>(data[0]));
+      break;
+    case BinXmlValueType::Int16:
+      appendNumber(out, static_cast<int16_t>(readLittleEndian<uint16_t>(data, 0)));
+      break;
+    case BinXmlValueType::UInt16:
+      appendNumber(out, readLittleEndian<uint16_t>(data, 0));
+      break;
+    case BinXmlValueType::Int32:
+      appendNumber(out, static_cast<int32_t>(readLittleEndian<uint32_t>(data, 0)));
+      break;
+    case BinXmlValueType::UInt32:
+      appendNumber(out, readLittleEndian<uint32_t>(data, 0));
+      break;
+    case BinXmlValueType::Int64:
+      appendNumber(out, static_cast<int64_t>(readLittleEndian<uint64_t>(data, 0)));
+      break;
+    case BinXmlValueType::UInt64:
+      appendNumber(out, readLittleEndian<uint64_t>(data, 0));
+      break;
+    case BinXmlValueType::Real32:
+      appendNumber(out, std::bit_cast<float>(readLittleEndian<uint32_t>(data, 0)));
+      break;
+    case BinXmlValueType::Real64:
+      appendNumber(out, std::bit_cast<double>(readLittleEndian<uint64_t>(data, 0)));
+      break;
+    case BinXmlValueType::Bool:
+      out += readLittleEndian<uint32_t>(data, 0) != 0 ? "true" : "false";
+      break;
+    case BinXmlValueType::Binary:
+      appendHexBytes(out, data);
+      break;
+    case BinXmlValueType::Guid:
+      appendGuid(out, data);
+      break;
+    case BinXmlValueType::SizeT:
+      if (data.size() >= 8) {
+        appendHex(out, readLittleEndian<uint64_t>(data, 0));
+      } else if (data.size() >= 4) {
+        appendHex(out, readLittleEndian<uint32_t>(data, 0));
+      }
+      break;
+    case BinXmlValueType::FileTime:
+      appendFileTime(out, readLittleEndian<uint64_t>(data, 0));
+      break;
+    case BinXmlValueType::SysTime:
+      appendSystemTime(out, data);
+      break;
+    case BinXmlValueType::Sid:
+      appendSid(out, data);
+      break;
+    case BinXmlValueType::HexInt32:
+      appendHex(out, readLittleEndian<uint32_t>(data, 0));
+      break;
+    case BinXmlValueType::HexInt64:
+      appendHex(out, readLittleEndian<uint64_t>(data, 0));
+      break;
+  }
+}
+
+}
+
+bool BinXmlValue::isNull() const noexcept {
+  return type == BinXmlValueType::Null ||
+         (data.empty() && type != BinXmlValueType::Placeholder);
+}
+
+bool BinXmlValue::toUnsigned(uint64_t& value) const noexcept {
+  switch (type) {
+    case BinXmlValueType::Int8:
+    case BinXmlValueType::UInt8:
+      if (data.size() < 1) return false;
+      value = data[0];
+      return true;
+    case BinXmlValueType::Int16:
+    case BinXmlValueType::UInt16:
+      if (data.size() < 2) return false;
+      value = readLittleEndian<uint16_t>(data, 0);
+      return true;
+    case BinXmlValueType::Int32:
+    case BinXmlValueType::UInt32:
+    case BinXmlValueType::HexInt32:
+      if (data.size() < 4) return false;
+      value = readLittleEndian<uint32_t>(data, 0);
+      return true;
+    case BinXmlValueType::Int64:
+    case BinXmlValueType::UInt64:
+    case BinXmlValueType::HexInt64:
+    case BinXmlValueType::FileTime:
+      if (data.size() < 8) return false;
+      value = readLittleEndian<uint64_t>(data, 0);
+      return true;
+    case BinXmlValueType::String:
+    case BinXmlValueType::Utf8Text: {
+      std::string text;
+      appendTo(text);
+      const auto result =
+          std::from_chars(text.data(), text.data() + text.size(), value);
+      return result.ec == std::errc{} && result.ptr == text.data() + text.size();
+    }
+    default:
+      return false;
+  }
+}
+
+void BinXmlValue::appendTo(std::string& out) const {
+  const auto raw_type = static_cast<uint8_t>(type);
+  if ((raw_type & static_cast<uint8_t>(BinXmlValueType::ArrayFlag)) == 0 ||
+      type == BinXmlValueType::Utf8Text) {
+    appendScalar(out, type, data);
+    return;
+  }
+
+  // Массив: строки разделены нулевыми символами, прочие элементы идут
+  // подряд с фиксированным размером
+  const auto element_type = static_cast<BinXmlValueType>(
+      raw_type & ~static_cast<uint8_t>(BinXmlValueType::ArrayFlag));
+  bool first = true;
+  const auto append_element = [&](std::span<const uint8_t> element) {
+    if (!first) out += ", ";
+    first = false;
+    appendScalar(out, element_type, element);
+  };
+
+  if (element_type == BinXmlValueType::String) {
+    size_t begin = 0;
+    for (size_t pos = 0; pos + 1 < data.size(); pos += 2) {
+      if (data[pos] == 0 && data[pos + 1] == 0) {
+        append_element(data.subspan(begin, pos - begin));
+        begin = pos + 2;
+      }
+    }
+    if (begin + 1 < data.size()) {
+      append_element(data.subspan(begin));
+    }
+    return;
+  }
+
+  const size_t width = element_type == BinXmlValueType::SizeT
+                           ? sizeof(uint64_t)
+                           : fixedSize(element_type);
+  if (width == 0) {
+    appendHexBytes(out, data);
+    return;
+  }
+  for (size_t pos = 0; pos + width <= data.size(); pos += width) {
+    append_element(data.subspan(pos, width));
+  }
+}
+
+BinXmlDecoder::BinXmlDecoder(std::span<const uint8_t> chunk,
+                             TemplateCache* cache)
+    : chunk_(chunk), cache_(cache) {}
+
+BinXmlDecoder::~BinXmlDecoder() {
+  if (cache_) {
+    TemplateCache::Statistics statistics;
+    statistics.plan_hits = plan_hits_;
+    statistics.fallbacks = fallbacks_;
+    cache_->merge(statistics);
+  }
+}
+
+bool BinXmlDecoder::decode(uint32_t offset, uint32_t size,
+                           IBinXmlHandler& handler) {
+  if (offset > chunk_.size() || size > chunk_.size() - offset) {
+    throw std::runtime_error("Фрагмент BinXml выходит за границы блока");
+  }
+
+  Cursor cursor{offset, offset + size};
+  return parseFragment(cursor, {}, handler, 0);
+}
+
+bool BinXmlDecoder::decodeValue(const BinXmlValue& value,
+                                IBinXmlHandler& handler) {
+  return emitText(value, handler, 1);
+}
+
+template <typename T>
+T BinXmlDecoder::read(Cursor& cursor) {
+  require(cursor, sizeof(T));
+  const T value = readLittleEndian<T>(chunk_, cursor.pos);
+  cursor.pos += sizeof(T);
+  return value;
+}
+
+void BinXmlDecoder::require(const Cursor& cursor, uint64_t size) const {
+  if (cursor.pos > cursor.end || size > cursor.end - cursor.pos) {
+    throw std::runtime_error("Неожиданный конец данных BinXml");
+  }
+}
+
+bool BinXmlDecoder::parseFragment(Cursor& cursor,
+                                  std::span<const BinXmlValue> values,
+                                  IBinXmlHandler& handler, int depth) {
+  if (depth > kMaxDepth) {
+    throw std::runtime_error("Слишком глубокая вложенность BinXml");
+  }
+
+  while (cursor.pos < cursor.end) {
+    const uint8_t token = chunk_[cursor.pos];
+
+    switch (baseToken(token)) {
+      case kTokenEof:
+        ++cursor.pos;
+        return true;
+      case kTokenFragmentHeader:
+        // token, major, minor, flags
+        require(cursor, 4);
+        cursor.pos += 4;
+        break;
+      case kTokenTemplateInstance:
+        if (!parseTemplateInstance(cursor, handler, depth)) return false;
+        break;
+      case kTokenOpenStartElement:
+        if (!parseElement(cursor, token, values, handler, depth)) return false;
+        break;
+      case kTokenPiTarget:
+        ++cursor.pos;
+        readName(cursor);
+        break;
+      case kTokenPiData:
+        ++cursor.pos;
+        readCountedString(cursor);
+        break;
+      default:
+        throw std::runtime_error("Неожиданный токен BinXml: " +
+                                 std::to_string(token));
+    }
+  }
+
+  return true;
+}
+
+bool BinXmlDecoder::parseTemplateInstance(Cursor& cursor,
+                                          IBinXmlHandler& handler,
+                                          int depth) {
+  if (symbolic_) {
+    throw std::runtime_error("Вложенный экземпляр шаблона в теле шаблона");
+  }
+
+  // token, unknown, template id (4), template definition offset (4)
+  require(cursor, 10);
+  cursor.pos += 6;
+  const uint32_t definition_offset = read<uint32_t>(cursor);
+
+  // Определение шаблона хранится inline при первом использовании в блоке
+  if (definition_offset == cursor.pos) {
+    require(cursor, kTemplateHeaderSize);
+    const uint32_t inline_size =
+        readLittleEndian<uint32_t>(chunk_, cursor.pos + 20);
+    require(cursor, uint64_t{kTemplateHeaderSize} + inline_size);
+    cursor.pos += kTemplateHeaderSize + inline_size;
+  }
+
+  if (definition_offset > chunk_.size() ||
+      chunk_.size() - definition_offset < kTemplateHeaderSize) {
+    throw std::runtime_error("Некорректное смещение шаблона BinXml");
+  }
+  const uint32_t body_offset = definition_offset + kTemplateHeaderSize;
+  const uint32_t body_size =
+      readLittleEndian<uint32_t>(chunk_, definition_offset + 20);
+  if (body_size > chunk_.size() - body_offset) {
+    throw std::runtime_error("Некорректный размер шаблона BinXml");
+  }
+
+  // Массив подстановок: количество, дескрипторы (размер, тип), значения.
+  // В поврежденных и восстановленных записях количество произвольно, поэтому
+  // оно сверяется с остатком записи до выделения памяти под подстановки
+  const uint32_t count = read<uint32_t>(cursor);
+  if (count > (cursor.end - cursor.pos) / 4) {
+    throw std::runtime_error("Некорректное количество подстановок BinXml");
+  }
+
+  std::vector<BinXmlValue> values(count);
+  uint64_t value_offset = uint64_t{cursor.pos} + uint64_t{count} * 4;
+  for (auto& value : values) {
+    const uint16_t size = read<uint16_t>(cursor);
+    value.type = static_cast<BinXmlValueType>(read<uint8_t>(cursor));
+    cursor.pos += 1;
+
+    value.offset = static_cast<uint32_t>(value_offset);
+    value_offset += size;
+    if (value_offset > cursor.end) {
+      throw std::runtime_error(
+          "Значения подстановок выходят за границы записи");
+    }
+  }
+
+  cursor.pos = static_cast<uint32_t>(value_offset);
+  for (size_t i = 0; i < values.size(); ++i) {
+    const uint32_t end =
+        i + 1 < values.size() ? values[i + 1].offset : cursor.pos;
+    values[i].data = chunk_.subspan(values[i].offset, end - values[i].offset);
+  }
+
+  if (cache_ && handler.usesTemplatePlans()) {
+    const TemplatePlan& plan =
+        planFor(definition_offset, body_offset, body_size, depth);
+    if (plan.usable) {
+      plan_hits_++;
+      return handler.applyTemplate(plan, values, *this);
+    }
+    fallbacks_++;
+  }
+
+  Cursor body{body_offset, body_offset + body_size};
+  return parseFragment(body, values, handler, depth + 1);
+}
+
+bool BinXmlDecoder::parseElement(Cursor& cursor, uint8_t token,
+                                 std::span<const BinXmlValue> values,
+                                 IBinXmlHandler& handler, int depth) {
+  if (depth > kMaxDepth) {
+    throw std::runtime_error("Слишком глубокая вложенность BinXml");
+  }
+
+  ++cursor.pos;
+  if (hasDependencyId(cursor)) {
+    cursor.pos += 2;
+  }
+  read<uint32_t>(cursor);  // размер данных элемента
+  const std::string_view name = readName(cursor);
+  if (token & kTokenFlagMore) {
+    read<uint32_t>(cursor);  // размер списка атрибутов
+  }
+
+  if (!handler.startElement(name)) return false;
+
+  // Атрибуты
+  for (;;) {
+    require(cursor, 1);
+    if (baseToken(chunk_[cursor.pos]) != kTokenAttribute) break;
+    ++cursor.pos;
+
+    const std::string_view attribute_name = readName(cursor);
+    BinXmlValue value;
+    parseAttributeValue(cursor, values, value);
+    if (!value.isNull() && !handler.attribute(attribute_name, value)) {
+      return false;
+    }
+  }
+
+  const uint8_t close = baseToken(read<uint8_t>(cursor));
+  if (close == kTokenCloseEmptyElement) {
+    return handler.closeStartElement() && handler.endElement();
+  }
+  if (close != kTokenCloseStartElement) {
+    throw std::runtime_error("Ожидалось закрытие начального тега BinXml");
+  }
+  if (!handler.closeStartElement()) return false;
+
+  // Содержимое элемента
+  for (;;) {
+    require(cursor, 1);
+    const uint8_t content_token = chunk_[cursor.pos];
+
+    switch (baseToken(content_token)) {
+      case kTokenEndElement:
+        ++cursor.pos;
+        return handler.endElement();
+      case kTokenOpenStartElement:
+        if (!parseElement(cursor, content_token, values, handler, depth + 1)) {
+          return false;
+        }
+        break;
+      case kTokenValue: {
+        cursor.pos += 2;  // token, value type (всегда строка)
+        if (!handler.text(readCountedString(cursor))) return false;
+        break;
+      }
+      case kTokenCData:
+        ++cursor.pos;
+        if (!handler.text(readCountedString(cursor))) return false;
+        break;
+      case kTokenNormalSubstitution:
+      case kTokenOptionalSubstitution: {
+        ++cursor.pos;
+        const uint16_t index = read<uint16_t>(cursor);
+        const uint8_t declared_type = read<uint8_t>(cursor);
+        if (symbolic_) {
+          if (!handler.text(placeholder(index, declared_type))) return false;
+        } else if (index < values.size() &&
+                   !emitText(values[index], handler, depth)) {
+          return false;
+        }
+        break;
+      }
+      case kTokenCharRef:
+      case kTokenEntityRef: {
+        BinXmlValue reference;
+        parseAttributeValue(cursor, values, reference);
+        if (!handler.text(reference)) return false;
+        break;
+      }
+      case kTokenTemplateInstance:
+        if (!parseTemplateInstance(cursor, handler, depth + 1)) return false;
+        break;
+      case kTokenPiTarget:
+        ++cursor.pos;
+        readName(cursor);
+        break;
+      case kTokenPiData:
+        ++cursor.pos;
+        readCountedString(cursor);
+        break;
+      default:
+        throw std::runtime_error("Неожиданный токен в содержимом элемента: " +
+                                 std::to_string(content_token));
+    }
+  }
+}
+
+void BinXmlDecoder::parseAttributeValue(Cursor& cursor,
+                                        std::span<const BinXmlValue> values,
+                                        BinXmlValue& value) {
+  std::string combined;
+  size_t parts = 0;
+  bool has_placeholder = false;
+
+  for (;;) {
+    if (cursor.pos >= cursor.end) break;
+    const uint8_t token = baseToken(chunk_[cursor.pos]);
+    if (token != kTokenValue && token != kTokenNormalSubstitution &&
+        token != kTokenOptionalSubstitution && token != kTokenCharRef &&
+        token != kTokenEntityRef) {
+      break;
+    }
+
+    // Второй фрагмент: первый переносится в общий буфер до того, как
+    // буфер ссылок будет перезаписан
+    if (parts == 1) {
+      value.appendTo(combined);
+    }
+
+    BinXmlValue part;
+    ++cursor.pos;
+    if (token == kTokenValue) {
+      cursor.pos += 1;
+      part = readCountedString(cursor);
+    } else if (token == kTokenCharRef) {
+      const uint16_t code = read<uint16_t>(cursor);
+      const uint8_t unit[2] = {static_cast<uint8_t>(code & 0xFF),
+                               static_cast<uint8_t>(code >> 8)};
+      scratch_.clear();
+      Utf16::appendUtf8(scratch_, unit);
+      part.type = BinXmlValueType::Utf8Text;
+      part.data = {reinterpret_cast<const uint8_t*>(scratch_.data()),
+                   scratch_.size()};
+    } else if (token == kTokenEntityRef) {
+      const std::string_view entity = readName(cursor);
+      std::string_view replacement;
+      if (entity == "amp") replacement = "&";
+      else if (entity == "lt") replacement = "<";
+      else if (entity == "gt") replacement = ">";
+      else if (entity == "quot") replacement = "\"";
+      else if (entity == "apos") replacement = "'";
+      part.type = BinXmlValueType::Utf8Text;
+      part.data = {reinterpret_cast<const uint8_t*>(replacement.data()),
+                   replacement.size()};
+    } else {
+      const uint16_t index = read<uint16_t>(cursor);
+      const uint8_t declared_type = read<uint8_t>(cursor);
+      if (symbolic_) {
+        part = placeholder(index, declared_type);
+      } else if (index < values.size()) {
+        part = values[index];
+      }
+    }
+
+    if (part.type == BinXmlValueType::Placeholder ||
+        (parts > 0 && value.type == BinXmlValueType::Placeholder)) {
+      has_placeholder = true;
+    }
+
+    if (parts == 0) {
+      value = part;
+    } else {
+      part.appendTo(combined);
+    }
+    ++parts;
+  }
+
+  // Подстановка внутри составного значения планом не выражается
+  if (has_placeholder && parts > 1) {
+    value = placeholder(BinXmlValue::kNoSubstitution, 0);
+  } else if (parts > 1) {
+    scratch_ = std::move(combined);
+    value.type = BinXmlValueType::Utf8Text;
+    value.data = {reinterpret_cast<const uint8_t*>(scratch_.data()),
+                  scratch_.size()};
+  }
+}
+
+bool BinXmlDecoder::emitText(const BinXmlValue& value, IBinXmlHandler& handler,
+                             int depth) {
+  if (value.isNull()) {
+    return true;
+  }
+  if (value.type == BinXmlValueType::BinXml) {
+    Cursor nested{value.offset,
+                  value.offset + static_cast<uint32_t>(value.data.size())};
+    return parseFragment(nested, {}, handler, depth + 1);
+  }
+  return handler.text(value);
+}
+
+const TemplatePlan& BinXmlDecoder::planFor(uint32_t definition_offset,
+                                           uint32_t body_offset,
+                                           uint32_t body_size, int depth) {
+  if (const auto it = plans_.find(definition_offset); it != plans_.end()) {
+    return *it->second;
+  }
+
+  // Символический обход тела: подстановки передаются как Placeholder
+  TemplatePlanCompiler compiler;
+  symbolic_ = true;
+  try {
+    Cursor body{body_offset, body_offset + body_size};
+    if (!parseFragment(body, {}, compiler, depth + 1)) {
+      compiler.invalidate();
+    }
+  } catch (const std::exception&) {
+    compiler.invalidate();
+  }
+  symbolic_ = false;
+
+  const auto [it, inserted] =
+      plans_.emplace(definition_offset, cache_->intern(compiler.finish()));
+  return *it->second;
+}
+
+BinXmlValue BinXmlDecoder::placeholder(uint16_t index,
+                                       uint8_t declared_type) noexcept {
+  BinXmlValue value;
+  value.type = BinXmlValueType::Placeholder;
+  value.declared_type = static_cast<BinXmlValueType>(declared_type);
+  value.substitution = index;
+  return value;
+}
+
+std::string_view BinXmlDecoder::readName(Cursor& cursor) {
+  const uint32_t name_offset = read<uint32_t>(cursor);
+
+  // Имя хранится inline при первом использовании в блоке
+  if (name_offset == cursor.pos) {
+    require(cursor, kNameHeaderSize);
+    const uint16_t length =
+        readLittleEndian<uint16_t>(chunk_, cursor.pos + 6);
+    const uint32_t total = kNameHeaderSize + length * 2u + 2u;
+    require(cursor, total);
+    cursor.pos += total;
+  }
+
+  if (const auto it = names_.find(name_offset); it != names_.end()) {
+    return it->second;
+  }
+
+  if (name_offset > chunk_.size() ||
+      chunk_.size() - name_offset < kNameHeaderSize) {
+    throw std::runtime_error("Некорректное смещение имени BinXml");
+  }
+  const uint16_t length = readLittleEndian<uint16_t>(chunk_, name_offset + 6);
+  if (length * 2u > chunk_.size() - name_offset - kNameHeaderSize) {
+    throw std::runtime_error("Некорректная длина имени BinXml");
+  }
+
+  const auto [it, inserted] = names_.emplace(
+      name_offset,
+      Utf16::toUtf8(chunk_.subspan(name_offset + kNameHeaderSize,
+                                   length * 2u)));
+  return it->second;
+}
+
+BinXmlValue BinXmlDecoder::readCountedString(Cursor& cursor) {
+  const uint16_t length = read<uint16_t>(cursor);
+  require(cursor, length * 2u);
+
+  BinXmlValue value;
+  value.type = BinXmlValueType::String;
+  value.offset = cursor.pos;
+  value.data = chunk_.subspan(cursor.pos, length * 2u);
+  cursor.pos += length * 2u;
+  return value;
+}
+
+bool BinXmlDecoder::hasDependencyId(const Cursor& cursor) const noexcept {
+  // Во вложенных фрагментах (подстановки типа BinXml) поле dependency id
+  // отсутствует; выбирается вариант, при котором смещение имени корректно
+  const auto plausible = [this, &cursor](uint32_t field_offset) {
+    if (field_offset + 4 > cursor.end) return false;
+    const uint32_t name_offset = readLittleEndian<uint32_t>(chunk_, field_offset);
+    return name_offset >= EvtxChunk::kHeaderSize &&
+           name_offset + kNameHeaderSize <= chunk_.size() &&
+           name_offset <= field_offset + 4;
+  };
+
+  if (plausible(cursor.pos + 6)) return true;
+  return !plausible(cursor.pos + 4);
+}
+
+}
@@ -0,0 +1,240 @@
+/// @file binxml.hpp
+/// @brief Декодер двоичного XML (BinXml) записей EVTX
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/// @namespace EventLogAnalysis
+/// @brief Пространство имен для работы с журналами событий Windows
+namespace EventLogAnalysis {
+
+class BinXmlDecoder;
+class TemplateCache;
+struct TemplatePlan;
+
+/// @brief Типы значений BinXml
+enum class BinXmlValueType : uint8_t {
+  Null = 0x00,
+  String = 0x01,      ///< UTF-16LE
+  AnsiString = 0x02,  ///< Однобайтовая строка
+  Int8 = 0x03,
+  UInt8 = 0x04,
+  Int16 = 0x05,
+  UInt16 = 0x06,
+  Int32 = 0x07,
+  UInt32 = 0x08,
+  Int64 = 0x09,
+  UInt64 = 0x0A,
+  Real32 = 0x0B,
+  Real64 = 0x0C,
+  Bool = 0x0D,
+  Binary = 0x0E,
+  Guid = 0x0F,
+  SizeT = 0x10,
+  FileTime = 0x11,
+  SysTime = 0x12,
+  Sid = 0x13,
+  HexInt32 = 0x14,
+  HexInt64 = 0x15,
+  BinXml = 0x21,      ///< Вложенный фрагмент BinXml
+  Placeholder = 0x7E,  ///< Внутренний тип: подстановка при компиляции шаблона
+  Utf8Text = 0x7F,    ///< Внутренний тип: уже декодированный текст UTF-8
+  ArrayFlag = 0x80,   ///< Признак массива значений
+};
+
+/// @brief Значение из потока BinXml (текст, атрибут или подстановка)
+/// @details Ссылается на байты блока и действительно только во время вызова
+/// обработчика
+struct BinXmlValue {
+  static constexpr uint16_t kNoSubstitution = 0xFFFF;  ///< Нет подстановки
+
+  BinXmlValueType type = BinXmlValueType::Null;  ///< Тип значения
+  BinXmlValueType declared_type =
+      BinXmlValueType::Null;  ///< Тип подстановки по шаблону (Placeholder)
+  uint16_t substitution = kNoSubstitution;  ///< Индекс подстановки
+                                            ///< (Placeholder)
+  uint32_t offset = 0;  ///< Смещение значения от начала блока
+  std::span<const uint8_t> data;  ///< Байты значения
+
+  /// @brief Проверяет отсутствие значения
+  [[nodiscard]] bool isNull() const noexcept;
+
+  /// @brief Читает значение как беззнаковое целое
+  /// @param value Результат
+  /// @return true если тип значения целочисленный
+  bool toUnsigned(uint64_t& value) const noexcept;
+
+  /// @brief Дописывает текстовое представление значения
+  /// @details Формат совпадает с XML, который рендерит Windows: целые в
+  /// десятичном виде, HexInt и SizeT с префиксом 0x, GUID в фигурных
+  /// скобках, FILETIME/SYSTEMTIME в ISO 8601, SID в виде S-1-...
+  /// @param out Строка-приемник
+  void appendTo(std::string& out) const;
+};
+
+/// @class IBinXmlHandler
+/// @brief Обработчик событий декодера BinXml (SAX-подобный интерфейс)
+/// @details Возврат false из любого метода прекращает разбор записи
+class IBinXmlHandler {
+ public:
+  /// @brief Виртуальный деструктор по умолчанию
+  virtual ~IBinXmlHandler() = default;
+
+  /// @brief Начало элемента
+  /// @param name Имя элемента (действительно до конца разбора блока)
+  virtual bool startElement(std::string_view name) = 0;
+
+  /// @brief Атрибут текущего элемента
+  /// @param name Имя атрибута
+  /// @param value Значение атрибута
+  virtual bool attribute(std::string_view name, const BinXmlValue& value) = 0;
+
+  /// @brief Конец списка атрибутов текущего элемента
+  virtual bool closeStartElement() = 0;
+
+  /// @brief Текстовое содержимое текущего элемента
+  /// @param value Значение
+  virtual bool text(const BinXmlValue& value) = 0;
+
+  /// @brief Конец текущего элемента
+  virtual bool endElement() = 0;
+
+  /// @brief Проверяет, может ли обработчик принять план шаблона
+  /// @return true если вместо обхода тела шаблона следует вызвать
+  /// applyTemplate
+  [[nodiscard]] virtual bool usesTemplatePlans() const noexcept {
+    return false;
+  }
+
+  /// @brief Заполняет запись по скомпилированному плану шаблона
+  /// @param plan План шаблона
+  /// @param values Массив подстановок записи
+  /// @param decoder Декодер для разбора вложенных фрагментов
+  virtual bool applyTemplate(const TemplatePlan& plan,
+                             std::span<const BinXmlValue> values,
+                             BinXmlDecoder& decoder) {
+    (void)plan;
+    (void)values;
+    (void)decoder;
+    return true;
+  }
+};
+
+/// @class BinXmlDecoder
+/// @brief Декодер BinXml в пределах одного блока EVTX
+/// @details Имена элементов и определения шаблонов хранятся в блоке и
+/// адресуются смещениями от его начала. Декодер кеширует имена, поэтому
+/// для разбора всех записей блока используется один экземпляр. Экземпляр не
+/// потокобезопасен: каждый поток разбирает свой блок своим декодером.
+///
+/// При заданном кеше шаблонов каждый шаблон блока компилируется в план
+/// один раз (символическим обходом тела), и записи обработчиков,
+/// поддерживающих планы, заполняются индексированием массива подстановок.
+class BinXmlDecoder {
+ public:
+  /// @brief Конструктор
+  /// @param chunk Байты блока EVTX
+  /// @param cache Общий кеш планов шаблонов (nullptr - без планов)
+  explicit BinXmlDecoder(std::span<const uint8_t> chunk,
+                         TemplateCache* cache = nullptr);
+
+  /// @brief Деструктор, передает счетчики в кеш шаблонов
+  ~BinXmlDecoder();
+
+  /// @brief Конструктор копирования (запрещен)
+  BinXmlDecoder(const BinXmlDecoder&) = delete;
+
+  /// @brief Оператор присваивания копированием (запрещен)
+  BinXmlDecoder& operator=(const BinXmlDecoder&) = delete;
+
+  /// @brief Декодирует фрагмент BinXml записи
+  /// @param offset Смещение фрагмента от начала блока
+  /// @param size Размер фрагмента
+  /// @param handler Обработчик событий разбора
+  /// @return true если фрагмент разобран полностью, false если разбор
+  /// остановлен обработчиком
+  /// @throws std::runtime_error Если данные фрагмента повреждены
+  bool decode(uint32_t offset, uint32_t size, IBinXmlHandler& handler);
+
+  /// @brief Передает значение подстановки обработчику
+  /// @details Вложенный BinXml разбирается как фрагмент, прочие значения
+  /// передаются как текст
+  /// @param value Значение подстановки
+  /// @param handler Обработчик событий разбора
+  /// @return false если разбор остановлен обработчиком
+  bool decodeValue(const BinXmlValue& value, IBinXmlHandler& handler);
+
+ private:
+  /// @brief Позиция разбора внутри блока
+  struct Cursor {
+    uint32_t pos;  ///< Текущее смещение от начала блока
+    uint32_t end;  ///< Граница доступной области
+  };
+
+  /// @brief Разбирает последовательность токенов до EOF или конца области
+  bool parseFragment(Cursor& cursor, std::span<const BinXmlValue> values,
+                     IBinXmlHandler& handler, int depth);
+
+  /// @brief Разбирает экземпляр шаблона и его массив подстановок
+  bool parseTemplateInstance(Cursor& cursor, IBinXmlHandler& handler,
+                             int depth);
+
+  /// @brief Разбирает элемент вместе с атрибутами и содержимым
+  bool parseElement(Cursor& cursor, uint8_t token,
+                    std::span<const BinXmlValue> values,
+                    IBinXmlHandler& handler, int depth);
+
+  /// @brief Разбирает значение атрибута (один или несколько токенов)
+  /// @param value Результат; несколько токенов объединяются в Utf8Text
+  void parseAttributeValue(Cursor& cursor, std::span<const BinXmlValue> values,
+                           BinXmlValue& value);
+
+  /// @brief Передает значение подстановки обработчику как текст
+  bool emitText(const BinXmlValue& value, IBinXmlHandler& handler, int depth);
+
+  /// @brief Возвращает план шаблона, компилируя его при первом обращении
+  const TemplatePlan& planFor(uint32_t definition_offset, uint32_t body_offset,
+                              uint32_t body_size, int depth);
+
+  /// @brief Создает значение-заместитель подстановки для компиляции
+  [[nodiscard]] static BinXmlValue placeholder(uint16_t index,
+                                               uint8_t declared_type) noexcept;
+
+  /// @brief Читает имя по смещению, пропуская его, если оно лежит inline
+  std::string_view readName(Cursor& cursor);
+
+  /// @brief Читает UTF-16 строку с префиксом длины как значение String
+  BinXmlValue readCountedString(Cursor& cursor);
+
+  /// @brief Определяет наличие поля dependency id у элемента
+  [[nodiscard]] bool hasDependencyId(const Cursor& cursor) const noexcept;
+
+  /// @brief Проверяет, что в области осталось не меньше size байт
+  /// @details Размер 64-битный, чтобы суммы прочитанных из файла величин
+  /// не переполнялись до проверки
+  void require(const Cursor& cursor, uint64_t size) const;
+
+  template <typename T>
+  T read(Cursor& cursor);
+
+  std::span<const uint8_t> chunk_;  ///< Байты блока
+  TemplateCache* cache_ = nullptr;  ///< Общий кеш планов шаблонов
+  std::unordered_map<uint32_t, std::shared_ptr<const TemplatePlan>>
+      plans_;  ///< Планы по смещению определения шаблона в блоке
+  bool symbolic_ = false;     ///< Идет компиляция тела шаблона
+  uint64_t plan_hits_ = 0;    ///< Записей, разобранных по плану
+  uint64_t fallbacks_ = 0;    ///< Записей, разобранных полным обходом
+  std::unordered_map<uint32_t, std::string>
+      names_;            ///< Кеш имен по смещению в блоке
+  std::string scratch_;  ///< Буфер для значений, собранных из нескольких
+                         ///< токенов
+};
+
+}
@@ -0,0 +1,145 @@
+#include "carver.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+
+#include "../common/byte_order.hpp"
+
+namespace EventLogAnalysis {
+
+namespace {
+
+constexpr uint8_t kChunkSignature[] = {'E', 'l', 'f', 'C', 'h', 'n', 'k', 0};
+constexpr uint8_t kRecordSignature[] = {'*', '*', 0, 0};
+
+constexpr size_t kNotFound = std::string_view::npos;
+
+}
+
+EvtxCarver::EvtxCarver(std::span<const uint8_t> data) noexcept
+    : data_(data), log_layout_(EvtxFileHeader::parse(data).has_value()) {}
+
+EvtxCarveResult EvtxCarver::scan() const {
+  EvtxCarveResult result;
+  std::vector<ChunkBase> bases;
+
+  // Блоки: сигнатура и CRC-32 заголовка
+  for (size_t pos = find(0, kChunkSignature); pos != kNotFound;
+       pos = find(pos, kChunkSignature)) {
+    const auto chunk = pos + EvtxChunk::kSize <= data_.size()
+                           ? EvtxChunk::parse(
+                                 data_.subspan(pos, EvtxChunk::kSize), pos)
+                           : std::nullopt;
+    if (!chunk) {
+      // Таблицы строк и шаблонов поврежденного блока могут быть целы
+      bases.push_back({pos, static_cast<uint32_t>(EvtxChunk::kHeaderSize)});
+      result.damaged_chunks++;
+      pos += sizeof(kChunkSignature);
+      continue;
+    }
+
+    bases.push_back({pos, chunk->freeSpaceOffset()});
+    if (!chunk->empty()) {
+      result.chunks.push_back(*chunk);
+    }
+    pos += EvtxChunk::kSize;
+  }
+
+  // Записи вне разобранных областей: после конца области записей "грязного"
+  // блока, в блоках с поврежденным заголовком и в отдельных фрагментах
+  for (size_t pos = find(0, kRecordSignature); pos != kNotFound;
+       pos = find(pos, kRecordSignature)) {
+    const auto base = baseFor(bases, pos);
+    if (!base) {
+      result.unresolved_records++;
+      pos += sizeof(kRecordSignature);
+      continue;
+    }
+    if (pos < base->offset + base->records_end) {
+      pos = base->offset + base->records_end;
+      continue;
+    }
+
+    EvtxCarvedRecord record;
+    if (validateRecord(pos, base->offset, record)) {
+      result.records.push_back(record);
+      pos += record.location.size;
+    } else {
+      pos += sizeof(kRecordSignature);
+    }
+  }
+
+  std::stable_sort(result.chunks.begin(), result.chunks.end(),
+                   [](const EvtxChunk& a, const EvtxChunk& b) {
+                     return a.firstRecordId() < b.firstRecordId();
+                   });
+  return result;
+}
+
+size_t EvtxCarver::find(size_t from,
+                        std::span<const uint8_t> signature) const noexcept {
+  while (from + signature.size() <= data_.size()) {
+    const void* found = std::memchr(data_.data() + from, signature[0],
+                                    data_.size() - from - signature.size() + 1);
+    if (found == nullptr) {
+      return kNotFound;
+    }
+    const size_t pos =
+        static_cast<size_t>(static_cast<const uint8_t*>(found) - data_.data());
+    if (std::memcmp(data_.data() + pos, signature.data(), signature.size()) ==
+        0) {
+      return pos;
+    }
+    from = pos + 1;
+  }
+  return kNotFound;
+}
+
+std::optional<EvtxCarver::ChunkBase> EvtxCarver::baseFor(
+    std::span<const ChunkBase> bases, size_t position) const noexcept {
+  const auto next = std::upper_bound(
+      bases.begin(), bases.end(), position,
+      [](size_t value, const ChunkBase& base) { return value < base.offset; });
+  if (next != bases.begin()) {
+    const ChunkBase& base = *std::prev(next);
+    if (position - base.offset < EvtxChunk::kSize) {
+      return base;
+    }
+  }
+
+  // В файле журнала блоки следуют за заголовком с шагом 64 КБ
+  if (log_layout_ && position >= EvtxFileHeader::kSize) {
+    return ChunkBase{EvtxFileHeader::kSize +
+                         (position - EvtxFileHeader::kSize) /
+                             EvtxChunk::kSize * EvtxChunk::kSize,
+                     static_cast<uint32_t>(EvtxChunk::kHeaderSize)};
+  }
+  return std::nullopt;
+}
+
+bool EvtxCarver::validateRecord(size_t position, uint64_t chunk_offset,
+                                EvtxCarvedRecord& record) const noexcept {
+  const size_t relative = position - chunk_offset;
+  if (relative < EvtxChunk::kHeaderSize ||
+      position + EvtxChunk::kRecordHeaderSize > data_.size()) {
+    return false;
+  }
+
+  const uint32_t size = readLittleEndian<uint32_t>(data_, position + 4);
+  if (size < EvtxChunk::kRecordHeaderSize + 4 ||
+      relative + size > EvtxChunk::kSize || position + size > data_.size() ||
+      readLittleEndian<uint32_t>(data_, position + size - 4) != size) {
+    return false;
+  }
+
+  record.chunk_offset = chunk_offset;
+  record.location.record_id = readLittleEndian<uint64_t>(data_, position + 8);
+  record.location.written_time =
+      readLittleEndian<uint64_t>(data_, position + 16);
+  record.location.offset = static_cast<uint32_t>(relative);
+  record.location.size = size;
+  return record.location.record_id != 0;
+}
+
+}
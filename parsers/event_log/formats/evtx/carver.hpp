@@ -0,0 +1,87 @@
+/// @file carver.hpp
+/// @brief Поиск блоков и записей EVTX в произвольных байтах
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "chunk.hpp"
+
+/// @namespace EventLogAnalysis
+/// @brief Пространство имен для работы с журналами событий Windows
+namespace EventLogAnalysis {
+
+/// @brief Запись, найденная вне области записей целого блока
+struct EvtxCarvedRecord {
+  uint64_t chunk_offset = 0;     ///< Смещение предполагаемого начала блока
+  EvtxRecordLocation location;   ///< Запись относительно начала блока
+};
+
+/// @brief Результат поиска в байтах
+struct EvtxCarveResult {
+  std::vector<EvtxChunk> chunks;          ///< Блоки с верной CRC заголовка
+  std::vector<EvtxCarvedRecord> records;  ///< Записи вне целых блоков
+  size_t damaged_chunks = 0;    ///< Сигнатуры блоков с поврежденным заголовком
+  size_t unresolved_records = 0;  ///< Записи без определимого начала блока
+};
+
+/// @class EvtxCarver
+/// @brief Восстановление записей EVTX из поврежденных журналов, slack и
+/// неразмеченного пространства
+/// @details Байты просматриваются дважды: сначала ищутся сигнатуры
+/// "ElfChnk\0" и проверяется CRC-32 заголовков блоков, затем сигнатуры
+/// записей "**\0\0" вне областей записей найденных блоков. Кандидат в
+/// запись принимается, если поле размера помещается в блок и совпадает с
+/// копией в конце записи. Смещения BinXml отсчитываются от начала блока,
+/// поэтому записи сопоставляется ближайшая предшествующая сигнатура блока
+/// (в пределах 64 КБ), а в файлах журнала без нее - штатное положение
+/// блока после заголовка файла. Поиск сигнатур выполняет memchr
+/// (векторизованный в libc), поэтому просмотр идет со скоростью чтения
+/// памяти.
+class EvtxCarver {
+ public:
+  /// @brief Создает поиск по байтам
+  /// @param data Байты файла или области образа
+  explicit EvtxCarver(std::span<const uint8_t> data) noexcept;
+
+  /// @brief Ищет блоки и записи
+  /// @return Блоки в порядке номеров записей и записи в порядке смещений
+  [[nodiscard]] EvtxCarveResult scan() const;
+
+ private:
+  /// @brief Известное начало блока
+  struct ChunkBase {
+    uint64_t offset = 0;       ///< Смещение блока
+    uint32_t records_end = 0;  ///< Конец разобранной области записей
+  };
+
+  /// @brief Находит сигнатуру начиная с позиции
+  /// @param from Начальная позиция
+  /// @param signature Сигнатура
+  /// @return Позиция или npos
+  [[nodiscard]] size_t find(size_t from,
+                            std::span<const uint8_t> signature) const noexcept;
+
+  /// @brief Определяет начало блока для записи
+  /// @param bases Начала блоков в порядке смещений
+  /// @param position Смещение записи
+  /// @return Начало блока или std::nullopt
+  [[nodiscard]] std::optional<ChunkBase> baseFor(
+      std::span<const ChunkBase> bases, size_t position) const noexcept;
+
+  /// @brief Проверяет кандидата в запись
+  /// @param position Смещение сигнатуры записи
+  /// @param chunk_offset Начало блока записи
+  /// @param record Запись (результат)
+  /// @return true если размеры записи согласованы
+  [[nodiscard]] bool validateRecord(size_t position, uint64_t chunk_offset,
+                                    EvtxCarvedRecord& record) const noexcept;
+
+  std::span<const uint8_t> data_;  ///< Просматриваемые байты
+  bool log_layout_ = false;        ///< Байты начинаются с заголовка журнала
+};
+
+}
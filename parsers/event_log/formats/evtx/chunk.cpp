@@ -0,0 +1,161 @@
+#include "chunk.hpp"
+
+#include <cstring>
+
+#include "../common/byte_order.hpp"
+#include "../common/crc32.hpp"
+#include "../common/mapped_file.hpp"
+
+namespace EventLogAnalysis {
+
+namespace {
+
+constexpr uint8_t kFileSignature[] = {'E', 'l', 'f', 'F', 'i', 'l', 'e', 0};
+constexpr uint8_t kChunkSignature[] = {'E', 'l', 'f', 'C', 'h', 'n', 'k', 0};
+constexpr uint32_t kRecordSignature = 0x00002A2A;  // "**\0\0"
+
+// Контрольная сумма заголовка файла покрывает первые 120 байт
+constexpr size_t kFileChecksumCoverage = 120;
+constexpr size_t kFileChecksumOffset = 124;
+
+// Контрольная сумма заголовка блока покрывает байты 0-119 и 128-511
+constexpr size_t kChunkChecksumGap = 120;
+constexpr size_t kChunkChecksumResume = 128;
+constexpr size_t kChunkChecksumOffset = 124;
+
+}
+
+std::optional<EvtxFileHeader> EvtxFileHeader::parse(
+    std::span<const uint8_t> file) noexcept {
+  if (file.size() < kFileChecksumOffset + 4 ||
+      std::memcmp(file.data(), kFileSignature, sizeof(kFileSignature)) != 0) {
+    return std::nullopt;
+  }
+
+  EvtxFileHeader header;
+  header.first_chunk_number = readLittleEndian<uint64_t>(file, 8);
+  header.last_chunk_number = readLittleEndian<uint64_t>(file, 16);
+  header.next_record_id = readLittleEndian<uint64_t>(file, 24);
+  header.minor_version = readLittleEndian<uint16_t>(file, 36);
+  header.major_version = readLittleEndian<uint16_t>(file, 38);
+  header.header_block_size = readLittleEndian<uint16_t>(file, 40);
+  header.chunk_count = readLittleEndian<uint16_t>(file, 42);
+  header.flags = readLittleEndian<uint32_t>(file, 120);
+  header.checksum_valid =
+      Crc32::compute(file.first(kFileChecksumCoverage)) ==
+      readLittleEndian<uint32_t>(file, kFileChecksumOffset);
+  return header;
+}
+
+std::optional<EvtxFileHeader> EvtxFileHeader::read(
+    const std::string& file_path) {
+  return parse(readFilePrefix(file_path, kSize));
+}
+
+bool EvtxFileHeader::isDirty() const noexcept {
+  return (flags & kFlagDirty) != 0;
+}
+
+EventLogSummary EvtxFileHeader::summary() const noexcept {
+  EventLogSummary result;
+  result.record_count = next_record_id > 0 ? next_record_id - 1 : 0;
+  result.dirty = isDirty() || !checksum_valid;
+  return result;
+}
+
+std::optional<EvtxChunk> EvtxChunk::parse(std::span<const uint8_t> data,
+                                          uint64_t offset) noexcept {
+  if (data.size() < kSize ||
+      std::memcmp(data.data(), kChunkSignature, sizeof(kChunkSignature)) !=
+          0) {
+    return std::nullopt;
+  }
+  data = data.first(kSize);
+
+  uint32_t crc = Crc32::compute(data.first(kChunkChecksumGap));
+  crc = Crc32::compute(
+      data.subspan(kChunkChecksumResume, kHeaderSize - kChunkChecksumResume),
+      crc);
+  if (crc != readLittleEndian<uint32_t>(data, kChunkChecksumOffset)) {
+    return std::nullopt;
+  }
+
+  EvtxChunk chunk;
+  chunk.data_ = data;
+  chunk.file_offset_ = offset;
+  chunk.first_record_id_ = readLittleEndian<uint64_t>(data, 24);
+  chunk.last_record_id_ = readLittleEndian<uint64_t>(data, 32);
+  chunk.free_space_offset_ = readLittleEndian<uint32_t>(data, 48);
+  chunk.records_checksum_ = readLittleEndian<uint32_t>(data, 52);
+
+  if (chunk.free_space_offset_ < kHeaderSize ||
+      chunk.free_space_offset_ > kSize ||
+      chunk.last_record_id_ < chunk.first_record_id_) {
+    return std::nullopt;
+  }
+
+  if (chunk.free_space_offset_ >= kHeaderSize + kRecordHeaderSize &&
+      readLittleEndian<uint32_t>(data, kHeaderSize) == kRecordSignature) {
+    chunk.first_record_time_ =
+        readLittleEndian<uint64_t>(data, kHeaderSize + 16);
+  }
+
+  return chunk;
+}
+
+bool EvtxChunk::recordsChecksumValid() const noexcept {
+  return Crc32::compute(data_.subspan(
+             kHeaderSize, free_space_offset_ - kHeaderSize)) ==
+         records_checksum_;
+}
+
+bool EvtxChunk::forEachRecord(const RecordVisitor& visitor) const {
+  size_t offset = kHeaderSize;
+
+  while (offset + kRecordHeaderSize + 4 <= free_space_offset_) {
+    if (readLittleEndian<uint32_t>(data_, offset) != kRecordSignature) {
+      break;
+    }
+
+    const uint32_t size = readLittleEndian<uint32_t>(data_, offset + 4);
+    if (size < kRecordHeaderSize + 4 || offset + size > free_space_offset_ ||
+        readLittleEndian<uint32_t>(data_, offset + size - 4) != size) {
+      break;
+    }
+
+    EvtxRecordLocation location;
+    location.record_id = readLittleEndian<uint64_t>(data_, offset + 8);
+    location.written_time = readLittleEndian<uint64_t>(data_, offset + 16);
+    location.offset = static_cast<uint32_t>(offset);
+    location.size = size;
+
+    if (!visitor(location)) {
+      return false;
+    }
+    offset += size;
+  }
+
+  return true;
+}
+
+std::span<const uint8_t> EvtxChunk::bytes() const noexcept { return data_; }
+
+uint64_t EvtxChunk::fileOffset() const noexcept { return file_offset_; }
+
+uint64_t EvtxChunk::firstRecordId() const noexcept { return first_record_id_; }
+
+uint64_t EvtxChunk::lastRecordId() const noexcept { return last_record_id_; }
+
+uint64_t EvtxChunk::firstRecordTime() const noexcept {
+  return first_record_time_;
+}
+
+uint32_t EvtxChunk::freeSpaceOffset() const noexcept {
+  return free_space_offset_;
+}
+
+bool EvtxChunk::empty() const noexcept {
+  return free_space_offset_ <= kHeaderSize;
+}
+
+}
@@ -0,0 +1,136 @@
+/// @file chunk.hpp
+/// @brief Заголовки и блоки (chunks) файла EVTX
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+
+#include "../../model/event_log_summary.hpp"
+
+/// @namespace EventLogAnalysis
+/// @brief Пространство имен для работы с журналами событий Windows
+namespace EventLogAnalysis {
+
+/// @brief Заголовок файла EVTX ("ElfFile")
+struct EvtxFileHeader {
+  static constexpr size_t kSize = 4096;           ///< Размер блока заголовка
+  static constexpr uint32_t kFlagDirty = 0x0001;  ///< Файл не был закрыт
+  static constexpr uint32_t kFlagFull = 0x0002;   ///< Журнал заполнен
+
+  uint64_t first_chunk_number = 0;  ///< Номер первого блока
+  uint64_t last_chunk_number = 0;   ///< Номер последнего блока
+  uint64_t next_record_id = 0;      ///< Идентификатор следующей записи
+  uint16_t minor_version = 0;       ///< Младшая версия формата
+  uint16_t major_version = 0;       ///< Старшая версия формата
+  uint16_t header_block_size = 0;   ///< Размер блока заголовка
+  uint16_t chunk_count = 0;         ///< Количество блоков
+  uint32_t flags = 0;               ///< Флаги файла
+  bool checksum_valid = false;      ///< CRC-32 заголовка совпала
+
+  /// @brief Разбирает заголовок файла
+  /// @param file Содержимое файла
+  /// @return Заголовок или std::nullopt, если сигнатура не совпала
+  [[nodiscard]] static std::optional<EvtxFileHeader> parse(
+      std::span<const uint8_t> file) noexcept;
+
+  /// @brief Читает и разбирает заголовок, не отображая файл в память
+  /// @param file_path Путь к файлу
+  /// @return Заголовок или std::nullopt, если сигнатура не совпала
+  [[nodiscard]] static std::optional<EvtxFileHeader> read(
+      const std::string& file_path);
+
+  /// @brief Проверяет флаг незавершенной записи
+  /// @return true если файл не был корректно закрыт
+  [[nodiscard]] bool isDirty() const noexcept;
+
+  /// @brief Возвращает сведения о журнале по заголовку
+  /// @details Количество записей - номер следующей записи минус один;
+  /// заголовок с неверной CRC-32 считается ненадежным, как "грязный"
+  [[nodiscard]] EventLogSummary summary() const noexcept;
+};
+
+/// @brief Положение записи события внутри блока
+struct EvtxRecordLocation {
+  uint64_t record_id = 0;     ///< Номер записи (EventRecordID)
+  uint64_t written_time = 0;  ///< Время записи (FILETIME)
+  uint32_t offset = 0;        ///< Смещение записи от начала блока
+  uint32_t size = 0;          ///< Полный размер записи
+};
+
+/// @class EvtxChunk
+/// @brief Блок EVTX размером 64 КБ ("ElfChnk") с собственными таблицами
+/// строк и шаблонов
+/// @details Блоки независимы друг от друга: все смещения внутри записей
+/// отсчитываются от начала блока, поэтому блоки можно разбирать параллельно
+class EvtxChunk {
+ public:
+  static constexpr size_t kSize = 0x10000;       ///< Размер блока
+  static constexpr size_t kHeaderSize = 0x200;   ///< Заголовок с таблицами
+  static constexpr size_t kRecordHeaderSize = 24;  ///< Заголовок записи
+
+  /// @brief Обработчик записи блока (false прекращает обход)
+  using RecordVisitor = std::function<bool(const EvtxRecordLocation&)>;
+
+  /// @brief Разбирает и проверяет заголовок блока
+  /// @details Проверяются сигнатура, границы смещений и CRC-32 заголовка.
+  /// CRC-32 данных записей вычисляется отдельно, так как в "грязных" файлах
+  /// она может не совпадать при целых записях
+  /// @param data Байты блока (не меньше kSize)
+  /// @param offset Смещение блока в файле
+  /// @return Блок или std::nullopt, если заголовок поврежден
+  [[nodiscard]] static std::optional<EvtxChunk> parse(
+      std::span<const uint8_t> data, uint64_t offset) noexcept;
+
+  /// @brief Проверяет CRC-32 области записей
+  /// @return true если контрольная сумма совпала
+  [[nodiscard]] bool recordsChecksumValid() const noexcept;
+
+  /// @brief Перебирает записи блока по порядку
+  /// @details Обход останавливается на первой записи с неверной сигнатурой
+  /// или размером
+  /// @param visitor Обработчик записей
+  /// @return true если блок обойден полностью
+  bool forEachRecord(const RecordVisitor& visitor) const;
+
+  /// @brief Возвращает байты блока
+  [[nodiscard]] std::span<const uint8_t> bytes() const noexcept;
+
+  /// @brief Возвращает смещение блока в файле
+  [[nodiscard]] uint64_t fileOffset() const noexcept;
+
+  /// @brief Возвращает номер первой записи блока
+  [[nodiscard]] uint64_t firstRecordId() const noexcept;
+
+  /// @brief Возвращает номер последней записи блока
+  [[nodiscard]] uint64_t lastRecordId() const noexcept;
+
+  /// @brief Возвращает время первой записи блока
+  /// @details Первая запись лежит на одной странице с заголовком блока,
+  /// поэтому ее время доступно без чтения остальных записей
+  /// @return FILETIME первой записи или 0, если запись повреждена
+  [[nodiscard]] uint64_t firstRecordTime() const noexcept;
+
+  /// @brief Возвращает смещение конца области записей по заголовку
+  /// @details В "грязных" файлах за ним могут лежать дописанные записи
+  [[nodiscard]] uint32_t freeSpaceOffset() const noexcept;
+
+  /// @brief Проверяет отсутствие записей в блоке
+  [[nodiscard]] bool empty() const noexcept;
+
+ private:
+  EvtxChunk() = default;
+
+  std::span<const uint8_t> data_;  ///< Байты блока
+  uint64_t file_offset_ = 0;       ///< Смещение блока в файле
+  uint64_t first_record_id_ = 0;   ///< Номер первой записи
+  uint64_t last_record_id_ = 0;    ///< Номер последней записи
+  uint64_t first_record_time_ = 0;  ///< Время первой записи
+  uint32_t free_space_offset_ = 0;  ///< Конец области записей
+  uint32_t records_checksum_ = 0;   ///< CRC-32 области записей
+};
+
+}
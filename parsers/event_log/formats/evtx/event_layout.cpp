@@ -0,0 +1,55 @@
+#include "event_layout.hpp"
+
+namespace EventLogAnalysis {
+
+EvtxSection EvtxEventLayout::sectionOf(std::string_view name) noexcept {
+  if (name == "System") return EvtxSection::System;
+  if (name == "EventData") return EvtxSection::EventData;
+  if (name == "UserData") return EvtxSection::UserData;
+  if (name == "RenderingInfo") return EvtxSection::RenderingInfo;
+  return EvtxSection::None;
+}
+
+EvtxField EvtxEventLayout::elementField(EvtxSection section, size_t depth,
+                                        std::string_view name) noexcept {
+  switch (section) {
+    case EvtxSection::System:
+      if (depth != 3) return EvtxField::None;
+      if (name == "EventID") return EvtxField::EventId;
+      if (name == "Level") return EvtxField::Level;
+      if (name == "Channel") return EvtxField::Channel;
+      if (name == "Computer") return EvtxField::Computer;
+      return EvtxField::None;
+    case EvtxSection::EventData:
+      return depth == 3 && name == "Data" ? EvtxField::Data : EvtxField::None;
+    case EvtxSection::UserData:
+      return depth == 4 ? EvtxField::UserData : EvtxField::None;
+    case EvtxSection::RenderingInfo:
+      return depth == 3 && name == "Message" ? EvtxField::Description
+                                             : EvtxField::None;
+    case EvtxSection::None:
+      break;
+  }
+  return EvtxField::None;
+}
+
+EvtxField EvtxEventLayout::attributeField(EvtxSection section, size_t depth,
+                                          std::string_view element,
+                                          std::string_view attribute) noexcept {
+  if (depth != 3) return EvtxField::None;
+
+  if (section == EvtxSection::System) {
+    if (element == "Provider" && attribute == "Name") {
+      return EvtxField::Provider;
+    }
+    if (element == "Security" && attribute == "UserID") {
+      return EvtxField::UserSid;
+    }
+  } else if (section == EvtxSection::EventData && element == "Data" &&
+             attribute == "Name") {
+    return EvtxField::DataName;
+  }
+  return EvtxField::None;
+}
+
+}
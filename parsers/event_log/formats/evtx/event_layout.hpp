@@ -0,0 +1,59 @@
+/// @file event_layout.hpp
+/// @brief Расположение полей события в XML-дереве записи EVTX
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+/// @namespace EventLogAnalysis
+/// @brief Пространство имен для работы с журналами событий Windows
+namespace EventLogAnalysis {
+
+/// @brief Раздел события второго уровня (дочерний элемент Event)
+enum class EvtxSection { None, System, EventData, UserData, RenderingInfo };
+
+/// @brief Поле EventData, в которое попадает значение элемента или атрибута
+enum class EvtxField {
+  None,         ///< Значение не используется
+  EventId,      ///< System/EventID
+  Level,        ///< System/Level
+  Channel,      ///< System/Channel
+  Computer,     ///< System/Computer
+  Provider,     ///< System/Provider/@Name
+  UserSid,      ///< System/Security/@UserID
+  DataName,     ///< EventData/Data/@Name
+  Data,         ///< EventData/Data
+  UserData,     ///< UserData/*/<поле>
+  Description,  ///< RenderingInfo/Message
+};
+
+/// @class EvtxEventLayout
+/// @brief Правила сопоставления элементов записи полям EventData
+/// @details Общие для обхода BinXml и для компиляции шаблонов, чтобы оба
+/// пути извлекали одинаковый набор полей
+class EvtxEventLayout {
+ public:
+  /// @brief Определяет раздел по имени элемента второго уровня
+  /// @param name Имя дочернего элемента Event
+  [[nodiscard]] static EvtxSection sectionOf(std::string_view name) noexcept;
+
+  /// @brief Определяет поле для текста элемента
+  /// @param section Текущий раздел
+  /// @param depth Глубина элемента (Event - 1)
+  /// @param name Имя элемента
+  [[nodiscard]] static EvtxField elementField(EvtxSection section,
+                                              size_t depth,
+                                              std::string_view name) noexcept;
+
+  /// @brief Определяет поле для значения атрибута
+  /// @param section Текущий раздел
+  /// @param depth Глубина элемента-владельца
+  /// @param element Имя элемента-владельца
+  /// @param attribute Имя атрибута
+  [[nodiscard]] static EvtxField attributeField(
+      EvtxSection section, size_t depth, std::string_view element,
+      std::string_view attribute) noexcept;
+};
+
+}
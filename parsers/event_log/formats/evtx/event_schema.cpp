@@ -0,0 +1,161 @@
+#include "event_schema.hpp"
+
+#include <array>
+
+namespace EventLogAnalysis {
+
+namespace {
+
+constexpr std::string_view kSecurityAuditing =
+    "Microsoft-Windows-Security-Auditing";
+constexpr std::string_view kSysmon = "Microsoft-Windows-Sysmon";
+constexpr std::string_view kRemoteConnectionManager =
+    "Microsoft-Windows-TerminalServices-RemoteConnectionManager";
+constexpr std::string_view kLocalSessionManager =
+    "Microsoft-Windows-TerminalServices-LocalSessionManager";
+
+// Security: создание процесса (версии 0-2)
+constexpr std::string_view kProcessCreation[] = {
+    "SubjectUserSid",    "SubjectUserName",    "SubjectDomainName",
+    "SubjectLogonId",    "NewProcessId",       "NewProcessName",
+    "TokenElevationType", "ProcessId",         "CommandLine",
+    "TargetUserSid",     "TargetUserName",     "TargetDomainName",
+    "TargetLogonId",     "ParentProcessName",  "MandatoryLabel"};
+
+// Security: завершение процесса
+constexpr std::string_view kProcessTermination[] = {
+    "SubjectUserSid", "SubjectUserName", "SubjectDomainName",
+    "SubjectLogonId", "Status",          "ProcessId",
+    "ProcessName"};
+
+// Security: успешный вход в систему (версии 0-2)
+constexpr std::string_view kLogon[] = {
+    "SubjectUserSid",         "SubjectUserName",
+    "SubjectDomainName",      "SubjectLogonId",
+    "TargetUserSid",          "TargetUserName",
+    "TargetDomainName",       "TargetLogonId",
+    "LogonType",              "LogonProcessName",
+    "AuthenticationPackageName", "WorkstationName",
+    "LogonGuid",              "TransmittedServices",
+    "LmPackageName",          "KeyLength",
+    "ProcessId",              "ProcessName",
+    "IpAddress",              "IpPort",
+    "ImpersonationLevel",     "RestrictedAdminMode",
+    "TargetOutboundUserName", "TargetOutboundDomainName",
+    "VirtualAccount",         "TargetLinkedLogonId",
+    "ElevatedToken"};
+
+// Security: выход из системы
+constexpr std::string_view kLogoff[] = {"TargetUserSid", "TargetUserName",
+                                        "TargetDomainName", "TargetLogonId",
+                                        "LogonType"};
+
+// Security: инициированный пользователем выход
+constexpr std::string_view kUserInitiatedLogoff[] = {
+    "TargetUserSid", "TargetUserName", "TargetDomainName", "TargetLogonId"};
+
+// Security: соединение, разрешенное/заблокированное WFP
+constexpr std::string_view kFilteringPlatformConnection[] = {
+    "ProcessID",   "Application", "Direction",  "SourceAddress",
+    "SourcePort",  "DestAddress", "DestPort",   "Protocol",
+    "FilterRTID",  "LayerName",   "LayerRTID",  "RemoteUserID",
+    "RemoteMachineID"};
+
+// Security: брандмауэр заблокировал прием входящих подключений
+constexpr std::string_view kFirewallBlockedListen[] = {"Profiles",
+                                                       "Application"};
+
+// Sysmon 1: создание процесса (версия 5)
+constexpr std::string_view kSysmonProcessCreate[] = {
+    "RuleName",          "UtcTime",           "ProcessGuid",
+    "ProcessId",         "Image",             "FileVersion",
+    "Description",       "Product",           "Company",
+    "OriginalFileName",  "CommandLine",       "CurrentDirectory",
+    "User",              "LogonGuid",         "LogonId",
+    "TerminalSessionId", "IntegrityLevel",    "Hashes",
+    "ParentProcessGuid", "ParentProcessId",   "ParentImage",
+    "ParentCommandLine", "ParentUser"};
+
+// Sysmon 3: сетевое подключение (версия 5)
+constexpr std::string_view kSysmonNetworkConnect[] = {
+    "RuleName",           "UtcTime",           "ProcessGuid",
+    "ProcessId",          "Image",             "User",
+    "Protocol",           "Initiated",         "SourceIsIpv6",
+    "SourceIp",           "SourceHostname",    "SourcePort",
+    "SourcePortName",     "DestinationIsIpv6", "DestinationIp",
+    "DestinationHostname", "DestinationPort",  "DestinationPortName"};
+
+// Sysmon 7: загрузка образа (версия 3)
+constexpr std::string_view kSysmonImageLoad[] = {
+    "RuleName",    "UtcTime",         "ProcessGuid", "ProcessId",
+    "Image",       "ImageLoaded",     "FileVersion", "Description",
+    "Product",     "Company",         "OriginalFileName", "Hashes",
+    "Signed",      "Signature",       "SignatureStatus",  "User"};
+
+// Sysmon 11: создание файла (версия 2)
+constexpr std::string_view kSysmonFileCreate[] = {
+    "RuleName",       "UtcTime",         "ProcessGuid", "ProcessId",
+    "Image",          "TargetFilename",  "CreationUtcTime", "User"};
+
+// Sysmon 13: изменение значения реестра (версия 2)
+constexpr std::string_view kSysmonRegistryValueSet[] = {
+    "RuleName", "EventType",    "UtcTime", "ProcessGuid", "ProcessId",
+    "Image",    "TargetObject", "Details", "User"};
+
+// Sysmon 22: DNS-запрос (версия 5)
+constexpr std::string_view kSysmonDnsQuery[] = {
+    "RuleName",  "UtcTime",      "ProcessGuid",  "ProcessId", "QueryName",
+    "QueryStatus", "QueryResults", "Image",      "User"};
+
+// TerminalServices: успешная сетевая аутентификация RDP (UserData)
+constexpr std::string_view kRdpAuthentication[] = {"Param1", "Param2",
+                                                   "Param3"};
+
+// TerminalServices: события сеанса (UserData)
+constexpr std::string_view kRdpSession[] = {"User", "SessionID", "Address"};
+
+/// @brief Запись таблицы схем
+struct SchemaEntry {
+  std::string_view provider;  ///< Имя провайдера
+  uint32_t event_id;          ///< Идентификатор события
+  uint8_t min_version;        ///< Минимальная поддерживаемая версия
+  uint8_t max_version;        ///< Максимальная поддерживаемая версия
+  std::span<const std::string_view> fields;  ///< Имена полей по позициям
+};
+
+constexpr std::array kSchemas = {
+    SchemaEntry{kSecurityAuditing, 4688, 0, 2, kProcessCreation},
+    SchemaEntry{kSecurityAuditing, 4689, 0, 0, kProcessTermination},
+    SchemaEntry{kSecurityAuditing, 4624, 0, 2, kLogon},
+    SchemaEntry{kSecurityAuditing, 4634, 0, 0, kLogoff},
+    SchemaEntry{kSecurityAuditing, 4647, 0, 0, kUserInitiatedLogoff},
+    SchemaEntry{kSecurityAuditing, 5156, 0, 1, kFilteringPlatformConnection},
+    SchemaEntry{kSecurityAuditing, 5157, 0, 1, kFilteringPlatformConnection},
+    SchemaEntry{kSecurityAuditing, 5031, 0, 0, kFirewallBlockedListen},
+    SchemaEntry{kSysmon, 1, 5, 5, kSysmonProcessCreate},
+    SchemaEntry{kSysmon, 3, 5, 5, kSysmonNetworkConnect},
+    SchemaEntry{kSysmon, 7, 3, 3, kSysmonImageLoad},
+    SchemaEntry{kSysmon, 11, 2, 2, kSysmonFileCreate},
+    SchemaEntry{kSysmon, 13, 2, 2, kSysmonRegistryValueSet},
+    SchemaEntry{kSysmon, 22, 5, 5, kSysmonDnsQuery},
+    SchemaEntry{kRemoteConnectionManager, 1149, 0, 0, kRdpAuthentication},
+    SchemaEntry{kLocalSessionManager, 21, 0, 0, kRdpSession},
+    SchemaEntry{kLocalSessionManager, 24, 0, 0, kRdpSession},
+    SchemaEntry{kLocalSessionManager, 25, 0, 0, kRdpSession},
+};
+
+}
+
+std::span<const std::string_view> EventSchema::find(std::string_view provider,
+                                                    uint32_t event_id,
+                                                    uint8_t version) noexcept {
+  for (const auto& entry : kSchemas) {
+    if (entry.event_id == event_id && entry.provider == provider &&
+        version >= entry.min_version && version <= entry.max_version) {
+      return entry.fields;
+    }
+  }
+  return {};
+}
+
+}
@@ -0,0 +1,32 @@
+/// @file event_schema.hpp
+/// @brief Таблица схем полей EventData для известных событий EVTX
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+/// @namespace EventLogAnalysis
+/// @brief Пространство имен для работы с журналами событий Windows
+namespace EventLogAnalysis {
+
+/// @class EventSchema
+/// @brief Соответствие позиций строк подстановки именам полей EventData
+/// @details libevtx отдает значения элементов EventData/UserData в порядке
+/// следования в шаблоне события. Для известных пар (провайдер, ID события)
+/// таблица позволяет восстановить имена полей без рендеринга XML. Новые версии
+/// событий дописывают поля в конец, поэтому одна схема покрывает диапазон
+/// версий.
+class EventSchema {
+ public:
+  /// @brief Ищет схему полей события
+  /// @param provider Имя провайдера события
+  /// @param event_id Идентификатор события
+  /// @param version Версия события
+  /// @return Имена полей по позициям или пустой диапазон, если схема неизвестна
+  [[nodiscard]] static std::span<const std::string_view> find(
+      std::string_view provider, uint32_t event_id, uint8_t version) noexcept;
+};
+
+}
@@ -0,0 +1,182 @@
+#include "log_index.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include "../common/crc32.hpp"
+#include "chunk.hpp"
+
+namespace EventLogAnalysis {
+
+void EvtxEventIdMask::add(uint32_t event_id) noexcept {
+  const size_t bit = event_id % kBits;
+  words[bit / 64] |= uint64_t{1} << (bit % 64);
+}
+
+void EvtxEventIdMask::fill() noexcept { words.fill(~uint64_t{0}); }
+
+bool EvtxEventIdMask::intersects(
+    const EvtxEventIdMask& other) const noexcept {
+  for (size_t i = 0; i < words.size(); ++i) {
+    if ((words[i] & other.words[i]) != 0) return true;
+  }
+  return false;
+}
+
+EvtxEventIdMask EvtxEventIdMask::of(const EventIdFilter& event_ids) {
+  EvtxEventIdMask mask;
+  for (const uint32_t id : event_ids.values()) {
+    mask.add(id);
+  }
+  return mask;
+}
+
+void EvtxChunkSummary::addRecord(uint64_t record_id,
+                                 uint64_t written_time) noexcept {
+  if (first_record_id == 0 || record_id < first_record_id) {
+    first_record_id = record_id;
+  }
+  last_record_id = std::max(last_record_id, record_id);
+  if (time_min == 0 || written_time < time_min) {
+    time_min = written_time;
+  }
+  time_max = std::max(time_max, written_time);
+}
+
+bool EvtxChunkSummary::mayMatch(
+    const EventLogQuery& query,
+    const EvtxEventIdMask* id_mask) const noexcept {
+  return last_record_id >= query.record_from &&
+         first_record_id <= query.record_to && time_max >= query.time_from &&
+         time_min <= query.time_to &&
+         (id_mask == nullptr || event_ids.intersects(*id_mask));
+}
+
+EvtxFileIdentity EvtxFileIdentity::of(const std::string& file_path,
+                                      std::span<const uint8_t> file) {
+  EvtxFileIdentity identity;
+  identity.file_size = file.size();
+
+  std::error_code error;
+  const auto modified = std::filesystem::last_write_time(file_path, error);
+  if (!error) {
+    identity.modified_time = modified.time_since_epoch().count();
+  }
+
+  // Заголовок хранит номер следующей записи и последнего блока, поэтому
+  // меняется при любой дозаписи журнала
+  identity.header_crc = Crc32::compute(
+      file.first(std::min(file.size(), EvtxFileHeader::kSize)));
+  return identity;
+}
+
+EvtxLogIndex::EvtxLogIndex(MappedFile file,
+                           std::span<const EvtxChunkSummary> chunks,
+                           const EventLogTail& tail)
+    : file_(std::move(file)), chunks_(chunks), tail_(tail) {}
+
+std::optional<EvtxLogIndex> EvtxLogIndex::open(
+    const std::filesystem::path& index_path,
+    const EvtxFileIdentity& identity) {
+  std::error_code error;
+  if (!std::filesystem::is_regular_file(index_path, error)) {
+    return std::nullopt;
+  }
+
+  try {
+    MappedFile file(index_path.string());
+    const auto bytes = file.bytes();
+    if (bytes.size() < sizeof(Header)) {
+      return std::nullopt;
+    }
+
+    Header header{};
+    std::memcpy(&header, bytes.data(), sizeof(Header));
+    if (header.magic != kMagic || header.version != kVersion ||
+        header.identity != identity ||
+        bytes.size() != sizeof(Header) + static_cast<size_t>(
+                                             header.chunk_count) *
+                                             sizeof(EvtxChunkSummary)) {
+      return std::nullopt;
+    }
+
+    // Сводки следуют за заголовком с выравниванием 8 байт и читаются прямо
+    // из отображения
+    const auto* summaries = reinterpret_cast<const EvtxChunkSummary*>(
+        bytes.data() + sizeof(Header));
+    const std::span<const EvtxChunkSummary> chunks(summaries,
+                                                   header.chunk_count);
+    return EvtxLogIndex(std::move(file), chunks,
+                        EventLogTail{header.tail_record_id,
+                                     header.tail_offset,
+                                     header.tail_checksum});
+  } catch (const std::exception&) {
+    return std::nullopt;
+  }
+}
+
+void EvtxLogIndex::write(const std::filesystem::path& index_path,
+                         const EvtxFileIdentity& identity,
+                         const EventLogTail& tail,
+                         std::span<const EvtxChunkSummary> chunks) {
+  std::error_code error;
+  std::filesystem::create_directories(index_path.parent_path(), error);
+
+  Header header{};
+  header.magic = kMagic;
+  header.version = kVersion;
+  header.chunk_count = static_cast<uint32_t>(chunks.size());
+  header.identity = identity;
+  header.tail_record_id = tail.record_id;
+  header.tail_offset = tail.offset;
+  header.tail_checksum = tail.checksum;
+
+  // Запись через временный файл: параллельный запуск не увидит
+  // недописанный индекс
+  std::filesystem::path temp_path = index_path;
+  temp_path += ".tmp";
+  {
+    std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(chunks.data()),
+              static_cast<std::streamsize>(chunks.size_bytes()));
+    if (!out) {
+      throw std::runtime_error("Не удалось записать индекс журнала: " +
+                               temp_path.string());
+    }
+  }
+
+  std::filesystem::rename(temp_path, index_path, error);
+  if (error) {
+    std::filesystem::remove(temp_path, error);
+    throw std::runtime_error("Не удалось сохранить индекс журнала: " +
+                             index_path.string());
+  }
+}
+
+std::filesystem::path EvtxLogIndex::pathFor(
+    const std::filesystem::path& index_dir, const std::string& log_path) {
+  std::error_code error;
+  auto absolute = std::filesystem::absolute(log_path, error);
+  if (error) absolute = log_path;
+
+  const std::string key = absolute.generic_string();
+  const uint32_t hash = Crc32::compute(std::span<const uint8_t>(
+      reinterpret_cast<const uint8_t*>(key.data()), key.size()));
+  std::ostringstream name;
+  name << absolute.filename().string() << '.' << std::hex << std::setw(8)
+       << std::setfill('0') << hash << ".evtxidx";
+  return index_dir / name.str();
+}
+
+std::span<const EvtxChunkSummary> EvtxLogIndex::chunks() const noexcept {
+  return chunks_;
+}
+
+}
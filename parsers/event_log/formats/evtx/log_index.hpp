@@ -0,0 +1,152 @@
+/// @file log_index.hpp
+/// @brief Сохраняемый индекс блоков журнала EVTX
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <type_traits>
+
+#include "../../model/event_id_filter.hpp"
+#include "../../model/event_log_query.hpp"
+#include "../../model/event_log_tail.hpp"
+#include "../common/mapped_file.hpp"
+
+/// @namespace EventLogAnalysis
+/// @brief Пространство имен для работы с журналами событий Windows
+namespace EventLogAnalysis {
+
+/// @brief Хешированная карта ID событий блока (1024 бита)
+/// @details Бит выбирается по ID по модулю размера карты: совпадение бита
+/// означает, что блок может содержать событие, отсутствие - что не содержит
+struct EvtxEventIdMask {
+  static constexpr size_t kBits = 1024;  ///< Размер карты в битах
+  std::array<uint64_t, kBits / 64> words{};  ///< Слова карты
+
+  /// @brief Отмечает ID события
+  void add(uint32_t event_id) noexcept;
+
+  /// @brief Отмечает все ID (содержимое блока известно не полностью)
+  void fill() noexcept;
+
+  /// @brief Проверяет пересечение с другой картой
+  [[nodiscard]] bool intersects(const EvtxEventIdMask& other) const noexcept;
+
+  /// @brief Строит карту по множеству ID
+  [[nodiscard]] static EvtxEventIdMask of(const EventIdFilter& event_ids);
+};
+
+/// @brief Сводка блока в индексе
+struct EvtxChunkSummary {
+  uint64_t file_offset = 0;      ///< Смещение блока в файле
+  uint64_t first_record_id = 0;  ///< Номер первой записи
+  uint64_t last_record_id = 0;   ///< Номер последней записи
+  uint64_t time_min = 0;         ///< Наименьшее время записи (FILETIME)
+  uint64_t time_max = 0;         ///< Наибольшее время записи (FILETIME)
+  EvtxEventIdMask event_ids;     ///< ID событий блока
+
+  /// @brief Учитывает запись блока
+  /// @param record_id Номер записи
+  /// @param written_time Время записи
+  void addRecord(uint64_t record_id, uint64_t written_time) noexcept;
+
+  /// @brief Проверяет, может ли блок содержать записи выборки
+  /// @param query Выборка записей
+  /// @param id_mask Карта ID выборки или nullptr, если ID не ограничены
+  [[nodiscard]] bool mayMatch(const EventLogQuery& query,
+                              const EvtxEventIdMask* id_mask) const noexcept;
+};
+
+static_assert(std::is_trivially_copyable_v<EvtxChunkSummary>);
+
+/// @brief Идентичность файла журнала, к которой привязан индекс
+struct EvtxFileIdentity {
+  uint64_t file_size = 0;     ///< Размер файла
+  int64_t modified_time = 0;  ///< Время изменения файла
+  uint32_t header_crc = 0;    ///< CRC-32 блока заголовка файла
+
+  /// @brief Определяет идентичность отображенного файла журнала
+  /// @param file_path Путь к файлу
+  /// @param file Содержимое файла
+  [[nodiscard]] static EvtxFileIdentity of(const std::string& file_path,
+                                           std::span<const uint8_t> file);
+
+  /// @brief Сравнивает идентичности
+  bool operator==(const EvtxFileIdentity&) const = default;
+};
+
+/// @class EvtxLogIndex
+/// @brief Индекс блоков журнала EVTX, сохраняемый рядом с результатами
+/// @details Для каждого блока с записями хранятся смещение, диапазон номеров
+/// записей, границы времени и карта ID событий. Индекс строится при первом
+/// полном проходе по журналу и при повторных запусках отображается в память:
+/// выборка по ID, времени или номерам записей читает только блоки, которые
+/// могут ей соответствовать. Индекс привязан к размеру, времени изменения и
+/// заголовку файла, а также к последней записи журнала и контрольной сумме
+/// ее блока; при их расхождении он игнорируется и перестраивается.
+/// Формат использует порядок байтов машины и предназначен для локального
+/// кэша, а не для переноса.
+class EvtxLogIndex {
+ public:
+  /// @brief Открывает индекс, если он соответствует файлу журнала
+  /// @param index_path Путь к файлу индекса
+  /// @param identity Идентичность журнала
+  /// @return Индекс или std::nullopt, если файла нет или он устарел
+  [[nodiscard]] static std::optional<EvtxLogIndex> open(
+      const std::filesystem::path& index_path,
+      const EvtxFileIdentity& identity);
+
+  /// @brief Записывает индекс (через временный файл и переименование)
+  /// @param index_path Путь к файлу индекса
+  /// @param identity Идентичность журнала
+  /// @param tail Последняя запись журнала
+  /// @param chunks Сводки блоков в порядке номеров записей
+  /// @throws std::runtime_error Если файл не удалось записать
+  static void write(const std::filesystem::path& index_path,
+                    const EvtxFileIdentity& identity, const EventLogTail& tail,
+                    std::span<const EvtxChunkSummary> chunks);
+
+  /// @brief Возвращает путь к индексу журнала в каталоге индексов
+  /// @details Имя включает хеш абсолютного пути журнала, поэтому одноименные
+  /// журналы разных источников не пересекаются
+  /// @param index_dir Каталог индексов
+  /// @param log_path Путь к журналу
+  [[nodiscard]] static std::filesystem::path pathFor(
+      const std::filesystem::path& index_dir, const std::string& log_path);
+
+  /// @brief Возвращает сводки блоков
+  [[nodiscard]] std::span<const EvtxChunkSummary> chunks() const noexcept;
+
+  /// @brief Возвращает последнюю запись журнала при построении индекса
+  [[nodiscard]] const EventLogTail& tail() const noexcept { return tail_; }
+
+ private:
+  /// @brief Заголовок файла индекса
+  struct Header {
+    std::array<char, 8> magic;   ///< Сигнатура "EvtxIdx1"
+    uint32_t version;            ///< Версия формата
+    uint32_t chunk_count;        ///< Количество сводок блоков
+    EvtxFileIdentity identity;   ///< Идентичность журнала
+    uint64_t tail_record_id;     ///< Номер последней записи
+    uint64_t tail_offset;        ///< Смещение последней записи в файле
+    uint32_t tail_checksum;      ///< CRC-32 блока до последней записи
+  };
+
+  static constexpr std::array<char, 8> kMagic = {'E', 'v', 't', 'x',
+                                                 'I', 'd', 'x', '1'};
+  static constexpr uint32_t kVersion = 3;  ///< Текущая версия формата
+
+  /// @brief Создает индекс по отображенному файлу
+  EvtxLogIndex(MappedFile file, std::span<const EvtxChunkSummary> chunks,
+               const EventLogTail& tail);
+
+  MappedFile file_;                            ///< Отображение индекса
+  std::span<const EvtxChunkSummary> chunks_;   ///< Сводки блоков
+  EventLogTail tail_;                          ///< Последняя запись журнала
+};
+
+}
@@ -0,0 +1,605 @@
+#include "native_parser.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <filesystem>
+#include <future>
+
+#include "../../../../utils/concurrency/thread_pool.hpp"
+#include "../../../../utils/logging/logger.hpp"
+#include "../common/crc32.hpp"
+#include "binxml.hpp"
+#include "carver.hpp"
+#include "record_assembler.hpp"
+
+namespace EventLogAnalysis {
+
+EvtxNativeParser::EvtxNativeParser(EvtxNativeParserOptions options)
+    : options_(options) {}
+
+std::vector<EventData> EvtxNativeParser::parse(const std::string& file_path) {
+  std::vector<EventData> events;
+  forEachRecord(file_path, [&events](EventData&& event) {
+    events.push_back(std::move(event));
+    return true;
+  });
+  return events;
+}
+
+bool EvtxNativeParser::forEachRecord(const std::string& file_path,
+                                     const EventRecordVisitor& visitor) {
+  return scanRecords(file_path, EventLogQuery{}, visitor);
+}
+
+bool EvtxNativeParser::forEachRecord(const std::string& file_path,
+                                     const EventIdFilter& event_ids,
+                                     const EventRecordVisitor& visitor) {
+  EventLogQuery query;
+  query.event_ids = event_ids;
+  return scanRecords(file_path, query, visitor);
+}
+
+bool EvtxNativeParser::queryRecords(const std::string& file_path,
+                                    const EventLogQuery& query,
+                                    const EventRecordVisitor& visitor) {
+  return scanRecords(file_path, query, visitor);
+}
+
+std::optional<EventLogTail> EvtxNativeParser::locateRecord(
+    const std::string& file_path, uint64_t record_id) {
+  const MappedFile file(file_path);
+  const auto chunks = locateChunks(file.bytes(), file_path);
+  if (chunks.empty()) {
+    return std::nullopt;
+  }
+
+  // Последняя запись ищется в блоке с наибольшими номерами: заголовок
+  // "грязного" блока может не учитывать последние записи
+  const EvtxChunk* chunk = &chunks.back();
+  if (record_id != EventLogTail::kLastRecord) {
+    const auto found = std::ranges::find_if(
+        chunks, [record_id](const EvtxChunk& candidate) {
+          return candidate.firstRecordId() <= record_id &&
+                 record_id <= candidate.lastRecordId();
+        });
+    if (found == chunks.end()) {
+      return std::nullopt;
+    }
+    chunk = &*found;
+  }
+  return recordTail(*chunk, record_id);
+}
+
+std::optional<EventLogTail> EvtxNativeParser::recordTail(
+    const EvtxChunk& chunk, uint64_t record_id) {
+  std::optional<EvtxRecordLocation> target;
+  chunk.forEachRecord([&](const EvtxRecordLocation& location) {
+    if (record_id == EventLogTail::kLastRecord ||
+        location.record_id == record_id) {
+      target = location;
+    }
+    return location.record_id != record_id;
+  });
+  if (!target) {
+    return std::nullopt;
+  }
+
+  // Область записей до конца найденной записи не меняется при дозаписи
+  const auto records = chunk.bytes().subspan(
+      EvtxChunk::kHeaderSize,
+      target->offset + target->size - EvtxChunk::kHeaderSize);
+  return EventLogTail{target->record_id,
+                      chunk.fileOffset() + target->offset,
+                      Crc32::compute(records)};
+}
+
+std::optional<EventLogSummary> EvtxNativeParser::readSummary(
+    const std::string& file_path) {
+  const auto header = EvtxFileHeader::read(file_path);
+  if (!header) {
+    return std::nullopt;
+  }
+  return header->summary();
+}
+
+std::unique_ptr<IEventRecordReader> EvtxNativeParser::openReader(
+    const std::string& file_path) {
+  return std::make_unique<EvtxNativeRecordReader>(file_path, options_);
+}
+
+std::vector<EventData> EvtxNativeParser::filterByEventId(
+    const std::string& file_path, uint32_t event_id) {
+  return filterByEventIds(file_path, EventIdFilter{event_id});
+}
+
+std::vector<EventData> EvtxNativeParser::filterByEventIds(
+    const std::string& file_path, const EventIdFilter& event_ids) {
+  std::vector<EventData> events;
+  forEachRecord(file_path, event_ids, [&events](EventData&& event) {
+    events.push_back(std::move(event));
+    return true;
+  });
+  return events;
+}
+
+bool EvtxNativeParser::supports(const std::string& file_path) const {
+  if (file_path.length() < 5) return false;
+
+  const std::string ext = file_path.substr(file_path.length() - 5);
+  return ext == ".evtx" || ext == ".evt-x";
+}
+
+std::string EvtxNativeParser::formatName() const {
+  return "Журнал событий Windows (EVTX, собственный парсер)";
+}
+
+std::vector<std::string> EvtxNativeParser::supportedExtensions() const {
+  return {".evtx", ".evt-x"};
+}
+
+std::vector<EvtxChunk> EvtxNativeParser::locateChunks(
+    std::span<const uint8_t> file, const std::string& file_path) {
+  const auto logger = GlobalLogger::get();
+
+  const auto header = EvtxFileHeader::parse(file);
+  if (!header) {
+    throw std::runtime_error("Файл не является журналом EVTX: " + file_path);
+  }
+  if (!header->checksum_valid) {
+    logger->debug("Несовпадение CRC-32 заголовка EVTX: \"{}\"", file_path);
+  }
+  if (header->isDirty()) {
+    logger->debug("Журнал EVTX не был корректно закрыт: \"{}\"", file_path);
+  }
+
+  // Количество блоков берется из размера файла: в "грязных" файлах счетчик
+  // в заголовке может отставать от фактически записанных блоков
+  const size_t first_chunk = header->header_block_size != 0
+                                 ? header->header_block_size
+                                 : EvtxFileHeader::kSize;
+  std::vector<EvtxChunk> chunks;
+  size_t damaged = 0;
+
+  for (size_t offset = first_chunk; offset + EvtxChunk::kSize <= file.size();
+       offset += EvtxChunk::kSize) {
+    const auto chunk =
+        EvtxChunk::parse(file.subspan(offset, EvtxChunk::kSize), offset);
+    if (!chunk) {
+      // Неиспользованные блоки заполнены нулями и повреждением не считаются
+      if (file[offset] != 0) damaged++;
+      continue;
+    }
+    if (!chunk->empty()) {
+      chunks.push_back(*chunk);
+    }
+  }
+
+  // После циклической перезаписи физический порядок блоков не совпадает с
+  // порядком записей
+  std::stable_sort(chunks.begin(), chunks.end(),
+                   [](const EvtxChunk& a, const EvtxChunk& b) {
+                     return a.firstRecordId() < b.firstRecordId();
+                   });
+
+  logger->debug("Журнал \"{}\": {} блоков с записями, {} поврежденных блоков",
+                file_path, chunks.size(), damaged);
+  return chunks;
+}
+
+std::span<const EvtxChunk> EvtxNativeParser::selectChunks(
+    std::span<const EvtxChunk> chunks, const EventLogQuery& query) {
+  if (query.hasRecordRange()) {
+    const auto begin = std::partition_point(
+        chunks.begin(), chunks.end(), [&query](const EvtxChunk& chunk) {
+          return chunk.lastRecordId() < query.record_from;
+        });
+    const auto end = std::partition_point(
+        begin, chunks.end(), [&query](const EvtxChunk& chunk) {
+          return chunk.firstRecordId() <= query.record_to;
+        });
+    chunks = std::span<const EvtxChunk>(begin, end);
+  }
+
+  const auto by_time = [](const EvtxChunk& a, const EvtxChunk& b) {
+    return a.firstRecordTime() < b.firstRecordTime();
+  };
+  if (query.hasTimeWindow() &&
+      std::is_sorted(chunks.begin(), chunks.end(), by_time)) {
+    auto begin = std::partition_point(
+        chunks.begin(), chunks.end(), [&query](const EvtxChunk& chunk) {
+          return chunk.firstRecordTime() < query.time_from;
+        });
+    // Блок, начатый до окна, может продолжаться внутри него
+    if (begin != chunks.begin()) --begin;
+    const auto end = std::partition_point(
+        begin, chunks.end(), [&query](const EvtxChunk& chunk) {
+          return chunk.firstRecordTime() <= query.time_to;
+        });
+    chunks = std::span<const EvtxChunk>(begin, end);
+  }
+
+  return chunks;
+}
+
+bool EvtxNativeParser::matchesTail(std::span<const uint8_t> file,
+                                   const EvtxLogIndex& index) {
+  const auto summaries = index.chunks();
+  if (summaries.empty() ||
+      summaries.back().file_offset + EvtxChunk::kSize > file.size()) {
+    return false;
+  }
+  const uint64_t offset = summaries.back().file_offset;
+  const auto chunk =
+      EvtxChunk::parse(file.subspan(offset, EvtxChunk::kSize), offset);
+  return chunk && recordTail(*chunk, EventLogTail::kLastRecord) == index.tail();
+}
+
+std::vector<EvtxChunk> EvtxNativeParser::selectIndexedChunks(
+    std::span<const uint8_t> file, const EvtxLogIndex& index,
+    const EventLogQuery& query) {
+  std::optional<EvtxEventIdMask> id_mask;
+  if (query.event_ids) {
+    id_mask = EvtxEventIdMask::of(*query.event_ids);
+  }
+
+  std::vector<EvtxChunk> chunks;
+  for (const auto& summary : index.chunks()) {
+    if (!summary.mayMatch(query, id_mask ? &*id_mask : nullptr) ||
+        summary.file_offset + EvtxChunk::kSize > file.size()) {
+      continue;
+    }
+    const auto chunk = EvtxChunk::parse(
+        file.subspan(summary.file_offset, EvtxChunk::kSize),
+        summary.file_offset);
+    if (chunk) {
+      chunks.push_back(*chunk);
+    }
+  }
+  return chunks;
+}
+
+bool EvtxNativeParser::decodeRecord(BinXmlDecoder& decoder,
+                                    EvtxRecordAssembler& assembler,
+                                    const EvtxRecordLocation& location,
+                                    const EventIdFilter* event_ids,
+                                    const XmlRetention& xml) {
+  const uint32_t offset =
+      location.offset + static_cast<uint32_t>(EvtxChunk::kRecordHeaderSize);
+  const uint32_t size =
+      location.size - static_cast<uint32_t>(EvtxChunk::kRecordHeaderSize) - 4;
+  try {
+    assembler.reset(location, event_ids, xml.mode == XmlRetentionMode::Always);
+    decoder.decode(offset, size, assembler);
+
+    // ID события известен только после разбора записи: запись с
+    // отобранным ID декодируется повторно с рендерингом XML
+    if (xml.mode == XmlRetentionMode::MatchingIds && !assembler.rejected() &&
+        xml.keeps(assembler.eventId())) {
+      assembler.reset(location, event_ids, true);
+      decoder.decode(offset, size, assembler);
+    }
+  } catch (const std::exception&) {
+    return false;
+  }
+  return true;
+}
+
+std::vector<EventData> EvtxNativeParser::decodeChunk(
+    const EvtxChunk& chunk, const EventLogQuery& query,
+    const XmlRetention& xml, TemplateCache& templates,
+    EvtxChunkSummary* summary) {
+  std::vector<EventData> events;
+  BinXmlDecoder decoder(chunk.bytes(), &templates);
+  // Значения всех записей блока размещаются в одной арене, повторы коротких
+  // значений внутри блока хранятся один раз
+  auto arena = std::make_shared<EventArena>(true);
+  EvtxRecordAssembler assembler(arena);
+  const EventIdFilter* event_ids = query.eventIds();
+  size_t damaged = 0;
+
+  chunk.forEachRecord([&](const EvtxRecordLocation& location) {
+    // Записи блока идут по возрастанию номеров
+    if (location.record_id > query.record_to) {
+      return false;
+    }
+    if (!query.matches(location.record_id, location.written_time)) {
+      return true;
+    }
+    if (summary) {
+      summary->addRecord(location.record_id, location.written_time);
+    }
+
+    if (!decodeRecord(decoder, assembler, location, event_ids, xml)) {
+      // Поврежденная запись пропускается, обход блока продолжается; ее ID
+      // неизвестен, поэтому блок в индексе подходит под любой фильтр
+      if (summary) summary->event_ids.fill();
+      damaged++;
+      return true;
+    }
+
+    if (summary) {
+      summary->event_ids.add(assembler.eventId());
+    }
+    if (!assembler.rejected()) {
+      EventData event = assembler.build();
+      if (query.accepts(event)) {
+        events.push_back(std::move(event));
+      }
+    }
+    return true;
+  });
+
+  if (damaged > 0) {
+    GlobalLogger::get()->debug(
+        "Пропущено {} поврежденных записей в блоке по смещению {}", damaged,
+        chunk.fileOffset());
+  }
+  arena->releaseSharing();
+  return events;
+}
+
+bool EvtxNativeParser::decodeChunks(std::span<const EvtxChunk> chunks,
+                                    const EventLogQuery& query,
+                                    std::span<EvtxChunkSummary> summaries,
+                                    const EventRecordVisitor& visitor,
+                                    const std::string& file_path) {
+  if (chunks.empty()) {
+    return true;
+  }
+
+  // Флаг отмены объявлен до пула: задачи, оставшиеся в очереди при досрочной
+  // остановке, завершаются в деструкторе пула и обращаются к нему
+  std::atomic<bool> cancelled = false;
+  TemplateCache templates;
+  ThreadPool pool(
+      ThreadPool::resolveThreadCount(options_.worker_threads, chunks.size()));
+
+  // Окно задач ограничивает число декодированных, но не отданных блоков
+  const size_t window = pool.size() * 2;
+  const XmlRetention& xml = options_.xml;
+  std::deque<std::future<std::vector<EventData>>> pending;
+  size_t next_chunk = 0;
+
+  const auto submit_next = [&]() {
+    EvtxChunkSummary* summary =
+        summaries.empty() ? nullptr : &summaries[next_chunk];
+    const EvtxChunk& chunk = chunks[next_chunk++];
+    pending.push_back(pool.submit(
+        [&chunk, &query, &xml, &cancelled, &templates, summary]() {
+          if (cancelled.load(std::memory_order_relaxed)) {
+            return std::vector<EventData>{};
+          }
+          if (summary) {
+            summary->file_offset = chunk.fileOffset();
+          }
+          return decodeChunk(chunk, query, xml, templates, summary);
+        }));
+  };
+
+  try {
+    while (next_chunk < chunks.size() && pending.size() < window) {
+      submit_next();
+    }
+
+    while (!pending.empty()) {
+      std::vector<EventData> events = pending.front().get();
+      pending.pop_front();
+      if (next_chunk < chunks.size()) {
+        submit_next();
+      }
+
+      for (auto& event : events) {
+        if (!visitor(std::move(event))) {
+          cancelled = true;
+          return false;
+        }
+      }
+    }
+  } catch (...) {
+    cancelled = true;
+    throw;
+  }
+
+  const auto statistics = templates.statistics();
+  GlobalLogger::get()->debug(
+      "Шаблоны BinXml \"{}\": {} записей по плану, {} компиляций, {} общих "
+      "между блоками, {} полных обходов",
+      file_path, statistics.plan_hits, statistics.compiled, statistics.shared,
+      statistics.fallbacks);
+  return true;
+}
+
+bool EvtxNativeParser::scanRecords(const std::string& file_path,
+                                   const EventLogQuery& query,
+                                   const EventRecordVisitor& visitor) {
+  if (options_.recover) {
+    return carveRecords(file_path, query, visitor);
+  }
+
+  const MappedFile file(file_path);
+
+  // Индекс журнала: при наличии отбирает блоки, при отсутствии строится
+  // во время полного прохода
+  std::filesystem::path index_path;
+  EvtxFileIdentity identity;
+  std::optional<EvtxLogIndex> index;
+  if (!options_.index_dir.empty()) {
+    index_path = EvtxLogIndex::pathFor(options_.index_dir, file_path);
+    identity = EvtxFileIdentity::of(file_path, file.bytes());
+    index = EvtxLogIndex::open(index_path, identity);
+
+    // Размер, время изменения и заголовок совпадают и у копии журнала
+    // другого снимка, поэтому индекс подтверждается последней записью
+    if (index && !matchesTail(file.bytes(), *index)) {
+      GlobalLogger::get()->debug(
+          "Последняя запись журнала \"{}\" не совпала с индексом", file_path);
+      index.reset();
+    }
+  }
+
+  std::vector<EvtxChunk> located;
+  std::span<const EvtxChunk> chunks;
+  if (index) {
+    located = selectIndexedChunks(file.bytes(), *index, query);
+    chunks = located;
+    GlobalLogger::get()->debug(
+        "Выборка из журнала \"{}\" по индексу: {} из {} блоков", file_path,
+        chunks.size(), index->chunks().size());
+  } else {
+    located = locateChunks(file.bytes(), file_path);
+    chunks = selectChunks(located, query);
+    if (query.hasTimeWindow() || query.hasRecordRange()) {
+      GlobalLogger::get()->debug("Выборка из журнала \"{}\": {} из {} блоков",
+                                 file_path, chunks.size(), located.size());
+    }
+  }
+
+  // Индекс строится только по проходу через все блоки
+  std::vector<EvtxChunkSummary> summaries;
+  if (!options_.index_dir.empty() && !index && !query.hasTimeWindow() &&
+      !query.hasRecordRange()) {
+    summaries.resize(chunks.size());
+  }
+
+  if (!decodeChunks(chunks, query, summaries, visitor, file_path)) {
+    return false;
+  }
+
+  const auto tail =
+      summaries.empty()
+          ? std::nullopt
+          : recordTail(located.back(), EventLogTail::kLastRecord);
+  if (tail) {
+    try {
+      EvtxLogIndex::write(index_path, identity, *tail, summaries);
+      GlobalLogger::get()->debug("Сохранен индекс журнала \"{}\": \"{}\"",
+                                 file_path, index_path.string());
+    } catch (const std::exception& e) {
+      GlobalLogger::get()->warn("Индекс журнала не сохранен: {}", e.what());
+    }
+  }
+  return true;
+}
+
+bool EvtxNativeParser::carveRecords(const std::string& file_path,
+                                    const EventLogQuery& query,
+                                    const EventRecordVisitor& visitor) {
+  const MappedFile file(file_path);
+  const EvtxCarveResult carved = EvtxCarver(file.bytes()).scan();
+  GlobalLogger::get()->debug(
+      "Восстановление журнала \"{}\": {} целых блоков, {} поврежденных "
+      "блоков, {} записей вне блоков, {} записей без начала блока",
+      file_path, carved.chunks.size(), carved.damaged_chunks,
+      carved.records.size(), carved.unresolved_records);
+
+  // Найденные блоки могут принадлежать разным журналам образа, поэтому
+  // номера записей не образуют общей последовательности и блоки не
+  // отбираются по заголовкам: выборка проверяется по записям
+  if (!decodeChunks(carved.chunks, query, {}, visitor, file_path)) {
+    return false;
+  }
+
+  // Записи идут в порядке смещений, записи одного блока - подряд
+  std::span<const EvtxCarvedRecord> records = carved.records;
+  while (!records.empty()) {
+    const auto group = nextCarvedGroup(records);
+    records = records.subspan(group.size());
+    for (auto& event :
+         decodeCarvedRecords(file.bytes(), group, query, options_.xml)) {
+      if (!visitor(std::move(event))) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+std::span<const EvtxCarvedRecord> EvtxNativeParser::nextCarvedGroup(
+    std::span<const EvtxCarvedRecord> records) noexcept {
+  size_t end = 0;
+  while (end < records.size() &&
+         records[end].chunk_offset == records.front().chunk_offset) {
+    end++;
+  }
+  return records.first(end);
+}
+
+std::vector<EventData> EvtxNativeParser::decodeCarvedRecords(
+    std::span<const uint8_t> file, std::span<const EvtxCarvedRecord> records,
+    const EventLogQuery& query, const XmlRetention& xml) {
+  std::vector<EventData> events;
+  if (records.empty()) {
+    return events;
+  }
+
+  const uint64_t chunk_offset = records.front().chunk_offset;
+  const size_t chunk_size = static_cast<size_t>(
+      std::min<uint64_t>(EvtxChunk::kSize, file.size() - chunk_offset));
+  BinXmlDecoder decoder(file.subspan(chunk_offset, chunk_size));
+  auto arena = std::make_shared<EventArena>(true);
+  EvtxRecordAssembler assembler(arena);
+  const EventIdFilter* event_ids = query.eventIds();
+  size_t damaged = 0;
+
+  for (const auto& record : records) {
+    if (!query.matches(record.location.record_id,
+                       record.location.written_time)) {
+      continue;
+    }
+    // Таблицы строк и шаблонов блока могли быть перезаписаны
+    if (!decodeRecord(decoder, assembler, record.location, event_ids, xml)) {
+      damaged++;
+      continue;
+    }
+    if (!assembler.rejected()) {
+      EventData event = assembler.build();
+      if (query.accepts(event)) {
+        events.push_back(std::move(event));
+      }
+    }
+  }
+
+  if (damaged > 0) {
+    GlobalLogger::get()->debug(
+        "Не удалось декодировать {} записей вне блоков, начало блока по "
+        "смещению {}",
+        damaged, chunk_offset);
+  }
+  arena->releaseSharing();
+  return events;
+}
+
+EvtxNativeRecordReader::EvtxNativeRecordReader(const std::string& file_path,
+                                               EvtxNativeParserOptions options)
+    : file_(file_path), options_(options) {
+  if (options_.recover) {
+    EvtxCarveResult carved = EvtxCarver(file_.bytes()).scan();
+    chunks_ = std::move(carved.chunks);
+    carved_ = std::move(carved.records);
+  } else {
+    chunks_ = EvtxNativeParser::locateChunks(file_.bytes(), file_path);
+  }
+}
+
+std::optional<EventData> EvtxNativeRecordReader::next() {
+  while (pending_index_ == pending_.size()) {
+    if (next_chunk_ < chunks_.size()) {
+      pending_ = EvtxNativeParser::decodeChunk(
+          chunks_[next_chunk_++], EventLogQuery{}, options_.xml, templates_);
+    } else if (next_carved_ < carved_.size()) {
+      const auto group = EvtxNativeParser::nextCarvedGroup(
+          std::span<const EvtxCarvedRecord>(carved_).subspan(next_carved_));
+      next_carved_ += group.size();
+      pending_ = EvtxNativeParser::decodeCarvedRecords(
+          file_.bytes(), group, EventLogQuery{}, options_.xml);
+    } else {
+      return std::nullopt;
+    }
+    pending_index_ = 0;
+  }
+
+  return std::move(pending_[pending_index_++]);
+}
+
+}
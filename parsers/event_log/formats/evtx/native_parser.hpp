@@ -0,0 +1,291 @@
+/// @file native_parser.hpp
+/// @brief Собственный многопоточный парсер EVTX без libevtx
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../../interfaces/iparser.hpp"
+#include "../../model/event_data.hpp"
+#include "../../model/xml_retention.hpp"
+#include "../common/mapped_file.hpp"
+#include "carver.hpp"
+#include "chunk.hpp"
+#include "log_index.hpp"
+#include "template_plan.hpp"
+
+/// @namespace EventLogAnalysis
+/// @brief Пространство имен для работы с журналами событий Windows
+namespace EventLogAnalysis {
+
+class BinXmlDecoder;
+class EvtxRecordAssembler;
+
+/// @brief Параметры собственного парсера EVTX
+struct EvtxNativeParserOptions {
+  XmlRetention xml;           ///< Сохранение XML-представления записей
+  size_t worker_threads = 0;  ///< Потоки разбора блоков (0 - по числу ядер)
+  std::string index_dir;      ///< Каталог индексов журналов (пусто - нет)
+  bool recover = false;       ///< Восстановление записей поиском сигнатур
+};
+
+/// @class EvtxNativeParser
+/// @brief Парсер EVTX, разбирающий блоки файла параллельно
+/// @details Файл отображается в память, заголовки файла и блоков
+/// проверяются по сигнатурам и CRC-32. Блоки упорядочиваются по номеру первой
+/// записи и декодируются задачами пула потоков; результаты передаются
+/// обработчику в порядке номеров записей. Одновременно в памяти находятся
+/// записи не более чем удвоенного числа потоков блоков. В режиме
+/// восстановления файл рассматривается как произвольные байты (поврежденный
+/// журнал, slack, неразмеченное пространство): блоки и записи находятся по
+/// сигнатурам, см. EvtxCarver.
+class EvtxNativeParser final : public IEventLogParser {
+ public:
+  /// @brief Конструктор
+  /// @param options Параметры разбора
+  explicit EvtxNativeParser(EvtxNativeParserOptions options = {});
+
+  /// @brief Парсит все события из EVTX файла
+  /// @param file_path Путь к EVTX файлу
+  /// @return Вектор разобранных событий
+  std::vector<EventData> parse(const std::string& file_path) override;
+
+  /// @brief Потоково обходит записи EVTX файла
+  /// @param file_path Путь к EVTX файлу
+  /// @param visitor Обработчик записей (false прекращает обход)
+  /// @return true если файл обойден полностью
+  bool forEachRecord(const std::string& file_path,
+                     const EventRecordVisitor& visitor) override;
+
+  /// @brief Открывает курсор для построчного чтения EVTX файла
+  /// @details Курсор декодирует блоки последовательно в вызывающем потоке
+  /// @param file_path Путь к EVTX файлу
+  /// @return Курсор записей
+  /// @throws std::runtime_error Если файл не является журналом EVTX
+  std::unique_ptr<IEventRecordReader> openReader(
+      const std::string& file_path) override;
+
+  /// @brief Фильтрует события по идентификатору из EVTX файла
+  /// @param file_path Путь к EVTX файлу
+  /// @param event_id Идентификатор события для фильтрации
+  /// @return Вектор событий с указанным идентификатором
+  std::vector<EventData> filterByEventId(const std::string& file_path,
+                                         uint32_t event_id) override;
+
+  /// @brief Фильтрует события по множеству идентификаторов из EVTX файла
+  /// @param file_path Путь к EVTX файлу
+  /// @param event_ids Множество идентификаторов событий
+  /// @return Вектор событий с подходящими идентификаторами
+  std::vector<EventData> filterByEventIds(
+      const std::string& file_path, const EventIdFilter& event_ids) override;
+
+  /// @brief Потоково обходит записи EVTX файла с заданными идентификаторами
+  /// @param file_path Путь к EVTX файлу
+  /// @param event_ids Множество идентификаторов событий
+  /// @param visitor Обработчик записей (false прекращает обход)
+  /// @return true если файл обойден полностью
+  bool forEachRecord(const std::string& file_path,
+                     const EventIdFilter& event_ids,
+                     const EventRecordVisitor& visitor) override;
+
+  /// @brief Потоково обходит записи EVTX файла, попадающие в выборку
+  /// @details Блоки вне диапазона номеров отбрасываются по заголовкам, блоки
+  /// вне окна времени - двоичным поиском по времени первой записи блока.
+  /// При наличии индекса журнала блоки отбираются по его сводкам, включая
+  /// карты ID событий
+  /// @param file_path Путь к EVTX файлу
+  /// @param query Окно времени, диапазон номеров и идентификаторы событий
+  /// @param visitor Обработчик записей (false прекращает обход)
+  /// @return true если выборка обойдена полностью
+  bool queryRecords(const std::string& file_path, const EventLogQuery& query,
+                    const EventRecordVisitor& visitor) override;
+
+  /// @brief Находит запись журнала и контрольную сумму ее блока
+  /// @details Сумма вычисляется по области записей блока от ее начала до
+  /// конца найденной записи
+  /// @param file_path Путь к EVTX файлу
+  /// @param record_id Номер записи или EventLogTail::kLastRecord
+  /// @return Положение записи или std::nullopt, если запись не найдена
+  std::optional<EventLogTail> locateRecord(const std::string& file_path,
+                                           uint64_t record_id) override;
+
+  /// @brief Читает сведения о журнале только из заголовка файла
+  /// @param file_path Путь к EVTX файлу
+  /// @return Сведения или std::nullopt, если заголовок не разобран
+  std::optional<EventLogSummary> readSummary(
+      const std::string& file_path) override;
+
+  /// @brief Проверяет поддержку формата файла
+  /// @param file_path Путь к файлу для проверки
+  /// @return true если файл имеет расширение .evtx
+  [[nodiscard]] bool supports(const std::string& file_path) const override;
+
+  /// @brief Возвращает название формата
+  /// @return Строка с названием формата
+  [[nodiscard]] std::string formatName() const override;
+
+  /// @brief Возвращает поддерживаемые расширения файлов
+  /// @return Вектор расширений {".evtx", ".evt-x"}
+  [[nodiscard]] std::vector<std::string> supportedExtensions() const override;
+
+ private:
+  friend class EvtxNativeRecordReader;  ///< Курсор использует разбор блоков
+
+  /// @brief Проверяет заголовок файла и собирает непустые блоки
+  /// @param file Содержимое файла
+  /// @param file_path Путь к файлу (для сообщений)
+  /// @return Блоки, упорядоченные по номеру первой записи
+  /// @throws std::runtime_error Если сигнатура файла не совпала
+  [[nodiscard]] static std::vector<EvtxChunk> locateChunks(
+      std::span<const uint8_t> file, const std::string& file_path);
+
+  /// @brief Находит запись блока и контрольную сумму блока до ее конца
+  /// @param chunk Блок
+  /// @param record_id Номер записи или EventLogTail::kLastRecord
+  /// @return Положение записи или std::nullopt, если запись не найдена
+  [[nodiscard]] static std::optional<EventLogTail> recordTail(
+      const EvtxChunk& chunk, uint64_t record_id);
+
+  /// @brief Проверяет, что последняя запись журнала совпадает с индексом
+  /// @details Читается только последний блок из сводок индекса
+  /// @param file Содержимое файла
+  /// @param index Индекс журнала
+  [[nodiscard]] static bool matchesTail(std::span<const uint8_t> file,
+                                        const EvtxLogIndex& index);
+
+  /// @brief Отбирает блоки, которые могут содержать записи выборки
+  /// @details Номера записей блоков возрастают, поэтому границы диапазона
+  /// номеров находятся двоичным поиском. Для окна времени используется время
+  /// первой записи блока: блок заканчивается не позже начала следующего.
+  /// Если время начала блоков не возрастает (перевод часов), отбор по времени
+  /// не выполняется и окно проверяется только по записям
+  /// @param chunks Блоки в порядке номеров записей
+  /// @param query Выборка записей
+  /// @return Непрерывный поддиапазон блоков
+  [[nodiscard]] static std::span<const EvtxChunk> selectChunks(
+      std::span<const EvtxChunk> chunks, const EventLogQuery& query);
+
+  /// @brief Отбирает блоки выборки по сводкам индекса
+  /// @details Заголовки остальных блоков не читаются
+  /// @param file Содержимое файла
+  /// @param index Индекс журнала
+  /// @param query Выборка записей
+  /// @return Блоки, которые могут содержать записи выборки
+  [[nodiscard]] static std::vector<EvtxChunk> selectIndexedChunks(
+      std::span<const uint8_t> file, const EvtxLogIndex& index,
+      const EventLogQuery& query);
+
+  /// @brief Декодирует одну запись
+  /// @details Запись с ID из XmlRetention::event_ids в режиме MatchingIds
+  /// декодируется повторно с рендерингом XML
+  /// @param decoder Декодер блока записи
+  /// @param assembler Сборщик события
+  /// @param location Положение записи в блоке
+  /// @param event_ids Фильтр ID событий или nullptr
+  /// @param xml Сохранение XML-представления записей
+  /// @return false если запись повреждена
+  static bool decodeRecord(BinXmlDecoder& decoder,
+                           EvtxRecordAssembler& assembler,
+                           const EvtxRecordLocation& location,
+                           const EventIdFilter* event_ids,
+                           const XmlRetention& xml);
+
+  /// @brief Декодирует записи одного блока
+  /// @param chunk Блок
+  /// @param query Выборка записей
+  /// @param xml Сохранение XML-представления записей
+  /// @param templates Общий кеш планов шаблонов файла
+  /// @param summary Сводка блока для индекса (nullptr - не собирать)
+  /// @return События блока в порядке записей
+  [[nodiscard]] static std::vector<EventData> decodeChunk(
+      const EvtxChunk& chunk, const EventLogQuery& query,
+      const XmlRetention& xml, TemplateCache& templates,
+      EvtxChunkSummary* summary = nullptr);
+
+  /// @brief Декодирует блоки в пуле потоков и передает записи обработчику
+  /// @param chunks Блоки в порядке выдачи
+  /// @param query Выборка записей
+  /// @param summaries Сводки блоков для индекса (пусто - не собирать)
+  /// @param visitor Обработчик записей (false прекращает обход)
+  /// @param file_path Путь к файлу (для сообщений)
+  /// @return true если блоки обойдены полностью
+  bool decodeChunks(std::span<const EvtxChunk> chunks,
+                    const EventLogQuery& query,
+                    std::span<EvtxChunkSummary> summaries,
+                    const EventRecordVisitor& visitor,
+                    const std::string& file_path);
+
+  /// @brief Восстанавливает записи файла поиском сигнатур
+  /// @details Сначала выдаются записи целых блоков в порядке номеров, затем
+  /// записи вне блоков в порядке смещений. Повторы не устраняются
+  /// @param file_path Путь к файлу или образу
+  /// @param query Выборка записей
+  /// @param visitor Обработчик записей (false прекращает обход)
+  /// @return true если выборка обойдена полностью
+  bool carveRecords(const std::string& file_path, const EventLogQuery& query,
+                    const EventRecordVisitor& visitor);
+
+  /// @brief Выделяет начальную группу записей с общим началом блока
+  /// @param records Записи в порядке смещений
+  /// @return Непустой префикс records (пустой, если records пуст)
+  [[nodiscard]] static std::span<const EvtxCarvedRecord> nextCarvedGroup(
+      std::span<const EvtxCarvedRecord> records) noexcept;
+
+  /// @brief Декодирует записи, найденные вне целых блоков
+  /// @param file Байты файла
+  /// @param records Записи одного начала блока в порядке смещений
+  /// @param query Выборка записей
+  /// @param xml Сохранение XML-представления записей
+  /// @return События в порядке смещений
+  [[nodiscard]] static std::vector<EventData> decodeCarvedRecords(
+      std::span<const uint8_t> file, std::span<const EvtxCarvedRecord> records,
+      const EventLogQuery& query, const XmlRetention& xml);
+
+  /// @brief Обходит блоки файла в пуле потоков
+  /// @details В режиме восстановления делегирует carveRecords, индекс
+  /// журнала не используется
+  /// @param file_path Путь к EVTX файлу
+  /// @param query Выборка записей
+  /// @param visitor Обработчик записей (false прекращает обход)
+  /// @return true если выборка обойдена полностью
+  bool scanRecords(const std::string& file_path, const EventLogQuery& query,
+                   const EventRecordVisitor& visitor);
+
+  EvtxNativeParserOptions options_;  ///< Параметры разбора
+};
+
+/// @class EvtxNativeRecordReader
+/// @brief Курсор для построчного чтения записей EVTX без libevtx
+/// @details В режиме восстановления после найденных блоков выдает записи
+/// вне блоков
+class EvtxNativeRecordReader final : public IEventRecordReader {
+ public:
+  /// @brief Открывает EVTX файл для чтения
+  /// @param file_path Путь к EVTX файлу
+  /// @param options Параметры разбора
+  /// @throws std::runtime_error Если файл не является журналом EVTX (вне
+  /// режима восстановления)
+  EvtxNativeRecordReader(const std::string& file_path,
+                         EvtxNativeParserOptions options);
+
+  /// @brief Читает следующую запись
+  /// @return Разобранная запись или std::nullopt по достижении конца файла
+  std::optional<EventData> next() override;
+
+ private:
+  MappedFile file_;                ///< Отображение файла
+  std::vector<EvtxChunk> chunks_;  ///< Блоки в порядке номеров записей
+  EvtxNativeParserOptions options_;  ///< Параметры разбора
+  TemplateCache templates_;          ///< Планы шаблонов файла
+  std::vector<EvtxCarvedRecord> carved_;  ///< Записи вне блоков
+  size_t next_chunk_ = 0;            ///< Индекс следующего блока
+  size_t next_carved_ = 0;           ///< Индекс следующей записи вне блоков
+  std::vector<EventData> pending_;   ///< Записи текущего блока
+  size_t pending_index_ = 0;         ///< Индекс следующей записи блока
+};
+
+}
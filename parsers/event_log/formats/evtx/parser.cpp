@@ -5,10 +5,47 @@
 #include "../../model/event_data_builder.hpp"
 #include "../common/time_converter.hpp"
 #include "../common/xml_parser.hpp"
+#include "chunk.hpp"
+#include "event_schema.hpp"
 
 namespace EventLogAnalysis {
 
-EvtxParser::EvtxParser() {
+namespace {
+
+/// @brief Читает UTF-8 строку записи через пару аксессоров libevtx
+/// @param record Запись libevtx
+/// @param get_size Функция получения размера строки
+/// @param get_value Функция получения строки
+/// @param out Строка-приемник
+/// @return true если строка прочитана и не пуста
+template <typename SizeFn, typename ValueFn>
+bool readString(libevtx_record_t* record, SizeFn get_size, ValueFn get_value,
+                std::string& out) {
+  libevtx_error_t* error = nullptr;
+  size_t size = 0;
+
+  if (get_size(record, &size, &error) != 1 || size <= 1) {
+    if (error) libevtx_error_free(&error);
+    return false;
+  }
+
+  out.resize(size);
+  if (get_value(record, reinterpret_cast<uint8_t*>(out.data()), size,
+                &error) != 1) {
+    if (error) libevtx_error_free(&error);
+    out.clear();
+    return false;
+  }
+
+  // Размер включает завершающий нулевой символ
+  out.resize(std::char_traits<char>::length(out.data()));
+  return true;
+}
+
+}
+
+EvtxParser::EvtxParser(EvtxParserOptions options)
+    : options_(options) {
   libevtx_error_t* error = nullptr;
   if (libevtx_file_initialize(&evtx_file_, &error) != 1) {
     handleLibEvtxError("Не удалось инициализировать libevtx", error);
@@ -24,48 +61,50 @@ EvtxParser::~EvtxParser() {
 }
 
 std::vector<EventData> EvtxParser::parse(const std::string& file_path) {
-  openFile(file_path);
+  std::vector<EventData> events;
+  forEachRecord(file_path, [&events](EventData&& event) {
+    events.push_back(std::move(event));
+    return true;
+  });
+  return events;
+}
 
-  try {
-    libevtx_error_t* error = nullptr;
-    int record_count = 0;
+bool EvtxParser::forEachRecord(const std::string& file_path,
+                               const EventRecordVisitor& visitor) {
+  return scanRecords(file_path, EventLogQuery{}, visitor);
+}
 
-    if (libevtx_file_get_number_of_records(evtx_file_, &record_count, &error) !=
-        1) {
-      handleLibEvtxError("Не удалось получить количество записей", error);
-      throw std::runtime_error("Не удалось прочитать EVTX файл");
-    }
+bool EvtxParser::forEachRecord(const std::string& file_path,
+                               const EventIdFilter& event_ids,
+                               const EventRecordVisitor& visitor) {
+  EventLogQuery query;
+  query.event_ids = event_ids;
+  return scanRecords(file_path, query, visitor);
+}
 
-    std::vector<EventData> events;
-    if (record_count > 0) {
-      events.reserve(static_cast<size_t>(record_count));
-    }
+bool EvtxParser::queryRecords(const std::string& file_path,
+                              const EventLogQuery& query,
+                              const EventRecordVisitor& visitor) {
+  return scanRecords(file_path, query, visitor);
+}
 
-    for (int i = 0; i < record_count; ++i) {
-      libevtx_record_t* record = nullptr;
-      if (libevtx_file_get_record_by_index(evtx_file_, i, &record, &error) ==
-          1) {
-        events.push_back(parseRecord(record));
-        libevtx_record_free(&record, nullptr);
-      } else {
-        if (error) {
-          char buffer[256];
-          libevtx_error_sprint(error, buffer, sizeof(buffer));
-          libevtx_error_free(&error);
-          // TODO: Log warning
-        }
-      }
-    }
+std::optional<EventLogTail> EvtxParser::locateRecord(const std::string&,
+                                                     uint64_t) {
+  return std::nullopt;
+}
 
-    return events;
-  } catch (...) {
-    closeFile();
-    throw;
+std::optional<EventLogSummary> EvtxParser::readSummary(
+    const std::string& file_path) {
+  const auto header = EvtxFileHeader::read(file_path);
+  if (!header) {
+    return std::nullopt;
   }
+  return header->summary();
 }
 
-std::vector<EventData> EvtxParser::filterByEventId(const std::string& file_path,
-                                                   uint32_t event_id) {
+bool EvtxParser::scanRecords(const std::string& file_path,
+                             const EventLogQuery& query,
+                             const EventRecordVisitor& visitor) {
   openFile(file_path);
 
   try {
@@ -78,33 +117,75 @@ std::vector<EventData> EvtxParser::filterByEventId(const std::string& file_path,
       throw std::runtime_error("Не удалось прочитать EVTX файл");
     }
 
-    std::vector<EventData> events;
+    const EventIdFilter* event_ids = query.eventIds();
+    const bool bounded = query.hasTimeWindow() || query.hasRecordRange();
 
-    for (int i = 0; i < record_count; ++i) {
+    bool completed = true;
+    for (int i = 0; i < record_count && completed; ++i) {
       libevtx_record_t* record = nullptr;
-      if (libevtx_file_get_record_by_index(evtx_file_, i, &record, &error) ==
-          1) {
-        uint32_t current_id = 0;
-        if (libevtx_record_get_event_identifier(record, &current_id, nullptr) ==
-                1 &&
-            current_id == event_id) {
-          events.push_back(parseRecord(record));
+      if (libevtx_file_get_record_by_index(evtx_file_, i, &record, &error) != 1) {
+        // Повреждённая запись пропускается, обход продолжается
+        if (error) libevtx_error_free(&error);
+        continue;
+      }
+
+      // Номер, время и идентификатор проверяются до разбора остальных полей
+      if (bounded) {
+        uint64_t record_id = 0;
+        uint64_t written_time = 0;
+        if (libevtx_record_get_identifier(record, &record_id, nullptr) != 1 ||
+            libevtx_record_get_written_time(record, &written_time, nullptr) !=
+                1 ||
+            !query.matches(record_id, written_time)) {
+          libevtx_record_free(&record, nullptr);
+          continue;
         }
-        libevtx_record_free(&record, nullptr);
-      } else {
-        if (error) {
-          libevtx_error_free(&error);
+      }
+      if (event_ids) {
+        uint32_t event_id = 0;
+        if (libevtx_record_get_event_identifier(record, &event_id, nullptr) !=
+                1 ||
+            !event_ids->contains(event_id)) {
+          libevtx_record_free(&record, nullptr);
+          continue;
         }
       }
+
+      EventData event = parseRecord(record, options_);
+      libevtx_record_free(&record, nullptr);
+      if (query.accepts(event)) {
+        completed = visitor(std::move(event));
+      }
     }
 
-    return events;
+    closeFile();
+    return completed;
   } catch (...) {
     closeFile();
     throw;
   }
 }
 
+std::unique_ptr<IEventRecordReader> EvtxParser::openReader(
+    const std::string& file_path) {
+  return std::make_unique<EvtxRecordReader>(file_path, options_);
+}
+
+std::vector<EventData> EvtxParser::filterByEventId(const std::string& file_path,
+                                                   uint32_t event_id) {
+  return filterByEventIds(file_path, EventIdFilter{event_id});
+}
+
+std::vector<EventData> EvtxParser::filterByEventIds(
+    const std::string& file_path, const EventIdFilter& event_ids) {
+  std::vector<EventData> events;
+  forEachRecord(file_path, event_ids, [&events](EventData&& event) {
+    events.push_back(std::move(event));
+    return true;
+  });
+  return events;
+}
+
 bool EvtxParser::supports(const std::string& file_path) const {
   if (file_path.length() < 5) return false;
 
@@ -141,7 +222,8 @@ void EvtxParser::closeFile() noexcept {
   }
 }
 
-EventData EvtxParser::parseRecord(libevtx_record_t* record) {
+EventData EvtxParser::parseRecord(libevtx_record_t* record,
+                                  const EvtxParserOptions& options) {
   EventDataBuilder builder;
   libevtx_error_t* error = nullptr;
 
@@ -160,6 +242,13 @@ EventData EvtxParser::parseRecord(libevtx_record_t* record) {
     libevtx_error_free(&error);
   }
 
+  uint64_t record_id = 0;
+  if (libevtx_record_get_identifier(record, &record_id, &error) == 1) {
+    builder.setRecordId(record_id);
+  } else if (error) {
+    libevtx_error_free(&error);
+  }
+
   uint8_t level = 0;
   if (libevtx_record_get_event_level(record, &level, &error) == 1) {
     builder.setLevel(static_cast<EventLevel>(level));
@@ -167,77 +256,117 @@ EventData EvtxParser::parseRecord(libevtx_record_t* record) {
     libevtx_error_free(&error);
   }
 
-  // Строковые поля
-  size_t size = 0;
-  if (libevtx_record_get_utf8_provider_identifier_size(record, &size, &error) ==
-          1 &&
-      size > 0) {
-    std::vector<char> buffer(size);
-    if (libevtx_record_get_utf8_provider_identifier(
-            record, reinterpret_cast<uint8_t*>(buffer.data()), size, &error) ==
-        1) {
-      builder.setProvider(std::string(buffer.data()));
-    }
-    if (error) libevtx_error_free(&error);
-  } else if (error) {
+  uint8_t version = 0;
+  if (libevtx_record_get_event_version(record, &version, &error) != 1 &&
+      error) {
     libevtx_error_free(&error);
   }
 
-  if (libevtx_record_get_utf8_computer_name_size(record, &size, &error) == 1 &&
-      size > 0) {
-    std::vector<char> buffer(size);
-    if (libevtx_record_get_utf8_computer_name(
-            record, reinterpret_cast<uint8_t*>(buffer.data()), size, &error) ==
-        1) {
-      builder.setComputer(std::string(buffer.data()));
-    }
-    if (error) libevtx_error_free(&error);
-  } else if (error) {
-    libevtx_error_free(&error);
+  // Строковые поля. Имя провайдера (source name) нужно для поиска схемы;
+  // GUID провайдера используется, только если имя отсутствует
+  std::string provider;
+  if (!readString(record, libevtx_record_get_utf8_source_name_size,
+                  libevtx_record_get_utf8_source_name, provider)) {
+    readString(record, libevtx_record_get_utf8_provider_identifier_size,
+               libevtx_record_get_utf8_provider_identifier, provider);
   }
 
-  if (libevtx_record_get_utf8_channel_name_size(record, &size, &error) == 1 &&
-      size > 0) {
-    std::vector<char> buffer(size);
-    if (libevtx_record_get_utf8_channel_name(
-            record, reinterpret_cast<uint8_t*>(buffer.data()), size, &error) ==
-        1) {
-      builder.setChannel(std::string(buffer.data()));
-    }
+  std::string value;
+  if (readString(record, libevtx_record_get_utf8_computer_name_size,
+                 libevtx_record_get_utf8_computer_name, value)) {
+    builder.setComputer(value);
+  }
+  if (readString(record, libevtx_record_get_utf8_channel_name_size,
+                 libevtx_record_get_utf8_channel_name, value)) {
+    builder.setChannel(value);
+  }
+  if (readString(record, libevtx_record_get_utf8_user_security_identifier_size,
+                 libevtx_record_get_utf8_user_security_identifier, value)) {
+    builder.setUserSid(value);
+  }
+
+  // Данные события: без рендеринга XML, если схема известна и XML не нужен
+  const bool keep_xml = options.xml.keeps(event_id);
+  const auto fields = EventSchema::find(provider, event_id, version);
+  const bool have_fields =
+      !keep_xml && !fields.empty() &&
+      readSubstitutionStrings(record, fields, builder);
+  if (!have_fields) {
+    readXml(record, keep_xml, builder);
+  }
+
+  builder.setProvider(provider);
+  return std::move(builder).build();
+}
+
+bool EvtxParser::readSubstitutionStrings(
+    libevtx_record_t* record, std::span<const std::string_view> fields,
+    EventDataBuilder& builder) {
+  libevtx_error_t* error = nullptr;
+
+  int string_count = 0;
+  if (libevtx_record_get_number_of_strings(record, &string_count, &error) !=
+      1) {
     if (error) libevtx_error_free(&error);
-  } else if (error) {
-    libevtx_error_free(&error);
+    return false;
   }
 
-  // XML данные
-  size_t xml_size = 0;
-  if (libevtx_record_get_utf8_xml_string_size(record, &xml_size, &error) == 1 &&
-      xml_size > 0) {
-    std::vector<char> buffer(xml_size);
-    if (libevtx_record_get_utf8_xml_string(
-            record, reinterpret_cast<uint8_t*>(buffer.data()), xml_size,
-            &error) == 1) {
-      std::string xml(buffer.data());
-      builder.setXml(xml);
-
-      // Извлекаем данные из XML
-      const auto xml_data = XmlEventParser::parseEventData(xml);
-      for (const auto& [key, value] : xml_data) {
-        builder.addData(key, value);
-      }
+  // Строк больше, чем полей в схеме: версия шаблона не совпадает со схемой
+  if (string_count < 0 || static_cast<size_t>(string_count) > fields.size()) {
+    return false;
+  }
 
-      // Извлекаем описание
-      const std::string description = XmlEventParser::parseDescription(xml);
-      if (!description.empty()) {
-        builder.setDescription(description);
+  std::vector<char> buffer;
+  for (int i = 0; i < string_count; ++i) {
+    size_t size = 0;
+    if (libevtx_record_get_utf8_string_size(record, i, &size, &error) != 1) {
+      if (error) libevtx_error_free(&error);
+      continue;
+    }
+
+    std::string value;
+    if (size > 1) {
+      buffer.resize(size);
+      if (libevtx_record_get_utf8_string(
+              record, i, reinterpret_cast<uint8_t*>(buffer.data()), size,
+              &error) != 1) {
+        if (error) libevtx_error_free(&error);
+        continue;
       }
+      value.assign(buffer.data());
     }
-    if (error) libevtx_error_free(&error);
-  } else if (error) {
-    libevtx_error_free(&error);
+
+    builder.addData(fields[static_cast<size_t>(i)], value);
   }
 
-  return std::move(builder).build();
+  return true;
+}
+
+void EvtxParser::readXml(libevtx_record_t* record, bool keep_xml,
+                         EventDataBuilder& builder) {
+  std::string xml;
+  if (!readString(record, libevtx_record_get_utf8_xml_string_size,
+                  libevtx_record_get_utf8_xml_string, xml)) {
+    return;
+  }
+
+  // Извлекаем данные из XML
+  XmlEventParser::forEachDataField(
+      xml, [&builder](std::string_view name, std::string_view raw_value) {
+        std::string decoded;
+        XmlEventParser::appendDecoded(decoded, raw_value);
+        builder.addData(name, decoded);
+      });
+
+  // Извлекаем описание
+  std::string description = XmlEventParser::parseDescription(xml);
+  if (!description.empty()) {
+    builder.setDescription(description);
+  }
+
+  if (keep_xml) {
+    builder.setXml(xml);
+  }
 }
 
 void EvtxParser::handleLibEvtxError(const std::string& context,
@@ -250,4 +379,69 @@ void EvtxParser::handleLibEvtxError(const std::string& context,
   }
 }
 
+EvtxRecordReader::EvtxRecordReader(const std::string& file_path,
+                                   EvtxParserOptions options)
+    : options_(options) {
+  libevtx_error_t* error = nullptr;
+
+  try {
+    if (libevtx_file_initialize(&evtx_file_, &error) != 1) {
+      EvtxParser::handleLibEvtxError("Не удалось инициализировать libevtx",
+                                     error);
+      throw std::runtime_error("Не удалось инициализировать курсор EVTX");
+    }
+
+    if (libevtx_file_open(evtx_file_, file_path.c_str(),
+                          LIBEVTX_ACCESS_FLAG_READ, &error) != 1) {
+      EvtxParser::handleLibEvtxError("Не удалось открыть файл: " + file_path,
+                                     error);
+      throw std::runtime_error("Не удалось открыть файл EVTX");
+    }
+    file_opened_ = true;
+
+    if (libevtx_file_get_number_of_records(evtx_file_, &record_count_,
+                                           &error) != 1) {
+      EvtxParser::handleLibEvtxError("Не удалось получить количество записей",
+                                     error);
+      throw std::runtime_error("Не удалось прочитать EVTX файл");
+    }
+  } catch (...) {
+    release();
+    throw;
+  }
+}
+
+EvtxRecordReader::~EvtxRecordReader() { release(); }
+
+std::optional<EventData> EvtxRecordReader::next() {
+  libevtx_error_t* error = nullptr;
+
+  while (next_index_ < record_count_) {
+    libevtx_record_t* record = nullptr;
+    const int index = next_index_++;
+
+    if (libevtx_file_get_record_by_index(evtx_file_, index, &record, &error) ==
+        1) {
+      EventData event = EvtxParser::parseRecord(record, options_);
+      libevtx_record_free(&record, nullptr);
+      return event;
+    }
+    if (error) {
+      libevtx_error_free(&error);
+    }
+  }
+
+  return std::nullopt;
+}
+
+void EvtxRecordReader::release() noexcept {
+  if (file_opened_ && evtx_file_) {
+    libevtx_file_close(evtx_file_, nullptr);
+    file_opened_ = false;
+  }
+  if (evtx_file_) {
+    libevtx_file_free(&evtx_file_, nullptr);
+  }
+}
+
 }
@@ -5,22 +5,38 @@
 
 #include <libevtx.h>
 
+#include <memory>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "../../interfaces/iparser.hpp"
 #include "../../model/event_data.hpp"
+#include "../../model/xml_retention.hpp"
 
 /// @namespace EventLogAnalysis
 /// @brief Пространство имен для работы с журналами событий Windows
 namespace EventLogAnalysis {
 
+/// @brief Параметры разбора записей EVTX
+struct EvtxParserOptions {
+  /// @brief Сохранение XML-представления записей
+  /// @details По умолчанию поля EventData читаются напрямую через строковые
+  /// аксессоры libevtx и именуются по таблице EventSchema. XML рендерится
+  /// для событий, XML которых сохраняется, либо для событий без известной
+  /// схемы.
+  XmlRetention xml;
+};
+
 /// @class EvtxParser
 /// @brief Парсер для EVTX файлов Windows
 class EvtxParser final : public IEventLogParser {
  public:
   /// @brief Конструктор
-  EvtxParser();
+  /// @param options Параметры разбора записей
+  explicit EvtxParser(EvtxParserOptions options = {});
 
   /// @brief Деструктор
   ~EvtxParser() override;
@@ -36,6 +52,20 @@ class EvtxParser final : public IEventLogParser {
   /// @return Вектор разобранных событий
   std::vector<EventData> parse(const std::string& file_path) override;
 
+  /// @brief Потоково обходит записи EVTX файла
+  /// @param file_path Путь к EVTX файлу
+  /// @param visitor Обработчик записей (false прекращает обход)
+  /// @return true если файл обойден полностью
+  bool forEachRecord(const std::string& file_path,
+                     const EventRecordVisitor& visitor) override;
+
+  /// @brief Открывает курсор для построчного чтения EVTX файла
+  /// @param file_path Путь к EVTX файлу
+  /// @return Курсор записей
+  /// @throws std::runtime_error Если не удалось открыть файл
+  std::unique_ptr<IEventRecordReader> openReader(
+      const std::string& file_path) override;
+
   /// @brief Фильтрует события по идентификатору из EVTX файла
   /// @param file_path Путь к EVTX файлу
   /// @param event_id Идентификатор события для фильтрации
@@ -43,6 +73,46 @@ class EvtxParser final : public IEventLogParser {
   std::vector<EventData> filterByEventId(const std::string& file_path,
                                          uint32_t event_id) override;
 
+  /// @brief Фильтрует события по множеству идентификаторов из EVTX файла
+  /// @param file_path Путь к EVTX файлу
+  /// @param event_ids Множество идентификаторов событий
+  /// @return Вектор событий с подходящими идентификаторами
+  std::vector<EventData> filterByEventIds(
+      const std::string& file_path, const EventIdFilter& event_ids) override;
+
+  /// @brief Потоково обходит записи EVTX файла с заданными идентификаторами
+  /// @param file_path Путь к EVTX файлу
+  /// @param event_ids Множество идентификаторов событий
+  /// @param visitor Обработчик записей (false прекращает обход)
+  /// @return true если файл обойден полностью
+  bool forEachRecord(const std::string& file_path,
+                     const EventIdFilter& event_ids,
+                     const EventRecordVisitor& visitor) override;
+
+  /// @brief Потоково обходит записи EVTX файла, попадающие в выборку
+  /// @details Номер и время записи читаются до разбора остальных полей
+  /// @param file_path Путь к EVTX файлу
+  /// @param query Окно времени, диапазон номеров и идентификаторы событий
+  /// @param visitor Обработчик записей (false прекращает обход)
+  /// @return true если файл обойден полностью
+  bool queryRecords(const std::string& file_path, const EventLogQuery& query,
+                    const EventRecordVisitor& visitor) override;
+
+  /// @brief Находит запись журнала и контрольную сумму ее блока
+  /// @details libevtx не предоставляет исходные байты записей, поэтому
+  /// контрольные точки не поддерживаются
+  /// @param file_path Путь к EVTX файлу
+  /// @param record_id Номер записи или EventLogTail::kLastRecord
+  /// @return std::nullopt
+  std::optional<EventLogTail> locateRecord(const std::string& file_path,
+                                           uint64_t record_id) override;
+
+  /// @brief Читает сведения о журнале только из заголовка файла
+  /// @param file_path Путь к EVTX файлу
+  /// @return Сведения или std::nullopt, если заголовок не разобран
+  std::optional<EventLogSummary> readSummary(
+      const std::string& file_path) override;
+
   /// @brief Проверяет поддержку формата файла
   /// @param file_path Путь к файлу для проверки
   /// @return true если файл имеет расширение .evtx
@@ -57,6 +127,8 @@ class EvtxParser final : public IEventLogParser {
   [[nodiscard]] std::vector<std::string> supportedExtensions() const override;
 
  private:
+  friend class EvtxRecordReader;  ///< Курсор использует разбор записей
+
   /// @brief Открывает EVTX файл для чтения
   /// @param file_path Путь к EVTX файлу
   /// @throws std::runtime_error Если не удалось открыть файл
@@ -65,10 +137,36 @@ class EvtxParser final : public IEventLogParser {
   /// @brief Закрывает открытый EVTX файл
   void closeFile() noexcept;
 
+  /// @brief Последовательно обходит записи открытого файла
+  /// @param file_path Путь к EVTX файлу
+  /// @param query Выборка записей
+  /// @param visitor Обработчик записей (false прекращает обход)
+  /// @return true если файл обойден полностью
+  bool scanRecords(const std::string& file_path, const EventLogQuery& query,
+                   const EventRecordVisitor& visitor);
+
   /// @brief Парсит одну запись из EVTX файла
   /// @param record Указатель на запись libevtx
+  /// @param options Параметры разбора
   /// @return Объект EventData с разобранными данными
-  [[nodiscard]] static EventData parseRecord(libevtx_record_t* record);
+  [[nodiscard]] static EventData parseRecord(libevtx_record_t* record,
+                                             const EvtxParserOptions& options);
+
+  /// @brief Читает поля EventData через строковые аксессоры libevtx
+  /// @param record Указатель на запись libevtx
+  /// @param fields Имена полей по позициям из EventSchema
+  /// @param builder Построитель события
+  /// @return true если поля прочитаны без рендеринга XML
+  static bool readSubstitutionStrings(libevtx_record_t* record,
+                                      std::span<const std::string_view> fields,
+                                      EventDataBuilder& builder);
+
+  /// @brief Рендерит XML записи и извлекает из него поля и описание
+  /// @param record Указатель на запись libevtx
+  /// @param keep_xml Сохранить XML в событии
+  /// @param builder Построитель события
+  static void readXml(libevtx_record_t* record, bool keep_xml,
+                      EventDataBuilder& builder);
 
   /// @brief Обрабатывает ошибку библиотеки libevtx
   /// @param context Контекст ошибки для сообщения
@@ -77,9 +175,44 @@ class EvtxParser final : public IEventLogParser {
   static void handleLibEvtxError(const std::string& context,
                                  libevtx_error_t* error);
 
+  EvtxParserOptions options_;  ///< Параметры разбора записей
   libevtx_file_t* evtx_file_ =
       nullptr;                ///< Указатель на файловый объект libevtx
   bool file_opened_ = false;  ///< Флаг открытого состояния файла
 };
 
+/// @class EvtxRecordReader
+/// @brief Курсор для построчного чтения записей EVTX файла
+class EvtxRecordReader final : public IEventRecordReader {
+ public:
+  /// @brief Открывает EVTX файл для чтения
+  /// @param file_path Путь к EVTX файлу
+  /// @param options Параметры разбора записей
+  /// @throws std::runtime_error Если не удалось открыть файл
+  EvtxRecordReader(const std::string& file_path, EvtxParserOptions options);
+
+  /// @brief Деструктор, закрывает файл
+  ~EvtxRecordReader() override;
+
+  /// @brief Конструктор копирования (запрещен)
+  EvtxRecordReader(const EvtxRecordReader&) = delete;
+
+  /// @brief Оператор присваивания копированием (запрещен)
+  EvtxRecordReader& operator=(const EvtxRecordReader&) = delete;
+
+  /// @brief Читает следующую запись
+  /// @return Разобранная запись или std::nullopt по достижении конца файла
+  std::optional<EventData> next() override;
+
+ private:
+  /// @brief Освобождает ресурсы libevtx
+  void release() noexcept;
+
+  EvtxParserOptions options_;            ///< Параметры разбора записей
+  libevtx_file_t* evtx_file_ = nullptr;  ///< Файловый объект libevtx
+  bool file_opened_ = false;             ///< Флаг открытого состояния файла
+  int record_count_ = 0;                 ///< Количество записей в файле
+  int next_index_ = 0;                   ///< Индекс следующей записи
+};
+
 }
@@ -0,0 +1,278 @@
+#include "record_assembler.hpp"
+
+#include <charconv>
+
+#include "template_plan.hpp"
+
+namespace EventLogAnalysis {
+
+namespace {
+
+/// @brief Разбирает десятичное число из текста элемента
+template <typename T>
+bool parseNumber(std::string_view text, T& value) {
+  const auto result =
+      std::from_chars(text.data(), text.data() + text.size(), value);
+  return result.ec == std::errc{};
+}
+
+}
+
+EvtxRecordAssembler::EvtxRecordAssembler(std::shared_ptr<EventArena> arena)
+    : arena_(std::move(arena)) {}
+
+void EvtxRecordAssembler::reset(const EvtxRecordLocation& location,
+                                const EventIdFilter* event_ids,
+                                bool keep_xml) {
+  keep_xml_ = keep_xml;
+  event_ids_ = event_ids;
+  builder_.emplace(arena_);
+  builder_->setTimestamp(location.written_time);
+  builder_->setRecordId(location.record_id);
+  path_.clear();
+  section_ = EvtxSection::None;
+  field_ = EvtxField::None;
+  text_.clear();
+  data_name_.clear();
+  xml_.clear();
+  tag_open_ = false;
+  event_id_ = 0;
+  rejected_ = false;
+}
+
+bool EvtxRecordAssembler::rejected() const noexcept { return rejected_; }
+
+uint32_t EvtxRecordAssembler::eventId() const noexcept { return event_id_; }
+
+EventData EvtxRecordAssembler::build() {
+  if (keep_xml_) {
+    builder_->setXml(xml_);
+  }
+  EventData event = std::move(*builder_).build();
+  builder_.reset();
+  return event;
+}
+
+bool EvtxRecordAssembler::startElement(std::string_view name) {
+  path_.push_back(name);
+
+  const size_t depth = path_.size();
+  if (depth == 2) {
+    section_ = EvtxEventLayout::sectionOf(name);
+  }
+  field_ = EvtxEventLayout::elementField(section_, depth, name);
+  text_.clear();
+  if (field_ == EvtxField::Data) {
+    data_name_.clear();
+  }
+
+  if (keep_xml_) {
+    closePendingTag();
+    xml_ += '<';
+    xml_.append(name);
+    tag_open_ = true;
+  }
+  return true;
+}
+
+bool EvtxRecordAssembler::attribute(std::string_view name,
+                                    const BinXmlValue& value) {
+  const EvtxField field =
+      path_.empty() ? EvtxField::None
+                    : EvtxEventLayout::attributeField(section_, path_.size(),
+                                                      path_.back(), name);
+
+  if (field == EvtxField::DataName) {
+    data_name_.clear();
+    value.appendTo(data_name_);
+  } else if (field != EvtxField::None) {
+    value_.clear();
+    value.appendTo(value_);
+    storeField(field, Symbol(), value_);
+  }
+
+  if (keep_xml_) {
+    xml_ += ' ';
+    xml_.append(name);
+    xml_ += "=\"";
+    value_.clear();
+    value.appendTo(value_);
+    appendEscaped(value_);
+    xml_ += '"';
+  }
+  return true;
+}
+
+bool EvtxRecordAssembler::closeStartElement() { return true; }
+
+bool EvtxRecordAssembler::text(const BinXmlValue& value) {
+  if (keep_xml_) {
+    closePendingTag();
+    value_.clear();
+    value.appendTo(value_);
+    appendEscaped(value_);
+    if (field_ != EvtxField::None) text_ += value_;
+    return true;
+  }
+
+  if (field_ != EvtxField::None) {
+    value.appendTo(text_);
+  }
+  return true;
+}
+
+bool EvtxRecordAssembler::endElement() {
+  if (path_.empty()) {
+    return true;
+  }
+
+  const std::string_view name = path_.back();
+  bool accepted = true;
+
+  if (field_ == EvtxField::Data) {
+    if (!data_name_.empty()) {
+      accepted = storeField(field_, Symbol::intern(data_name_), text_);
+    }
+  } else if (field_ == EvtxField::UserData) {
+    accepted = storeField(field_, Symbol::intern(name), text_);
+  } else if (field_ != EvtxField::None) {
+    accepted = storeField(field_, Symbol(), text_);
+  }
+  if (!accepted) {
+    return false;
+  }
+
+  if (keep_xml_) {
+    if (tag_open_) {
+      xml_ += "/>";
+      tag_open_ = false;
+    } else {
+      xml_ += "</";
+      xml_.append(name);
+      xml_ += '>';
+    }
+  }
+
+  path_.pop_back();
+  field_ = EvtxField::None;
+  if (path_.size() < 2) {
+    section_ = EvtxSection::None;
+  }
+  return true;
+}
+
+bool EvtxRecordAssembler::usesTemplatePlans() const noexcept {
+  return !keep_xml_ && path_.empty();
+}
+
+bool EvtxRecordAssembler::applyTemplate(const TemplatePlan& plan,
+                                        std::span<const BinXmlValue> values,
+                                        BinXmlDecoder& decoder) {
+  for (const auto& binding : plan.bindings) {
+    if (binding.fragment) {
+      const uint16_t index = binding.parts.front().substitution;
+      if (index >= values.size() ||
+          values[index].type != BinXmlValueType::BinXml) {
+        continue;
+      }
+
+      // Вложенный фрагмент разбирается обходом в контексте пути шаблона
+      path_.assign(binding.path.begin(), binding.path.end());
+      section_ = path_.size() >= 2 ? EvtxEventLayout::sectionOf(path_[1])
+                                   : EvtxSection::None;
+      field_ = EvtxField::None;
+      const bool completed = decoder.decodeValue(values[index], *this);
+      path_.clear();
+      section_ = EvtxSection::None;
+      if (!completed) return false;
+      continue;
+    }
+
+    text_.clear();
+    for (const auto& part : binding.parts) {
+      if (part.substitution == TemplatePart::kLiteral) {
+        text_ += part.literal;
+      } else if (part.substitution < values.size()) {
+        values[part.substitution].appendTo(text_);
+      }
+    }
+    if (!storeField(binding.field, binding.key, text_)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool EvtxRecordAssembler::storeField(EvtxField field, Symbol name,
+                                     std::string_view value) {
+  switch (field) {
+    case EvtxField::EventId:
+      parseNumber(value, event_id_);
+      builder_->setEventId(event_id_);
+      if (event_ids_ && !event_ids_->contains(event_id_)) {
+        rejected_ = true;
+        return false;
+      }
+      break;
+    case EvtxField::Level: {
+      unsigned level = 0;
+      if (parseNumber(value, level)) {
+        builder_->setLevel(static_cast<EventLevel>(level));
+      }
+      break;
+    }
+    case EvtxField::Channel:
+      builder_->setChannel(value);
+      break;
+    case EvtxField::Computer:
+      builder_->setComputer(value);
+      break;
+    case EvtxField::Provider:
+      builder_->setProvider(value);
+      break;
+    case EvtxField::UserSid:
+      builder_->setUserSid(value);
+      break;
+    case EvtxField::Data:
+    case EvtxField::UserData:
+      builder_->addData(name, value);
+      break;
+    case EvtxField::Description:
+      builder_->setDescription(value);
+      break;
+    case EvtxField::DataName:
+    case EvtxField::None:
+      break;
+  }
+  return true;
+}
+
+void EvtxRecordAssembler::appendEscaped(std::string_view text) {
+  for (const char ch : text) {
+    switch (ch) {
+      case '&':
+        xml_ += "&amp;";
+        break;
+      case '<':
+        xml_ += "&lt;";
+        break;
+      case '>':
+        xml_ += "&gt;";
+        break;
+      case '"':
+        xml_ += "&quot;";
+        break;
+      default:
+        xml_ += ch;
+    }
+  }
+}
+
+void EvtxRecordAssembler::closePendingTag() {
+  if (tag_open_) {
+    xml_ += '>';
+    tag_open_ = false;
+  }
+}
+
+}
@@ -0,0 +1,108 @@
+/// @file record_assembler.hpp
+/// @brief Сборка EventData из потока событий декодера BinXml
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../../model/event_data.hpp"
+#include "../../model/event_data_builder.hpp"
+#include "../../model/event_id_filter.hpp"
+#include "binxml.hpp"
+#include "chunk.hpp"
+#include "event_layout.hpp"
+
+/// @namespace EventLogAnalysis
+/// @brief Пространство имен для работы с журналами событий Windows
+namespace EventLogAnalysis {
+
+/// @class EvtxRecordAssembler
+/// @brief Обработчик BinXml, заполняющий EventData по пути элементов
+/// @details Из System извлекаются провайдер, ID, версия, уровень, канал,
+/// компьютер и SID; из EventData - пары Data[@Name]; из UserData - листовые
+/// элементы второго уровня; из RenderingInfo - текст сообщения. Если задан
+/// фильтр ID, разбор записи прекращается сразу после элемента EventID.
+/// Без рендеринга XML запись верхнего уровня заполняется по плану шаблона.
+class EvtxRecordAssembler final : public IBinXmlHandler {
+ public:
+  /// @brief Конструктор
+  /// @param arena Общая арена значений записей пакета
+  explicit EvtxRecordAssembler(std::shared_ptr<EventArena> arena);
+
+  /// @brief Подготавливает сборщик к разбору новой записи
+  /// @param location Положение и заголовок записи
+  /// @param event_ids Фильтр идентификаторов (nullptr - все записи)
+  /// @param keep_xml Рендерить и сохранить XML-представление записи
+  void reset(const EvtxRecordLocation& location,
+             const EventIdFilter* event_ids, bool keep_xml);
+
+  /// @brief Проверяет, отклонена ли запись фильтром идентификаторов
+  [[nodiscard]] bool rejected() const noexcept;
+
+  /// @brief Возвращает идентификатор события разобранной записи
+  [[nodiscard]] uint32_t eventId() const noexcept;
+
+  /// @brief Завершает сборку записи
+  /// @return Разобранное событие
+  [[nodiscard]] EventData build();
+
+  /// @brief Начало элемента: обновляет путь и раздел
+  bool startElement(std::string_view name) override;
+
+  /// @brief Атрибут: Provider/@Name, Security/@UserID, Data/@Name
+  bool attribute(std::string_view name, const BinXmlValue& value) override;
+
+  /// @brief Конец списка атрибутов
+  bool closeStartElement() override;
+
+  /// @brief Текст: накапливается для нужных элементов
+  bool text(const BinXmlValue& value) override;
+
+  /// @brief Конец элемента: сохраняет накопленное значение поля
+  /// @return false если запись отклонена фильтром ID
+  bool endElement() override;
+
+  /// @brief Планы применимы к шаблону верхнего уровня без рендеринга XML
+  [[nodiscard]] bool usesTemplatePlans() const noexcept override;
+
+  /// @brief Заполняет поля записи по плану шаблона
+  /// @return false если запись отклонена фильтром ID
+  bool applyTemplate(const TemplatePlan& plan,
+                     std::span<const BinXmlValue> values,
+                     BinXmlDecoder& decoder) override;
+
+ private:
+  /// @brief Сохраняет значение поля в построителе
+  /// @param field Поле события
+  /// @param name Интернированное имя поля Data/UserData
+  /// @param value Текстовое значение
+  /// @return false если запись отклонена фильтром ID
+  bool storeField(EvtxField field, Symbol name, std::string_view value);
+
+  /// @brief Дописывает текст в XML с экранированием
+  void appendEscaped(std::string_view text);
+
+  /// @brief Закрывает открытый начальный тег в XML
+  void closePendingTag();
+
+  bool keep_xml_ = false;                   ///< Рендерить XML записи
+  std::shared_ptr<EventArena> arena_;       ///< Арена значений пакета
+  const EventIdFilter* event_ids_ = nullptr;  ///< Фильтр ID записи
+  std::optional<EventDataBuilder> builder_;  ///< Построитель записи
+  std::vector<std::string_view> path_;  ///< Путь от корня до элемента
+  EvtxSection section_ = EvtxSection::None;  ///< Текущий раздел
+  EvtxField field_ = EvtxField::None;  ///< Поле текста текущего элемента
+  std::string text_;      ///< Текст текущего элемента
+  std::string data_name_;  ///< Значение Data/@Name
+  std::string value_;      ///< Буфер форматирования значений
+  std::string xml_;        ///< XML-представление записи
+  bool tag_open_ = false;  ///< Начальный тег в XML еще не закрыт
+  uint32_t event_id_ = 0;  ///< Идентификатор события
+  bool rejected_ = false;  ///< Запись отклонена фильтром
+};
+
+}
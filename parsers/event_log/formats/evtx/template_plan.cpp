@@ -0,0 +1,210 @@
+#include "template_plan.hpp"
+
+#include <algorithm>
+
+namespace EventLogAnalysis {
+
+namespace {
+
+constexpr uint64_t kFnvOffset = 0xCBF29CE484222325ULL;
+constexpr uint64_t kFnvPrime = 0x100000001B3ULL;
+
+void hashBytes(uint64_t& hash, std::string_view bytes) noexcept {
+  for (const char ch : bytes) {
+    hash = (hash ^ static_cast<uint8_t>(ch)) * kFnvPrime;
+  }
+  hash = (hash ^ 0xFF) * kFnvPrime;
+}
+
+void hashValue(uint64_t& hash, uint64_t value) noexcept {
+  for (int i = 0; i < 8; ++i) {
+    hash = (hash ^ ((value >> (i * 8)) & 0xFF)) * kFnvPrime;
+  }
+}
+
+uint64_t hashPlan(const std::vector<TemplateBinding>& bindings) noexcept {
+  uint64_t hash = kFnvOffset;
+  for (const auto& binding : bindings) {
+    hashValue(hash, static_cast<uint64_t>(binding.field));
+    hashValue(hash, binding.fragment ? 1 : 0);
+    hashBytes(hash, binding.name);
+    for (const auto& part : binding.parts) {
+      hashValue(hash, part.substitution);
+      hashBytes(hash, part.literal);
+    }
+    for (const auto& element : binding.path) {
+      hashBytes(hash, element);
+    }
+  }
+  return hash;
+}
+
+}
+
+bool TemplatePlanCompiler::startElement(std::string_view name) {
+  path_.push_back(name);
+
+  const size_t depth = path_.size();
+  if (depth == 2) {
+    section_ = EvtxEventLayout::sectionOf(name);
+  }
+  field_ = EvtxEventLayout::elementField(section_, depth, name);
+  parts_.clear();
+  if (field_ == EvtxField::Data) {
+    data_name_.clear();
+  }
+  return true;
+}
+
+bool TemplatePlanCompiler::attribute(std::string_view name,
+                                     const BinXmlValue& value) {
+  if (path_.empty()) return true;
+
+  const EvtxField field = EvtxEventLayout::attributeField(
+      section_, path_.size(), path_.back(), name);
+
+  if (field == EvtxField::DataName) {
+    // Имя поля, заданное подстановкой, планом не выражается
+    if (value.type == BinXmlValueType::Placeholder) {
+      invalidate();
+      return false;
+    }
+    data_name_.clear();
+    value.appendTo(data_name_);
+  } else if (field != EvtxField::None) {
+    parts_.clear();
+    if (!appendPart(value)) return false;
+    bindings_.push_back(
+        TemplateBinding{field, {}, {}, std::move(parts_), false, {}});
+    parts_.clear();
+  }
+  return true;
+}
+
+bool TemplatePlanCompiler::closeStartElement() { return true; }
+
+bool TemplatePlanCompiler::text(const BinXmlValue& value) {
+  // Вложенный фрагмент разбирается при применении плана с учетом пути
+  if (value.type == BinXmlValueType::Placeholder &&
+      value.declared_type == BinXmlValueType::BinXml) {
+    TemplateBinding binding;
+    binding.fragment = true;
+    binding.parts.push_back(TemplatePart{value.substitution, {}});
+    binding.path.assign(path_.begin(), path_.end());
+    bindings_.push_back(std::move(binding));
+    return true;
+  }
+
+  if (field_ == EvtxField::None) {
+    return true;
+  }
+  return appendPart(value);
+}
+
+bool TemplatePlanCompiler::endElement() {
+  if (path_.empty()) {
+    return true;
+  }
+
+  if (field_ == EvtxField::Data) {
+    if (!data_name_.empty()) {
+      bindings_.push_back(
+          TemplateBinding{field_, data_name_, Symbol::intern(data_name_),
+                          std::move(parts_), false, {}});
+    }
+  } else if (field_ == EvtxField::UserData) {
+    bindings_.push_back(TemplateBinding{field_, std::string(path_.back()),
+                                        Symbol::intern(path_.back()),
+                                        std::move(parts_), false, {}});
+  } else if (field_ != EvtxField::None) {
+    bindings_.push_back(
+        TemplateBinding{field_, {}, {}, std::move(parts_), false, {}});
+  }
+
+  parts_.clear();
+  field_ = EvtxField::None;
+  path_.pop_back();
+  if (path_.size() < 2) {
+    section_ = EvtxSection::None;
+  }
+  return true;
+}
+
+void TemplatePlanCompiler::invalidate() noexcept { usable_ = false; }
+
+TemplatePlan TemplatePlanCompiler::finish() {
+  TemplatePlan plan;
+  plan.usable = usable_;
+  if (!usable_) {
+    return plan;
+  }
+
+  // EventID первым: фильтр ID проверяется до форматирования остальных полей
+  std::stable_partition(bindings_.begin(), bindings_.end(),
+                        [](const TemplateBinding& binding) {
+                          return binding.field == EvtxField::EventId;
+                        });
+  plan.bindings = std::move(bindings_);
+  plan.hash = hashPlan(plan.bindings);
+  return plan;
+}
+
+bool TemplatePlanCompiler::appendPart(const BinXmlValue& value) {
+  if (value.type == BinXmlValueType::Placeholder) {
+    if (value.substitution == TemplatePart::kLiteral) {
+      invalidate();
+      return false;
+    }
+    parts_.push_back(TemplatePart{value.substitution, {}});
+    return true;
+  }
+
+  // Соседние литералы объединяются
+  if (parts_.empty() || parts_.back().substitution != TemplatePart::kLiteral) {
+    parts_.emplace_back();
+  }
+  value.appendTo(parts_.back().literal);
+  return true;
+}
+
+TemplateCache::Statistics& TemplateCache::Statistics::operator+=(
+    const Statistics& other) noexcept {
+  plan_hits += other.plan_hits;
+  compiled += other.compiled;
+  shared += other.shared;
+  fallbacks += other.fallbacks;
+  return *this;
+}
+
+std::shared_ptr<const TemplatePlan> TemplateCache::intern(TemplatePlan plan) {
+  std::lock_guard lock(mutex_);
+
+  statistics_.compiled++;
+  if (plan.usable) {
+    const auto [begin, end] = plans_.equal_range(plan.hash);
+    for (auto it = begin; it != end; ++it) {
+      if (it->second->bindings == plan.bindings) {
+        statistics_.shared++;
+        return it->second;
+      }
+    }
+  }
+
+  auto shared = std::make_shared<const TemplatePlan>(std::move(plan));
+  if (shared->usable) {
+    plans_.emplace(shared->hash, shared);
+  }
+  return shared;
+}
+
+void TemplateCache::merge(const Statistics& statistics) {
+  std::lock_guard lock(mutex_);
+  statistics_ += statistics;
+}
+
+TemplateCache::Statistics TemplateCache::statistics() const {
+  std::lock_guard lock(mutex_);
+  return statistics_;
+}
+
+}
@@ -0,0 +1,134 @@
+/// @file template_plan.hpp
+/// @brief Скомпилированные планы извлечения полей из шаблонов BinXml
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../../model/symbol.hpp"
+#include "binxml.hpp"
+#include "event_layout.hpp"
+
+/// @namespace EventLogAnalysis
+/// @brief Пространство имен для работы с журналами событий Windows
+namespace EventLogAnalysis {
+
+/// @brief Часть значения поля: литерал из тела шаблона или подстановка
+struct TemplatePart {
+  static constexpr uint16_t kLiteral = 0xFFFF;  ///< Признак литерала
+
+  uint16_t substitution = kLiteral;  ///< Индекс в массиве подстановок
+  std::string literal;               ///< Текст литерала
+
+  bool operator==(const TemplatePart&) const = default;
+};
+
+/// @brief Привязка поля EventData к частям шаблона
+struct TemplateBinding {
+  EvtxField field = EvtxField::None;  ///< Заполняемое поле
+  std::string name;                   ///< Имя поля Data/UserData
+  Symbol key;                         ///< Интернированное имя поля
+  std::vector<TemplatePart> parts;    ///< Части значения по порядку
+  bool fragment = false;  ///< Подстановка содержит вложенный BinXml
+  std::vector<std::string> path;  ///< Путь элемента вложенного фрагмента
+
+  bool operator==(const TemplateBinding&) const = default;
+};
+
+/// @brief Плоский план извлечения полей записи по шаблону
+/// @details Строится один раз на шаблон. Для каждой записи достаточно
+/// проиндексировать массив подстановок по привязкам плана, не обходя
+/// токены тела шаблона. Привязка EventID идет первой, чтобы фильтр ID
+/// отсекал запись до форматирования остальных полей.
+struct TemplatePlan {
+  std::vector<TemplateBinding> bindings;  ///< Привязки полей
+  uint64_t hash = 0;     ///< Хеш содержимого плана
+  bool usable = false;   ///< План применим (иначе нужен полный обход)
+};
+
+/// @class TemplatePlanCompiler
+/// @brief Обработчик BinXml, строящий план при символическом обходе тела
+/// шаблона (подстановки передаются как Placeholder)
+class TemplatePlanCompiler final : public IBinXmlHandler {
+ public:
+  /// @brief Начало элемента
+  bool startElement(std::string_view name) override;
+
+  /// @brief Атрибут: привязка Provider/UserSid или имя поля Data
+  bool attribute(std::string_view name, const BinXmlValue& value) override;
+
+  /// @brief Конец списка атрибутов
+  bool closeStartElement() override;
+
+  /// @brief Текст: литерал или подстановка в значении поля
+  bool text(const BinXmlValue& value) override;
+
+  /// @brief Конец элемента: фиксирует привязку поля
+  bool endElement() override;
+
+  /// @brief Помечает шаблон как неподдерживаемый планом
+  void invalidate() noexcept;
+
+  /// @brief Завершает компиляцию
+  /// @return План шаблона
+  [[nodiscard]] TemplatePlan finish();
+
+ private:
+  /// @brief Переводит значение в часть привязки
+  /// @return false если значение нельзя выразить частью плана
+  bool appendPart(const BinXmlValue& value);
+
+  std::vector<std::string_view> path_;  ///< Путь текущего элемента
+  EvtxSection section_ = EvtxSection::None;  ///< Текущий раздел
+  EvtxField field_ = EvtxField::None;  ///< Поле текущего элемента
+  std::vector<TemplatePart> parts_;    ///< Части значения текущего поля
+  std::string data_name_;              ///< Значение Data/@Name
+  std::vector<TemplateBinding> bindings_;  ///< Собранные привязки
+  bool usable_ = true;  ///< Шаблон выразим планом
+};
+
+/// @class TemplateCache
+/// @brief Общий для блоков файла набор скомпилированных планов
+/// @details Внутри блока план находится по смещению определения шаблона
+/// (кеш декодера блока). Между блоками одинаковые планы объединяются по хешу
+/// содержимого: тело шаблона в разных блоках отличается смещениями имен, а
+/// план от них не зависит. Потокобезопасен.
+class TemplateCache {
+ public:
+  /// @brief Счетчики использования планов
+  struct Statistics {
+    uint64_t plan_hits = 0;  ///< Записей, разобранных по готовому плану
+    uint64_t compiled = 0;   ///< Скомпилированных шаблонов
+    uint64_t shared = 0;     ///< Планов, найденных в других блоках по хешу
+    uint64_t fallbacks = 0;  ///< Записей, разобранных полным обходом
+
+    /// @brief Суммирует счетчики
+    Statistics& operator+=(const Statistics& other) noexcept;
+  };
+
+  /// @brief Возвращает общий экземпляр плана с тем же содержимым
+  /// @param plan Скомпилированный план
+  /// @return Разделяемый план
+  [[nodiscard]] std::shared_ptr<const TemplatePlan> intern(TemplatePlan plan);
+
+  /// @brief Добавляет счетчики декодера блока
+  /// @param statistics Счетчики
+  void merge(const Statistics& statistics);
+
+  /// @brief Возвращает накопленные счетчики
+  [[nodiscard]] Statistics statistics() const;
+
+ private:
+  mutable std::mutex mutex_;  ///< Защита таблицы и счетчиков
+  std::unordered_multimap<uint64_t, std::shared_ptr<const TemplatePlan>>
+      plans_;               ///< Планы по хешу содержимого
+  Statistics statistics_;  ///< Накопленные счетчики
+};
+
+}
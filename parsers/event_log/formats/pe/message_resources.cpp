@@ -0,0 +1,366 @@
+#include "message_resources.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+#include "../common/byte_order.hpp"
+#include "../common/utf16.hpp"
+
+namespace {
+
+using EventLogAnalysis::readLittleEndian;
+
+constexpr uint16_t kPe32Magic = 0x10B;              ///< Заголовок PE32
+constexpr uint16_t kPe32PlusMagic = 0x20B;          ///< Заголовок PE32+
+constexpr uint32_t kResourceDirectory = 2;          ///< Каталог ресурсов
+constexpr uint32_t kSectionHeaderSize = 40;         ///< Размер описания раздела
+constexpr uint32_t kRtMessageTable = 11;            ///< Тип MESSAGETABLE
+constexpr uint32_t kLanguageEnglish = 0x409;        ///< Язык en-US
+constexpr uint32_t kSubdirectoryFlag = 0x80000000;  ///< Признак подкаталога
+constexpr uint32_t kNoMessage = 0xFFFFFFFF;         ///< Событие без сообщения
+constexpr uint16_t kUnicodeEntry = 0x0001;          ///< Строка в UTF-16
+
+/// @brief Размер описания события в элементе EVNT манифеста
+constexpr size_t kEventDefinitionSize = 48;
+
+/// @brief Проверяет, что в буфере есть size байтов по смещению
+bool fits(std::span<const uint8_t> data, size_t offset, size_t size) noexcept {
+  return offset <= data.size() && size <= data.size() - offset;
+}
+
+/// @brief Сравнивает сигнатуру по смещению
+bool hasSignature(std::span<const uint8_t> data, size_t offset,
+                  std::string_view signature) noexcept {
+  return fits(data, offset, signature.size()) &&
+         std::equal(signature.begin(), signature.end(), data.begin() + offset);
+}
+
+/// @brief Форматирует двоичный GUID как "{XXXXXXXX-XXXX-XXXX-XXXX-...}"
+std::string formatGuid(std::span<const uint8_t> guid) {
+  constexpr char kHex[] = "0123456789ABCDEF";
+  std::string out = "{";
+  const auto hex = [&](uint64_t value, int digits) {
+    for (int shift = (digits - 1) * 4; shift >= 0; shift -= 4) {
+      out += kHex[(value >> shift) & 0xF];
+    }
+  };
+  hex(readLittleEndian<uint32_t>(guid, 0), 8);
+  out += '-';
+  hex(readLittleEndian<uint16_t>(guid, 4), 4);
+  out += '-';
+  hex(readLittleEndian<uint16_t>(guid, 6), 4);
+  out += '-';
+  for (size_t i = 8; i < 16; ++i) {
+    if (i == 10) out += '-';
+    hex(guid[i], 2);
+  }
+  out += '}';
+  return out;
+}
+
+/// @brief Сравнивает строки ASCII без учета регистра
+bool equalsIgnoreCase(std::string_view a, std::string_view b) noexcept {
+  return std::ranges::equal(a, b, [](unsigned char x, unsigned char y) {
+    return std::toupper(x) == std::toupper(y);
+  });
+}
+
+/// @brief Преобразует строку однобайтовой кодировки (Latin-1) в UTF-8
+std::string latin1ToUtf8(std::span<const uint8_t> text) {
+  std::string out;
+  out.reserve(text.size());
+  for (const uint8_t c : text) {
+    if (c < 0x80) {
+      out += static_cast<char>(c);
+    } else {
+      out += static_cast<char>(0xC0 | (c >> 6));
+      out += static_cast<char>(0x80 | (c & 0x3F));
+    }
+  }
+  return out;
+}
+
+/// @brief Отбрасывает завершающие нули, пробелы и переводы строки
+void trimTrailing(std::string& text) {
+  const size_t end = text.find_last_not_of(std::string_view(" \r\n\0", 4));
+  text.resize(end == std::string::npos ? 0 : end + 1);
+}
+
+}
+
+namespace EventLogAnalysis {
+
+MessageResourceFile::MessageResourceFile(const std::string& file_path)
+    : file_(file_path), bytes_(file_.bytes()) {
+  if (!hasSignature(bytes_, 0, "MZ") || !fits(bytes_, 0x3C, 4)) {
+    throw std::runtime_error("Файл не является PE-файлом: " + file_path);
+  }
+  const uint32_t pe = readLittleEndian<uint32_t>(bytes_, 0x3C);
+  if (!hasSignature(bytes_, pe, std::string_view("PE\0\0", 4)) ||
+      !fits(bytes_, pe, 24 + 2)) {
+    throw std::runtime_error("Файл не является PE-файлом: " + file_path);
+  }
+
+  section_count_ = readLittleEndian<uint16_t>(bytes_, pe + 6);
+  const uint16_t optional_size = readLittleEndian<uint16_t>(bytes_, pe + 20);
+  const size_t optional = pe + 24;
+  section_table_ = optional + optional_size;
+
+  // Каталоги данных: после 96 байт заголовка PE32 или 112 байт PE32+
+  const uint16_t magic = readLittleEndian<uint16_t>(bytes_, optional);
+  size_t directories = 0;
+  if (magic == kPe32Magic) {
+    directories = optional + 96;
+  } else if (magic == kPe32PlusMagic) {
+    directories = optional + 112;
+  } else {
+    throw std::runtime_error("Неизвестный формат PE-файла: " + file_path);
+  }
+  const size_t count_offset = directories - 4;
+  if (!fits(bytes_, count_offset, 4) ||
+      readLittleEndian<uint32_t>(bytes_, count_offset) <= kResourceDirectory) {
+    return;
+  }
+  const size_t entry = directories + kResourceDirectory * 8;
+  if (entry + 8 > section_table_ || !fits(bytes_, entry, 8)) {
+    return;
+  }
+
+  const uint32_t rva = readLittleEndian<uint32_t>(bytes_, entry);
+  const uint32_t size = readLittleEndian<uint32_t>(bytes_, entry + 4);
+  if (const auto offset = rva != 0 ? rvaToOffset(rva) : std::nullopt) {
+    resources_ = bytes_.subspan(
+        *offset, std::min<size_t>(size, bytes_.size() - *offset));
+  }
+}
+
+std::optional<size_t> MessageResourceFile::rvaToOffset(uint32_t rva) const {
+  for (uint16_t i = 0; i < section_count_; ++i) {
+    const size_t header = section_table_ + i * kSectionHeaderSize;
+    if (!fits(bytes_, header, kSectionHeaderSize)) {
+      break;
+    }
+    const auto field = [&](size_t offset) {
+      return readLittleEndian<uint32_t>(bytes_, header + offset);
+    };
+    const uint32_t address = field(12);
+    const uint32_t extent = std::max(field(8), field(16));
+    const uint32_t raw_offset = field(20);
+    if (rva >= address && rva - address < extent) {
+      const size_t offset = size_t{raw_offset} + (rva - address);
+      if (offset < bytes_.size()) {
+        return offset;
+      }
+      break;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<uint32_t> MessageResourceFile::firstEntry(
+    uint32_t directory, uint32_t prefer_id) const {
+  if (!fits(resources_, directory, 16)) {
+    return std::nullopt;
+  }
+  const size_t count =
+      size_t{readLittleEndian<uint16_t>(resources_, directory + 12)} +
+      readLittleEndian<uint16_t>(resources_, directory + 14);
+  std::optional<uint32_t> first;
+  for (size_t i = 0; i < count; ++i) {
+    const size_t entry = directory + 16 + i * 8;
+    if (!fits(resources_, entry, 8)) {
+      break;
+    }
+    const uint32_t name = readLittleEndian<uint32_t>(resources_, entry);
+    const uint32_t data = readLittleEndian<uint32_t>(resources_, entry + 4);
+    if (!first) first = data;
+    if (prefer_id == 0 || name == prefer_id) {
+      return data;
+    }
+  }
+  return first;
+}
+
+std::optional<std::span<const uint8_t>> MessageResourceFile::findResource(
+    uint32_t type_id, std::string_view type_name) const {
+  if (!fits(resources_, 0, 16)) {
+    return std::nullopt;
+  }
+
+  // Уровни каталога: тип, имя (ID) ресурса, язык
+  const size_t count =
+      size_t{readLittleEndian<uint16_t>(resources_, 12)} +
+      readLittleEndian<uint16_t>(resources_, 14);
+  std::optional<uint32_t> type_directory;
+  for (size_t i = 0; i < count && !type_directory; ++i) {
+    const size_t entry = 16 + i * 8;
+    if (!fits(resources_, entry, 8)) {
+      break;
+    }
+    const uint32_t name = readLittleEndian<uint32_t>(resources_, entry);
+    const uint32_t data = readLittleEndian<uint32_t>(resources_, entry + 4);
+    if ((data & kSubdirectoryFlag) == 0) {
+      continue;
+    }
+
+    bool matched = false;
+    if ((name & kSubdirectoryFlag) == 0) {
+      matched = type_id != 0 && name == type_id;
+    } else if (type_id == 0) {
+      const uint32_t offset = name & ~kSubdirectoryFlag;
+      if (fits(resources_, offset, 2)) {
+        const size_t length = readLittleEndian<uint16_t>(resources_, offset);
+        if (fits(resources_, offset + 2, length * 2)) {
+          matched = equalsIgnoreCase(
+              Utf16::toUtf8(resources_.subspan(offset + 2, length * 2)),
+              type_name);
+        }
+      }
+    }
+    if (matched) type_directory = data & ~kSubdirectoryFlag;
+  }
+  if (!type_directory) {
+    return std::nullopt;
+  }
+
+  const auto name_entry = firstEntry(*type_directory, 0);
+  if (!name_entry || (*name_entry & kSubdirectoryFlag) == 0) {
+    return std::nullopt;
+  }
+  const auto language_entry =
+      firstEntry(*name_entry & ~kSubdirectoryFlag, kLanguageEnglish);
+  if (!language_entry || (*language_entry & kSubdirectoryFlag) != 0 ||
+      !fits(resources_, *language_entry, 16)) {
+    return std::nullopt;
+  }
+
+  const uint32_t rva = readLittleEndian<uint32_t>(resources_, *language_entry);
+  const uint32_t size =
+      readLittleEndian<uint32_t>(resources_, *language_entry + 4);
+  const auto offset = rvaToOffset(rva);
+  if (!offset || !fits(bytes_, *offset, size)) {
+    return std::nullopt;
+  }
+  return bytes_.subspan(*offset, size);
+}
+
+bool MessageResourceFile::hasMessageTable() const {
+  return findResource(kRtMessageTable, {}).has_value();
+}
+
+void MessageResourceFile::readMessages(MessageTemplates& messages) const {
+  const auto table = findResource(kRtMessageTable, {});
+  if (!table || !fits(*table, 0, 4)) {
+    return;
+  }
+  const auto data = *table;
+
+  // MESSAGE_RESOURCE_DATA: блоки {LowId, HighId, OffsetToEntries}, записи
+  // блока {Length, Flags, Text} идут подряд для ID от LowId до HighId
+  const uint32_t block_count = readLittleEndian<uint32_t>(data, 0);
+  for (uint32_t block = 0; block < block_count; ++block) {
+    const size_t header = 4 + size_t{block} * 12;
+    if (!fits(data, header, 12)) {
+      break;
+    }
+    const uint32_t low_id = readLittleEndian<uint32_t>(data, header);
+    const uint32_t high_id = readLittleEndian<uint32_t>(data, header + 4);
+    size_t pos = readLittleEndian<uint32_t>(data, header + 8);
+
+    for (uint64_t id = low_id; id <= high_id; ++id) {
+      if (!fits(data, pos, 4)) {
+        break;
+      }
+      const uint16_t length = readLittleEndian<uint16_t>(data, pos);
+      const uint16_t flags = readLittleEndian<uint16_t>(data, pos + 2);
+      if (length < 4 || !fits(data, pos, length)) {
+        break;
+      }
+      const auto text = data.subspan(pos + 4, length - 4);
+      pos += length;
+
+      if (messages.contains(static_cast<uint32_t>(id))) {
+        continue;
+      }
+      std::string message = (flags & kUnicodeEntry)
+                                ? Utf16::toUtf8(Utf16::trimNulls(text))
+                                : latin1ToUtf8(text);
+      trimTrailing(message);
+      messages.emplace(static_cast<uint32_t>(id), std::move(message));
+    }
+  }
+}
+
+void MessageResourceFile::readEventMessages(
+    std::string_view provider_guid,
+    std::unordered_map<uint32_t, uint32_t>& events) const {
+  const auto resource = findResource(0, "WEVT_TEMPLATE");
+  if (!resource || !hasSignature(*resource, 0, "CRIM") ||
+      !fits(*resource, 0, 16)) {
+    return;
+  }
+  const auto data = *resource;
+
+  // CRIM: заголовок и записи {GUID, смещение WEVT} провайдеров; смещения
+  // отсчитываются от начала ресурса
+  const uint32_t provider_count = readLittleEndian<uint32_t>(data, 12);
+  std::optional<uint32_t> provider;
+  for (uint32_t i = 0; i < provider_count && !provider; ++i) {
+    const size_t entry = 16 + size_t{i} * 20;
+    if (!fits(data, entry, 20)) {
+      break;
+    }
+    if (equalsIgnoreCase(formatGuid(data.subspan(entry, 16)), provider_guid)) {
+      provider = readLittleEndian<uint32_t>(data, entry + 16);
+    }
+  }
+  if (!provider || !hasSignature(data, *provider, "WEVT") ||
+      !fits(data, *provider, 20)) {
+    return;
+  }
+
+  // WEVT: дескрипторы {смещение, не используется} элементов манифеста
+  std::map<uint32_t, std::pair<uint8_t, uint32_t>> latest;
+  const uint32_t descriptor_count =
+      readLittleEndian<uint32_t>(data, *provider + 12);
+  for (uint32_t i = 0; i < descriptor_count; ++i) {
+    const size_t descriptor = *provider + 20 + size_t{i} * 8;
+    if (!fits(data, descriptor, 8)) {
+      break;
+    }
+    const uint32_t element = readLittleEndian<uint32_t>(data, descriptor);
+    if (!hasSignature(data, element, "EVNT") || !fits(data, element, 16)) {
+      continue;
+    }
+
+    // EVNT: ID(2), версия(1), канал, уровень, код операции, задача(2),
+    // ключевые слова(8), ID сообщения(4) и смещения описаний
+    const uint32_t event_count =
+        readLittleEndian<uint32_t>(data, element + 8);
+    for (uint32_t j = 0; j < event_count; ++j) {
+      const size_t event = element + 16 + size_t{j} * kEventDefinitionSize;
+      if (!fits(data, event, kEventDefinitionSize)) {
+        break;
+      }
+      const uint32_t message = readLittleEndian<uint32_t>(data, event + 16);
+      if (message == kNoMessage) {
+        continue;
+      }
+      const uint16_t id = readLittleEndian<uint16_t>(data, event);
+      const uint8_t version = data[event + 2];
+      const auto [found, inserted] = latest.try_emplace(id, version, message);
+      if (!inserted && version >= found->second.first) {
+        found->second = {version, message};
+      }
+    }
+  }
+
+  for (const auto& [id, definition] : latest) {
+    events.try_emplace(id, definition.second);
+  }
+}
+
+}
@@ -0,0 +1,82 @@
+/// @file message_resources.hpp
+/// @brief Чтение ресурсов сообщений (MESSAGETABLE, WEVT_TEMPLATE) PE-файлов
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "../common/mapped_file.hpp"
+
+/// @namespace EventLogAnalysis
+/// @brief Пространство имен для работы с журналами событий Windows
+namespace EventLogAnalysis {
+
+/// @brief Шаблоны сообщений по ID
+using MessageTemplates = std::unordered_map<uint32_t, std::string>;
+
+/// @class MessageResourceFile
+/// @brief Ресурсы сообщений файла провайдера событий (DLL, EXE, MUI)
+/// @details Описания событий хранятся не в журнале, а в ресурсах файла
+/// провайдера: таблица MESSAGETABLE содержит шаблоны с подстановками
+/// %1..%n, а WEVT_TEMPLATE (манифест, Vista и новее) сопоставляет ID
+/// событий с ID сообщений. Начиная с Vista таблица сообщений обычно
+/// вынесена в файл локализации MUI, манифест остается в основном файле.
+/// Файл отображается в память, границы всех структур проверяются.
+class MessageResourceFile {
+ public:
+  /// @brief Открывает файл и находит каталог ресурсов
+  /// @param file_path Путь к PE-файлу
+  /// @throws std::runtime_error Если файл не удалось открыть или он не
+  /// является PE-файлом
+  explicit MessageResourceFile(const std::string& file_path);
+
+  /// @brief Проверяет наличие таблицы сообщений
+  [[nodiscard]] bool hasMessageTable() const;
+
+  /// @brief Дописывает шаблоны таблицы сообщений
+  /// @details Уже имеющиеся ID не заменяются; завершающий перевод строки
+  /// шаблона отбрасывается
+  /// @param messages Шаблоны по ID сообщения
+  void readMessages(MessageTemplates& messages) const;
+
+  /// @brief Дописывает ID сообщений событий провайдера из манифеста
+  /// @details Для нескольких версий события берется сообщение старшей
+  /// версии
+  /// @param provider_guid GUID провайдера ("{XXXXXXXX-...}", регистр не
+  /// важен)
+  /// @param events ID сообщения по ID события
+  void readEventMessages(std::string_view provider_guid,
+                         std::unordered_map<uint32_t, uint32_t>& events) const;
+
+ private:
+  /// @brief Находит данные ресурса
+  /// @param type_id Числовой тип ресурса (0 - искать по имени)
+  /// @param type_name Имя типа ресурса
+  /// @return Байты ресурса или nullopt
+  [[nodiscard]] std::optional<std::span<const uint8_t>> findResource(
+      uint32_t type_id, std::string_view type_name) const;
+
+  /// @brief Возвращает первую запись каталога ресурсов
+  /// @details Для каталога языков предпочитается английский (0x409)
+  /// @param directory Смещение каталога в разделе ресурсов
+  /// @param prefer_id Предпочитаемый ID (0 - первая запись)
+  /// @return Смещение данных записи или nullopt
+  [[nodiscard]] std::optional<uint32_t> firstEntry(uint32_t directory,
+                                                   uint32_t prefer_id) const;
+
+  /// @brief Преобразует RVA в смещение в файле
+  [[nodiscard]] std::optional<size_t> rvaToOffset(uint32_t rva) const;
+
+  MappedFile file_;                     ///< Отображение файла
+  std::span<const uint8_t> bytes_;      ///< Содержимое файла
+  std::span<const uint8_t> resources_;  ///< Данные каталога ресурсов
+  size_t section_table_ = 0;            ///< Смещение таблицы разделов
+  uint16_t section_count_ = 0;          ///< Количество разделов
+};
+
+}
@@ -3,10 +3,17 @@
 
 #pragma once
 
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
 #include "../model/event_data.hpp"
+#include "../model/event_id_filter.hpp"
+#include "../model/event_log_query.hpp"
+#include "../model/event_log_summary.hpp"
+#include "../model/event_log_tail.hpp"
+#include "irecord_reader.hpp"
 
 /// @namespace EventLogAnalysis
 /// @brief Пространство имен для работы с журналами событий Windows
@@ -24,6 +31,23 @@ class IEventLogParser {
   /// @return Вектор объектов EventData с разобранными событиями
   virtual std::vector<EventData> parse(const std::string& file_path) = 0;
 
+  /// @brief Потоково обходит записи журнала
+  /// @details Записи передаются обработчику по одной и не накапливаются
+  /// парсером, поэтому пиковое потребление памяти ограничено одной записью
+  /// @param file_path Путь к файлу журнала событий
+  /// @param visitor Обработчик записей (false прекращает обход)
+  /// @return true если журнал обойден полностью, false при досрочной остановке
+  virtual bool forEachRecord(const std::string& file_path,
+                             const EventRecordVisitor& visitor) = 0;
+
+  /// @brief Открывает курсор для построчного чтения записей
+  /// @details Курсор владеет собственным дескриптором файла и не зависит от
+  /// состояния парсера
+  /// @param file_path Путь к файлу журнала событий
+  /// @return Курсор, возвращающий записи по одной
+  virtual std::unique_ptr<IEventRecordReader> openReader(
+      const std::string& file_path) = 0;
+
   /// @brief Фильтрует события по идентификатору
   /// @param file_path Путь к файлу журнала событий
   /// @param event_id Идентификатор события для фильтрации
@@ -31,6 +55,54 @@ class IEventLogParser {
   virtual std::vector<EventData> filterByEventId(const std::string& file_path,
                                                  uint32_t event_id) = 0;
 
+  /// @brief Фильтрует события по множеству идентификаторов за один проход
+  /// @details Идентификатор проверяется до разбора остальных полей записи,
+  /// полностью декодируются только подходящие записи
+  /// @param file_path Путь к файлу журнала событий
+  /// @param event_ids Множество идентификаторов событий
+  /// @return Вектор объектов EventData с подходящими идентификаторами
+  virtual std::vector<EventData> filterByEventIds(
+      const std::string& file_path, const EventIdFilter& event_ids) = 0;
+
+  /// @brief Потоково обходит записи с заданными идентификаторами
+  /// @param file_path Путь к файлу журнала событий
+  /// @param event_ids Множество идентификаторов событий
+  /// @param visitor Обработчик записей (false прекращает обход)
+  /// @return true если журнал обойден полностью, false при досрочной остановке
+  virtual bool forEachRecord(const std::string& file_path,
+                             const EventIdFilter& event_ids,
+                             const EventRecordVisitor& visitor) = 0;
+
+  /// @brief Потоково обходит записи, попадающие в выборку
+  /// @details Окно времени и диапазон номеров проверяются по заголовку записи
+  /// до разбора ее содержимого; записи передаются в порядке номеров
+  /// @param file_path Путь к файлу журнала событий
+  /// @param query Окно времени, диапазон номеров и идентификаторы событий
+  /// @param visitor Обработчик записей (false прекращает обход)
+  /// @return true если выборка обойдена полностью, false при досрочной
+  /// остановке
+  virtual bool queryRecords(const std::string& file_path,
+                            const EventLogQuery& query,
+                            const EventRecordVisitor& visitor) = 0;
+
+  /// @brief Находит запись журнала и контрольную сумму ее блока
+  /// @details Используется для возобновления разбора с контрольной точки:
+  /// совпадение суммы означает, что журнал только дописывался
+  /// @param file_path Путь к файлу журнала событий
+  /// @param record_id Номер записи или EventLogTail::kLastRecord
+  /// @return Положение записи или std::nullopt, если запись не найдена или
+  /// парсер не поддерживает контрольные точки
+  virtual std::optional<EventLogTail> locateRecord(
+      const std::string& file_path, uint64_t record_id) = 0;
+
+  /// @brief Читает сведения о журнале только из заголовка файла
+  /// @details Используется для отбора журналов до разбора: файл не
+  /// отображается в память, читается только блок заголовка
+  /// @param file_path Путь к файлу журнала событий
+  /// @return Сведения или std::nullopt, если заголовок не разобран
+  virtual std::optional<EventLogSummary> readSummary(
+      const std::string& file_path) = 0;
+
   /// @brief Проверяет поддержку формата файла
   /// @param file_path Путь к файлу для проверки
   /// @return true если формат файла поддерживается парсером
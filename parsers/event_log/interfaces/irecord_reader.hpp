@@ -0,0 +1,33 @@
+/// @file irecord_reader.hpp
+/// @brief Интерфейс последовательного чтения записей журнала событий
+
+#pragma once
+
+#include <functional>
+#include <optional>
+
+#include "../model/event_data.hpp"
+
+/// @namespace EventLogAnalysis
+/// @brief Пространство имен для работы с журналами событий Windows
+namespace EventLogAnalysis {
+
+/// @brief Обработчик записей при потоковом обходе журнала
+/// @details Получает очередную запись во владение. Возврат false прекращает
+/// обход журнала.
+using EventRecordVisitor = std::function<bool(EventData&&)>;
+
+/// @class IEventRecordReader
+/// @brief Курсор для построчного (pull) чтения записей журнала
+/// @details В памяти одновременно находится только текущая запись
+class IEventRecordReader {
+ public:
+  /// @brief Виртуальный деструктор по умолчанию
+  virtual ~IEventRecordReader() = default;
+
+  /// @brief Читает следующую запись журнала
+  /// @return Разобранная запись или std::nullopt по достижении конца журнала
+  virtual std::optional<EventData> next() = 0;
+};
+
+}
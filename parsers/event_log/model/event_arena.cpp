@@ -0,0 +1,63 @@
+#include "event_arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+namespace EventLogAnalysis {
+
+EventArena::EventArena(bool share_values)
+    : shared_(share_values ? std::make_unique<SharedValues>() : nullptr) {}
+
+size_t EventArena::allocatedBytes() const noexcept { return allocated_; }
+
+void* EventArena::allocate(size_t size, size_t alignment) {
+  const size_t padding =
+      (alignment - reinterpret_cast<uintptr_t>(cursor_) % alignment) %
+      alignment;
+
+  if (cursor_ == nullptr || padding + size > remaining_) {
+    // Значение крупнее очередного блока (XML записи) получает блок по размеру
+    const size_t block_size = std::max(next_block_size_, size + alignment);
+    blocks_.push_back(std::make_unique_for_overwrite<std::byte[]>(block_size));
+    allocated_ += block_size;
+    next_block_size_ = std::min(next_block_size_ * 2, kMaxBlockSize);
+
+    std::byte* block = blocks_.back().get();
+    const size_t block_padding =
+        (alignment - reinterpret_cast<uintptr_t>(block) % alignment) %
+        alignment;
+    cursor_ = block + block_padding + size;
+    remaining_ = block_size - block_padding - size;
+    return block + block_padding;
+  }
+
+  std::byte* result = cursor_ + padding;
+  cursor_ = result + size;
+  remaining_ -= padding + size;
+  return result;
+}
+
+std::string_view EventArena::store(std::string_view text) {
+  if (text.empty()) return {};
+  if (!shared_ || text.size() > kSharedValueLimit) return copy(text);
+
+  // Вытеснение при коллизии только снижает долю разделенных значений
+  std::string_view& slot =
+      (*shared_)[std::hash<std::string_view>{}(text) % kSharedSlots];
+  if (slot != text) {
+    slot = copy(text);
+  }
+  return slot;
+}
+
+void EventArena::releaseSharing() noexcept { shared_.reset(); }
+
+std::string_view EventArena::copy(std::string_view text) {
+  auto* data = static_cast<char*>(allocate(text.size(), 1));
+  std::memcpy(data, text.data(), text.size());
+  return {data, text.size()};
+}
+
+}
@@ -0,0 +1,75 @@
+/// @file event_arena.hpp
+/// @brief Общее хранилище строк группы событий
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+/// @namespace EventLogAnalysis
+/// @brief Пространство имен для работы с журналами событий Windows
+namespace EventLogAnalysis {
+
+/// @class EventArena
+/// @brief Арена для значений полей группы событий
+/// @details Участки выделяются в блоках возрастающего размера и не
+/// перемещаются до уничтожения арены. Парсер заводит одну арену на пакет
+/// записей (например, блок EVTX); события пакета разделяют владение ею.
+/// Короткие значения внутри пакета сильно повторяются (SID, имена учетных
+/// записей, пути образов, "-" и "0x0"), поэтому арена пакета может хранить
+/// их один раз через небольшой кэш прямого отображения. Запись в арену
+/// выполняет один поток, чтение после передачи событий - любые потоки.
+class EventArena {
+ public:
+  /// @brief Создает пустую арену
+  /// @param share_values Хранить повторяющиеся короткие значения один раз
+  explicit EventArena(bool share_values = false);
+
+  /// @brief Запрет копирования
+  EventArena(const EventArena&) = delete;
+
+  /// @brief Запрет присваивания копированием
+  EventArena& operator=(const EventArena&) = delete;
+
+  /// @brief Выделяет выровненный участок
+  /// @param size Размер участка
+  /// @param alignment Выравнивание (степень двойки)
+  /// @return Участок, действительный до уничтожения арены
+  [[nodiscard]] void* allocate(size_t size, size_t alignment);
+
+  /// @brief Копирует строку в арену
+  /// @details При включенном разделении короткая строка, уже сохраненная
+  /// в арене, повторно не копируется
+  /// @param text Строка
+  /// @return Копия строки, действительная до уничтожения арены
+  [[nodiscard]] std::string_view store(std::string_view text);
+
+  /// @brief Освобождает кэш разделения после заполнения пакета
+  void releaseSharing() noexcept;
+
+  /// @brief Возвращает объем памяти, занятый блоками арены
+  [[nodiscard]] size_t allocatedBytes() const noexcept;
+
+ private:
+  static constexpr size_t kInitialBlockSize = 512;   ///< Первый блок
+  static constexpr size_t kMaxBlockSize = 8 * 1024;  ///< Предел роста блоков
+  static constexpr size_t kSharedValueLimit = 64;  ///< Предел длины значения
+  static constexpr size_t kSharedSlots = 512;      ///< Ячейки кэша
+
+  using SharedValues = std::array<std::string_view, kSharedSlots>;
+
+  /// @brief Копирует строку в арену без поиска в кэше
+  [[nodiscard]] std::string_view copy(std::string_view text);
+
+  std::vector<std::unique_ptr<std::byte[]>> blocks_;  ///< Блоки арены
+  std::byte* cursor_ = nullptr;  ///< Свободное место текущего блока
+  size_t remaining_ = 0;         ///< Остаток текущего блока
+  size_t next_block_size_ = kInitialBlockSize;  ///< Размер следующего блока
+  size_t allocated_ = 0;         ///< Суммарный размер блоков
+  std::unique_ptr<SharedValues> shared_;  ///< Кэш сохраненных значений
+};
+
+}
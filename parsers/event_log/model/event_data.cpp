@@ -8,36 +8,60 @@ uint32_t EventData::getEventId() const noexcept { return event_id_; }
 
 uint64_t EventData::getTimestamp() const noexcept { return timestamp_; }
 
+uint64_t EventData::getRecordId() const noexcept { return record_id_; }
+
 EventLevel EventData::getLevel() const noexcept { return level_; }
 
-const std::string& EventData::getProvider() const noexcept { return provider_; }
+std::string_view EventData::getProvider() const noexcept {
+  return provider_.view();
+}
+
+std::string_view EventData::getComputer() const noexcept {
+  return computer_.view();
+}
 
-const std::string& EventData::getComputer() const noexcept { return computer_; }
+std::string_view EventData::getChannel() const noexcept {
+  return channel_.view();
+}
 
-const std::string& EventData::getChannel() const noexcept { return channel_; }
+std::string_view EventData::getDescription() const noexcept {
+  return extras_ ? extras_->description : std::string_view();
+}
 
-const std::string& EventData::getDescription() const noexcept {
-  return description_;
+std::string_view EventData::getXml() const noexcept {
+  return extras_ ? extras_->xml : std::string_view();
 }
 
-const std::string& EventData::getXml() const noexcept { return xml_; }
+std::string_view EventData::getUserSid() const noexcept {
+  return user_sid_.view();
+}
 
-const std::string& EventData::getUserSid() const noexcept { return user_sid_; }
+std::span<const uint8_t> EventData::getBinaryData() const noexcept {
+  return extras_ ? extras_->binary_data : std::span<const uint8_t>();
+}
 
-const std::vector<uint8_t>& EventData::getBinaryData() const noexcept {
-  return binary_data_;
+std::span<const EventField> EventData::getData() const noexcept {
+  return {fields_, field_count_};
 }
 
-const std::unordered_map<std::string, std::string>& EventData::getData()
-    const noexcept {
-  return data_;
+std::optional<std::string_view> EventData::getDataField(
+    const std::string_view key) const noexcept {
+  for (const auto& field : getData()) {
+    if (field.name.view() == key) {
+      return field.value();
+    }
+  }
+  return std::nullopt;
 }
 
 std::optional<std::string_view> EventData::getDataField(
-    const std::string_view key) const {
-  const auto it = data_.find(std::string(key));
-  return it != data_.end() ? std::make_optional(std::string_view(it->second))
-                           : std::nullopt;
+    const Symbol key) const noexcept {
+  for (const auto& field : getData()) {
+    if (field.name == key) {
+      return field.value();
+    }
+  }
+  return std::nullopt;
 }
 
 std::chrono::system_clock::time_point EventData::getSystemTimepoint()
@@ -65,22 +89,23 @@ bool EventData::isWarning() const noexcept { return is_warning_level(level_); }
 
 bool EventData::isInfo() const noexcept { return is_info_level(level_); }
 
-EventData::EventData(uint32_t event_id, uint64_t timestamp, EventLevel level,
-                     std::string provider, std::string computer,
-                     std::string channel, std::string description,
-                     std::string xml, std::string user_sid,
-                     std::vector<uint8_t> binary_data,
-                     std::unordered_map<std::string, std::string> data)
-    : event_id_(event_id),
-      timestamp_(timestamp),
+EventData::EventData(uint32_t event_id, uint64_t timestamp, uint64_t record_id,
+                     EventLevel level, Symbol provider, Symbol computer,
+                     Symbol channel, Symbol user_sid,
+                     std::span<const EventField> fields,
+                     const EventExtras* extras,
+                     std::shared_ptr<const EventArena> arena) noexcept
+    : timestamp_(timestamp),
+      record_id_(record_id),
+      event_id_(event_id),
       level_(level),
-      provider_(std::move(provider)),
-      computer_(std::move(computer)),
-      channel_(std::move(channel)),
-      description_(std::move(description)),
-      xml_(std::move(xml)),
-      user_sid_(std::move(user_sid)),
-      binary_data_(std::move(binary_data)),
-      data_(std::move(data)) {}
+      provider_(provider),
+      computer_(computer),
+      channel_(channel),
+      user_sid_(user_sid),
+      field_count_(static_cast<uint32_t>(fields.size())),
+      fields_(fields.data()),
+      extras_(extras),
+      arena_(std::move(arena)) {}
 
 }
@@ -4,13 +4,15 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
+#include <memory>
 #include <optional>
-#include <string>
+#include <span>
 #include <string_view>
-#include <unordered_map>
-#include <vector>
 
+#include "event_arena.hpp"
 #include "event_level.hpp"
+#include "symbol.hpp"
 
 /// @namespace EventLogAnalysis
 /// @brief Пространство имен для работы с журналами событий Windows
@@ -18,8 +20,30 @@ namespace EventLogAnalysis {
 
 class EventDataBuilder;
 
+/// @brief Дополнительное поле события (EventData/UserData), 16 байт
+struct EventField {
+  Symbol name;                 ///< Интернированное имя поля
+  uint32_t size = 0;           ///< Длина значения
+  const char* data = nullptr;  ///< Значение в арене события
+
+  /// @brief Возвращает значение поля
+  [[nodiscard]] std::string_view value() const noexcept { return {data, size}; }
+};
+
+/// @brief Редко заполняемые данные события, хранятся в арене при наличии
+struct EventExtras {
+  std::string_view description;         ///< Текстовое описание события
+  std::string_view xml;                 ///< XML-представление события
+  std::span<const uint8_t> binary_data;  ///< Бинарные данные события
+};
+
 /// @class EventData
 /// @brief Неизменяемый контейнер данных события Windows
+/// @details Повторяющиеся строки (провайдер, компьютер, канал, SID, имена
+/// полей) хранятся 32-битными символами общей таблицы. Поля, значения и
+/// редкие данные (описание, XML, бинарные данные) лежат в арене, которую
+/// разделяют события одного пакета; поиск поля идет линейно по плоскому
+/// массиву без построения ключа.
 class EventData {
  public:
   /// @brief Запрет копирования
@@ -46,51 +70,58 @@ class EventData {
   /// года
   [[nodiscard]] uint64_t getTimestamp() const noexcept;
 
+  /// @brief Возвращает номер записи в журнале
+  /// @return EventRecordID (EVTX) или RecordNumber (EVT); 0 - неизвестен
+  [[nodiscard]] uint64_t getRecordId() const noexcept;
+
   /// @brief Возвращает уровень важности события
   /// @return Уровень важности события из перечисления EventLevel
   [[nodiscard]] EventLevel getLevel() const noexcept;
 
   /// @brief Возвращает имя провайдера события
-  /// @return Константная ссылка на строку с именем провайдера (источника)
-  /// события
-  [[nodiscard]] const std::string& getProvider() const noexcept;
+  /// @return Строка с именем провайдера (источника) события
+  [[nodiscard]] std::string_view getProvider() const noexcept;
 
   /// @brief Возвращает имя компьютера
-  /// @return Константная ссылка на строку с именем компьютера, где произошло
-  /// событие
-  [[nodiscard]] const std::string& getComputer() const noexcept;
+  /// @return Строка с именем компьютера, где произошло событие
+  [[nodiscard]] std::string_view getComputer() const noexcept;
 
   /// @brief Возвращает канал журнала событий
-  /// @return Константная ссылка на строку с именем канала журнала событий
-  [[nodiscard]] const std::string& getChannel() const noexcept;
+  /// @return Строка с именем канала журнала событий
+  [[nodiscard]] std::string_view getChannel() const noexcept;
 
   /// @brief Возвращает текстовое описание события
-  /// @return Константная ссылка на строку с текстовым описанием события
-  [[nodiscard]] const std::string& getDescription() const noexcept;
+  /// @return Строка с текстовым описанием события
+  [[nodiscard]] std::string_view getDescription() const noexcept;
 
   /// @brief Возвращает XML-представление события
-  /// @return Константная ссылка на строку с полным XML-представлением события
-  [[nodiscard]] const std::string& getXml() const noexcept;
+  /// @return Строка с полным XML-представлением события
+  [[nodiscard]] std::string_view getXml() const noexcept;
 
   /// @brief Возвращает SID пользователя
-  /// @return Константная ссылка на строку с Security Identifier пользователя
-  [[nodiscard]] const std::string& getUserSid() const noexcept;
+  /// @return Строка с Security Identifier пользователя
+  [[nodiscard]] std::string_view getUserSid() const noexcept;
 
   /// @brief Возвращает бинарные данные события
-  /// @return Константная ссылка на вектор с бинарными данными события
-  [[nodiscard]] const std::vector<uint8_t>& getBinaryData() const noexcept;
+  /// @return Бинарные данные события
+  [[nodiscard]] std::span<const uint8_t> getBinaryData() const noexcept;
 
-  /// @brief Возвращает словарь дополнительных данных
-  /// @return Константная ссылка на словарь с дополнительными параметрами
-  /// события
-  [[nodiscard]] const std::unordered_map<std::string, std::string>& getData()
-      const noexcept;
+  /// @brief Возвращает дополнительные поля события
+  /// @return Поля в порядке следования в записи
+  [[nodiscard]] std::span<const EventField> getData() const noexcept;
 
   /// @brief Ищет дополнительное поле данных по ключу
+  /// @details При повторе имени возвращается первое значение
   /// @param[in] key Ключ для поиска в дополнительных данных
   /// @return Optional с значением поля или std::nullopt если поле не найдено
   [[nodiscard]] std::optional<std::string_view> getDataField(
-      std::string_view key) const;
+      std::string_view key) const noexcept;
+
+  /// @brief Ищет дополнительное поле данных по интернированному ключу
+  /// @param[in] key Символ ключа
+  /// @return Optional с значением поля или std::nullopt если поле не найдено
+  [[nodiscard]] std::optional<std::string_view> getDataField(
+      Symbol key) const noexcept;
 
   /// @brief Преобразует Windows FILETIME в стандартную временную точку
   /// @return Временная точка std::chrono::system_clock
@@ -116,33 +147,33 @@ class EventData {
   /// @brief Приватный конструктор, доступный только для EventDataBuilder
   /// @param[in] event_id Числовой идентификатор события
   /// @param[in] timestamp Временная метка в формате Windows FILETIME
+  /// @param[in] record_id Номер записи в журнале
   /// @param[in] level Уровень важности события
   /// @param[in] provider Имя провайдера (источника) события
   /// @param[in] computer Имя компьютера, где произошло событие
   /// @param[in] channel Канал журнала событий
-  /// @param[in] description Текстовое описание события
-  /// @param[in] xml XML-представление события
   /// @param[in] user_sid SID пользователя
-  /// @param[in] binary_data Бинарные данные события
-  /// @param[in] data Дополнительные параметры события
-  EventData(uint32_t event_id, uint64_t timestamp, EventLevel level,
-            std::string provider, std::string computer, std::string channel,
-            std::string description, std::string xml, std::string user_sid,
-            std::vector<uint8_t> binary_data,
-            std::unordered_map<std::string, std::string> data);
-
-  uint32_t event_id_;        ///< Числовой идентификатор события
-  uint64_t timestamp_;       ///< Временная метка в формате Windows FILETIME
-  EventLevel level_;         ///< Уровень важности события
-  std::string provider_;     ///< Имя провайдера события
-  std::string computer_;     ///< Имя компьютера
-  std::string channel_;      ///< Канал журнала событий
-  std::string description_;  ///< Текстовое описание события
-  std::string xml_;          ///< XML-представление события
-  std::string user_sid_;     ///< SID пользователя
-  std::vector<uint8_t> binary_data_;  ///< Бинарные данные события
-  std::unordered_map<std::string, std::string>
-      data_;  ///< Дополнительные параметры
+  /// @param[in] fields Дополнительные поля в арене
+  /// @param[in] extras Редкие данные в арене или nullptr
+  /// @param[in] arena Арена, владеющая полями и значениями события
+  EventData(uint32_t event_id, uint64_t timestamp, uint64_t record_id,
+            EventLevel level, Symbol provider, Symbol computer,
+            Symbol channel, Symbol user_sid, std::span<const EventField> fields,
+            const EventExtras* extras,
+            std::shared_ptr<const EventArena> arena) noexcept;
+
+  uint64_t timestamp_;  ///< Временная метка в формате Windows FILETIME
+  uint64_t record_id_;  ///< Номер записи в журнале
+  uint32_t event_id_;   ///< Числовой идентификатор события
+  EventLevel level_;    ///< Уровень важности события
+  Symbol provider_;     ///< Имя провайдера события
+  Symbol computer_;     ///< Имя компьютера
+  Symbol channel_;      ///< Канал журнала событий
+  Symbol user_sid_;     ///< SID пользователя
+  uint32_t field_count_;                     ///< Количество полей
+  const EventField* fields_;                 ///< Поля в арене
+  const EventExtras* extras_;                ///< Редкие данные или nullptr
+  std::shared_ptr<const EventArena> arena_;  ///< Владелец полей и значений
 };
 
 }
@@ -1,9 +1,17 @@
 #include "event_data_builder.hpp"
 
+#include <cstring>
+#include <new>
 #include <stdexcept>
 
 namespace EventLogAnalysis {
 
+EventDataBuilder::EventDataBuilder()
+    : EventDataBuilder(std::make_shared<EventArena>()) {}
+
+EventDataBuilder::EventDataBuilder(std::shared_ptr<EventArena> arena)
+    : arena_(std::move(arena)) {}
+
 EventDataBuilder& EventDataBuilder::setEventId(uint32_t id) & noexcept {
   event_id_ = id;
   return *this;
@@ -24,6 +32,17 @@ EventDataBuilder&& EventDataBuilder::setTimestamp(uint64_t timestamp) && noexcep
   return std::move(*this);
 }
 
+EventDataBuilder& EventDataBuilder::setRecordId(uint64_t record_id) & noexcept {
+  record_id_ = record_id;
+  return *this;
+}
+
+EventDataBuilder&& EventDataBuilder::setRecordId(
+    uint64_t record_id) && noexcept {
+  record_id_ = record_id;
+  return std::move(*this);
+}
+
 EventDataBuilder& EventDataBuilder::setLevel(EventLevel level) & noexcept {
   level_ = level;
   return *this;
@@ -34,86 +53,105 @@ EventDataBuilder&& EventDataBuilder::setLevel(EventLevel level) && noexcept {
   return std::move(*this);
 }
 
-EventDataBuilder& EventDataBuilder::setProvider(std::string provider) & {
-  provider_ = std::move(provider);
+EventDataBuilder& EventDataBuilder::setProvider(std::string_view provider) & {
+  provider_ = Symbol::intern(provider);
   return *this;
 }
 
-EventDataBuilder&& EventDataBuilder::setProvider(std::string provider) && {
-  provider_ = std::move(provider);
+EventDataBuilder&& EventDataBuilder::setProvider(std::string_view provider) && {
+  provider_ = Symbol::intern(provider);
   return std::move(*this);
 }
 
-EventDataBuilder& EventDataBuilder::setComputer(std::string computer) & {
-  computer_ = std::move(computer);
+EventDataBuilder& EventDataBuilder::setComputer(std::string_view computer) & {
+  computer_ = Symbol::intern(computer);
   return *this;
 }
 
-EventDataBuilder&& EventDataBuilder::setComputer(std::string computer) && {
-  computer_ = std::move(computer);
+EventDataBuilder&& EventDataBuilder::setComputer(std::string_view computer) && {
+  computer_ = Symbol::intern(computer);
   return std::move(*this);
 }
 
-EventDataBuilder& EventDataBuilder::setChannel(std::string channel) & {
-  channel_ = std::move(channel);
+EventDataBuilder& EventDataBuilder::setChannel(std::string_view channel) & {
+  channel_ = Symbol::intern(channel);
   return *this;
 }
 
-EventDataBuilder&& EventDataBuilder::setChannel(std::string channel) && {
-  channel_ = std::move(channel);
+EventDataBuilder&& EventDataBuilder::setChannel(std::string_view channel) && {
+  channel_ = Symbol::intern(channel);
   return std::move(*this);
 }
 
-EventDataBuilder& EventDataBuilder::setDescription(std::string description) & {
-  description_ = std::move(description);
+EventDataBuilder& EventDataBuilder::setDescription(std::string_view description) & {
+  extras_.description = arena_->store(description);
   return *this;
 }
 
-EventDataBuilder&& EventDataBuilder::setDescription(std::string description) && {
-  description_ = std::move(description);
+EventDataBuilder&& EventDataBuilder::setDescription(std::string_view description) && {
+  extras_.description = arena_->store(description);
   return std::move(*this);
 }
 
-EventDataBuilder& EventDataBuilder::setXml(std::string xml) & {
-  xml_ = std::move(xml);
+EventDataBuilder& EventDataBuilder::setXml(std::string_view xml) & {
+  extras_.xml = arena_->store(xml);
   return *this;
 }
 
-EventDataBuilder&& EventDataBuilder::setXml(std::string xml) && {
-  xml_ = std::move(xml);
+EventDataBuilder&& EventDataBuilder::setXml(std::string_view xml) && {
+  extras_.xml = arena_->store(xml);
   return std::move(*this);
 }
 
-EventDataBuilder& EventDataBuilder::setUserSid(std::string sid) & {
-  user_sid_ = std::move(sid);
+EventDataBuilder& EventDataBuilder::setUserSid(std::string_view sid) & {
+  user_sid_ = Symbol::intern(sid);
   return *this;
 }
 
-EventDataBuilder&& EventDataBuilder::setUserSid(std::string sid) && {
-  user_sid_ = std::move(sid);
+EventDataBuilder&& EventDataBuilder::setUserSid(std::string_view sid) && {
+  user_sid_ = Symbol::intern(sid);
   return std::move(*this);
 }
 
-EventDataBuilder& EventDataBuilder::setBinaryData(std::vector<uint8_t> data) & {
-  binary_data_ = std::move(data);
+EventDataBuilder& EventDataBuilder::setBinaryData(
+    std::span<const uint8_t> data) & {
+  const std::string_view bytes = arena_->store(std::string_view(
+      reinterpret_cast<const char*>(data.data()), data.size()));
+  extras_.binary_data = {reinterpret_cast<const uint8_t*>(bytes.data()),
+                         bytes.size()};
   return *this;
 }
 
-EventDataBuilder&& EventDataBuilder::setBinaryData(std::vector<uint8_t> data) && {
-  binary_data_ = std::move(data);
+EventDataBuilder&& EventDataBuilder::setBinaryData(
+    std::span<const uint8_t> data) && {
+  const std::string_view bytes = arena_->store(std::string_view(
+      reinterpret_cast<const char*>(data.data()), data.size()));
+  extras_.binary_data = {reinterpret_cast<const uint8_t*>(bytes.data()),
+                         bytes.size()};
   return std::move(*this);
 }
 
-EventDataBuilder& EventDataBuilder::addData(std::string key,
-                                             std::string value) & {
-  data_.emplace(std::move(key), std::move(value));
+EventDataBuilder& EventDataBuilder::addData(std::string_view key,
+                                             std::string_view value) & {
+  return addData(Symbol::intern(key), value);
+}
+
+EventDataBuilder&& EventDataBuilder::addData(std::string_view key,
+                                              std::string_view value) && {
+  return std::move(addData(Symbol::intern(key), value));
+}
+
+EventDataBuilder& EventDataBuilder::addData(Symbol key,
+                                             std::string_view value) & {
+  const std::string_view stored = arena_->store(value);
+  data_.push_back(
+      EventField{key, static_cast<uint32_t>(stored.size()), stored.data()});
   return *this;
 }
 
-EventDataBuilder&& EventDataBuilder::addData(std::string key,
-                                              std::string value) && {
-  data_.emplace(std::move(key), std::move(value));
-  return std::move(*this);
+EventDataBuilder&& EventDataBuilder::addData(Symbol key,
+                                              std::string_view value) && {
+  return std::move(addData(key, value));
 }
 
 EventData EventDataBuilder::build() && {
@@ -124,10 +162,25 @@ EventData EventDataBuilder::build() && {
     // throw std::runtime_error("Обязательные поля не заполнены");
   }
 
-  return EventData(
-      event_id_, timestamp_, level_, std::move(provider_), std::move(computer_),
-      std::move(channel_), std::move(description_), std::move(xml_),
-      std::move(user_sid_), std::move(binary_data_), std::move(data_));
+  // Записи полей и редкие данные переносятся в арену: событие не владеет
+  // отдельными буферами
+  EventField* fields = nullptr;
+  if (!data_.empty()) {
+    fields = static_cast<EventField*>(arena_->allocate(
+        data_.size() * sizeof(EventField), alignof(EventField)));
+    std::memcpy(fields, data_.data(), data_.size() * sizeof(EventField));
+  }
+
+  const EventExtras* extras = nullptr;
+  if (!extras_.description.empty() || !extras_.xml.empty() ||
+      !extras_.binary_data.empty()) {
+    extras = new (arena_->allocate(sizeof(EventExtras), alignof(EventExtras)))
+        EventExtras(extras_);
+  }
+
+  return EventData(event_id_, timestamp_, record_id_, level_, provider_,
+                   computer_, channel_, user_sid_, {fields, data_.size()},
+                   extras, std::move(arena_));
 }
 
 bool EventDataBuilder::isValid() const noexcept {
@@ -3,13 +3,16 @@
 
 #pragma once
 
-#include <string>
-#include <unordered_map>
+#include <memory>
+#include <span>
+#include <string_view>
 #include <vector>
 
 #include "../exceptions/exceptions.hpp"
+#include "event_arena.hpp"
 #include "event_data.hpp"
 #include "event_level.hpp"
+#include "symbol.hpp"
 
 /// @namespace EventLogAnalysis
 /// @brief Пространство имен для работы с журналами событий Windows
@@ -17,10 +20,17 @@ namespace EventLogAnalysis {
 
 /// @class EventDataBuilder
 /// @brief Строитель объектов EventData по паттерну "Строитель"
+/// @details Повторяющиеся строки интернируются, остальные значения сразу
+/// копируются в арену; записи полей переносятся в арену при построении.
+/// Построители одного пакета записей могут разделять одну арену.
 class EventDataBuilder {
  public:
-  /// @brief Конструктор по умолчанию
-  EventDataBuilder() = default;
+  /// @brief Конструктор с собственной ареной события
+  EventDataBuilder();
+
+  /// @brief Конструктор с общей ареной пакета записей
+  /// @param arena Арена для значений события
+  explicit EventDataBuilder(std::shared_ptr<EventArena> arena);
 
   /// @brief Деструктор по умолчанию
   ~EventDataBuilder() = default;
@@ -45,6 +55,16 @@ class EventDataBuilder {
   /// @return Rvalue-ссылка на текущий построитель для цепочки вызовов
   EventDataBuilder&& setTimestamp(uint64_t timestamp) && noexcept;
 
+  /// @brief Устанавливает номер записи в журнале (lvalue-версия)
+  /// @param[in] record_id EventRecordID (EVTX) или RecordNumber (EVT)
+  /// @return Ссылка на текущий построитель для цепочки вызовов
+  EventDataBuilder& setRecordId(uint64_t record_id) & noexcept;
+
+  /// @brief Устанавливает номер записи в журнале (rvalue-версия)
+  /// @param[in] record_id EventRecordID (EVTX) или RecordNumber (EVT)
+  /// @return Rvalue-ссылка на текущий построитель для цепочки вызовов
+  EventDataBuilder&& setRecordId(uint64_t record_id) && noexcept;
+
   /// @brief Устанавливает уровень важности события (lvalue-версия)
   /// @param[in] level Уровень важности события
   /// @return Ссылка на текущий построитель для цепочки вызовов
@@ -58,84 +78,96 @@ class EventDataBuilder {
   /// @brief Устанавливает провайдера события (lvalue-версия)
   /// @param[in] provider Имя провайдера события
   /// @return Ссылка на текущий построитель для цепочки вызовов
-  EventDataBuilder& setProvider(std::string provider) &;
+  EventDataBuilder& setProvider(std::string_view provider) &;
 
   /// @brief Устанавливает провайдера события (rvalue-версия)
   /// @param[in] provider Имя провайдера события
   /// @return Rvalue-ссылка на текущий построитель для цепочки вызовов
-  EventDataBuilder&& setProvider(std::string provider) &&;
+  EventDataBuilder&& setProvider(std::string_view provider) &&;
 
   /// @brief Устанавливает имя компьютера (lvalue-версия)
   /// @param[in] computer Имя компьютера
   /// @return Ссылка на текущий построитель для цепочки вызовов
-  EventDataBuilder& setComputer(std::string computer) &;
+  EventDataBuilder& setComputer(std::string_view computer) &;
 
   /// @brief Устанавливает имя компьютера (rvalue-версия)
   /// @param[in] computer Имя компьютера
   /// @return Rvalue-ссылка на текущий построитель для цепочки вызовов
-  EventDataBuilder&& setComputer(std::string computer) &&;
+  EventDataBuilder&& setComputer(std::string_view computer) &&;
 
   /// @brief Устанавливает канал журнала (lvalue-версия)
   /// @param[in] channel Канал журнала событий
   /// @return Ссылка на текущий построитель для цепочки вызовов
-  EventDataBuilder& setChannel(std::string channel) &;
+  EventDataBuilder& setChannel(std::string_view channel) &;
 
   /// @brief Устанавливает канал журнала (rvalue-версия)
   /// @param[in] channel Канал журнала событий
   /// @return Rvalue-ссылка на текущий построитель для цепочки вызовов
-  EventDataBuilder&& setChannel(std::string channel) &&;
+  EventDataBuilder&& setChannel(std::string_view channel) &&;
 
   /// @brief Устанавливает описание события (lvalue-версия)
   /// @param[in] description Текстовое описание события
   /// @return Ссылка на текущий построитель для цепочки вызовов
-  EventDataBuilder& setDescription(std::string description) &;
+  EventDataBuilder& setDescription(std::string_view description) &;
 
   /// @brief Устанавливает описание события (rvalue-версия)
   /// @param[in] description Текстовое описание события
   /// @return Rvalue-ссылка на текущий построитель для цепочки вызовов
-  EventDataBuilder&& setDescription(std::string description) &&;
+  EventDataBuilder&& setDescription(std::string_view description) &&;
 
   /// @brief Устанавливает XML-представление события (lvalue-версия)
   /// @param[in] xml XML-представление события
   /// @return Ссылка на текущий построитель для цепочки вызовов
-  EventDataBuilder& setXml(std::string xml) &;
+  EventDataBuilder& setXml(std::string_view xml) &;
 
   /// @brief Устанавливает XML-представление события (rvalue-версия)
   /// @param[in] xml XML-представление события
   /// @return Rvalue-ссылка на текущий построитель для цепочки вызовов
-  EventDataBuilder&& setXml(std::string xml) &&;
+  EventDataBuilder&& setXml(std::string_view xml) &&;
 
   /// @brief Устанавливает SID пользователя (lvalue-версия)
   /// @param[in] sid SID пользователя
   /// @return Ссылка на текущий построитель для цепочки вызовов
-  EventDataBuilder& setUserSid(std::string sid) &;
+  EventDataBuilder& setUserSid(std::string_view sid) &;
 
   /// @brief Устанавливает SID пользователя (rvalue-версия)
   /// @param[in] sid SID пользователя
   /// @return Rvalue-ссылка на текущий построитель для цепочки вызовов
-  EventDataBuilder&& setUserSid(std::string sid) &&;
+  EventDataBuilder&& setUserSid(std::string_view sid) &&;
 
   /// @brief Устанавливает бинарные данные события (lvalue-версия)
   /// @param[in] data Бинарные данные события
   /// @return Ссылка на текущий построитель для цепочки вызовов
-  EventDataBuilder& setBinaryData(std::vector<uint8_t> data) &;
+  EventDataBuilder& setBinaryData(std::span<const uint8_t> data) &;
 
   /// @brief Устанавливает бинарные данные события (rvalue-версия)
   /// @param[in] data Бинарные данные события
   /// @return Rvalue-ссылка на текущий построитель для цепочки вызовов
-  EventDataBuilder&& setBinaryData(std::vector<uint8_t> data) &&;
+  EventDataBuilder&& setBinaryData(std::span<const uint8_t> data) &&;
 
   /// @brief Добавляет дополнительное поле данных (lvalue-версия)
   /// @param[in] key Ключ дополнительного поля
   /// @param[in] value Значение дополнительного поля
   /// @return Ссылка на текущий построитель для цепочки вызовов
-  EventDataBuilder& addData(std::string key, std::string value) &;
+  EventDataBuilder& addData(std::string_view key, std::string_view value) &;
 
   /// @brief Добавляет дополнительное поле данных (rvalue-версия)
   /// @param[in] key Ключ дополнительного поля
   /// @param[in] value Значение дополнительного поля
   /// @return Rvalue-ссылка на текущий построитель для цепочки вызовов
-  EventDataBuilder&& addData(std::string key, std::string value) &&;
+  EventDataBuilder&& addData(std::string_view key, std::string_view value) &&;
+
+  /// @brief Добавляет поле данных с интернированным ключом (lvalue-версия)
+  /// @param[in] key Символ ключа дополнительного поля
+  /// @param[in] value Значение дополнительного поля
+  /// @return Ссылка на текущий построитель для цепочки вызовов
+  EventDataBuilder& addData(Symbol key, std::string_view value) &;
+
+  /// @brief Добавляет поле данных с интернированным ключом (rvalue-версия)
+  /// @param[in] key Символ ключа дополнительного поля
+  /// @param[in] value Значение дополнительного поля
+  /// @return Rvalue-ссылка на текущий построитель для цепочки вызовов
+  EventDataBuilder&& addData(Symbol key, std::string_view value) &&;
 
   /// @brief Строит итоговый объект EventData
   /// @return Неизменяемый объект EventData
@@ -152,16 +184,15 @@ class EventDataBuilder {
  private:
   uint32_t event_id_ = 0;   ///< Числовой идентификатор события
   uint64_t timestamp_ = 0;  ///< Временная метка в формате Windows FILETIME
+  uint64_t record_id_ = 0;  ///< Номер записи в журнале
   EventLevel level_ = EventLevel::LogAlways;  ///< Уровень важности события
-  std::string provider_;                      ///< Имя провайдера события
-  std::string computer_;                      ///< Имя компьютера
-  std::string channel_;                       ///< Канал журнала событий
-  std::string description_;                   ///< Текстовое описание события
-  std::string xml_;                           ///< XML-представление события
-  std::string user_sid_;                      ///< SID пользователя
-  std::vector<uint8_t> binary_data_;          ///< Бинарные данные события
-  std::unordered_map<std::string, std::string>
-      data_;  ///< Дополнительные параметры
+  Symbol provider_;                           ///< Имя провайдера события
+  Symbol computer_;                           ///< Имя компьютера
+  Symbol channel_;                            ///< Канал журнала событий
+  Symbol user_sid_;                           ///< SID пользователя
+  EventExtras extras_;                        ///< Редкие данные события
+  std::vector<EventField> data_;              ///< Дополнительные параметры
+  std::shared_ptr<EventArena> arena_;         ///< Хранилище события
 };
 
 }
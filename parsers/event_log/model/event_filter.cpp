@@ -0,0 +1,690 @@
+#include "event_filter.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <compare>
+#include <stdexcept>
+
+namespace EventLogAnalysis {
+
+namespace {
+
+constexpr uint64_t kFiletimeEpochDifference = 116444736000000000ULL;
+constexpr uint64_t kTicksPerSecond = 10000000ULL;
+
+char toLowerAscii(char c) noexcept {
+  return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+}
+
+std::string toLower(std::string_view text) {
+  std::string result(text);
+  std::ranges::transform(result, result.begin(), toLowerAscii);
+  return result;
+}
+
+bool equalsIgnoreCase(std::string_view left, std::string_view right) noexcept {
+  return std::ranges::equal(left, right, [](char a, char b) {
+    return toLowerAscii(a) == toLowerAscii(b);
+  });
+}
+
+/// @brief Разбирает десятичное или шестнадцатеричное (0x) число целиком
+std::optional<uint64_t> parseNumber(std::string_view text) noexcept {
+  int base = 10;
+  if (text.size() > 2 && text[0] == '0' &&
+      (text[1] == 'x' || text[1] == 'X')) {
+    text.remove_prefix(2);
+    base = 16;
+  }
+  uint64_t value = 0;
+  const auto [end, error] =
+      std::from_chars(text.data(), text.data() + text.size(), value, base);
+  if (text.empty() || error != std::errc{} ||
+      end != text.data() + text.size()) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+/// @brief Разбирает время "ГГГГ-ММ-ДД[ ЧЧ:ММ:СС][Z]" (UTC) в FILETIME
+std::optional<uint64_t> parseTime(std::string_view text) noexcept {
+  if (!text.empty() && (text.back() == 'Z' || text.back() == 'z')) {
+    text.remove_suffix(1);
+  }
+  if (text.size() != 10 && text.size() != 19) {
+    return std::nullopt;
+  }
+  const auto part = [text](size_t pos, size_t size) -> std::optional<int> {
+    int value = 0;
+    const auto [end, error] =
+        std::from_chars(text.data() + pos, text.data() + pos + size, value);
+    if (error != std::errc{} || end != text.data() + pos + size) {
+      return std::nullopt;
+    }
+    return value;
+  };
+
+  const auto year = part(0, 4);
+  const auto month = part(5, 2);
+  const auto day = part(8, 2);
+  if (!year || !month || !day || text[4] != '-' || text[7] != '-') {
+    return std::nullopt;
+  }
+  const std::chrono::year_month_day date{
+      std::chrono::year(*year),
+      std::chrono::month(static_cast<unsigned>(*month)),
+      std::chrono::day(static_cast<unsigned>(*day))};
+  if (!date.ok()) {
+    return std::nullopt;
+  }
+
+  const std::chrono::sys_seconds midnight = std::chrono::sys_days(date);
+  int64_t seconds = midnight.time_since_epoch().count();
+  if (text.size() == 19) {
+    const auto hours = part(11, 2);
+    const auto minutes = part(14, 2);
+    const auto secs = part(17, 2);
+    if ((text[10] != ' ' && text[10] != 'T' && text[10] != 't') ||
+        text[13] != ':' || text[16] != ':' || !hours || !minutes || !secs ||
+        *hours > 23 || *minutes > 59 || *secs > 59) {
+      return std::nullopt;
+    }
+    seconds += *hours * 3600 + *minutes * 60 + *secs;
+  }
+
+  const int64_t ticks = seconds * static_cast<int64_t>(kTicksPerSecond) +
+                        static_cast<int64_t>(kFiletimeEpochDifference);
+  if (ticks < 0) {
+    return std::nullopt;
+  }
+  return static_cast<uint64_t>(ticks);
+}
+
+/// @brief Возвращает номер уровня по имени
+std::optional<uint64_t> parseLevel(std::string_view name) noexcept {
+  for (int level = 0; level <= static_cast<int>(EventLevel::Verbose);
+       ++level) {
+    if (equalsIgnoreCase(name, to_string(static_cast<EventLevel>(level)))) {
+      return static_cast<uint64_t>(level);
+    }
+  }
+  return std::nullopt;
+}
+
+bool isNumericField(EventFilterField field) noexcept {
+  return field == EventFilterField::EventId ||
+         field == EventFilterField::Time || field == EventFilterField::Level;
+}
+
+/// @brief Стоимость получения значения поля
+uint8_t fieldCost(EventFilterField field) noexcept {
+  switch (field) {
+    case EventFilterField::EventId:
+    case EventFilterField::Time:
+    case EventFilterField::Level:
+      return 0;
+    case EventFilterField::Provider:
+    case EventFilterField::Computer:
+    case EventFilterField::Channel:
+    case EventFilterField::UserSid:
+      return 1;
+    case EventFilterField::Description:
+      return 2;
+    case EventFilterField::Data:
+      break;
+  }
+  return 3;
+}
+
+/// @brief Лексема выражения
+struct Token {
+  enum class Kind : uint8_t {
+    End,
+    Identifier,
+    Number,
+    String,
+    And,
+    Or,
+    Not,
+    LeftParen,
+    RightParen,
+    Comma,
+    Compare,
+  };
+
+  Kind kind = Kind::End;                    ///< Вид лексемы
+  std::string_view text;                    ///< Исходный текст лексемы
+  std::string value;                        ///< Значение строки
+  EventFilterOp op = EventFilterOp::Equal;  ///< Операция сравнения
+  size_t position = 0;                      ///< Позиция в выражении
+};
+
+/// @brief Рекурсивный спуск по выражению фильтра
+class FilterParser {
+ public:
+  explicit FilterParser(std::string_view expression) : text_(expression) {
+    advance();
+  }
+
+  EventFilterNode parse() {
+    EventFilterNode node = parseOr();
+    if (token_.kind != Token::Kind::End) {
+      fail("лишние символы после выражения");
+    }
+    return node;
+  }
+
+ private:
+  EventFilterNode parseOr() {
+    return parseChain(Token::Kind::Or, EventFilterNode::Kind::Or,
+                      &FilterParser::parseAnd);
+  }
+
+  EventFilterNode parseAnd() {
+    return parseChain(Token::Kind::And, EventFilterNode::Kind::And,
+                      &FilterParser::parseUnary);
+  }
+
+  /// @brief Разбирает цепочку операндов одного логического оператора
+  EventFilterNode parseChain(Token::Kind separator, EventFilterNode::Kind kind,
+                             EventFilterNode (FilterParser::*operand)()) {
+    EventFilterNode first = (this->*operand)();
+    if (token_.kind != separator) {
+      return first;
+    }
+
+    EventFilterNode node;
+    node.kind = kind;
+    node.children.push_back(std::move(first));
+    while (token_.kind == separator) {
+      advance();
+      node.children.push_back((this->*operand)());
+    }
+
+    // Операнды без побочных эффектов переставляются: дешевые проверки
+    // отсекают запись раньше дорогих
+    std::ranges::stable_sort(node.children, {}, &EventFilterNode::cost);
+    node.cost = node.children.back().cost;
+    return node;
+  }
+
+  EventFilterNode parseUnary() {
+    if (token_.kind == Token::Kind::Not) {
+      advance();
+      EventFilterNode node;
+      node.kind = EventFilterNode::Kind::Not;
+      node.children.push_back(parseUnary());
+      node.cost = node.children.front().cost;
+      return node;
+    }
+    if (token_.kind == Token::Kind::LeftParen) {
+      advance();
+      EventFilterNode node = parseOr();
+      expect(Token::Kind::RightParen, "ожидалась \")\"");
+      return node;
+    }
+    return parseComparison();
+  }
+
+  EventFilterNode parseComparison() {
+    if (token_.kind != Token::Kind::Identifier) {
+      fail("ожидалось имя поля");
+    }
+
+    EventFilterNode node;
+    node.kind = EventFilterNode::Kind::Compare;
+    resolveField(token_.text, node);
+    node.cost = fieldCost(node.field);
+    advance();
+
+    if (token_.kind == Token::Kind::Compare) {
+      node.op = token_.op;
+    } else if (token_.kind == Token::Kind::Identifier &&
+               equalsIgnoreCase(token_.text, "in")) {
+      node.op = EventFilterOp::In;
+    } else if (token_.kind == Token::Kind::Identifier &&
+               equalsIgnoreCase(token_.text, "contains")) {
+      node.op = EventFilterOp::Contains;
+    } else if (token_.kind == Token::Kind::Identifier &&
+               equalsIgnoreCase(token_.text, "startswith")) {
+      node.op = EventFilterOp::StartsWith;
+    } else if (token_.kind == Token::Kind::Identifier &&
+               equalsIgnoreCase(token_.text, "endswith")) {
+      node.op = EventFilterOp::EndsWith;
+    } else {
+      fail("ожидалась операция сравнения");
+    }
+    const bool substring = node.op == EventFilterOp::Contains ||
+                           node.op == EventFilterOp::StartsWith ||
+                           node.op == EventFilterOp::EndsWith;
+    if (substring && isNumericField(node.field)) {
+      fail("операция над строками применена к числовому полю");
+    }
+    advance();
+
+    if (node.op == EventFilterOp::In) {
+      expect(Token::Kind::LeftParen, "ожидалась \"(\" после in");
+      node.literals.push_back(parseLiteral(node.field));
+      while (token_.kind == Token::Kind::Comma) {
+        advance();
+        node.literals.push_back(parseLiteral(node.field));
+      }
+      expect(Token::Kind::RightParen, "ожидалась \")\"");
+    } else {
+      node.literals.push_back(parseLiteral(node.field));
+    }
+    return node;
+  }
+
+  void resolveField(std::string_view name, EventFilterNode& node) {
+    constexpr std::string_view kDataPrefix = "data.";
+    if (name.size() > kDataPrefix.size() &&
+        equalsIgnoreCase(name.substr(0, kDataPrefix.size()), kDataPrefix)) {
+      node.field = EventFilterField::Data;
+      node.data_name = Symbol::intern(name.substr(kDataPrefix.size()));
+      return;
+    }
+
+    static constexpr std::pair<std::string_view, EventFilterField> kFields[] = {
+        {"eventid", EventFilterField::EventId},
+        {"time", EventFilterField::Time},
+        {"timecreated", EventFilterField::Time},
+        {"level", EventFilterField::Level},
+        {"provider", EventFilterField::Provider},
+        {"computer", EventFilterField::Computer},
+        {"channel", EventFilterField::Channel},
+        {"usersid", EventFilterField::UserSid},
+        {"description", EventFilterField::Description},
+    };
+    for (const auto& [field_name, field] : kFields) {
+      if (equalsIgnoreCase(name, field_name)) {
+        node.field = field;
+        return;
+      }
+    }
+    fail("неизвестное поле \"" + std::string(name) + "\"");
+  }
+
+  EventFilterLiteral parseLiteral(EventFilterField field) {
+    EventFilterLiteral literal;
+    if (token_.kind == Token::Kind::Number) {
+      literal.text = toLower(token_.text);
+      literal.number = parseNumber(token_.text);
+      if (!literal.number) {
+        fail("некорректное число");
+      }
+    } else if (token_.kind == Token::Kind::String) {
+      literal.text = toLower(token_.value);
+      if (field == EventFilterField::Time) {
+        literal.number = parseTime(token_.value);
+        if (!literal.number) {
+          fail("некорректное время, ожидалось \"ГГГГ-ММ-ДД ЧЧ:ММ:СС\"");
+        }
+      } else if (field == EventFilterField::Level) {
+        literal.number = parseLevel(token_.value);
+        if (!literal.number) {
+          fail("неизвестный уровень \"" + token_.value + "\"");
+        }
+      } else if (isNumericField(field)) {
+        fail("ожидалось число");
+      }
+    } else {
+      fail("ожидалось значение");
+    }
+    advance();
+    return literal;
+  }
+
+  void expect(Token::Kind kind, std::string_view message) {
+    if (token_.kind != kind) {
+      fail(message);
+    }
+    advance();
+  }
+
+  /// @brief Читает следующую лексему
+  void advance() {
+    while (pos_ < text_.size() &&
+           std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+      pos_++;
+    }
+
+    token_ = Token{};
+    token_.position = pos_;
+    if (pos_ == text_.size()) {
+      return;
+    }
+
+    const char c = text_[pos_];
+    const char next = pos_ + 1 < text_.size() ? text_[pos_ + 1] : '\0';
+    const auto symbol = [this](Token::Kind kind, size_t size,
+                               EventFilterOp op = EventFilterOp::Equal) {
+      token_.kind = kind;
+      token_.op = op;
+      token_.text = text_.substr(pos_, size);
+      pos_ += size;
+    };
+
+    if (c == '&' && next == '&') return symbol(Token::Kind::And, 2);
+    if (c == '|' && next == '|') return symbol(Token::Kind::Or, 2);
+    if (c == '=' && next == '=') {
+      return symbol(Token::Kind::Compare, 2, EventFilterOp::Equal);
+    }
+    if (c == '!' && next == '=') {
+      return symbol(Token::Kind::Compare, 2, EventFilterOp::NotEqual);
+    }
+    if (c == '<' && next == '=') {
+      return symbol(Token::Kind::Compare, 2, EventFilterOp::LessEqual);
+    }
+    if (c == '>' && next == '=') {
+      return symbol(Token::Kind::Compare, 2, EventFilterOp::GreaterEqual);
+    }
+    if (c == '<') return symbol(Token::Kind::Compare, 1, EventFilterOp::Less);
+    if (c == '>') {
+      return symbol(Token::Kind::Compare, 1, EventFilterOp::Greater);
+    }
+    if (c == '!') return symbol(Token::Kind::Not, 1);
+    if (c == '(') return symbol(Token::Kind::LeftParen, 1);
+    if (c == ')') return symbol(Token::Kind::RightParen, 1);
+    if (c == ',') return symbol(Token::Kind::Comma, 1);
+
+    if (c == '"') {
+      token_.kind = Token::Kind::String;
+      for (pos_++; pos_ < text_.size() && text_[pos_] != '"'; pos_++) {
+        if (text_[pos_] == '\\' && pos_ + 1 < text_.size()) {
+          pos_++;
+        }
+        token_.value += text_[pos_];
+      }
+      if (pos_ == text_.size()) {
+        fail("незакрытая строка");
+      }
+      pos_++;
+      return;
+    }
+
+    const auto is_word = [](char ch) {
+      return std::isalnum(static_cast<unsigned char>(ch)) || ch == '_' ||
+             ch == '.' || ch == '-';
+    };
+    if (std::isalnum(static_cast<unsigned char>(c)) || c == '_') {
+      const size_t begin = pos_;
+      while (pos_ < text_.size() && is_word(text_[pos_])) pos_++;
+      token_.text = text_.substr(begin, pos_ - begin);
+      token_.kind = std::isdigit(static_cast<unsigned char>(c))
+                        ? Token::Kind::Number
+                        : Token::Kind::Identifier;
+      return;
+    }
+
+    fail("неожиданный символ");
+  }
+
+  [[noreturn]] void fail(std::string_view message) const {
+    throw std::runtime_error("Ошибка в фильтре событий (позиция " +
+                             std::to_string(token_.position + 1) +
+                             "): " + std::string(message));
+  }
+
+  std::string_view text_;  ///< Текст выражения
+  size_t pos_ = 0;         ///< Позиция чтения
+  Token token_;            ///< Текущая лексема
+};
+
+/// @brief Ограничения, которым обязано удовлетворять подходящее событие
+struct FilterBounds {
+  std::optional<EventIdFilter> event_ids;  ///< Множество ID (nullopt - все)
+  uint64_t time_from = 0;                  ///< Начало окна времени
+  uint64_t time_to = std::numeric_limits<uint64_t>::max();  ///< Конец окна
+};
+
+/// @brief Выводит ограничения по ID и времени из дерева
+/// @details Вывод консервативен: ограничение может быть шире выражения, но
+/// никогда не отбрасывает подходящее событие
+FilterBounds deriveBounds(const EventFilterNode& node) {
+  FilterBounds bounds;
+  switch (node.kind) {
+    case EventFilterNode::Kind::Not:
+      break;
+
+    case EventFilterNode::Kind::And:
+      for (const auto& child : node.children) {
+        FilterBounds other = deriveBounds(child);
+        bounds.time_from = std::max(bounds.time_from, other.time_from);
+        bounds.time_to = std::min(bounds.time_to, other.time_to);
+        if (!other.event_ids) continue;
+        if (!bounds.event_ids) {
+          bounds.event_ids = std::move(other.event_ids);
+          continue;
+        }
+        EventIdFilter both;
+        for (const uint32_t id : bounds.event_ids->values()) {
+          if (other.event_ids->contains(id)) both.add(id);
+        }
+        bounds.event_ids = std::move(both);
+      }
+      break;
+
+    case EventFilterNode::Kind::Or: {
+      bounds.time_from = std::numeric_limits<uint64_t>::max();
+      bounds.time_to = 0;
+      bounds.event_ids.emplace();
+      for (const auto& child : node.children) {
+        const FilterBounds other = deriveBounds(child);
+        bounds.time_from = std::min(bounds.time_from, other.time_from);
+        bounds.time_to = std::max(bounds.time_to, other.time_to);
+        if (!other.event_ids) {
+          bounds.event_ids.reset();
+        } else if (bounds.event_ids) {
+          bounds.event_ids->merge(*other.event_ids);
+        }
+      }
+      break;
+    }
+
+    case EventFilterNode::Kind::Compare:
+      if (node.field == EventFilterField::EventId &&
+          (node.op == EventFilterOp::Equal || node.op == EventFilterOp::In)) {
+        bounds.event_ids.emplace();
+        for (const auto& literal : node.literals) {
+          if (*literal.number <= std::numeric_limits<uint32_t>::max()) {
+            bounds.event_ids->add(static_cast<uint32_t>(*literal.number));
+          }
+        }
+      } else if (node.field == EventFilterField::Time) {
+        const uint64_t value = *node.literals.front().number;
+        switch (node.op) {
+          case EventFilterOp::Equal:
+            bounds.time_from = bounds.time_to = value;
+            break;
+          case EventFilterOp::In:
+            bounds.time_from = *std::ranges::min(
+                node.literals, {}, &EventFilterLiteral::number).number;
+            bounds.time_to = *std::ranges::max(
+                node.literals, {}, &EventFilterLiteral::number).number;
+            break;
+          // Строгие границы на краю диапазона дают пустое окно
+          case EventFilterOp::Greater:
+            if (value == std::numeric_limits<uint64_t>::max()) {
+              bounds.time_from = value;
+              bounds.time_to = value - 1;
+            } else {
+              bounds.time_from = value + 1;
+            }
+            break;
+          case EventFilterOp::GreaterEqual:
+            bounds.time_from = value;
+            break;
+          case EventFilterOp::Less:
+            bounds.time_from = value == 0 ? 1 : 0;
+            bounds.time_to = value == 0 ? 0 : value - 1;
+            break;
+          case EventFilterOp::LessEqual:
+            bounds.time_to = value;
+            break;
+          default:
+            break;
+        }
+      }
+      break;
+  }
+  return bounds;
+}
+
+/// @brief Применяет операцию порядка к результату сравнения
+template <typename Ordering>
+bool ordered(EventFilterOp op, Ordering order) noexcept {
+  switch (op) {
+    case EventFilterOp::Equal:
+    case EventFilterOp::In:
+      return order == 0;
+    case EventFilterOp::NotEqual:
+      return order != 0;
+    case EventFilterOp::Less:
+      return order < 0;
+    case EventFilterOp::LessEqual:
+      return order <= 0;
+    case EventFilterOp::Greater:
+      return order > 0;
+    case EventFilterOp::GreaterEqual:
+      return order >= 0;
+    default:
+      return false;
+  }
+}
+
+/// @brief Сравнивает значение поля с литералом без учета регистра
+/// @details Если литерал числовой и значение поля разбирается как число,
+/// сравниваются числа
+std::weak_ordering compareText(std::string_view value,
+                               const EventFilterLiteral& literal) noexcept {
+  if (literal.number) {
+    if (const auto number = parseNumber(value)) {
+      return *number <=> *literal.number;
+    }
+  }
+  return std::lexicographical_compare_three_way(
+      value.begin(), value.end(), literal.text.begin(), literal.text.end(),
+      [](char a, char b) { return toLowerAscii(a) <=> b; });
+}
+
+}
+
+EventFilter EventFilter::compile(std::string_view expression) {
+  EventFilter filter;
+  filter.expression_ = std::string(expression);
+  filter.root_ = FilterParser(filter.expression_).parse();
+
+  FilterBounds bounds = deriveBounds(filter.root_);
+  filter.event_ids_ = std::move(bounds.event_ids);
+  filter.time_from_ = bounds.time_from;
+  filter.time_to_ = bounds.time_to;
+  return filter;
+}
+
+bool EventFilter::matches(const EventData& event) const {
+  return evaluate(root_, event);
+}
+
+const std::string& EventFilter::expression() const noexcept {
+  return expression_;
+}
+
+const EventIdFilter* EventFilter::eventIds() const noexcept {
+  return event_ids_ ? &*event_ids_ : nullptr;
+}
+
+uint64_t EventFilter::timeFrom() const noexcept { return time_from_; }
+
+uint64_t EventFilter::timeTo() const noexcept { return time_to_; }
+
+bool EventFilter::evaluate(const EventFilterNode& node,
+                           const EventData& event) {
+  switch (node.kind) {
+    case EventFilterNode::Kind::And:
+      return std::ranges::all_of(node.children, [&event](const auto& child) {
+        return evaluate(child, event);
+      });
+    case EventFilterNode::Kind::Or:
+      return std::ranges::any_of(node.children, [&event](const auto& child) {
+        return evaluate(child, event);
+      });
+    case EventFilterNode::Kind::Not:
+      return !evaluate(node.children.front(), event);
+    case EventFilterNode::Kind::Compare:
+      break;
+  }
+  return compare(node, event);
+}
+
+bool EventFilter::compare(const EventFilterNode& node,
+                          const EventData& event) {
+  if (isNumericField(node.field)) {
+    uint64_t value = 0;
+    switch (node.field) {
+      case EventFilterField::EventId:
+        value = event.getEventId();
+        break;
+      case EventFilterField::Time:
+        value = event.getTimestamp();
+        break;
+      default:
+        value = static_cast<uint64_t>(event.getLevel());
+        break;
+    }
+    if (node.op == EventFilterOp::In) {
+      return std::ranges::any_of(node.literals, [value](const auto& literal) {
+        return value == *literal.number;
+      });
+    }
+    return ordered(node.op, value <=> *node.literals.front().number);
+  }
+
+  // Поле Data ищется только при вычислении узла
+  std::string_view value;
+  switch (node.field) {
+    case EventFilterField::Provider:
+      value = event.getProvider();
+      break;
+    case EventFilterField::Computer:
+      value = event.getComputer();
+      break;
+    case EventFilterField::Channel:
+      value = event.getChannel();
+      break;
+    case EventFilterField::UserSid:
+      value = event.getUserSid();
+      break;
+    case EventFilterField::Description:
+      value = event.getDescription();
+      break;
+    default:
+      value = event.getDataField(node.data_name).value_or(std::string_view{});
+      break;
+  }
+
+  const auto same = [](char a, char b) { return toLowerAscii(a) == b; };
+  const std::string& needle = node.literals.front().text;
+  switch (node.op) {
+    case EventFilterOp::Contains:
+      return !std::ranges::search(value, needle, same).empty() ||
+             needle.empty();
+    case EventFilterOp::StartsWith:
+      return value.size() >= needle.size() &&
+             std::ranges::equal(value.substr(0, needle.size()), needle, same);
+    case EventFilterOp::EndsWith:
+      return value.size() >= needle.size() &&
+             std::ranges::equal(value.substr(value.size() - needle.size()),
+                                needle, same);
+    case EventFilterOp::In:
+      return std::ranges::any_of(node.literals, [value](const auto& literal) {
+        return compareText(value, literal) == 0;
+      });
+    default:
+      return ordered(node.op, compareText(value, node.literals.front()));
+  }
+}
+
+}
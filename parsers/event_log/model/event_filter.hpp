@@ -0,0 +1,137 @@
+/// @file event_filter.hpp
+/// @brief Скомпилированные выражения фильтра событий
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "event_data.hpp"
+#include "event_id_filter.hpp"
+#include "symbol.hpp"
+
+/// @namespace EventLogAnalysis
+/// @brief Пространство имен для работы с журналами событий Windows
+namespace EventLogAnalysis {
+
+/// @brief Поле события в выражении фильтра
+enum class EventFilterField : uint8_t {
+  EventId,      ///< EventID
+  Time,         ///< Time, TimeCreated (FILETIME)
+  Level,        ///< Level (число или имя уровня)
+  Provider,     ///< Provider
+  Computer,     ///< Computer
+  Channel,      ///< Channel
+  UserSid,      ///< UserSid
+  Description,  ///< Description
+  Data,         ///< Data.<Имя> - поле EventData/UserData
+};
+
+/// @brief Операция сравнения в выражении фильтра
+enum class EventFilterOp : uint8_t {
+  Equal,         ///< ==
+  NotEqual,      ///< !=
+  Less,          ///< <
+  LessEqual,     ///< <=
+  Greater,       ///< >
+  GreaterEqual,  ///< >=
+  In,            ///< in (a, b, ...)
+  Contains,      ///< contains
+  StartsWith,    ///< startswith
+  EndsWith,      ///< endswith
+};
+
+/// @brief Значение-литерал выражения фильтра
+struct EventFilterLiteral {
+  std::string text;               ///< Текст в нижнем регистре
+  std::optional<uint64_t> number;  ///< Числовое значение, если есть
+};
+
+/// @brief Узел дерева выражения фильтра
+struct EventFilterNode {
+  /// @brief Вид узла
+  enum class Kind : uint8_t { And, Or, Not, Compare };
+
+  Kind kind = Kind::Compare;                     ///< Вид узла
+  EventFilterField field = EventFilterField::EventId;  ///< Поле сравнения
+  EventFilterOp op = EventFilterOp::Equal;       ///< Операция сравнения
+  Symbol data_name;                              ///< Имя поля Data.<Имя>
+  std::vector<EventFilterLiteral> literals;      ///< Правые части сравнения
+  std::vector<EventFilterNode> children;         ///< Операнды And/Or/Not
+  uint8_t cost = 0;                              ///< Стоимость вычисления
+};
+
+/// @class EventFilter
+/// @brief Выражение фильтра, скомпилированное в дерево предикатов
+/// @details Грамматика:
+/// @code
+///   expr    := and ('||' and)*
+///   and     := unary ('&&' unary)*
+///   unary   := '!' unary | '(' expr ')' | field op value
+///            | field 'in' '(' value (',' value)* ')'
+///   op      := == | != | < | <= | > | >= | contains | startswith | endswith
+///   field   := EventID | Time | Level | Provider | Computer | Channel
+///            | UserSid | Description | Data.<Имя>
+///   value   := число | 0xHEX | "строка"
+/// @endcode
+/// Имена полей и операций не зависят от регистра, кроме имени после
+/// "Data.". Строки сравниваются без учета регистра ASCII; отсутствующее
+/// поле Data считается пустой строкой. Время задается FILETIME или строкой
+/// "ГГГГ-ММ-ДД[ ЧЧ:ММ:СС]" в UTC, уровень - числом или именем (Error,
+/// Warning, ...).
+///
+/// Операнды && и || при компиляции упорядочиваются по стоимости: сначала
+/// проверяются поля заголовка (ID, время, уровень), затем символы
+/// провайдера, компьютера и канала, в последнюю очередь описание и поля
+/// Data, которые ищутся только при вычислении своего узла. Из выражения
+/// выводятся множество ID и окно времени, которым обязано удовлетворять
+/// подходящее событие; парсеры проверяют их по заголовку записи до ее
+/// декодирования (см. EventLogQuery::setFilter).
+class EventFilter {
+ public:
+  /// @brief Компилирует выражение
+  /// @param expression Текст выражения
+  /// @return Скомпилированный фильтр
+  /// @throws std::runtime_error При синтаксической ошибке
+  [[nodiscard]] static EventFilter compile(std::string_view expression);
+
+  /// @brief Проверяет событие
+  /// @param event Разобранное событие
+  /// @return true если событие удовлетворяет выражению
+  [[nodiscard]] bool matches(const EventData& event) const;
+
+  /// @brief Возвращает текст выражения
+  [[nodiscard]] const std::string& expression() const noexcept;
+
+  /// @brief Возвращает ID, которыми ограничено выражение
+  /// @return Множество ID или nullptr, если выражение их не ограничивает
+  [[nodiscard]] const EventIdFilter* eventIds() const noexcept;
+
+  /// @brief Возвращает начало окна времени, выведенного из выражения
+  [[nodiscard]] uint64_t timeFrom() const noexcept;
+
+  /// @brief Возвращает конец окна времени, выведенного из выражения
+  [[nodiscard]] uint64_t timeTo() const noexcept;
+
+ private:
+  /// @brief Вычисляет узел
+  [[nodiscard]] static bool evaluate(const EventFilterNode& node,
+                                     const EventData& event);
+
+  /// @brief Вычисляет сравнение
+  [[nodiscard]] static bool compare(const EventFilterNode& node,
+                                    const EventData& event);
+
+  std::string expression_;                ///< Текст выражения
+  EventFilterNode root_;                  ///< Корень дерева предикатов
+  std::optional<EventIdFilter> event_ids_;  ///< Выведенное множество ID
+  uint64_t time_from_ = 0;                ///< Выведенное начало окна
+  uint64_t time_to_ =
+      std::numeric_limits<uint64_t>::max();  ///< Выведенный конец окна
+};
+
+}
@@ -0,0 +1,97 @@
+#include "event_id_filter.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace EventLogAnalysis {
+
+EventIdFilter::EventIdFilter(std::initializer_list<uint32_t> ids) {
+  for (const uint32_t id : ids) {
+    add(id);
+  }
+}
+
+EventIdFilter::EventIdFilter(const std::vector<uint32_t>& ids) {
+  for (const uint32_t id : ids) {
+    add(id);
+  }
+}
+
+void EventIdFilter::add(uint32_t id) {
+  if (contains(id)) {
+    return;
+  }
+
+  if (!bitmap_.empty() && id < kBitmapRange) {
+    bitmap_[id / kWordBits] |= uint64_t{1} << (id % kWordBits);
+    bitmap_count_++;
+    return;
+  }
+
+  sorted_ids_.insert(std::ranges::lower_bound(sorted_ids_, id), id);
+
+  if (bitmap_.empty() && sorted_ids_.size() > kSortedSetLimit) {
+    promoteToBitmap();
+  }
+}
+
+void EventIdFilter::merge(const EventIdFilter& other) {
+  for (const uint32_t id : other.values()) {
+    add(id);
+  }
+}
+
+bool EventIdFilter::contains(uint32_t id) const noexcept {
+  if (!bitmap_.empty() && id < kBitmapRange) {
+    return (bitmap_[id / kWordBits] >> (id % kWordBits)) & 1U;
+  }
+
+  // Для малого множества линейный проход дешевле двоичного поиска
+  if (sorted_ids_.size() <= kSortedSetLimit) {
+    for (const uint32_t value : sorted_ids_) {
+      if (value >= id) {
+        return value == id;
+      }
+    }
+    return false;
+  }
+
+  return std::ranges::binary_search(sorted_ids_, id);
+}
+
+bool EventIdFilter::empty() const noexcept { return size() == 0; }
+
+size_t EventIdFilter::size() const noexcept {
+  return sorted_ids_.size() + bitmap_count_;
+}
+
+std::vector<uint32_t> EventIdFilter::values() const {
+  std::vector<uint32_t> result;
+  result.reserve(size());
+
+  if (!bitmap_.empty()) {
+    for (size_t word = 0; word < bitmap_.size(); ++word) {
+      for (uint64_t bits = bitmap_[word]; bits != 0; bits &= bits - 1) {
+        const auto bit = static_cast<uint32_t>(std::countr_zero(bits));
+        result.push_back(static_cast<uint32_t>(word * kWordBits) + bit);
+      }
+    }
+  }
+
+  // В векторе после переноса остаются только ID вне диапазона карты
+  result.insert(result.end(), sorted_ids_.begin(), sorted_ids_.end());
+  return result;
+}
+
+void EventIdFilter::promoteToBitmap() {
+  bitmap_.assign(kBitmapRange / kWordBits, 0);
+
+  const auto first_large = std::ranges::lower_bound(sorted_ids_, kBitmapRange);
+  for (auto it = sorted_ids_.begin(); it != first_large; ++it) {
+    bitmap_[*it / kWordBits] |= uint64_t{1} << (*it % kWordBits);
+    bitmap_count_++;
+  }
+  sorted_ids_.erase(sorted_ids_.begin(), first_large);
+}
+
+}
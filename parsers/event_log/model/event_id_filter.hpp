@@ -0,0 +1,74 @@
+/// @file event_id_filter.hpp
+/// @brief Множество идентификаторов событий для фильтрации при чтении журнала
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+/// @namespace EventLogAnalysis
+/// @brief Пространство имен для работы с журналами событий Windows
+namespace EventLogAnalysis {
+
+/// @class EventIdFilter
+/// @brief Множество ID событий с проверкой принадлежности за O(1)
+/// @details Пока идентификаторов немного, они хранятся в отсортированном
+/// векторе. При превышении порога 16-битные ID переносятся в битовую карту
+/// на 64K бит. ID больше 0xFFFF (EVT-идентификаторы с квалификаторами) всегда
+/// остаются в отсортированном векторе.
+class EventIdFilter {
+ public:
+  /// @brief Создает пустое множество
+  EventIdFilter() = default;
+
+  /// @brief Создает множество из списка идентификаторов
+  /// @param ids Идентификаторы событий
+  EventIdFilter(std::initializer_list<uint32_t> ids);
+
+  /// @brief Создает множество из вектора идентификаторов
+  /// @param ids Идентификаторы событий
+  explicit EventIdFilter(const std::vector<uint32_t>& ids);
+
+  /// @brief Добавляет идентификатор в множество
+  /// @param id Идентификатор события
+  void add(uint32_t id);
+
+  /// @brief Добавляет все идентификаторы другого множества
+  /// @param other Множество идентификаторов
+  void merge(const EventIdFilter& other);
+
+  /// @brief Проверяет принадлежность идентификатора множеству
+  /// @param id Идентификатор события
+  /// @return true если идентификатор входит в множество
+  [[nodiscard]] bool contains(uint32_t id) const noexcept;
+
+  /// @brief Проверяет, пусто ли множество
+  /// @return true если множество не содержит идентификаторов
+  [[nodiscard]] bool empty() const noexcept;
+
+  /// @brief Возвращает количество идентификаторов
+  /// @return Размер множества
+  [[nodiscard]] size_t size() const noexcept;
+
+  /// @brief Возвращает идентификаторы в порядке возрастания
+  /// @return Вектор идентификаторов
+  [[nodiscard]] std::vector<uint32_t> values() const;
+
+ private:
+  static constexpr size_t kSortedSetLimit =
+      16;  ///< Порог перехода на битовую карту
+  static constexpr uint32_t kBitmapRange =
+      0x10000;  ///< Диапазон ID, хранимых в битовой карте
+  static constexpr size_t kWordBits = 64;  ///< Разрядность слова карты
+
+  /// @brief Переносит 16-битные ID из вектора в битовую карту
+  void promoteToBitmap();
+
+  std::vector<uint32_t> sorted_ids_;  ///< Отсортированные ID (малое множество)
+  std::vector<uint64_t> bitmap_;      ///< Битовая карта ID (пуста до переноса)
+  size_t bitmap_count_ = 0;           ///< Количество ID в битовой карте
+};
+
+}
@@ -0,0 +1,50 @@
+#include "event_log_query.hpp"
+
+#include <algorithm>
+
+namespace EventLogAnalysis {
+
+bool EventLogQuery::hasTimeWindow() const noexcept {
+  return time_from != 0 || time_to != kUnbounded;
+}
+
+bool EventLogQuery::hasRecordRange() const noexcept {
+  return record_from != 0 || record_to != kUnbounded;
+}
+
+bool EventLogQuery::matches(uint64_t record_id,
+                            uint64_t written_time) const noexcept {
+  return record_id >= record_from && record_id <= record_to &&
+         written_time >= time_from && written_time <= time_to;
+}
+
+const EventIdFilter* EventLogQuery::eventIds() const noexcept {
+  return event_ids ? &*event_ids : nullptr;
+}
+
+void EventLogQuery::setFilter(std::shared_ptr<const EventFilter> expression) {
+  filter = std::move(expression);
+  if (!filter) {
+    return;
+  }
+
+  time_from = std::max(time_from, filter->timeFrom());
+  time_to = std::min(time_to, filter->timeTo());
+  if (const EventIdFilter* ids = filter->eventIds()) {
+    if (!event_ids) {
+      event_ids = *ids;
+      return;
+    }
+    EventIdFilter both;
+    for (const uint32_t id : event_ids->values()) {
+      if (ids->contains(id)) both.add(id);
+    }
+    event_ids = std::move(both);
+  }
+}
+
+bool EventLogQuery::accepts(const EventData& event) const {
+  return !filter || filter->matches(event);
+}
+
+}
@@ -0,0 +1,66 @@
+/// @file event_log_query.hpp
+/// @brief Параметры выборки записей журнала по времени и номерам записей
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+
+#include "event_data.hpp"
+#include "event_filter.hpp"
+#include "event_id_filter.hpp"
+
+/// @namespace EventLogAnalysis
+/// @brief Пространство имен для работы с журналами событий Windows
+namespace EventLogAnalysis {
+
+/// @struct EventLogQuery
+/// @brief Выборка записей журнала
+/// @details Все границы включительные. Значения по умолчанию не ограничивают
+/// выборку. Парсеры проверяют окно времени и диапазон номеров по заголовку
+/// записи до разбора ее содержимого, а EVTX дополнительно отбрасывает целые
+/// блоки по их заголовкам. Выражение фильтра проверяется после декодирования
+/// записи, до передачи события обработчику.
+struct EventLogQuery {
+  static constexpr uint64_t kUnbounded =
+      std::numeric_limits<uint64_t>::max();  ///< Отсутствие верхней границы
+
+  uint64_t time_from = 0;            ///< Начало окна времени (FILETIME)
+  uint64_t time_to = kUnbounded;     ///< Конец окна времени (FILETIME)
+  uint64_t record_from = 0;          ///< Первый номер записи
+  uint64_t record_to = kUnbounded;   ///< Последний номер записи
+  std::optional<EventIdFilter> event_ids;  ///< ID событий (nullopt - все)
+  std::shared_ptr<const EventFilter> filter;  ///< Выражение (nullptr - нет)
+
+  /// @brief Задает выражение фильтра
+  /// @details Выведенные из выражения ID и окно времени сужают выборку,
+  /// чтобы парсер отбросил неподходящие записи по заголовку
+  /// @param expression Скомпилированное выражение
+  void setFilter(std::shared_ptr<const EventFilter> expression);
+
+  /// @brief Проверяет наличие ограничения по времени
+  [[nodiscard]] bool hasTimeWindow() const noexcept;
+
+  /// @brief Проверяет наличие ограничения по номерам записей
+  [[nodiscard]] bool hasRecordRange() const noexcept;
+
+  /// @brief Проверяет попадание записи в окно времени и диапазон номеров
+  /// @param record_id Номер записи
+  /// @param written_time Время записи (FILETIME)
+  /// @return true если запись удовлетворяет выборке
+  [[nodiscard]] bool matches(uint64_t record_id,
+                             uint64_t written_time) const noexcept;
+
+  /// @brief Возвращает фильтр идентификаторов для парсера
+  /// @return Указатель на фильтр или nullptr, если ID не ограничены
+  [[nodiscard]] const EventIdFilter* eventIds() const noexcept;
+
+  /// @brief Проверяет декодированное событие выражением фильтра
+  /// @param event Событие
+  /// @return true если выражение не задано или событие ему удовлетворяет
+  [[nodiscard]] bool accepts(const EventData& event) const;
+};
+
+}
@@ -0,0 +1,27 @@
+/// @file event_log_summary.hpp
+/// @brief Сведения о журнале из заголовка файла
+
+#pragma once
+
+#include <cstdint>
+
+/// @namespace EventLogAnalysis
+/// @brief Пространство имен для работы с журналами событий Windows
+namespace EventLogAnalysis {
+
+/// @struct EventLogSummary
+/// @brief Сведения о журнале, прочитанные только из заголовка файла
+/// @details Заголовок обновляется при закрытии журнала, поэтому у
+/// "грязного" файла или файла с поврежденным заголовком счетчик может
+/// отставать от записанных записей
+struct EventLogSummary {
+  uint64_t record_count = 0;  ///< Количество записей по заголовку
+  bool dirty = false;         ///< Заголовку нельзя доверять
+
+  /// @brief Проверяет, что журнал заведомо не содержит записей
+  [[nodiscard]] bool empty() const noexcept {
+    return !dirty && record_count == 0;
+  }
+};
+
+}
@@ -0,0 +1,31 @@
+/// @file event_log_tail.hpp
+/// @brief Положение записи журнала для возобновления разбора
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+/// @namespace EventLogAnalysis
+/// @brief Пространство имен для работы с журналами событий Windows
+namespace EventLogAnalysis {
+
+/// @struct EventLogTail
+/// @brief Запись журнала, ее смещение и контрольная сумма ее блока
+/// @details Контрольная сумма покрывает данные блока от начала области
+/// записей до конца записи включительно: дозапись журнала ее не меняет, а
+/// очистка или перезапись журнала - меняет. Положения равны, только если
+/// запись с тем же номером лежит по тому же смещению с тем же содержимым
+struct EventLogTail {
+  static constexpr uint64_t kLastRecord =
+      std::numeric_limits<uint64_t>::max();  ///< Запрос последней записи
+
+  uint64_t record_id = 0;  ///< Номер записи
+  uint64_t offset = 0;     ///< Смещение записи в файле
+  uint32_t checksum = 0;   ///< CRC-32 блока до конца записи
+
+  /// @brief Сравнивает положения
+  bool operator==(const EventLogTail&) const = default;
+};
+
+}
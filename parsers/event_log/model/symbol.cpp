@@ -0,0 +1,106 @@
+#include "symbol.hpp"
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace EventLogAnalysis {
+
+namespace {
+
+constexpr size_t kSegmentBits = 12;
+constexpr size_t kSegmentSize = size_t{1} << kSegmentBits;
+constexpr size_t kMaxSegments = 4096;
+
+/// @brief Общая таблица интернированных строк
+/// @details Номера разрешаются в строки без блокировки: сегменты
+/// представлений публикуются атомарно и после записи не изменяются
+struct SymbolTable {
+  std::shared_mutex mutex;         ///< Защита словаря и хранилища
+  std::deque<std::string> strings;  ///< Строки (адреса стабильны)
+  std::unordered_map<std::string_view, uint32_t> ids;  ///< Строка -> номер
+  std::array<std::atomic<std::string_view*>, kMaxSegments>
+      segments{};  ///< Представления строк по номерам
+  std::deque<std::unique_ptr<std::string_view[]>>
+      owned;  ///< Память опубликованных сегментов
+};
+
+SymbolTable& symbolTable() {
+  static SymbolTable table;
+  return table;
+}
+
+uint32_t internShared(std::string_view text) {
+  SymbolTable& table = symbolTable();
+  {
+    std::shared_lock lock(table.mutex);
+    if (const auto it = table.ids.find(text); it != table.ids.end()) {
+      return it->second;
+    }
+  }
+
+  std::unique_lock lock(table.mutex);
+  if (const auto it = table.ids.find(text); it != table.ids.end()) {
+    return it->second;
+  }
+
+  // Номер 0 зарезервирован за пустой строкой
+  const size_t id = table.strings.size() + 1;
+  const size_t segment = id >> kSegmentBits;
+  if (segment >= kMaxSegments) {
+    throw std::length_error("Переполнена таблица интернированных строк");
+  }
+  if (table.segments[segment].load(std::memory_order_relaxed) == nullptr) {
+    table.owned.push_back(std::make_unique<std::string_view[]>(kSegmentSize));
+    table.segments[segment].store(table.owned.back().get(),
+                                  std::memory_order_release);
+  }
+
+  const std::string& stored = table.strings.emplace_back(text);
+  std::string_view* views =
+      table.segments[segment].load(std::memory_order_relaxed);
+  views[id & (kSegmentSize - 1)] = stored;
+  table.ids.emplace(stored, static_cast<uint32_t>(id));
+  return static_cast<uint32_t>(id);
+}
+
+}
+
+Symbol Symbol::intern(std::string_view text) {
+  if (text.empty()) {
+    return {};
+  }
+
+  // Локальный кеш потока снимает обращения к общей блокировке для уже
+  // встречавшихся строк; ключи ссылаются на строки таблицы
+  thread_local std::unordered_map<std::string_view, uint32_t> cache;
+  if (const auto it = cache.find(text); it != cache.end()) {
+    return Symbol(it->second);
+  }
+
+  const Symbol symbol(internShared(text));
+  cache.emplace(symbol.view(), symbol.id_);
+  return symbol;
+}
+
+std::string_view Symbol::view() const noexcept {
+  if (id_ == 0) {
+    return {};
+  }
+  const std::string_view* segment =
+      symbolTable().segments[id_ >> kSegmentBits].load(
+          std::memory_order_acquire);
+  return segment[id_ & (kSegmentSize - 1)];
+}
+
+bool Symbol::empty() const noexcept { return id_ == 0; }
+
+Symbol::Symbol(uint32_t id) noexcept : id_(id) {}
+
+}
@@ -0,0 +1,47 @@
+/// @file symbol.hpp
+/// @brief Интернированные строки журналов событий
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+/// @namespace EventLogAnalysis
+/// @brief Пространство имен для работы с журналами событий Windows
+namespace EventLogAnalysis {
+
+/// @class Symbol
+/// @brief Номер строки в общей таблице интернирования
+/// @details Провайдеры, каналы, имена компьютеров, SID и имена полей
+/// повторяются в миллионах записей, поэтому хранятся в таблице один раз на
+/// процесс, а события хранят 32-битный номер. Равные строки дают равные
+/// символы. Таблица потокобезопасна, строки живут до завершения процесса,
+/// поэтому интернировать следует только значения из ограниченного множества.
+class Symbol {
+ public:
+  /// @brief Создает пустой символ
+  Symbol() = default;
+
+  /// @brief Возвращает символ строки, добавляя ее в таблицу при отсутствии
+  /// @param text Строка
+  /// @return Символ строки (пустой для пустой строки)
+  /// @throws std::length_error Если таблица переполнена
+  [[nodiscard]] static Symbol intern(std::string_view text);
+
+  /// @brief Возвращает текст символа
+  [[nodiscard]] std::string_view view() const noexcept;
+
+  /// @brief Проверяет, пуст ли символ
+  [[nodiscard]] bool empty() const noexcept;
+
+  /// @brief Сравнивает символы по номерам
+  bool operator==(const Symbol&) const = default;
+
+ private:
+  /// @brief Создает символ по номеру в таблице
+  explicit Symbol(uint32_t id) noexcept;
+
+  uint32_t id_ = 0;  ///< Номер строки в таблице (0 - пустая строка)
+};
+
+}
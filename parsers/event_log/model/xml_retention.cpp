@@ -0,0 +1,44 @@
+#include "xml_retention.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+namespace EventLogAnalysis {
+
+namespace {
+
+bool equalsIgnoreCase(std::string_view left, std::string_view right) noexcept {
+  return std::ranges::equal(left, right, [](char a, char b) {
+    return std::tolower(static_cast<unsigned char>(a)) ==
+           std::tolower(static_cast<unsigned char>(b));
+  });
+}
+
+}
+
+bool XmlRetention::enabled() const noexcept {
+  return mode == XmlRetentionMode::Always ||
+         (mode == XmlRetentionMode::MatchingIds && !event_ids.empty());
+}
+
+bool XmlRetention::keeps(uint32_t event_id) const noexcept {
+  switch (mode) {
+    case XmlRetentionMode::Always:
+      return true;
+    case XmlRetentionMode::MatchingIds:
+      return event_ids.contains(event_id);
+    case XmlRetentionMode::Never:
+      break;
+  }
+  return false;
+}
+
+std::optional<XmlRetentionMode> XmlRetention::parseMode(
+    std::string_view name) noexcept {
+  if (equalsIgnoreCase(name, "never")) return XmlRetentionMode::Never;
+  if (equalsIgnoreCase(name, "always")) return XmlRetentionMode::Always;
+  if (equalsIgnoreCase(name, "matching")) return XmlRetentionMode::MatchingIds;
+  return std::nullopt;
+}
+
+}
@@ -0,0 +1,48 @@
+/// @file xml_retention.hpp
+/// @brief Политика сохранения XML-представления событий
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "event_id_filter.hpp"
+
+/// @namespace EventLogAnalysis
+/// @brief Пространство имен для работы с журналами событий Windows
+namespace EventLogAnalysis {
+
+/// @brief Режим сохранения XML в EventData
+enum class XmlRetentionMode {
+  Never,        ///< XML не сохраняется
+  Always,       ///< XML сохраняется для всех событий
+  MatchingIds,  ///< XML сохраняется только для заданных ID событий
+};
+
+/// @struct XmlRetention
+/// @brief Политика сохранения XML-представления записей
+/// @details Структурированные поля извлекаются всегда; XML удваивает память
+/// события, поэтому по умолчанию не сохраняется. Буфер рендеринга XML
+/// переиспользуется между записями и в событие не передается, если запись
+/// не подходит под политику.
+struct XmlRetention {
+  XmlRetentionMode mode = XmlRetentionMode::Never;  ///< Режим сохранения
+  EventIdFilter event_ids;  ///< ID событий для режима MatchingIds
+
+  /// @brief Проверяет, сохраняется ли XML хотя бы для части событий
+  [[nodiscard]] bool enabled() const noexcept;
+
+  /// @brief Проверяет, сохраняется ли XML события
+  /// @param event_id Идентификатор события
+  /// @return true если XML события нужно сохранить
+  [[nodiscard]] bool keeps(uint32_t event_id) const noexcept;
+
+  /// @brief Разбирает имя режима из конфигурации
+  /// @param name "never", "always" или "matching" (без учета регистра)
+  /// @return Режим или std::nullopt для неизвестного имени
+  [[nodiscard]] static std::optional<XmlRetentionMode> parseMode(
+      std::string_view name) noexcept;
+};
+
+}
@@ -0,0 +1,128 @@
+/// @file binxml_test.cpp
+/// @brief Проверки BinXmlDecoder на поврежденных экземплярах шаблонов
+/// @details Экземпляр шаблона с определением inline и пустым телом
+/// собирается в синтетическом блоке; массив подстановок записи задается
+/// тестом. Поврежденная запись должна отклоняться исключением
+/// std::runtime_error без выделения памяти по прочитанному количеству.
+
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <initializer_list>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "../parsers/event_log/formats/evtx/binxml.hpp"
+
+namespace {
+
+using namespace EventLogAnalysis;
+
+constexpr uint32_t kRecordOffset = 0x200;  ///< Начало записи в блоке
+constexpr size_t kChunkSize = 0x10000;     ///< Размер блока EVTX
+
+/// @brief Обработчик, принимающий любые события разбора
+class NullHandler final : public IBinXmlHandler {
+ public:
+  bool startElement(std::string_view) override { return true; }
+  bool attribute(std::string_view, const BinXmlValue&) override {
+    return true;
+  }
+  bool closeStartElement() override { return true; }
+  bool text(const BinXmlValue&) override { return true; }
+  bool endElement() override { return true; }
+};
+
+/// @brief Синтетический блок с одной записью
+struct Record {
+  std::vector<uint8_t> chunk = std::vector<uint8_t>(kChunkSize);
+  uint32_t size = 0;  ///< Размер записи
+
+  void put(std::initializer_list<uint8_t> bytes) {
+    for (const uint8_t byte : bytes) chunk[kRecordOffset + size++] = byte;
+  }
+
+  void put32(uint32_t value) {
+    std::memcpy(&chunk[kRecordOffset + size], &value, sizeof(value));
+    size += sizeof(value);
+  }
+};
+
+/// @brief Собирает запись: заголовок фрагмента, экземпляр шаблона с
+/// определением inline (тело - один токен EOF) и количество подстановок
+Record templateInstance(uint32_t count) {
+  Record record;
+  record.put({0x0F, 0x01, 0x01, 0x00});  // заголовок фрагмента
+  record.put({0x0C, 0x01});              // экземпляр шаблона
+  record.put32(1);                       // ID шаблона
+  record.put32(kRecordOffset + record.size + 4);  // определение inline
+  record.put32(0);                                // следующий шаблон
+  for (int i = 0; i < 16; ++i) record.put({0});   // GUID
+  record.put32(1);                                // размер тела
+  record.put({0x00});                             // тело: EOF
+  record.put32(count);
+  return record;
+}
+
+/// @brief Декодирует запись
+/// @return true если запись разобрана, false если отклонена как
+/// поврежденная
+bool decode(const Record& record) {
+  BinXmlDecoder decoder(record.chunk);
+  NullHandler handler;
+  try {
+    return decoder.decode(kRecordOffset, record.size, handler);
+  } catch (const std::runtime_error&) {
+    return false;
+  }
+}
+
+int failures = 0;
+
+void check(bool condition, std::string_view name) {
+  if (!condition) {
+    std::cerr << "FAIL: " << name << "\n";
+    failures++;
+  }
+}
+
+}
+
+int main() {
+  try {
+    // Корректная запись: одна подстановка String из 2 байт
+    Record valid = templateInstance(1);
+    valid.put({0x02, 0x00, 0x01, 0x00});  // дескриптор: размер 2, String
+    valid.put({'A', 0x00});
+    valid.put({0x00});  // EOF
+    check(decode(valid), "корректный экземпляр шаблона");
+
+    // Количество, при котором count * 4 переполняет uint32_t
+    Record wrapped = templateInstance(0x40000001);
+    wrapped.put({0x02, 0x00, 0x01, 0x00, 'A', 0x00, 0x00});
+    check(!decode(wrapped), "переполнение count * 4");
+
+    // Огромное количество подстановок
+    Record huge = templateInstance(0xFFFFFFFF);
+    huge.put({0x00, 0x00, 0x00, 0x00});
+    check(!decode(huge), "огромное количество подстановок");
+
+    // Дескрипторов меньше, чем заявлено
+    Record truncated = templateInstance(3);
+    truncated.put({0x02, 0x00, 0x01, 0x00, 0x02, 0x00, 0x01, 0x00});
+    check(!decode(truncated), "усеченный массив дескрипторов");
+
+    // Значения выходят за границы записи
+    Record overrun = templateInstance(1);
+    overrun.put({0xFF, 0xFF, 0x01, 0x00, 'A', 0x00});
+    check(!decode(overrun), "значение за границей записи");
+  } catch (const std::bad_alloc&) {
+    std::cerr << "FAIL: выделение памяти по количеству из записи\n";
+    return 1;
+  }
+
+  return failures == 0 ? 0 : 1;
+}
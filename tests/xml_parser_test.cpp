@@ -0,0 +1,49 @@
+/// @file xml_parser_test.cpp
+/// @brief Проверки декодирования сущностей XmlEventParser::appendDecoded
+/// @details Известные и числовые сущности заменяются символами, '&' без
+/// сущности в окне поиска копируется как есть.
+
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "../parsers/event_log/formats/common/xml_parser.hpp"
+
+namespace {
+
+using EventLogAnalysis::XmlEventParser;
+
+int failures = 0;
+
+void check(std::string_view text, std::string_view expected) {
+  std::string decoded;
+  XmlEventParser::appendDecoded(decoded, text);
+  if (decoded != expected) {
+    std::cerr << "FAIL: \"" << text << "\" -> \"" << decoded
+              << "\", ожидалось \"" << expected << "\"\n";
+    failures++;
+  }
+}
+
+}
+
+int main() {
+  check("a &amp; b &lt;c&gt; &quot;d&quot; &apos;e&apos;",
+        "a & b <c> \"d\" 'e'");
+  check("&#65;&#x42;&#X43;", "ABC");
+  check("&#x10FFFF;", "\xF4\x8F\xBF\xBF");
+  check("a & b", "a & b");
+  check("&&amp;", "&&");
+  check("&unknown;", "&unknown;");
+  check("&", "&");
+
+  // ';' дальше окна поиска не относится к '&'
+  check("& 123456789;", "& 123456789;");
+  check("&#0000000065;", "&#0000000065;");
+
+  // Много одиночных '&' и ';' в конце значения
+  const std::string ampersands(100000, '&');
+  check(ampersands + ";", ampersands + ";");
+
+  return failures == 0 ? 0 : 1;
+}
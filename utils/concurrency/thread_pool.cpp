@@ -0,0 +1,60 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t thread_count) {
+  if (thread_count == 0) {
+    thread_count = std::max<size_t>(1, std::thread::hardware_concurrency());
+  }
+
+  workers_.reserve(thread_count);
+  for (size_t i = 0; i < thread_count; ++i) {
+    workers_.emplace_back([this]() { workerLoop(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard lock(mutex_);
+    stopping_ = true;
+  }
+  condition_.notify_all();
+
+  for (auto& worker : workers_) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+}
+
+size_t ThreadPool::size() const noexcept { return workers_.size(); }
+
+size_t ThreadPool::resolveThreadCount(size_t requested,
+                                      size_t task_count) noexcept {
+  size_t count = requested;
+  if (count == 0) {
+    count = std::max<size_t>(1, std::thread::hardware_concurrency());
+  }
+  return std::clamp<size_t>(count, 1, std::max<size_t>(1, task_count));
+}
+
+void ThreadPool::workerLoop() {
+  while (true) {
+    std::function<void()> task;
+
+    {
+      std::unique_lock lock(mutex_);
+      condition_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+
+      // Очередь дорабатывается до конца даже после запроса остановки
+      if (tasks_.empty()) {
+        return;
+      }
+
+      task = std::move(tasks_.front());
+      tasks_.pop();
+    }
+
+    task();
+  }
+}
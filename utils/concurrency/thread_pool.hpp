@@ -0,0 +1,82 @@
+/// @file thread_pool.hpp
+/// @brief Пул рабочих потоков фиксированного размера
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// @class ThreadPool
+/// @brief Пул потоков с общей очередью задач
+/// @details Задачи выполняются в порядке постановки в очередь. Результат
+/// (или исключение) задачи возвращается через std::future.
+class ThreadPool {
+ public:
+  /// @brief Конструктор пула
+  /// @param thread_count Количество рабочих потоков (0 - по числу ядер)
+  explicit ThreadPool(size_t thread_count = 0);
+
+  /// @brief Деструктор, дожидается выполнения всех поставленных задач
+  ~ThreadPool();
+
+  /// @brief Конструктор копирования (запрещен)
+  ThreadPool(const ThreadPool&) = delete;
+
+  /// @brief Оператор присваивания копированием (запрещен)
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /// @brief Ставит задачу в очередь
+  /// @param task Вызываемый объект без аргументов
+  /// @return Future с результатом выполнения задачи
+  /// @throws std::runtime_error Если пул уже остановлен
+  template <typename F>
+  auto submit(F&& task) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+    using Result = std::invoke_result_t<std::decay_t<F>>;
+
+    auto packaged = std::make_shared<std::packaged_task<Result()>>(
+        std::forward<F>(task));
+    std::future<Result> future = packaged->get_future();
+
+    {
+      std::lock_guard lock(mutex_);
+      if (stopping_) {
+        throw std::runtime_error("Пул потоков остановлен");
+      }
+      tasks_.emplace([packaged]() { (*packaged)(); });
+    }
+    condition_.notify_one();
+
+    return future;
+  }
+
+  /// @brief Возвращает количество рабочих потоков
+  /// @return Количество потоков в пуле
+  [[nodiscard]] size_t size() const noexcept;
+
+  /// @brief Определяет разумное количество потоков для задачи
+  /// @param requested Запрошенное количество (0 - по числу ядер)
+  /// @param task_count Количество независимых задач
+  /// @return Количество потоков в диапазоне [1, task_count]
+  [[nodiscard]] static size_t resolveThreadCount(size_t requested,
+                                                 size_t task_count) noexcept;
+
+ private:
+  /// @brief Основной цикл рабочего потока
+  void workerLoop();
+
+  std::vector<std::thread> workers_;         ///< Рабочие потоки
+  std::queue<std::function<void()>> tasks_;  ///< Очередь задач
+  std::mutex mutex_;                         ///< Мьютекс очереди
+  std::condition_variable condition_;  ///< Сигнал о появлении задач
+  bool stopping_ = false;              ///< Флаг остановки пула
+};
@@ -27,6 +27,10 @@ struct AggregatedData {
   std::set<std::string> versions;
   std::set<std::string> hashes;
   std::set<uint64_t> file_sizes;  // Размеры файлов
+  std::set<std::string> logon_sessions;  // Сеансы входа запусков
+  WindowsDiskAnalysis::SysmonActivity sysmon;  // Активность по Sysmon
+  std::set<std::string> loaded_modules;
+  std::set<std::string> dns_names;
   bool has_deleted_trace = false;
 };
 
@@ -106,7 +110,9 @@ void CSVExporter::exportToCSV(
     file << "ИсполняемыйФайл,Версии,Хэши,РазмерФайла,ВременаЗапуска,"
             "Автозагрузка,"
          << "КоличествоЗапусков,"
-         << "Тома(серийный:тип),СетевыеПодключения,ФайловыеМетрики\n";
+         << "Тома(серийный:тип),СетевыеПодключения,ФайловыеМетрики,"
+         << "СеансыВхода,ЗагруженныеМодули,DNSЗапросы,АктивностьSysmon,"
+         << "СобытияSysmon\n";
 
     // Основная карта для агрегации данных по имени файла
     std::map<std::string, AggregatedData> aggregated_data;
@@ -137,6 +143,29 @@ void CSVExporter::exportToCSV(
                             info.volumes.end());
         data.metrics.insert(data.metrics.end(), info.metrics.begin(),
                             info.metrics.end());
+        data.logon_sessions.insert(info.logon_sessions.begin(),
+                                   info.logon_sessions.end());
+
+        const auto& sysmon = info.sysmon;
+        data.hashes.insert(sysmon.hashes.begin(), sysmon.hashes.end());
+        data.loaded_modules.insert(sysmon.loaded_modules.begin(),
+                                   sysmon.loaded_modules.end());
+        data.dns_names.insert(sysmon.dns_names.begin(),
+                              sysmon.dns_names.end());
+        data.sysmon.event_count += sysmon.event_count;
+        data.sysmon.image_loads += sysmon.image_loads;
+        data.sysmon.file_creates += sysmon.file_creates;
+        data.sysmon.registry_sets += sysmon.registry_sets;
+        data.sysmon.dns_queries += sysmon.dns_queries;
+        if (!sysmon.first_seen.empty() &&
+            (data.sysmon.first_seen.empty() ||
+             sysmon.first_seen < data.sysmon.first_seen)) {
+          data.sysmon.first_seen = sysmon.first_seen;
+        }
+        data.sysmon.last_seen =
+            std::max(data.sysmon.last_seen, sysmon.last_seen);
+        data.sysmon.events.insert(data.sysmon.events.end(),
+                                  sysmon.events.begin(), sysmon.events.end());
     }
 
     // 3. Обрабатываем сетевые подключения
@@ -252,6 +281,10 @@ void CSVExporter::exportToCSV(
         std::stringstream ss;
         ss << conn.protocol << ":" << conn.local_address << "->"
            << conn.remote_address << ":" << conn.port;
+        if (conn.event_count > 0) {
+          ss << " x" << conn.event_count << " (" << conn.first_seen << " - "
+             << conn.last_seen << ")";
+        }
         network_str += ss.str();
       }
 
@@ -273,12 +306,53 @@ void CSVExporter::exportToCSV(
         metrics_str += metric_filename;
       }
 
+      // Форматирование сеансов входа
+      std::string sessions_str;
+      for (const auto& session : data.logon_sessions) {
+        if (!sessions_str.empty()) sessions_str += ";";
+        sessions_str += session;
+      }
+
+      // Форматирование данных Sysmon
+      std::string modules_str;
+      for (const auto& module : data.loaded_modules) {
+        if (!modules_str.empty()) modules_str += ";";
+        modules_str += module;
+      }
+
+      std::string dns_str;
+      for (const auto& name : data.dns_names) {
+        if (!dns_str.empty()) dns_str += ";";
+        dns_str += name;
+      }
+
+      std::string sysmon_str;
+      if (data.sysmon.event_count > 0) {
+        std::stringstream ss;
+        ss << "события:" << data.sysmon.event_count
+           << ";модули:" << data.sysmon.image_loads
+           << ";файлы:" << data.sysmon.file_creates
+           << ";реестр:" << data.sysmon.registry_sets
+           << ";DNS:" << data.sysmon.dns_queries << " ("
+           << data.sysmon.first_seen << " - " << data.sysmon.last_seen << ")";
+        sysmon_str = ss.str();
+      }
+
+      std::string sysmon_events_str;
+      for (const auto& event : data.sysmon.events) {
+        if (!sysmon_events_str.empty()) sysmon_events_str += "\n";
+        sysmon_events_str += event;
+      }
+
       // Запись данных с новыми полями
       file << escape(filename) << "," << escape(versions_str) << ","
            << escape(hashes_str) << "," << escape(file_sizes_str) << ","
            << escape(run_times_str) << "," << escape(autorun_str) << ","
            << data.run_count << "," << escape(volumes_str) << ","
-           << escape(network_str) << "," << escape(metrics_str) << "\n";
+           << escape(network_str) << "," << escape(metrics_str) << ","
+           << escape(sessions_str) << "," << escape(modules_str) << ","
+           << escape(dns_str) << "," << escape(sysmon_str) << ","
+           << escape(sysmon_events_str) << "\n";
     }
   } catch (const std::exception& e) {
     throw CsvExportException(std::string("Ошибка при экспорте данных: ") +
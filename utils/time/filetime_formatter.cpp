@@ -0,0 +1,133 @@
+#include "filetime_formatter.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace {
+
+/// @brief Секунды между 1601-01-01 и 1970-01-01
+constexpr int64_t kFiletimeEpochSeconds = 11644473600;
+
+/// @brief Количество 100-наносекундных интервалов в секунде
+constexpr uint64_t kFiletimeTicksPerSecond = 10000000;
+
+/// @brief Секунды в сутках
+constexpr int64_t kSecondsPerDay = 86400;
+
+/// @brief Границы представимого диапазона (0000-01-01, 9999-12-31 23:59:59)
+constexpr int64_t kMinSeconds = -62167219200;
+constexpr int64_t kMaxSeconds = 253402300799;
+
+/// @brief Строка нулевой (незаданной) метки
+constexpr char kNotAvailable[] = "N/A";
+
+/// @brief Пары десятичных цифр "00".."99"
+constexpr auto kDigitPairs = [] {
+  std::array<char, 200> pairs{};
+  for (int i = 0; i < 100; ++i) {
+    pairs[2 * i] = static_cast<char>('0' + i / 10);
+    pairs[2 * i + 1] = static_cast<char>('0' + i % 10);
+  }
+  return pairs;
+}();
+
+/// @brief Записывает число 0..99 двумя цифрами
+void putTwoDigits(char* out, int64_t value) noexcept {
+  std::memcpy(out, kDigitPairs.data() + 2 * value, 2);
+}
+
+/// @brief Записывает дату "YYYY-MM-DD" по номеру дня от 1970-01-01
+/// @details Алгоритм civil_from_days (H. Hinnant) для пролептического
+/// григорианского календаря
+void formatDate(int64_t days, char* out) noexcept {
+  days += 719468;
+  const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+  const int64_t day_of_era = days - era * 146097;
+  const int64_t year_of_era =
+      (day_of_era - day_of_era / 1460 + day_of_era / 36524 -
+       day_of_era / 146096) /
+      365;
+  const int64_t day_of_year =
+      day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+  const int64_t month_index = (5 * day_of_year + 2) / 153;
+  const int64_t day = day_of_year - (153 * month_index + 2) / 5 + 1;
+  const int64_t month = month_index < 10 ? month_index + 3 : month_index - 9;
+  const int64_t year = year_of_era + era * 400 + (month <= 2 ? 1 : 0);
+
+  putTwoDigits(out, year / 100);
+  putTwoDigits(out + 2, year % 100);
+  out[4] = '-';
+  putTwoDigits(out + 5, month);
+  out[7] = '-';
+  putTwoDigits(out + 8, day);
+}
+
+}
+
+void FiletimeFormatter::format(uint64_t filetime, char* out) noexcept {
+  formatSeconds(
+      static_cast<int64_t>(filetime / kFiletimeTicksPerSecond) -
+          kFiletimeEpochSeconds,
+      out);
+}
+
+void FiletimeFormatter::formatUnix(int64_t seconds, char* out) noexcept {
+  formatSeconds(seconds, out);
+}
+
+void FiletimeFormatter::formatBatch(std::span<const uint64_t> filetimes,
+                                    std::span<char> out) noexcept {
+  char* position = out.data();
+  for (const uint64_t filetime : filetimes) {
+    if (filetime == 0) {
+      std::memset(position, ' ', kLength);
+      std::memcpy(position, kNotAvailable, sizeof(kNotAvailable) - 1);
+    } else {
+      format(filetime, position);
+    }
+    position += kLength;
+  }
+}
+
+void FiletimeFormatter::appendBatch(std::span<const uint64_t> filetimes,
+                                    std::vector<std::string>& out) {
+  out.reserve(out.size() + filetimes.size());
+  for (const uint64_t filetime : filetimes) {
+    out.push_back(toString(filetime));
+  }
+}
+
+std::string FiletimeFormatter::toString(uint64_t filetime) {
+  if (filetime == 0) {
+    return kNotAvailable;
+  }
+  std::string result(kLength, '\0');
+  format(filetime, result.data());
+  return result;
+}
+
+void FiletimeFormatter::formatSeconds(int64_t seconds, char* out) noexcept {
+  seconds = std::clamp(seconds, kMinSeconds, kMaxSeconds);
+
+  // Деление с округлением вниз: время до 1970 года тоже отсчитывается от
+  // начала суток
+  int64_t day = seconds / kSecondsPerDay;
+  int64_t time_of_day = seconds % kSecondsPerDay;
+  if (time_of_day < 0) {
+    time_of_day += kSecondsPerDay;
+    --day;
+  }
+
+  if (day != cached_day_) {
+    formatDate(day, date_);
+    cached_day_ = day;
+  }
+  std::memcpy(out, date_, sizeof(date_));
+  out[10] = ' ';
+  putTwoDigits(out + 11, time_of_day / 3600);
+  out[13] = ':';
+  putTwoDigits(out + 14, time_of_day / 60 % 60);
+  out[16] = ':';
+  putTwoDigits(out + 17, time_of_day % 60);
+}
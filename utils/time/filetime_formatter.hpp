@@ -0,0 +1,59 @@
+/// @file filetime_formatter.hpp
+/// @brief Форматирование временных меток без выделения памяти
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <vector>
+
+/// @class FiletimeFormatter
+/// @brief Форматирует FILETIME и Unix-время в строку "YYYY-MM-DD HH:MM:SS"
+/// @details Дата вычисляется целочисленным преобразованием номера дня в
+/// календарную дату (без gmtime и локали) и запоминается, поэтому для
+/// соседних меток одного дня пересчитывается только время суток. Результат
+/// фиксированной длины (UTC) записывается в буфер вызывающего. Метки за
+/// пределами 0000-01-01..9999-12-31 приводятся к границам диапазона.
+/// Экземпляр не потокобезопасен: каждый поток использует свой.
+class FiletimeFormatter {
+ public:
+  static constexpr size_t kLength = 19;  ///< Длина результата
+
+  /// @brief Записывает FILETIME в буфер
+  /// @param filetime 100-наносекундные интервалы с 1601-01-01 UTC
+  /// @param out Буфер не менее kLength символов
+  void format(uint64_t filetime, char* out) noexcept;
+
+  /// @brief Записывает Unix-время в буфер
+  /// @param seconds Секунды с 1970-01-01 UTC
+  /// @param out Буфер не менее kLength символов
+  void formatUnix(int64_t seconds, char* out) noexcept;
+
+  /// @brief Форматирует пакет меток FILETIME подряд в один буфер
+  /// @details Каждая метка занимает kLength символов; нулевая метка
+  /// записывается как "N/A", дополненное пробелами, как в toString
+  /// @param filetimes Метки FILETIME
+  /// @param out Буфер не менее filetimes.size() * kLength символов
+  void formatBatch(std::span<const uint64_t> filetimes,
+                   std::span<char> out) noexcept;
+
+  /// @brief Дописывает строки меток FILETIME (нулевая метка - "N/A")
+  /// @param filetimes Метки FILETIME
+  /// @param out Вектор строк результата
+  void appendBatch(std::span<const uint64_t> filetimes,
+                   std::vector<std::string>& out);
+
+  /// @brief Возвращает строку метки FILETIME (нулевая метка - "N/A")
+  [[nodiscard]] std::string toString(uint64_t filetime);
+
+ private:
+  /// @brief Записывает секунды относительно 1970-01-01 в буфер
+  void formatSeconds(int64_t seconds, char* out) noexcept;
+
+  int64_t cached_day_ =
+      std::numeric_limits<int64_t>::min();  ///< День запомненной даты
+  char date_[10] = {};  ///< Запомненная дата "YYYY-MM-DD"
+};
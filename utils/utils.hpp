@@ -10,6 +10,8 @@
 #include <string>
 #include <vector>
 
+#include "time/filetime_formatter.hpp"
+
 /// @brief Удаляет пробельные символы в начале и конце строки
 /// @param str Строка для обработки (изменяется на месте)
 inline void trim(std::string& str) {
@@ -161,20 +163,12 @@ inline SYSTEMTIME filetimeToSystemTime(uint64_t filetime) {
 }
 
 /// @brief Конвертирует FILETIME в строку формата YYYY-MM-DD HH:MM:SS
+/// @details Потокобезопасно: у каждого потока свой форматтер
 /// @param filetime 64-битное значение FILETIME
-/// @return Строковое представление времени
+/// @return Строковое представление времени (UTC)
 inline std::string filetimeToString(uint64_t filetime) {
-  if (filetime == 0) return "N/A";
-
-  SYSTEMTIME st = filetimeToSystemTime(filetime);
-
-  std::ostringstream oss;
-  oss << std::setfill('0') << std::setw(4) << st.wYear << "-" << std::setw(2)
-      << st.wMonth << "-" << std::setw(2) << st.wDay << " " << std::setw(2)
-      << st.wHour << ":" << std::setw(2) << st.wMinute << ":" << std::setw(2)
-      << st.wSecond;
-
-  return oss.str();
+  thread_local FiletimeFormatter formatter;
+  return formatter.toString(filetime);
 }
 
 /// @brief Конвертирует FILETIME в Unix timestamp
@@ -189,16 +183,10 @@ inline time_t filetimeToUnixTime(uint64_t filetime) {
 /// @param timestamp Unix timestamp
 /// @return Строковое представление времени
 inline std::string unixTimeToString(time_t timestamp) {
-  struct tm* tm = gmtime(&timestamp);
-  if (!tm) return "N/A";
-
-  std::ostringstream oss;
-  oss << std::setfill('0') << std::setw(4) << (tm->tm_year + 1900) << "-"
-      << std::setw(2) << (tm->tm_mon + 1) << "-" << std::setw(2) << tm->tm_mday
-      << " " << std::setw(2) << tm->tm_hour << ":" << std::setw(2) << tm->tm_min
-      << ":" << std::setw(2) << tm->tm_sec;
-
-  return oss.str();
+  thread_local FiletimeFormatter formatter;
+  std::string result(FiletimeFormatter::kLength, '\0');
+  formatter.formatUnix(static_cast<int64_t>(timestamp), result.data());
+  return result;
 }
 
 /// @brief Форматирует Unix timestamp в строку (локальное время)